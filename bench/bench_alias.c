@@ -0,0 +1,116 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <popt.h>
+#include "alias.h"
+
+#define BENCH_APP_NAME "uk.co.fidgetbox.flog"
+#define BENCH_ITERATIONS 2000
+#define BENCH_ALIASES 200
+#define BENCH_OTHER_ENTRIES 200
+#define BENCH_PATH_LEN 256
+
+static struct poptOption options[] = {
+    { "level",      'l',  POPT_ARG_STRING,  NULL,  'l',  NULL,  NULL },
+    { "subsystem",  's',  POPT_ARG_STRING,  NULL,  's',  NULL,  NULL },
+    { "category",   'c',  POPT_ARG_STRING,  NULL,  'c',  NULL,  NULL },
+    POPT_TABLEEND
+};
+
+static uint64_t
+bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000000000 + (uint64_t) now.tv_nsec;
+}
+
+// Measures the cost of reading option aliases at startup, parsing a popt
+// configuration file on every run against loading the compiled alias cache
+int
+main(void) {
+    char dir[] = "/tmp/flog-bench.XXXXXX";
+    if (mkdtemp(dir) == NULL) {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+
+    char source[BENCH_PATH_LEN];
+    char cache[BENCH_PATH_LEN];
+    snprintf(source, sizeof(source), "%s/popt", dir);
+    snprintf(cache, sizeof(cache), "%s/flog.aliases", dir);
+
+    FILE *file = fopen(source, "w");
+    if (file == NULL) {
+        perror("fopen");
+        return EXIT_FAILURE;
+    }
+
+    for (int i = 0; i < BENCH_OTHER_ENTRIES; i++) {
+        fprintf(file, "other.app%d alias --option%d --verbose --quiet\n", i, i);
+    }
+    for (int i = 0; i < BENCH_ALIASES; i++) {
+        fprintf(file, BENCH_APP_NAME " alias --alias%d -l fault -s uk.co.fidgetbox.server%d -c \"runtime %d\"\n", i, i, i);
+    }
+
+    fclose(file);
+
+    const char *argv[] = { "flog", "--alias7", "message", NULL };
+    const char *sources[] = { source };
+
+    uint64_t start = bench_now();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        poptContext context = poptGetContext(BENCH_APP_NAME, 3, argv, options, 0);
+        poptReadConfigFile(context, source);
+        poptGetNextOpt(context);
+        poptFreeContext(context);
+    }
+    uint64_t parsed = bench_now() - start;
+
+    FlogAliasStatus status = ALIAS_CACHE_MISS;
+
+    start = bench_now();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        poptContext context = poptGetContext(BENCH_APP_NAME, 3, argv, options, 0);
+        status = flog_alias_read(context, BENCH_APP_NAME, sources, 1, cache);
+        poptGetNextOpt(context);
+        poptFreeContext(context);
+    }
+    uint64_t cached = bench_now() - start;
+
+    printf("aliases parsed: %8.1f us/startup\n", (double) parsed / BENCH_ITERATIONS / 1000);
+    printf("aliases cached: %8.1f us/startup (%s)\n", (double) cached / BENCH_ITERATIONS / 1000,
+           status == ALIAS_CACHE_HIT ? "cache hit" : "cache not used");
+    printf("(%d aliases, %d entries for other applications)\n", BENCH_ALIASES, BENCH_OTHER_ENTRIES);
+
+    unlink(cache);
+    unlink(source);
+    rmdir(dir);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,46 @@
+#!/usr/bin/env bash
+#
+# Measures the cost of logging a message from a bash script with the flog command,
+# which starts a process for every call, against the flog loadable builtin, which
+# runs in the shell and keeps its append files open between calls.
+#
+# Usage: bench_builtin.sh <path to flog> <path to flog.so> [iterations]
+
+set -euo pipefail
+
+if [[ $# -lt 2 ]]; then
+    echo "usage: ${0##*/} <path to flog> <path to flog.so> [iterations]" >&2
+    exit 1
+fi
+
+flog_path=$1
+builtin_path=$2
+iterations=${3:-2000}
+
+bench_dir=$(mktemp -d "${TMPDIR:-/tmp}/flog-bench.XXXXXX")
+trap 'rm -rf "${bench_dir}"' EXIT
+
+# Prints the mean time of the calls made since the given start time, which like
+# the end time is read from EPOCHREALTIME and converted to microseconds by removing
+# its decimal separator
+per_call() {
+    local start=${1//[!0-9]/} end=${EPOCHREALTIME//[!0-9]/}
+    local hundredths=$(( (10#${end} - 10#${start}) * 100 / iterations ))
+    printf '%5d.%02d us/call\n' $(( hundredths / 100 )) $(( hundredths % 100 ))
+}
+
+start=$EPOCHREALTIME
+for ((i = 0; i < iterations; i++)); do
+    "${flog_path}" -l info -s uk.co.fidgetbox.bench -a "${bench_dir}/external.log" "message ${i}"
+done
+printf 'external: '
+per_call "${start}"
+
+enable -f "${builtin_path}" flog
+
+start=$EPOCHREALTIME
+for ((i = 0; i < iterations; i++)); do
+    flog -l info -s uk.co.fidgetbox.bench -a "${bench_dir}/builtin.log" "message ${i}"
+done
+printf 'builtin:  '
+per_call "${start}"
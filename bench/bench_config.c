@@ -0,0 +1,160 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "config.h"
+#include "alias.h"
+#include "common.h"
+
+#define BENCH_ITERATIONS 20000
+#define BENCH_PATH_LEN 256
+#define BENCH_LINE "-l error -s uk.co.fidgetbox.server -c runtime -a /tmp/flog.log connection refused\n"
+
+static uint64_t
+bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000000000 + (uint64_t) now.tv_nsec;
+}
+
+static bool
+bench_parse(uint64_t *elapsed) {
+    char *argv[] = {
+        "flog", "-l", "error", "-s", "uk.co.fidgetbox.server", "-c", "runtime", "-a", "/tmp/flog.log",
+        "connection", "refused", NULL
+    };
+    int argc = (int) (sizeof(argv) / sizeof(argv[0])) - 1;
+
+    uint64_t start = bench_now();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        FlogError error = FLOG_ERROR_NONE;
+        FlogConfig *config = flog_config_new(argc, argv, &error);
+        if (config == NULL) {
+            flog_print_error(error);
+            return false;
+        }
+        flog_config_free(config);
+    }
+    *elapsed = bench_now() - start;
+
+    return true;
+}
+
+static bool
+bench_parse_line(uint64_t *elapsed) {
+    char *argv[] = { "flog", "--batch", "-", NULL };
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogConfig *defaults = flog_config_new(3, argv, &error);
+    if (defaults == NULL) {
+        flog_print_error(error);
+        return false;
+    }
+
+    FlogConfig *config = flog_config_new_with_defaults(defaults, &error);
+    if (config == NULL) {
+        flog_config_free(defaults);
+        flog_print_error(error);
+        return false;
+    }
+
+    char line[sizeof(BENCH_LINE)];
+
+    uint64_t start = bench_now();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        // Lines are parsed in place, as they are when read from a batch file
+        memcpy(line, BENCH_LINE, sizeof(BENCH_LINE));
+        error = flog_config_parse_line(config, line);
+        if (error != FLOG_ERROR_NONE) {
+            flog_config_free(config);
+            flog_config_free(defaults);
+            flog_print_error(error);
+            return false;
+        }
+    }
+    *elapsed = bench_now() - start;
+
+    flog_config_free(config);
+    flog_config_free(defaults);
+
+    return true;
+}
+
+// Measures the cost of parsing a typical command line at startup with the fast
+// argument parser, which applies when no popt configuration files exist, against
+// popt, which is used once an (empty) $HOME/.popt is created, and the cost of
+// parsing the same options from a line of a batch file
+int
+main(void) {
+    char dir[] = "/tmp/flog-bench.XXXXXX";
+    if (mkdtemp(dir) == NULL) {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+
+    char source[BENCH_PATH_LEN];
+    snprintf(source, sizeof(source), "%s/.popt", dir);
+
+    setenv("HOME", dir, 1);
+    setenv(ALIAS_CACHE_ENV, "", 1);
+
+    bool fast = !flog_alias_sources_exist();
+
+    uint64_t unaliased;
+    if (!bench_parse(&unaliased)) {
+        return EXIT_FAILURE;
+    }
+
+    uint64_t line;
+    if (!bench_parse_line(&line)) {
+        return EXIT_FAILURE;
+    }
+
+    FILE *file = fopen(source, "w");
+    if (file == NULL) {
+        perror("fopen");
+        return EXIT_FAILURE;
+    }
+    fclose(file);
+
+    uint64_t aliased;
+    if (!bench_parse(&aliased)) {
+        return EXIT_FAILURE;
+    }
+
+    printf("fast parser: %8.2f us/startup%s\n", (double) unaliased / BENCH_ITERATIONS / 1000,
+           fast ? "" : " (not used, system popt configuration exists)");
+    printf("popt parser: %8.2f us/startup\n", (double) aliased / BENCH_ITERATIONS / 1000);
+    printf("batch line:  %8.2f us/line\n", (double) line / BENCH_ITERATIONS / 1000);
+
+    unlink(source);
+    rmdir(dir);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,172 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "jsonl.h"
+#include "fields.h"
+#include "prefix.h"
+#include "config.h"
+#include "common.h"
+
+#define BENCH_RECORDS 2000000
+#define BENCH_RECORDS_PER_SECOND 100000
+
+static const char *bench_messages[] = {
+    "request served in 12ms for GET /api/v1/users/42 by worker 3",
+    "connection reset by peer while reading response headers from upstream 10.0.0.7:8080, retrying",
+    "payload {\"id\":42,\"path\":\"C:\\\\tmp\"} rejected",
+};
+
+#define BENCH_MESSAGE_COUNT (sizeof(bench_messages) / sizeof(bench_messages[0]))
+
+// Escapes a string a byte at a time, as a baseline for the word-at-a-time scan used
+// when rendering records
+static size_t
+bench_escape_bytewise(const char *str, size_t len, char *buf) {
+    static const char hex[] = "0123456789abcdef";
+    size_t pos = 0;
+
+    buf[pos++] = '"';
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char) str[i];
+        if (c == '"' || c == '\\') {
+            buf[pos++] = '\\';
+            buf[pos++] = (char) c;
+        } else if (c < 0x20) {
+            memcpy(buf + pos, "\\u00", 4);
+            buf[pos + 4] = hex[c >> 4];
+            buf[pos + 5] = hex[c & 0xf];
+            pos += 6;
+        } else {
+            buf[pos++] = (char) c;
+        }
+    }
+    buf[pos++] = '"';
+
+    return pos;
+}
+
+static uint64_t
+bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000000000 + (uint64_t) now.tv_nsec;
+}
+
+static struct timespec
+bench_time(const struct timespec *base, long i) {
+    struct timespec time = {
+        .tv_sec = base->tv_sec + i / BENCH_RECORDS_PER_SECOND,
+        .tv_nsec = (i % BENCH_RECORDS_PER_SECOND) * (1000000000 / BENCH_RECORDS_PER_SECOND)
+    };
+
+    return time;
+}
+
+int
+main(void) {
+    FlogError error = FLOG_ERROR_NONE;
+    FlogPrefix *text_prefix = flog_prefix_new(PFX_TIME | PFX_LEVEL | PFX_SUBSYSTEM | PFX_CATEGORY, &error);
+    FlogPrefix *time_prefix = flog_prefix_new(PFX_TIME, &error);
+    char *buf = malloc(JSONL_LEN);
+    if (text_prefix == NULL || time_prefix == NULL || buf == NULL) {
+        flog_print_error(error != FLOG_ERROR_NONE ? error : FLOG_ERROR_ALLOC);
+        return EXIT_FAILURE;
+    }
+
+    size_t message_lens[BENCH_MESSAGE_COUNT];
+    for (size_t i = 0; i < BENCH_MESSAGE_COUNT; i++) {
+        message_lens[i] = strlen(bench_messages[i]);
+    }
+
+    struct timespec base;
+    clock_gettime(CLOCK_REALTIME, &base);
+
+    char prefix[PREFIX_LEN];
+    size_t total = 0;
+
+    // The text record is the prefix followed by the message, as written by writev(2)
+    uint64_t start = bench_now();
+    for (long i = 0; i < BENCH_RECORDS; i++) {
+        struct timespec time = bench_time(&base, i);
+        size_t len = flog_prefix_render(text_prefix, &time, LVL_ERROR, "com.example.app", "network",
+                                        prefix, sizeof(prefix));
+        size_t message = (size_t) i % BENCH_MESSAGE_COUNT;
+        memcpy(buf, prefix, len);
+        memcpy(buf + len, bench_messages[message], message_lens[message]);
+        total += len + message_lens[message];
+    }
+    uint64_t text = bench_now() - start;
+
+    start = bench_now();
+    for (long i = 0; i < BENCH_RECORDS; i++) {
+        struct timespec time = bench_time(&base, i);
+        size_t len = flog_prefix_render(time_prefix, &time, LVL_ERROR, "", "", prefix, sizeof(prefix));
+        size_t message = (size_t) i % BENCH_MESSAGE_COUNT;
+
+        FlogJsonlRecord record = {
+            .time = prefix,
+            .time_len = len - 1,
+            .level = LVL_ERROR,
+            .message_type = MSG_PUBLIC,
+            .subsystem = "com.example.app",
+            .category = "network",
+            .message = bench_messages[message],
+            .message_len = message_lens[message]
+        };
+        total += flog_jsonl_render(&record, buf, JSONL_LEN);
+    }
+    uint64_t json = bench_now() - start;
+
+    start = bench_now();
+    for (long i = 0; i < BENCH_RECORDS; i++) {
+        size_t message = (size_t) i % BENCH_MESSAGE_COUNT;
+        total += bench_escape_bytewise(bench_messages[message], message_lens[message], buf);
+    }
+    uint64_t bytewise = bench_now() - start;
+
+    start = bench_now();
+    for (long i = 0; i < BENCH_RECORDS; i++) {
+        size_t message = (size_t) i % BENCH_MESSAGE_COUNT;
+        size_t len = 0;
+        flog_fields_append_quoted(buf, JSONL_LEN, &len, bench_messages[message], message_lens[message]);
+        total += len;
+    }
+    uint64_t wordwise = bench_now() - start;
+
+    printf("text record:     %6.1f ns/record\n", (double) text / BENCH_RECORDS);
+    printf("json record:     %6.1f ns/record\n", (double) json / BENCH_RECORDS);
+    printf("escape bytewise: %6.1f ns/message\n", (double) bytewise / BENCH_RECORDS);
+    printf("escape wordwise: %6.1f ns/message\n", (double) wordwise / BENCH_RECORDS);
+    printf("(%zu bytes rendered)\n", total);
+
+    free(buf);
+    flog_prefix_free(time_prefix);
+    flog_prefix_free(text_prefix);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,263 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <sys/utsname.h>
+#include "flog.h"
+#include "config.h"
+#include "common.h"
+
+#define BENCH_ITERATIONS 200
+#define BENCH_PATH_LEN 256
+#define BENCH_PHASE_COUNT 4
+
+extern char **environ;
+
+static const size_t message_sizes[] = { 1, 64, 1024, 4096, MESSAGE_LEN - 1 };
+
+static const char *phase_names[BENCH_PHASE_COUNT] = {
+    "flog_config_new",
+    "flog_cli_new",
+    "flog_append_message_output",
+    "flog_commit_message"
+};
+
+static uint64_t
+bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000000000 + (uint64_t) now.tv_nsec;
+}
+
+static int
+bench_compare(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+// Percentiles use the nearest-rank method over the sorted samples
+static uint64_t
+bench_percentile(const uint64_t *sorted, int count, int percentile) {
+    int rank = (percentile * count + 99) / 100;
+
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+static void
+bench_print_result(const char *name, size_t message_size, uint64_t *samples, int count, bool last) {
+    qsort(samples, (size_t) count, sizeof(uint64_t), bench_compare);
+
+    uint64_t total = 0;
+    for (int i = 0; i < count; i++) {
+        total += samples[i];
+    }
+
+    printf("    {\"name\": \"%s\", \"message_size\": %zu, \"samples\": %d, \"unit\": \"ns\", "
+           "\"mean\": %llu, \"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"max\": %llu}%s\n",
+           name, message_size, count,
+           (unsigned long long) (total / (uint64_t) count),
+           (unsigned long long) bench_percentile(samples, count, 50),
+           (unsigned long long) bench_percentile(samples, count, 90),
+           (unsigned long long) bench_percentile(samples, count, 99),
+           (unsigned long long) samples[count - 1],
+           last ? "" : ",");
+}
+
+// Measures the time from posix_spawn(3) of the flog binary to its exit
+static bool
+bench_exec(const char *binary, char *argv[], uint64_t *samples, int count) {
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+
+    bool success = true;
+    for (int i = 0; i < count && success; i++) {
+        pid_t pid;
+        int status;
+
+        uint64_t start = bench_now();
+        if (posix_spawn(&pid, binary, &actions, NULL, argv, environ) != 0 ||
+            waitpid(pid, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "bench_latency: %s did not run successfully\n", binary);
+            success = false;
+        }
+        samples[i] = bench_now() - start;
+    }
+
+    posix_spawn_file_actions_destroy(&actions);
+
+    return success;
+}
+
+// Measures each phase of logging a message in-process, in the order used by main()
+static bool
+bench_phases(int argc, char *argv[], uint64_t *samples[BENCH_PHASE_COUNT], int count) {
+    for (int i = 0; i < count; i++) {
+        FlogError error = FLOG_ERROR_NONE;
+
+        uint64_t start = bench_now();
+        FlogConfig *config = flog_config_new(argc, argv, &error);
+        uint64_t config_end = bench_now();
+        if (config == NULL) {
+            flog_print_error(error);
+            return false;
+        }
+
+        FlogCli *flog = flog_cli_new(config, &error);
+        uint64_t cli_end = bench_now();
+        if (flog == NULL) {
+            flog_config_free(config);
+            flog_print_error(error);
+            return false;
+        }
+
+        error = flog_append_message_output(flog);
+        uint64_t append_end = bench_now();
+        if (error != FLOG_ERROR_NONE) {
+            flog_cli_free(flog);
+            flog_config_free(config);
+            flog_print_error(error);
+            return false;
+        }
+
+        flog_commit_message(flog);
+        uint64_t commit_end = bench_now();
+
+        samples[0][i] = config_end - start;
+        samples[1][i] = cli_end - config_end;
+        samples[2][i] = append_end - cli_end;
+        samples[3][i] = commit_end - append_end;
+
+        flog_cli_free(flog);
+        flog_config_free(config);
+    }
+
+    return true;
+}
+
+// Reports exec-to-exit latency of the flog binary and the cost of each phase of
+// logging a message, for message sizes from 1 byte to MESSAGE_LEN - 1, as JSON
+int
+main(int argc, char *argv[]) {
+    const char *binary = BENCH_FLOG_PATH;
+    int iterations = BENCH_ITERATIONS;
+
+    int option;
+    while ((option = getopt(argc, argv, "b:n:")) != -1) {
+        switch (option) {
+            case 'b':
+                binary = optarg;
+                break;
+            case 'n':
+                iterations = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "usage: bench_latency [-b flog_binary] [-n iterations]\n");
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (iterations < 1) {
+        fprintf(stderr, "bench_latency: iterations must be a positive number\n");
+        return EXIT_FAILURE;
+    }
+
+    char dir[] = "/tmp/flog-bench.XXXXXX";
+    if (mkdtemp(dir) == NULL) {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+
+    char path[BENCH_PATH_LEN];
+    snprintf(path, sizeof(path), "%s/latency.log", dir);
+
+    uint64_t *exec_samples = malloc((size_t) iterations * sizeof(uint64_t));
+    uint64_t *phase_samples[BENCH_PHASE_COUNT];
+    char *message = malloc(MESSAGE_LEN);
+    bool success = exec_samples != NULL && message != NULL;
+
+    for (int phase = 0; phase < BENCH_PHASE_COUNT; phase++) {
+        phase_samples[phase] = malloc((size_t) iterations * sizeof(uint64_t));
+        success = success && phase_samples[phase] != NULL;
+    }
+
+    struct utsname system;
+    uname(&system);
+
+    printf("{\n");
+    printf("  \"benchmark\": \"latency\",\n");
+    printf("  \"system\": \"%s\",\n", system.sysname);
+    printf("  \"machine\": \"%s\",\n", system.machine);
+    printf("  \"iterations\": %d,\n", iterations);
+    printf("  \"results\": [\n");
+
+    size_t size_count = sizeof(message_sizes) / sizeof(message_sizes[0]);
+    for (size_t s = 0; s < size_count && success; s++) {
+        memset(message, 'x', message_sizes[s]);
+        message[message_sizes[s]] = '\0';
+
+        char *bench_argv[] = {
+            "flog", "-l", "info", "-s", "uk.co.fidgetbox.bench", "-c", "latency", "-a", path, message, NULL
+        };
+        int bench_argc = (int) (sizeof(bench_argv) / sizeof(bench_argv[0])) - 1;
+
+        success = bench_exec(binary, bench_argv, exec_samples, iterations) &&
+                  bench_phases(bench_argc, bench_argv, phase_samples, iterations);
+
+        if (success) {
+            bool last_size = s + 1 == size_count;
+
+            bench_print_result("exec", message_sizes[s], exec_samples, iterations, false);
+            for (int phase = 0; phase < BENCH_PHASE_COUNT; phase++) {
+                bench_print_result(phase_names[phase], message_sizes[s], phase_samples[phase], iterations,
+                                   last_size && phase + 1 == BENCH_PHASE_COUNT);
+            }
+        }
+
+        unlink(path);
+    }
+
+    printf("  ]\n");
+    printf("}\n");
+
+    for (int phase = 0; phase < BENCH_PHASE_COUNT; phase++) {
+        free(phase_samples[phase]);
+    }
+    free(exec_samples);
+    free(message);
+    rmdir(dir);
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
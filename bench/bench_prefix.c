@@ -0,0 +1,110 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "prefix.h"
+#include "config.h"
+#include "common.h"
+
+#define BENCH_RECORDS 2000000
+#define BENCH_RECORDS_PER_SECOND 100000
+
+// Approximates the per-record cost of rendering the same prefix with localtime_r(3),
+// strftime(3) and snprintf(3), as a baseline for the cached rendering in prefix.c
+static size_t
+bench_render_uncached(const struct timespec *time, FlogConfigLevel level, const char *subsystem,
+                      const char *category, char *buf, size_t size) {
+    struct tm tm;
+    localtime_r(&time->tv_sec, &tm);
+
+    char date[32];
+    char offset[8];
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &tm);
+    strftime(offset, sizeof(offset), "%z", &tm);
+
+    int len = snprintf(buf, size, "%s.%06ld%.3s:%.2s %s [%ld] %s %s ",
+                       date, time->tv_nsec / 1000, offset, offset + 3,
+                       flog_config_level_string(level), (long) getpid(),
+                       subsystem[0] != '\0' ? subsystem : "-",
+                       category[0] != '\0' ? category : "-");
+
+    return (size_t) len;
+}
+
+static uint64_t
+bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000000000 + (uint64_t) now.tv_nsec;
+}
+
+int
+main(void) {
+    FlogError error = FLOG_ERROR_NONE;
+    FlogPrefix *prefix = flog_prefix_new(PFX_TIME | PFX_LEVEL | PFX_PID | PFX_SUBSYSTEM | PFX_CATEGORY, &error);
+    if (prefix == NULL) {
+        flog_print_error(error);
+        return EXIT_FAILURE;
+    }
+
+    struct timespec base;
+    clock_gettime(CLOCK_REALTIME, &base);
+
+    char buf[PREFIX_LEN];
+    size_t total = 0;
+
+    // Records are spread over simulated time so that the cached second changes at a
+    // realistic rate rather than never (or on every record)
+    uint64_t start = bench_now();
+    for (long i = 0; i < BENCH_RECORDS; i++) {
+        struct timespec time = {
+            .tv_sec = base.tv_sec + i / BENCH_RECORDS_PER_SECOND,
+            .tv_nsec = (i % BENCH_RECORDS_PER_SECOND) * (1000000000 / BENCH_RECORDS_PER_SECOND)
+        };
+        total += flog_prefix_render(prefix, &time, LVL_ERROR, "com.example.app", "network", buf, sizeof(buf));
+    }
+    uint64_t cached = bench_now() - start;
+
+    start = bench_now();
+    for (long i = 0; i < BENCH_RECORDS; i++) {
+        struct timespec time = {
+            .tv_sec = base.tv_sec + i / BENCH_RECORDS_PER_SECOND,
+            .tv_nsec = (i % BENCH_RECORDS_PER_SECOND) * (1000000000 / BENCH_RECORDS_PER_SECOND)
+        };
+        total += bench_render_uncached(&time, LVL_ERROR, "com.example.app", "network", buf, sizeof(buf));
+    }
+    uint64_t uncached = bench_now() - start;
+
+    printf("prefix cached:   %6.1f ns/record\n", (double) cached / BENCH_RECORDS);
+    printf("prefix strftime: %6.1f ns/record\n", (double) uncached / BENCH_RECORDS);
+    printf("(%zu bytes rendered)\n", total);
+
+    flog_prefix_free(prefix);
+
+    return EXIT_SUCCESS;
+}
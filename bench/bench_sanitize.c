@@ -0,0 +1,146 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "sanitize.h"
+
+#define BENCH_INPUT_LEN (1024 * 1024)
+#define BENCH_ROUNDS 200
+
+// Validates a string a byte at a time with the same rules as flog_sanitize_scan(), as a
+// baseline for the vector and word scans used there
+static size_t
+bench_scan_bytewise(const unsigned char *str, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        unsigned char c = str[i];
+        if ((c >= 0x20 && c < 0x80) || c == '\t' || c == '\n') {
+            i++;
+            continue;
+        } else if (c == '\r') {
+            if (i + 1 < len && str[i + 1] == '\n') {
+                i += 2;
+                continue;
+            }
+            break;
+        }
+
+        size_t sequence_len = c >= 0xc2 && c <= 0xdf ? 2 : c >= 0xe0 && c <= 0xef ? 3 : c >= 0xf0 && c <= 0xf4 ? 4 : 0;
+        unsigned char min = c == 0xe0 ? 0xa0 : c == 0xf0 ? 0x90 : 0x80;
+        unsigned char max = c == 0xed ? 0x9f : c == 0xf4 ? 0x8f : 0xbf;
+        if (sequence_len == 0 || i + sequence_len > len || str[i + 1] < min || str[i + 1] > max) {
+            break;
+        }
+
+        size_t j = 2;
+        while (j < sequence_len && str[i + j] >= 0x80 && str[i + j] <= 0xbf) {
+            j++;
+        }
+        if (j < sequence_len) {
+            break;
+        }
+        i += sequence_len;
+    }
+
+    return i;
+}
+
+static uint64_t
+bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000000000 + (uint64_t) now.tv_nsec;
+}
+
+static void
+bench_fill(char *buf, size_t len, const char *pattern) {
+    size_t pattern_len = strlen(pattern);
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = pattern[i % pattern_len];
+    }
+}
+
+static void
+bench_run(const char *name, const char *input, char *output) {
+    size_t total = 0;
+    bool truncated;
+
+    uint64_t start = bench_now();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        total += flog_sanitize_scan(input, BENCH_INPUT_LEN);
+    }
+    uint64_t scan = bench_now() - start;
+
+    start = bench_now();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        total += bench_scan_bytewise((const unsigned char *) input, BENCH_INPUT_LEN);
+    }
+    uint64_t bytewise = bench_now() - start;
+
+    start = bench_now();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        total += flog_sanitize_copy(input, BENCH_INPUT_LEN, output, BENCH_INPUT_LEN * 4 + 1, &truncated);
+    }
+    uint64_t copy = bench_now() - start;
+
+    double bytes = (double) BENCH_INPUT_LEN * BENCH_ROUNDS;
+    printf("%-12s scan %6.2f GB/s, bytewise scan %6.2f GB/s, copy %6.2f GB/s (%zu)\n", name,
+           bytes / (double) scan, bytes / (double) bytewise, bytes / (double) copy, total);
+}
+
+int
+main(void) {
+    char *input = malloc(BENCH_INPUT_LEN);
+    char *output = malloc(BENCH_INPUT_LEN * 4 + 1);
+    if (input == NULL || output == NULL) {
+        fprintf(stderr, "bench_sanitize: out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    bench_fill(input, BENCH_INPUT_LEN, "GET /api/v1/users/42 served in 12ms by worker 3\n");
+    bench_run("ascii", input, output);
+
+    // The byte-wise scan stops at the first sequence cut short where the input ends
+    bench_fill(input, BENCH_INPUT_LEN,
+               "caf\xc3\xa9 cr\xc3\xa8me br\xc3\xbbl\xc3\xa9" "e \xe2\x82\xac" "5 \xf0\x9f\x98\x80\n");
+    bench_run("mixed utf-8", input, output);
+
+    // Random bytes hold an invalid sequence or control character every few bytes
+    srand(1);
+    for (size_t i = 0; i < BENCH_INPUT_LEN; i++) {
+        input[i] = (char) (rand() & 0xff);
+    }
+    bench_run("random", input, output);
+
+    bench_fill(input, BENCH_INPUT_LEN, "\x1b[31m\xff\xc0\x80");
+    bench_run("escapes", input, output);
+
+    free(output);
+    free(input);
+
+    return EXIT_SUCCESS;
+}
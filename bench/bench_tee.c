@@ -0,0 +1,215 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "flog.h"
+#include "config.h"
+#include "common.h"
+
+#define BENCH_SIZE_MIB 256
+#define BENCH_LINE_LEN 200
+#define BENCH_CHUNK_SIZE 131072
+#define BENCH_PATH_LEN 256
+#define BENCH_RUNS 5
+
+static uint64_t
+bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000000000 + (uint64_t) now.tv_nsec;
+}
+
+static int
+bench_compare(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+// Writes size bytes of lines of line_len bytes (including the newline) to fd, as
+// an upstream command in a pipeline would
+static void
+bench_produce(int fd, size_t size, size_t line_len) {
+    char *chunk = malloc(BENCH_CHUNK_SIZE);
+    if (chunk == NULL) {
+        _exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < BENCH_CHUNK_SIZE; i++) {
+        chunk[i] = (i + 1) % line_len == 0 ? '\n' : (char) ('a' + i % 26);
+    }
+
+    size_t offset = 0;
+    while (size > 0) {
+        size_t len = size < BENCH_CHUNK_SIZE - offset ? size : BENCH_CHUNK_SIZE - offset;
+        ssize_t written = write(fd, chunk + offset, len);
+        if (written <= 0) {
+            _exit(EXIT_FAILURE);
+        }
+
+        size -= (size_t) written;
+        offset = (offset + (size_t) written) % BENCH_CHUNK_SIZE;
+    }
+
+    _exit(EXIT_SUCCESS);
+}
+
+static bool
+bench_tee(const char *path, bool zero_copy, size_t size, size_t line_len, uint64_t *elapsed) {
+    char *argv[] = { "flog", "-a", (char *) path, "--tee", NULL };
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogConfig *config = flog_config_new(4, argv, &error);
+    if (config == NULL) {
+        flog_print_error(error);
+        return false;
+    }
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    if (flog == NULL) {
+        flog_config_free(config);
+        flog_print_error(error);
+        return false;
+    }
+
+    int fds[2];
+    if (pipe(fds) < 0) {
+        perror("pipe");
+        return false;
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        bench_produce(fds[1], size, line_len);
+    }
+    close(fds[1]);
+
+    uint64_t start = bench_now();
+    error = flog_cli_tee(flog, fds[0], zero_copy);
+    if (error == FLOG_ERROR_NONE) {
+        error = flog_cli_flush(flog);
+    }
+    *elapsed = bench_now() - start;
+
+    close(fds[0]);
+
+    int status;
+    waitpid(pid, &status, 0);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    struct stat file_stat;
+    if (error != FLOG_ERROR_NONE || stat(path, &file_stat) < 0 || (size_t) file_stat.st_size != size) {
+        fprintf(stderr, "bench_tee: %s was not passed through completely\n", path);
+        return false;
+    }
+
+    unlink(path);
+
+    return true;
+}
+
+// Measures the throughput of passing a pipe through to an append file with --tee,
+// copying the data through user space against moving it with tee(2) and splice(2)
+// where they are available; both paths commit every line to the logging system.
+// The runs of each path alternate, and the median of each is reported
+int
+main(int argc, char *argv[]) {
+    size_t size_mib = BENCH_SIZE_MIB;
+    size_t line_len = BENCH_LINE_LEN;
+    int runs = BENCH_RUNS;
+
+    int option;
+    while ((option = getopt(argc, argv, "s:l:n:")) != -1) {
+        switch (option) {
+            case 's':
+                size_mib = (size_t) strtoul(optarg, NULL, 10);
+                break;
+            case 'l':
+                line_len = (size_t) strtoul(optarg, NULL, 10);
+                break;
+            case 'n':
+                runs = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "usage: bench_tee [-s size_mib] [-l line_length] [-n runs]\n");
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (size_mib < 1 || line_len < 2 || runs < 1) {
+        fprintf(stderr, "bench_tee: size, line length and runs must be positive numbers\n");
+        return EXIT_FAILURE;
+    }
+
+    char dir[] = "/tmp/flog-bench.XXXXXX";
+    if (mkdtemp(dir) == NULL) {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+
+    char path[BENCH_PATH_LEN];
+    snprintf(path, sizeof(path), "%s/tee.log", dir);
+
+    size_t size = size_mib * 1024 * 1024;
+
+    uint64_t *copy = calloc((size_t) runs, sizeof(uint64_t));
+    uint64_t *zero_copy = calloc((size_t) runs, sizeof(uint64_t));
+    if (copy == NULL || zero_copy == NULL) {
+        perror("calloc");
+        return EXIT_FAILURE;
+    }
+
+    for (int i = 0; i < runs; i++) {
+        if (!bench_tee(path, false, size, line_len, &copy[i]) ||
+            !bench_tee(path, true, size, line_len, &zero_copy[i])) {
+            rmdir(dir);
+            return EXIT_FAILURE;
+        }
+    }
+
+    rmdir(dir);
+
+    qsort(copy, (size_t) runs, sizeof(uint64_t), bench_compare);
+    qsort(zero_copy, (size_t) runs, sizeof(uint64_t), bench_compare);
+
+    printf("tee %zu MiB in %zu byte lines (median of %d runs):\n", size_mib, line_len, runs);
+    printf("  copy       %8.1f MiB/s\n", (double) size_mib / ((double) copy[runs / 2] / 1e9));
+    printf("  zero copy  %8.1f MiB/s\n", (double) size_mib / ((double) zero_copy[runs / 2] / 1e9));
+
+    free(copy);
+    free(zero_copy);
+
+    return EXIT_SUCCESS;
+}
@@ -1,8 +1,24 @@
 function(add_cmocka_test unit)
+    cmake_parse_arguments(PARSE_ARGV 1 ARG "" "" "SOURCES")
+
     set(test_target test_${unit})
 
     add_executable(${test_target} test_${unit}.c ${CMAKE_SOURCE_DIR}/src/${unit}.c)
 
+    # Additional sources are built without UNIT_TESTING so that only the unit under
+    # test has its allocation and assertion functions replaced by test/testing.h
+    if (ARG_SOURCES)
+        list(TRANSFORM ARG_SOURCES PREPEND ${CMAKE_SOURCE_DIR}/src/)
+        add_library(${test_target}_sources OBJECT ${ARG_SOURCES})
+        target_include_directories(${test_target}_sources PRIVATE ${CMAKE_SOURCE_DIR}/src PRIVATE ${POPT_INCLUDE_DIRS})
+        target_compile_options(${test_target}_sources PRIVATE ${POPT_CFLAGS})
+        target_sources(${test_target} PRIVATE $<TARGET_OBJECTS:${test_target}_sources>)
+
+        if (ENABLE_COVERAGE)
+            target_compile_options(${test_target}_sources PRIVATE -fprofile-arcs PRIVATE -ftest-coverage)
+        endif()
+    endif()
+
     if (ENABLE_COVERAGE)
         target_link_options(${test_target} PRIVATE --coverage)
         target_compile_options(${test_target} PRIVATE -fprofile-arcs PRIVATE -ftest-coverage)
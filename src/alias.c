@@ -0,0 +1,690 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "alias.h"
+#include "common.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syslimits.h>
+#include <popt.h>
+
+#ifdef UNIT_TESTING
+#include "../test/testing.h"
+#endif
+
+#define ALIAS_CACHE_MAGIC "FLOGALS"
+#define ALIAS_CACHE_VERSION 1
+#define ALIAS_CACHE_NAME_SUFFIX ".aliases"
+#define ALIAS_SOURCE_MAX 8
+#define ALIAS_ALIGN(n) (((n) + 7) & ~(size_t) 7)
+
+#ifdef __APPLE__
+#define ALIAS_MTIME(statbuf) ((statbuf).st_mtimespec)
+#else
+#define ALIAS_MTIME(statbuf) ((statbuf).st_mtim)
+#endif
+
+// The cache image is written in native byte order, as it is only ever read by the
+// host that wrote it:
+//
+//   AliasHeader, application name
+//   AliasSource, source path        (source_count times)
+//   AliasEntry, long name, argv     (alias_count times)
+//
+// Strings are null-terminated and each item starts on an 8-byte boundary.
+
+typedef struct AliasHeaderData {
+    char magic[8];
+    uint32_t version;
+    uint32_t source_count;
+    uint32_t alias_count;
+    uint32_t app_len;
+    uint64_t size;
+} AliasHeader;
+
+typedef struct AliasSourceData {
+    int64_t size;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+    uint64_t ino;
+    uint64_t dev;
+    uint32_t path_len;
+    uint32_t reserved;
+} AliasSource;
+
+typedef struct AliasEntryData {
+    uint32_t short_name;
+    uint32_t argc;
+    uint32_t long_len;
+    uint32_t data_len;
+} AliasEntry;
+
+typedef struct AliasImageData {
+    char *data;
+    size_t len;
+    size_t cap;
+    bool failed;
+} AliasImage;
+
+void flog_alias_stat_source(const char *path, AliasSource *source);
+
+bool flog_alias_build_image(AliasImage *image, const char *app_name, const char *const *sources,
+                            const AliasSource *stats, size_t source_count);
+
+bool flog_alias_parse_file(AliasImage *image, const char *app_name, const char *path, uint32_t *alias_count);
+
+bool flog_alias_parse_line(AliasImage *image, const char *app_name, char *line, uint32_t *alias_count);
+
+bool flog_alias_walk(poptContext context, const char *data, size_t len, const char *app_name,
+                     const char *const *sources, const AliasSource *stats, size_t source_count, bool add);
+
+void flog_alias_image_append(AliasImage *image, const void *data, size_t len);
+
+void flog_alias_image_align(AliasImage *image);
+
+void flog_alias_write_cache(const char *cache_path, const AliasImage *image);
+
+bool flog_alias_default_cache_path(const char *app_name, char *buf, size_t size);
+
+bool
+flog_alias_sources_exist(void) {
+#ifndef FLOG_POPT_SYSCONFDIR
+    // Without the directory popt reads there is no telling whether aliases apply
+    return true;
+#else
+    struct stat statbuf;
+
+    if (stat(FLOG_POPT_SYSCONFDIR "/popt", &statbuf) == 0 || stat(FLOG_POPT_SYSCONFDIR "/popt.d", &statbuf) == 0) {
+        return true;
+    }
+
+    char home_source[PATH_MAX];
+    const char *home = getenv("HOME");
+
+    return home != NULL && snprintf(home_source, PATH_MAX, "%s/.popt", home) < PATH_MAX &&
+           stat(home_source, &statbuf) == 0;
+#endif
+}
+
+FlogAliasStatus
+flog_alias_read_default(poptContext context, const char *app_name) {
+    assert(context != NULL);
+    assert(app_name != NULL);
+
+#ifndef FLOG_POPT_SYSCONFDIR
+    poptReadDefaultConfig(context, 0);
+    return ALIAS_UNCACHED;
+#else
+    struct stat statbuf;
+    if (stat(FLOG_POPT_SYSCONFDIR "/popt.d", &statbuf) == 0 && S_ISDIR(statbuf.st_mode)) {
+        poptReadDefaultConfig(context, 0);
+        return ALIAS_UNCACHED;
+    }
+
+    const char *sources[2] = { FLOG_POPT_SYSCONFDIR "/popt", NULL };
+    size_t source_count = 1;
+
+    char home_source[PATH_MAX];
+    const char *home = getenv("HOME");
+    if (home != NULL && snprintf(home_source, PATH_MAX, "%s/.popt", home) < PATH_MAX) {
+        sources[source_count++] = home_source;
+    }
+
+    char cache_path[PATH_MAX];
+    const char *cache = getenv(ALIAS_CACHE_ENV);
+
+    if (cache != NULL) {
+        cache = strlen(cache) > 0 ? cache : NULL;
+    } else if (flog_alias_default_cache_path(app_name, cache_path, PATH_MAX)) {
+        cache = cache_path;
+    }
+
+    return flog_alias_read(context, app_name, sources, source_count, cache);
+#endif
+}
+
+FlogAliasStatus
+flog_alias_read(poptContext context, const char *app_name, const char *const *sources,
+                size_t source_count, const char *cache_path) {
+    assert(context != NULL);
+    assert(app_name != NULL);
+    assert(sources != NULL);
+
+    AliasSource stats[ALIAS_SOURCE_MAX];
+    if (source_count > ALIAS_SOURCE_MAX) {
+        for (size_t i = 0; i < source_count; i++) {
+            poptReadConfigFile(context, sources[i]);
+        }
+        return ALIAS_UNCACHED;
+    }
+
+    // Sources are examined before they are read, so that a source modified while it
+    // is being read leaves a cache that will be found to be stale
+    for (size_t i = 0; i < source_count; i++) {
+        flog_alias_stat_source(sources[i], &stats[i]);
+    }
+
+    if (cache_path != NULL) {
+        int fd = open(cache_path, O_RDONLY | O_CLOEXEC);
+        struct stat statbuf;
+
+        if (fd != -1 && fstat(fd, &statbuf) == 0 && S_ISREG(statbuf.st_mode) &&
+            statbuf.st_uid == geteuid() && (statbuf.st_mode & (S_IWGRP | S_IWOTH)) == 0 &&
+            (size_t) statbuf.st_size >= sizeof(AliasHeader)) {
+            size_t len = (size_t) statbuf.st_size;
+            void *data = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (data != MAP_FAILED) {
+                bool valid = flog_alias_walk(context, data, len, app_name, sources, stats, source_count, false);
+                if (valid) {
+                    flog_alias_walk(context, data, len, app_name, sources, stats, source_count, true);
+                }
+
+                munmap(data, len);
+
+                if (valid) {
+                    close(fd);
+                    return ALIAS_CACHE_HIT;
+                }
+            }
+        }
+
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+
+    AliasImage image = {0};
+    if (!flog_alias_build_image(&image, app_name, sources, stats, source_count)) {
+        free(image.data);
+        for (size_t i = 0; i < source_count; i++) {
+            poptReadConfigFile(context, sources[i]);
+        }
+        return ALIAS_UNCACHED;
+    }
+
+    flog_alias_walk(context, image.data, image.len, app_name, sources, stats, source_count, true);
+
+    if (cache_path != NULL) {
+        flog_alias_write_cache(cache_path, &image);
+    }
+
+    free(image.data);
+
+    return ALIAS_CACHE_MISS;
+}
+
+void
+flog_alias_stat_source(const char *path, AliasSource *source) {
+    memset(source, 0, sizeof(AliasSource));
+
+    struct stat statbuf;
+    if (stat(path, &statbuf) != 0) {
+        source->size = -1;
+        return;
+    }
+
+    source->size = (int64_t) statbuf.st_size;
+    source->mtime_sec = (int64_t) ALIAS_MTIME(statbuf).tv_sec;
+    source->mtime_nsec = (int64_t) ALIAS_MTIME(statbuf).tv_nsec;
+    source->ino = (uint64_t) statbuf.st_ino;
+    source->dev = (uint64_t) statbuf.st_dev;
+}
+
+bool
+flog_alias_build_image(AliasImage *image, const char *app_name, const char *const *sources,
+                       const AliasSource *stats, size_t source_count) {
+    AliasHeader header = {
+        .magic = ALIAS_CACHE_MAGIC,
+        .version = ALIAS_CACHE_VERSION,
+        .source_count = (uint32_t) source_count,
+        .alias_count = 0,
+        .app_len = (uint32_t) strlen(app_name)
+    };
+
+    flog_alias_image_append(image, &header, sizeof(header));
+    flog_alias_image_append(image, app_name, header.app_len + 1);
+    flog_alias_image_align(image);
+
+    for (size_t i = 0; i < source_count; i++) {
+        AliasSource source = stats[i];
+        source.path_len = (uint32_t) strlen(sources[i]);
+
+        flog_alias_image_append(image, &source, sizeof(source));
+        flog_alias_image_append(image, sources[i], source.path_len + 1);
+        flog_alias_image_align(image);
+    }
+
+    for (size_t i = 0; i < source_count; i++) {
+        if (stats[i].size >= 0 && !flog_alias_parse_file(image, app_name, sources[i], &header.alias_count)) {
+            return false;
+        }
+    }
+
+    if (image->failed) {
+        return false;
+    }
+
+    header.size = image->len;
+    memcpy(image->data, &header, sizeof(header));
+
+    return true;
+}
+
+bool
+flog_alias_parse_file(AliasImage *image, const char *app_name, const char *path, uint32_t *alias_count) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat statbuf;
+    if (fstat(fd, &statbuf) != 0 || !S_ISREG(statbuf.st_mode)) {
+        close(fd);
+        return false;
+    }
+
+    size_t len = (size_t) statbuf.st_size;
+    char *buf = malloc(len + 1);
+    char *line = malloc(len + 1);
+    if (buf == NULL || line == NULL) {
+        free(buf);
+        free(line);
+        close(fd);
+        return false;
+    }
+
+    size_t total = 0;
+    while (total < len) {
+        ssize_t n = read(fd, buf + total, len - total);
+        if (n <= 0) {
+            break;
+        }
+        total += (size_t) n;
+    }
+
+    close(fd);
+
+    // As in popt, a backslash before a newline joins two lines and other
+    // backslashes are kept for poptParseArgvString()
+    bool supported = true;
+    char *te = line;
+
+    for (size_t i = 0; i <= total && supported; i++) {
+        if (i == total || buf[i] == '\n') {
+            *te = '\0';
+
+            char *start = line;
+            while (*start != '\0' && isspace((unsigned char) *start)) {
+                start++;
+            }
+
+            if (*start != '\0' && *start != '#') {
+                supported = flog_alias_parse_line(image, app_name, start, alias_count);
+            }
+
+            te = line;
+        } else if (buf[i] == '\\' && i + 1 < total && buf[i + 1] == '\n') {
+            i++;
+        } else {
+            *te++ = buf[i];
+        }
+    }
+
+    free(buf);
+    free(line);
+
+    return supported;
+}
+
+bool
+flog_alias_parse_line(AliasImage *image, const char *app_name, char *line, uint32_t *alias_count) {
+    char *se = line;
+
+    char *app = se;
+    while (*se != '\0' && !isspace((unsigned char) *se)) {
+        se++;
+    }
+    if (*se == '\0') {
+        return true;
+    }
+    *se++ = '\0';
+
+    int match = strpbrk(app, "*?[") != NULL ? fnmatch(app, app_name, FNM_PATHNAME | FNM_PERIOD) : strcmp(app, app_name);
+    if (match != 0) {
+        return true;
+    }
+
+    while (*se != '\0' && isspace((unsigned char) *se)) {
+        se++;
+    }
+    char *type = se;
+    while (*se != '\0' && !isspace((unsigned char) *se)) {
+        se++;
+    }
+    if (*se != '\0') {
+        *se++ = '\0';
+    }
+
+    while (*se != '\0' && isspace((unsigned char) *se)) {
+        se++;
+    }
+    if (*se == '\0') {
+        return true;
+    }
+    char *opt = se;
+    while (*se != '\0' && !isspace((unsigned char) *se)) {
+        se++;
+    }
+    if (opt[0] == '-' && *se == '\0') {
+        return true;
+    }
+    if (*se != '\0') {
+        *se++ = '\0';
+    }
+
+    while (*se != '\0' && isspace((unsigned char) *se)) {
+        se++;
+    }
+    if (opt[0] == '-' && *se == '\0') {
+        return true;
+    }
+
+    if (strcmp(type, "alias") != 0) {
+        // popt ignores unknown entry types, but exec entries are not cached
+        return strcmp(type, "exec") != 0;
+    }
+
+    const char *long_name = "";
+    char short_name = '\0';
+
+    if (opt[0] == '-' && opt[1] == '-') {
+        long_name = opt + 2;
+    } else if (opt[0] == '-' && opt[1] != '\0' && opt[2] == '\0') {
+        short_name = opt[1];
+    } else {
+        return false;
+    }
+
+    int argc;
+    const char **argv;
+    if (poptParseArgvString(se, &argc, &argv) < 0) {
+        return true;
+    }
+
+    // Descriptions are only used by popt's help output and are dropped
+    AliasEntry entry = {
+        .short_name = (unsigned char) short_name,
+        .argc = 0,
+        .long_len = (uint32_t) strlen(long_name),
+        .data_len = (uint32_t) strlen(long_name) + 1
+    };
+
+    for (int i = 0; i < argc; i++) {
+        if (strncmp(argv[i], "--POPTdesc=", strlen("--POPTdesc=")) != 0 &&
+            strncmp(argv[i], "--POPTargs=", strlen("--POPTargs=")) != 0) {
+            entry.argc++;
+            entry.data_len += (uint32_t) strlen(argv[i]) + 1;
+        }
+    }
+
+    flog_alias_image_append(image, &entry, sizeof(entry));
+
+    flog_alias_image_append(image, long_name, entry.long_len + 1);
+    for (int i = 0; i < argc; i++) {
+        if (strncmp(argv[i], "--POPTdesc=", strlen("--POPTdesc=")) != 0 &&
+            strncmp(argv[i], "--POPTargs=", strlen("--POPTargs=")) != 0) {
+            flog_alias_image_append(image, argv[i], strlen(argv[i]) + 1);
+        }
+    }
+    flog_alias_image_align(image);
+
+    free(argv);
+    (*alias_count)++;
+
+    return true;
+}
+
+bool
+flog_alias_walk(poptContext context, const char *data, size_t len, const char *app_name,
+                const char *const *sources, const AliasSource *stats, size_t source_count, bool add) {
+    AliasHeader header;
+    if (len < sizeof(header)) {
+        return false;
+    }
+
+    memcpy(&header, data, sizeof(header));
+
+    if (memcmp(header.magic, ALIAS_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != ALIAS_CACHE_VERSION ||
+        header.size != len ||
+        header.source_count != source_count ||
+        header.app_len != strlen(app_name)) {
+        return false;
+    }
+
+    size_t offset = sizeof(header);
+
+    if (len - offset < ALIAS_ALIGN(header.app_len + 1) ||
+        memcmp(data + offset, app_name, header.app_len + 1) != 0) {
+        return false;
+    }
+    offset += ALIAS_ALIGN(header.app_len + 1);
+
+    for (size_t i = 0; i < source_count; i++) {
+        AliasSource source;
+        if (len - offset < sizeof(source)) {
+            return false;
+        }
+
+        memcpy(&source, data + offset, sizeof(source));
+        offset += sizeof(source);
+
+        if (source.path_len != strlen(sources[i]) ||
+            len - offset < ALIAS_ALIGN((size_t) source.path_len + 1) ||
+            memcmp(data + offset, sources[i], source.path_len + 1) != 0) {
+            return false;
+        }
+        offset += ALIAS_ALIGN((size_t) source.path_len + 1);
+
+        if (source.size != stats[i].size ||
+            source.mtime_sec != stats[i].mtime_sec ||
+            source.mtime_nsec != stats[i].mtime_nsec ||
+            source.ino != stats[i].ino ||
+            source.dev != stats[i].dev) {
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < header.alias_count; i++) {
+        AliasEntry entry;
+        if (len - offset < sizeof(entry)) {
+            return false;
+        }
+
+        memcpy(&entry, data + offset, sizeof(entry));
+        offset += sizeof(entry);
+
+        if (len - offset < ALIAS_ALIGN((size_t) entry.data_len) || entry.argc >= entry.data_len) {
+            return false;
+        }
+
+        const char *strings = data + offset;
+        const char *end = strings + entry.data_len;
+        offset += ALIAS_ALIGN((size_t) entry.data_len);
+
+        // Each string must be terminated within the entry
+        const char **argv = NULL;
+        if (add) {
+            argv = malloc(((size_t) entry.argc + 1) * sizeof(char *));
+            if (argv == NULL) {
+                return false;
+            }
+        }
+
+        const char *long_name = strings;
+        const char *p = strings;
+
+        for (uint32_t j = 0; j <= entry.argc; j++) {
+            const char *nul = memchr(p, '\0', (size_t) (end - p));
+            if (nul == NULL || (j == 0 && (size_t) (nul - p) != entry.long_len)) {
+                free(argv);
+                return false;
+            }
+            if (add && j > 0) {
+                argv[j - 1] = p;
+            }
+            p = nul + 1;
+        }
+
+        if (add) {
+            int dup_argc = 0;
+            const char **dup_argv = NULL;
+
+            if (poptDupArgv((int) entry.argc, argv, &dup_argc, &dup_argv) == 0) {
+                struct poptAlias alias = {
+                    .longName = entry.long_len > 0 ? long_name : NULL,
+                    .shortName = (char) entry.short_name,
+                    .argc = dup_argc,
+                    .argv = dup_argv
+                };
+                poptAddAlias(context, alias, 0);
+            }
+
+            free(argv);
+        }
+    }
+
+    return offset == len;
+}
+
+void
+flog_alias_image_append(AliasImage *image, const void *data, size_t len) {
+    if (image->failed) {
+        return;
+    }
+
+    if (image->len + len > image->cap) {
+        size_t cap = image->cap > 0 ? image->cap : 4096;
+        while (cap < image->len + len) {
+            cap *= 2;
+        }
+
+        char *grown = malloc(cap);
+        if (grown == NULL) {
+            image->failed = true;
+            return;
+        }
+
+        if (image->len > 0) {
+            memcpy(grown, image->data, image->len);
+        }
+
+        free(image->data);
+        image->data = grown;
+        image->cap = cap;
+    }
+
+    memcpy(image->data + image->len, data, len);
+    image->len += len;
+}
+
+void
+flog_alias_image_align(AliasImage *image) {
+    static const char padding[8] = {0};
+
+    flog_alias_image_append(image, padding, ALIAS_ALIGN(image->len) - image->len);
+}
+
+void
+flog_alias_write_cache(const char *cache_path, const AliasImage *image) {
+    char path[PATH_MAX];
+    if (snprintf(path, PATH_MAX, "%s.XXXXXX", cache_path) >= PATH_MAX) {
+        return;
+    }
+
+    // Create the cache directory, and its parent, for the current user only
+    char *slash = strrchr(path, '/');
+    if (slash != NULL && slash != path) {
+        *slash = '\0';
+        char *parent = strrchr(path, '/');
+        if (parent != NULL && parent != path) {
+            *parent = '\0';
+            mkdir(path, 0700);
+            *parent = '/';
+        }
+        mkdir(path, 0700);
+        *slash = '/';
+    }
+
+    int fd = mkstemp(path);
+    if (fd == -1) {
+        return;
+    }
+
+    size_t written = 0;
+    while (written < image->len) {
+        ssize_t n = write(fd, image->data + written, image->len - written);
+        if (n <= 0) {
+            break;
+        }
+        written += (size_t) n;
+    }
+
+    if (close(fd) != 0 || written != image->len || rename(path, cache_path) != 0) {
+        unlink(path);
+    }
+}
+
+bool
+flog_alias_default_cache_path(const char *app_name, char *buf, size_t size) {
+    const char *home = getenv("HOME");
+    int len;
+
+#ifdef __APPLE__
+    if (home == NULL || home[0] == '\0') {
+        return false;
+    }
+    len = snprintf(buf, size, "%s/Library/Caches/flog/%s" ALIAS_CACHE_NAME_SUFFIX, home, app_name);
+#else
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    if (xdg != NULL && xdg[0] == '/') {
+        len = snprintf(buf, size, "%s/flog/%s" ALIAS_CACHE_NAME_SUFFIX, xdg, app_name);
+    } else if (home != NULL && home[0] != '\0') {
+        len = snprintf(buf, size, "%s/.cache/flog/%s" ALIAS_CACHE_NAME_SUFFIX, home, app_name);
+    } else {
+        return false;
+    }
+#endif
+
+    return len > 0 && (size_t) len < size;
+}
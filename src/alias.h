@@ -0,0 +1,114 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_ALIAS_H
+#define FLOG_ALIAS_H
+
+/*! \file alias.h
+ *
+ *  Functions for reading popt option aliases through a compiled cache.
+ *
+ *  Reading aliases with \c poptReadDefaultConfig() opens and parses every popt
+ *  configuration file on each run. Instead, the aliases defined for an application
+ *  are compiled into a cache file together with the path, size, modification time
+ *  and inode of each configuration file. Later runs validate the cache with a
+ *  \c stat(2) of each configuration file and load it with a single \c mmap(2),
+ *  parsing the configuration files again only when one of them has changed.
+ *
+ *  Configuration lines are interpreted as by popt. If a file contains an entry that
+ *  cannot be cached (an \c exec entry, or an alias whose expansion is read from a
+ *  file) it is read with \c poptReadConfigFile() on every run instead.
+ *
+ *  The default cache is stored in <tt>$HOME/Library/Caches/flog</tt> on macOS and
+ *  <tt>$XDG_CACHE_HOME/flog</tt> (or <tt>$HOME/.cache/flog</tt>) elsewhere. The
+ *  \c FLOG_ALIAS_CACHE environment variable overrides the cache file path, and
+ *  disables the cache if it is set but empty.
+ *
+ *  The system-wide configuration files are looked for in \c FLOG_POPT_SYSCONFDIR,
+ *  which must be the directory popt was built with. If it is not defined, the
+ *  directory is unknown and \c poptReadDefaultConfig() is always used.
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <popt.h>
+
+#define ALIAS_CACHE_ENV "FLOG_ALIAS_CACHE"
+
+/*! \brief An enumerated type representing how aliases were read. */
+typedef enum FlogAliasStatusData {
+    ALIAS_CACHE_HIT,
+    ALIAS_CACHE_MISS,
+    ALIAS_UNCACHED
+} FlogAliasStatus;
+
+/*! \brief Check whether any of the default popt configuration files exist.
+ *
+ *  When none of the files read by flog_alias_read_default() exist no aliases can
+ *  apply, and command-line arguments may be parsed without a popt context.
+ *
+ *  \return \c true if the system-wide \c popt file or \c popt.d directory, or
+ *          \c $HOME/.popt, exists, or if the system-wide directory is unknown,
+ *          otherwise \c false
+ */
+bool flog_alias_sources_exist(void);
+
+/*! \brief Read option aliases from the default popt configuration files.
+ *
+ *  Reads the same files as \c poptReadDefaultConfig(): the system-wide \c popt
+ *  file and \c $HOME/.popt. If the system-wide \c popt.d directory exists its
+ *  files cannot be tracked by the cache, so \c poptReadDefaultConfig() is used, as
+ *  it is when the system-wide directory is unknown.
+ *
+ *  \param context  A popt context
+ *  \param app_name A pointer to the null-terminated application name used to
+ *                  select aliases, which must match the name of \c context
+ *
+ *  \pre \c context is \e not \c NULL
+ *  \pre \c app_name is \e not \c NULL
+ *
+ *  \return A FlogAliasStatus value representing how the aliases were read
+ */
+FlogAliasStatus flog_alias_read_default(poptContext context, const char *app_name);
+
+/*! \brief Read option aliases from a list of popt configuration files.
+ *
+ *  \param context      A popt context
+ *  \param app_name     A pointer to the null-terminated application name used to
+ *                      select aliases
+ *  \param sources      A pointer to an array of null-terminated configuration file
+ *                      paths, read in order; files that do not exist are skipped
+ *  \param source_count The number of configuration file paths
+ *  \param cache_path   A pointer to the null-terminated cache file path, or \c NULL
+ *                      to read the configuration files without a cache
+ *
+ *  \pre \c context, \c app_name and \c sources are \e not \c NULL
+ *
+ *  \return ALIAS_CACHE_HIT if the aliases were loaded from a valid cache,
+ *          ALIAS_CACHE_MISS if the configuration files were parsed (and the cache
+ *          rewritten when possible), or ALIAS_UNCACHED if the configuration files
+ *          were read by popt because they cannot be cached
+ */
+FlogAliasStatus flog_alias_read(poptContext context, const char *app_name, const char *const *sources,
+                                size_t source_count, const char *cache_path);
+
+#endif //FLOG_ALIAS_H
@@ -0,0 +1,137 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "assembler.h"
+#include "pattern.h"
+#include <assert.h>
+#include <regex.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef UNIT_TESTING
+#include "../test/testing.h"
+#endif
+
+struct FlogAssemblerData {
+    regex_t start;
+    bool has_start;
+    size_t max_len;
+    size_t len;
+    char record[];
+};
+
+FlogAssembler *
+flog_assembler_new(const char *start_pattern, size_t max_len, FlogError *error) {
+    assert(start_pattern != NULL);
+    assert(max_len > 0);
+    assert(error != NULL);
+
+    *error = FLOG_ERROR_NONE;
+
+    FlogAssembler *assembler = calloc(1, sizeof(struct FlogAssemblerData) + max_len + 1);
+    if (assembler == NULL) {
+        *error = FLOG_ERROR_ALLOC;
+        return NULL;
+    }
+
+    if (strlen(start_pattern) > 0) {
+        if (!flog_pattern_compile(&assembler->start, start_pattern)) {
+            free(assembler);
+            *error = FLOG_ERROR_RECORD;
+            return NULL;
+        }
+        assembler->has_start = true;
+    }
+
+    assembler->max_len = max_len;
+
+    return assembler;
+}
+
+void
+flog_assembler_free(FlogAssembler *assembler) {
+    assert(assembler != NULL);
+
+    if (assembler->has_start) {
+        regfree(&assembler->start);
+    }
+
+    free(assembler);
+}
+
+bool
+flog_assembler_starts_record(const FlogAssembler *assembler, const char *line) {
+    assert(assembler != NULL);
+    assert(line != NULL);
+
+    if (assembler->has_start) {
+        return regexec(&assembler->start, line, 0, NULL, 0) == 0;
+    }
+
+    return line[0] != ' ' && line[0] != '\t';
+}
+
+size_t
+flog_assembler_add_line(FlogAssembler *assembler, const char *line, size_t len) {
+    assert(assembler != NULL);
+    assert(line != NULL);
+
+    size_t separator = assembler->len > 0 ? 1 : 0;
+    if (assembler->len + separator >= assembler->max_len) {
+        return 0;
+    }
+
+    size_t space = assembler->max_len - assembler->len - separator;
+    size_t count = len < space ? len : space;
+
+    if (separator > 0) {
+        assembler->record[assembler->len++] = '\n';
+    }
+
+    memcpy(assembler->record + assembler->len, line, count);
+    assembler->len += count;
+    assembler->record[assembler->len] = '\0';
+
+    return count;
+}
+
+const char *
+flog_assembler_get_record(const FlogAssembler *assembler) {
+    assert(assembler != NULL);
+
+    return assembler->record;
+}
+
+size_t
+flog_assembler_get_length(const FlogAssembler *assembler) {
+    assert(assembler != NULL);
+
+    return assembler->len;
+}
+
+void
+flog_assembler_clear(FlogAssembler *assembler) {
+    assert(assembler != NULL);
+
+    assembler->len = 0;
+    assembler->record[0] = '\0';
+}
@@ -0,0 +1,138 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_ASSEMBLER_H
+#define FLOG_ASSEMBLER_H
+
+/*! \file assembler.h
+ *
+ *  Assembler object and associated functions for joining the lines of a stream into
+ *  multi-line records, such as stack traces, that are each logged as one message.
+ *
+ *  A line either starts a new record or continues the record held by the assembler.
+ *  With a start pattern, a line starts a record if it matches the pattern, which is a
+ *  POSIX extended regular expression; otherwise a line starts a record unless it
+ *  begins with a space or tab. The lines of a record are joined with newlines.
+ *
+ *  Patterns containing backreferences are rejected, so that every pattern can be
+ *  matched by an automaton in time linear in the length of the line, and each line is
+ *  matched once as it arrives; input already held is never examined again.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "common.h"
+
+/*! \struct FlogAssembler
+ *
+ *  \brief An opaque type representing a FlogAssembler record assembler object.
+ */
+typedef struct FlogAssemblerData FlogAssembler;
+
+/*! \brief Create a FlogAssembler object for joining lines into records.
+ *
+ *  \param[in]  start_pattern A pointer to a null-terminated POSIX extended regular
+ *                            expression matching the first line of each record, or
+ *                            an empty string to continue records with indented lines
+ *  \param[in]  max_len       The maximum length of a record in bytes
+ *  \param[out] error         A pointer to a FlogError object that will be used to
+ *                            represent an error condition on failure
+ *
+ *  \pre \c start_pattern is \e not \c NULL
+ *  \pre \c max_len is greater than zero
+ *  \pre \c error is \e not \c NULL
+ *
+ *  \return If successful, a pointer to a FlogAssembler object; if there is an error
+ *          a \c NULL pointer is returned and \c error will be set to a FlogError
+ *          variant representing an error condition
+ */
+FlogAssembler * flog_assembler_new(const char *start_pattern, size_t max_len, FlogError *error);
+
+/*! \brief Free a FlogAssembler object.
+ *
+ *  \param assembler A pointer to the FlogAssembler object that should be freed
+ *
+ *  \pre \c assembler is \e not \c NULL
+ */
+void flog_assembler_free(FlogAssembler *assembler);
+
+/*! \brief Determine whether a line starts a new record.
+ *
+ *  \param assembler A pointer to the FlogAssembler object
+ *  \param line      A pointer to the null-terminated line, without its newline
+ *
+ *  \pre \c assembler is \e not \c NULL
+ *  \pre \c line is \e not \c NULL
+ *
+ *  \return \c true if the line starts a new record, or \c false if it continues the
+ *          record held
+ */
+bool flog_assembler_starts_record(const FlogAssembler *assembler, const char *line);
+
+/*! \brief Add a line to the record held by a FlogAssembler object.
+ *
+ *  The line is joined to the record with a newline. If the record cannot hold the
+ *  whole line, as much of it as fits is added and the number of bytes added is
+ *  returned, so that the record can be taken and the remainder added to the next;
+ *  a line is always added in part to an empty record.
+ *
+ *  \param assembler A pointer to the FlogAssembler object
+ *  \param line      A pointer to the line, without its newline
+ *  \param len       The length of the line in bytes
+ *
+ *  \pre \c assembler is \e not \c NULL
+ *  \pre \c line is \e not \c NULL
+ *
+ *  \return The number of bytes of the line added to the record
+ */
+size_t flog_assembler_add_line(FlogAssembler *assembler, const char *line, size_t len);
+
+/*! \brief Get the record held by a FlogAssembler object.
+ *
+ *  \param assembler A pointer to the FlogAssembler object
+ *
+ *  \pre \c assembler is \e not \c NULL
+ *
+ *  \return A pointer to the null-terminated record, which is empty if no line has
+ *          been added since the record was last cleared
+ */
+const char * flog_assembler_get_record(const FlogAssembler *assembler);
+
+/*! \brief Get the length of the record held by a FlogAssembler object.
+ *
+ *  \param assembler A pointer to the FlogAssembler object
+ *
+ *  \pre \c assembler is \e not \c NULL
+ *
+ *  \return The length of the record in bytes
+ */
+size_t flog_assembler_get_length(const FlogAssembler *assembler);
+
+/*! \brief Clear the record held by a FlogAssembler object once it has been taken.
+ *
+ *  \param assembler A pointer to the FlogAssembler object
+ *
+ *  \pre \c assembler is \e not \c NULL
+ */
+void flog_assembler_clear(FlogAssembler *assembler);
+
+#endif //FLOG_ASSEMBLER_H
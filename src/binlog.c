@@ -0,0 +1,761 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "binlog.h"
+#include "checksum.h"
+#include "common.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifdef UNIT_TESTING
+#include "../test/testing.h"
+#endif
+
+#define BINLOG_MAGIC "FLOGBIN"
+#define BINLOG_VERSION 1
+#define BINLOG_BYTE_ORDER 0x0102
+#define BINLOG_SYNC 0x464c4f47
+
+#define BLOCK_RECORD 1
+#define BLOCK_STRING 2
+#define BLOCK_INDEX 3
+
+#define STRING_MAX 4096
+#define STRING_BUCKETS 256
+
+// Binary files are created without group or other write permission (see writer.c)
+#define BINLOG_FILE_MODE (S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)
+
+typedef struct BinlogHeaderData {
+    char magic[8];
+    uint16_t version;
+    uint16_t byte_order;
+    uint32_t index_interval;
+    uint64_t record_count;
+    uint64_t last_index;
+    uint64_t last_string;
+    uint64_t pending_offset;
+    uint64_t pending_min;
+    uint64_t pending_max;
+    uint32_t pending_count;
+    uint32_t pending_levels;
+    uint32_t next_string_id;
+    uint32_t reserved;
+} BinlogHeader;
+
+typedef struct BinlogBlockData {
+    uint32_t sync;
+    uint8_t type;
+    uint8_t level;
+    uint8_t message_type;
+    uint8_t reserved;
+    uint32_t length;
+    uint32_t checksum;
+} BinlogBlock;
+
+typedef struct BinlogRecordPayloadData {
+    uint64_t timestamp;
+    uint32_t subsystem_id;
+    uint32_t category_id;
+} BinlogRecordPayload;
+
+typedef struct BinlogStringPayloadData {
+    uint64_t prev;
+    uint32_t id;
+    uint32_t reserved;
+} BinlogStringPayload;
+
+typedef struct BinlogIndexPayloadData {
+    uint64_t prev;
+    uint64_t first;
+    uint64_t end;
+    uint64_t min;
+    uint64_t max;
+    uint32_t count;
+    uint32_t levels;
+} BinlogIndexPayload;
+
+_Static_assert(sizeof(BinlogHeader) == 80, "unexpected binary log header size");
+_Static_assert(sizeof(BinlogBlock) == 16, "unexpected binary log block size");
+_Static_assert(sizeof(BinlogRecordPayload) == 16, "unexpected binary log record size");
+_Static_assert(sizeof(BinlogStringPayload) == 16, "unexpected binary log string size");
+_Static_assert(sizeof(BinlogIndexPayload) == 48, "unexpected binary log index size");
+
+typedef struct BinlogRangeData {
+    uint64_t first;
+    uint64_t end;
+    uint64_t min;
+    uint64_t max;
+    uint32_t levels;
+} BinlogRange;
+
+/*! \brief A string interned in a binary log file, chained with the others in its hash bucket. */
+typedef struct BinlogStringData {
+    struct BinlogStringData *chain;
+    uint32_t id;
+    size_t len;
+    char str[];
+} BinlogString;
+
+struct FlogBinlogWriterData {
+    int fd;
+    // The string chain head and next identifier of the file when the table was last brought
+    // up to date; a header that differs has had strings interned by another writer
+    uint64_t last_string;
+    uint32_t next_string_id;
+    BinlogString *strings[STRING_BUCKETS];
+};
+
+struct FlogBinlogReaderData {
+    const unsigned char *map;
+    size_t size;
+    BinlogHeader header;
+    char **strings;
+    uint32_t string_count;
+};
+
+bool flog_binlog_write_all(int fd, const void *buf, size_t len, off_t offset);
+bool flog_binlog_read_all(int fd, void *buf, size_t len, off_t offset);
+bool flog_binlog_header_valid(const BinlogHeader *header);
+const BinlogString * flog_binlog_writer_find_string(const FlogBinlogWriter *writer, const char *str, size_t len);
+bool flog_binlog_writer_add_string(FlogBinlogWriter *writer, const char *str, size_t len, uint32_t id);
+void flog_binlog_writer_clear_strings(FlogBinlogWriter *writer);
+bool flog_binlog_writer_sync_strings(FlogBinlogWriter *writer, const BinlogHeader *header);
+bool flog_binlog_writer_write(FlogBinlogWriter *writer, const FlogBinlogRecord *record);
+uint32_t flog_binlog_intern(FlogBinlogWriter *writer, BinlogHeader *header, off_t *end, const char *str);
+FlogError flog_binlog_reader_scan(const FlogBinlogReader *reader, uint64_t start, uint64_t end,
+                                  const FlogBinlogQuery *query, FlogBinlogVisitor visitor, void *context,
+                                  bool *stopped);
+
+bool
+flog_binlog_write_all(int fd, const void *buf, size_t len, off_t offset) {
+    const char *ptr = buf;
+
+    while (len > 0) {
+        ssize_t written = pwrite(fd, ptr, len, offset);
+        if (written <= 0) {
+            return false;
+        }
+        ptr += written;
+        len -= (size_t) written;
+        offset += written;
+    }
+
+    return true;
+}
+
+bool
+flog_binlog_read_all(int fd, void *buf, size_t len, off_t offset) {
+    char *ptr = buf;
+
+    while (len > 0) {
+        ssize_t count = pread(fd, ptr, len, offset);
+        if (count <= 0) {
+            return false;
+        }
+        ptr += count;
+        len -= (size_t) count;
+        offset += count;
+    }
+
+    return true;
+}
+
+bool
+flog_binlog_header_valid(const BinlogHeader *header) {
+    return memcmp(header->magic, BINLOG_MAGIC, sizeof(BINLOG_MAGIC)) == 0 &&
+           header->version == BINLOG_VERSION &&
+           header->byte_order == BINLOG_BYTE_ORDER &&
+           header->index_interval > 0;
+}
+
+const BinlogString *
+flog_binlog_writer_find_string(const FlogBinlogWriter *writer, const char *str, size_t len) {
+    const BinlogString *string = writer->strings[flog_hash64(str, len) & (STRING_BUCKETS - 1)];
+
+    while (string != NULL && (string->len != len || memcmp(string->str, str, len) != 0)) {
+        string = string->chain;
+    }
+
+    return string;
+}
+
+bool
+flog_binlog_writer_add_string(FlogBinlogWriter *writer, const char *str, size_t len, uint32_t id) {
+    BinlogString *string = malloc(sizeof(BinlogString) + len);
+    if (string == NULL) {
+        return false;
+    }
+
+    BinlogString **bucket = &writer->strings[flog_hash64(str, len) & (STRING_BUCKETS - 1)];
+
+    memcpy(string->str, str, len);
+    string->len = len;
+    string->id = id;
+    string->chain = *bucket;
+    *bucket = string;
+
+    return true;
+}
+
+void
+flog_binlog_writer_clear_strings(FlogBinlogWriter *writer) {
+    for (size_t i = 0; i < STRING_BUCKETS; i++) {
+        BinlogString *string = writer->strings[i];
+        while (string != NULL) {
+            BinlogString *chain = string->chain;
+            free(string);
+            string = chain;
+        }
+        writer->strings[i] = NULL;
+    }
+
+    writer->last_string = 0;
+    writer->next_string_id = 1;
+}
+
+bool
+flog_binlog_writer_sync_strings(FlogBinlogWriter *writer, const BinlogHeader *header) {
+    if (header->last_string == writer->last_string && header->next_string_id == writer->next_string_id) {
+        return true;
+    }
+
+    if (header->next_string_id < writer->next_string_id) {
+        flog_binlog_writer_clear_strings(writer);
+    }
+
+    // Strings interned since the table was last brought up to date are read back along the
+    // chain as far as the newest string already known
+    char str[STRING_MAX];
+    uint64_t offset = header->last_string;
+
+    while (offset != writer->last_string) {
+        if (offset == 0) {
+            // The chain never reached the newest string known, so the file has been replaced
+            flog_binlog_writer_clear_strings(writer);
+            offset = header->last_string;
+            continue;
+        }
+
+        BinlogBlock block;
+        BinlogStringPayload payload;
+
+        if (!flog_binlog_read_all(writer->fd, &block, sizeof(block), (off_t) offset) ||
+            !flog_binlog_read_all(writer->fd, &payload, sizeof(payload), (off_t) (offset + sizeof(block)))) {
+            return false;
+        }
+
+        if (block.sync != BINLOG_SYNC || block.type != BLOCK_STRING || block.length < sizeof(payload) ||
+            block.length - sizeof(payload) > STRING_MAX || payload.prev >= offset) {
+            return false;
+        }
+
+        size_t len = block.length - sizeof(payload);
+        if (!flog_binlog_read_all(writer->fd, str, len, (off_t) (offset + sizeof(block) + sizeof(payload))) ||
+            !flog_binlog_writer_add_string(writer, str, len, payload.id)) {
+            return false;
+        }
+
+        offset = payload.prev;
+    }
+
+    writer->last_string = header->last_string;
+    writer->next_string_id = header->next_string_id;
+
+    return true;
+}
+
+uint32_t
+flog_binlog_intern(FlogBinlogWriter *writer, BinlogHeader *header, off_t *end, const char *str) {
+    size_t len = strlen(str);
+    if (len == 0) {
+        return 0;
+    }
+    if (len > STRING_MAX) {
+        len = STRING_MAX;
+    }
+
+    const BinlogString *string = flog_binlog_writer_find_string(writer, str, len);
+    if (string != NULL) {
+        return string->id;
+    }
+
+    BinlogBlock block = {
+        .sync = BINLOG_SYNC,
+        .type = BLOCK_STRING,
+        .length = (uint32_t) (sizeof(BinlogStringPayload) + len)
+    };
+    BinlogStringPayload payload = {
+        .prev = header->last_string,
+        .id = header->next_string_id
+    };
+
+    if (!flog_binlog_write_all(writer->fd, &block, sizeof(block), *end) ||
+        !flog_binlog_write_all(writer->fd, &payload, sizeof(payload), *end + (off_t) sizeof(block)) ||
+        !flog_binlog_write_all(writer->fd, str, len, *end + (off_t) (sizeof(block) + sizeof(payload))) ||
+        !flog_binlog_writer_add_string(writer, str, len, payload.id)) {
+        return UINT32_MAX;
+    }
+
+    // Should the append fail before the header is written, the table no longer matches the
+    // file and is rebuilt from it by the next append
+    header->last_string = (uint64_t) *end;
+    header->next_string_id++;
+    writer->last_string = header->last_string;
+    writer->next_string_id = header->next_string_id;
+    *end += (off_t) (sizeof(block) + block.length);
+
+    return payload.id;
+}
+
+FlogBinlogWriter *
+flog_binlog_writer_new(const char *path, FlogError *error) {
+    assert(path != NULL);
+    assert(error != NULL);
+
+    *error = FLOG_ERROR_NONE;
+
+    FlogBinlogWriter *writer = calloc(1, sizeof(struct FlogBinlogWriterData));
+    if (writer == NULL) {
+        *error = FLOG_ERROR_ALLOC;
+        return NULL;
+    }
+
+    // The descriptor is held open between appends, so it must not leak into commands run by --exec
+    writer->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, BINLOG_FILE_MODE);
+    if (writer->fd == -1) {
+        free(writer);
+        *error = FLOG_ERROR_APPEND;
+        return NULL;
+    }
+
+    writer->next_string_id = 1;
+
+    return writer;
+}
+
+void
+flog_binlog_writer_free(FlogBinlogWriter *writer) {
+    assert(writer != NULL);
+
+    flog_binlog_writer_clear_strings(writer);
+    close(writer->fd);
+    free(writer);
+}
+
+FlogError
+flog_binlog_writer_append(FlogBinlogWriter *writer, const FlogBinlogRecord *record) {
+    assert(writer != NULL);
+    assert(record != NULL);
+
+    // Writers must agree on the header contents, so appends to the same
+    // file are serialised with an advisory lock held for the whole append
+    struct flock lock = { .l_type = F_WRLCK, .l_whence = SEEK_SET };
+    if (fcntl(writer->fd, F_SETLKW, &lock) == -1) {
+        return FLOG_ERROR_APPEND;
+    }
+
+    bool written = flog_binlog_writer_write(writer, record);
+
+    lock.l_type = F_UNLCK;
+    fcntl(writer->fd, F_SETLK, &lock);
+
+    return written ? FLOG_ERROR_NONE : FLOG_ERROR_APPEND;
+}
+
+FlogError
+flog_binlog_append(const char *path, const FlogBinlogRecord *record) {
+    assert(path != NULL);
+    assert(record != NULL);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogBinlogWriter *writer = flog_binlog_writer_new(path, &error);
+    if (writer == NULL) {
+        return error;
+    }
+
+    error = flog_binlog_writer_append(writer, record);
+    flog_binlog_writer_free(writer);
+
+    return error;
+}
+
+bool
+flog_binlog_writer_write(FlogBinlogWriter *writer, const FlogBinlogRecord *record) {
+    struct stat statbuf;
+    BinlogHeader header;
+
+    if (fstat(writer->fd, &statbuf) == -1) {
+        return false;
+    }
+
+    off_t end = statbuf.st_size;
+
+    if (end == 0) {
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, BINLOG_MAGIC, sizeof(BINLOG_MAGIC));
+        header.version = BINLOG_VERSION;
+        header.byte_order = BINLOG_BYTE_ORDER;
+        header.index_interval = BINLOG_INDEX_INTERVAL;
+        header.next_string_id = 1;
+        end = sizeof(header);
+    } else if (!flog_binlog_read_all(writer->fd, &header, sizeof(header), 0) || !flog_binlog_header_valid(&header)) {
+        return false;
+    }
+
+    if (!flog_binlog_writer_sync_strings(writer, &header)) {
+        return false;
+    }
+
+    uint32_t subsystem_id = flog_binlog_intern(writer, &header, &end, record->subsystem);
+    uint32_t category_id = flog_binlog_intern(writer, &header, &end, record->category);
+    if (subsystem_id == UINT32_MAX || category_id == UINT32_MAX) {
+        return false;
+    }
+
+    BinlogBlock block = {
+        .sync = BINLOG_SYNC,
+        .type = BLOCK_RECORD,
+        .level = (uint8_t) record->level,
+        .message_type = (uint8_t) record->message_type,
+        .length = (uint32_t) (sizeof(BinlogRecordPayload) + record->message_len)
+    };
+    BinlogRecordPayload payload = {
+        .timestamp = record->timestamp,
+        .subsystem_id = subsystem_id,
+        .category_id = category_id
+    };
+
+    block.checksum = flog_crc32c(0, &payload, sizeof(payload));
+    block.checksum = flog_crc32c(block.checksum, record->message, record->message_len);
+
+    off_t record_offset = end;
+    if (!flog_binlog_write_all(writer->fd, &block, sizeof(block), end) ||
+        !flog_binlog_write_all(writer->fd, &payload, sizeof(payload), end + (off_t) sizeof(block)) ||
+        !flog_binlog_write_all(writer->fd, record->message, record->message_len,
+                               end + (off_t) (sizeof(block) + sizeof(payload)))) {
+        return false;
+    }
+    end += (off_t) (sizeof(block) + block.length);
+
+    if (header.pending_count == 0) {
+        header.pending_offset = (uint64_t) record_offset;
+        header.pending_min = record->timestamp;
+        header.pending_max = record->timestamp;
+    } else {
+        if (record->timestamp < header.pending_min) {
+            header.pending_min = record->timestamp;
+        }
+        if (record->timestamp > header.pending_max) {
+            header.pending_max = record->timestamp;
+        }
+    }
+    header.pending_count++;
+    header.pending_levels |= 1U << record->level;
+    header.record_count++;
+
+    if (header.pending_count >= header.index_interval) {
+        BinlogBlock index_block = {
+            .sync = BINLOG_SYNC,
+            .type = BLOCK_INDEX,
+            .length = sizeof(BinlogIndexPayload)
+        };
+        BinlogIndexPayload index = {
+            .prev = header.last_index,
+            .first = header.pending_offset,
+            .end = (uint64_t) end,
+            .min = header.pending_min,
+            .max = header.pending_max,
+            .count = header.pending_count,
+            .levels = header.pending_levels
+        };
+
+        if (!flog_binlog_write_all(writer->fd, &index_block, sizeof(index_block), end) ||
+            !flog_binlog_write_all(writer->fd, &index, sizeof(index), end + (off_t) sizeof(index_block))) {
+            return false;
+        }
+
+        header.last_index = (uint64_t) end;
+        header.pending_count = 0;
+        header.pending_levels = 0;
+    }
+
+    return flog_binlog_write_all(writer->fd, &header, sizeof(header), 0);
+}
+
+FlogBinlogReader *
+flog_binlog_reader_new(const char *path, FlogError *error) {
+    assert(path != NULL);
+    assert(error != NULL);
+
+    *error = FLOG_ERROR_NONE;
+
+    FlogBinlogReader *reader = calloc(1, sizeof(struct FlogBinlogReaderData));
+    if (reader == NULL) {
+        *error = FLOG_ERROR_ALLOC;
+        return NULL;
+    }
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        free(reader);
+        *error = FLOG_ERROR_READ;
+        return NULL;
+    }
+
+    // Hold a shared lock while taking the snapshot so that the header and the
+    // mapped length describe the same set of completed appends
+    struct flock lock = { .l_type = F_RDLCK, .l_whence = SEEK_SET };
+    struct stat statbuf;
+
+    if (fcntl(fd, F_SETLKW, &lock) == -1 || fstat(fd, &statbuf) == -1 ||
+        (size_t) statbuf.st_size < sizeof(BinlogHeader)) {
+        close(fd);
+        free(reader);
+        *error = FLOG_ERROR_READ;
+        return NULL;
+    }
+
+    reader->size = (size_t) statbuf.st_size;
+    reader->map = mmap(NULL, reader->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (reader->map == MAP_FAILED) {
+        free(reader);
+        *error = FLOG_ERROR_READ;
+        return NULL;
+    }
+
+    memcpy(&reader->header, reader->map, sizeof(BinlogHeader));
+    if (!flog_binlog_header_valid(&reader->header)) {
+        flog_binlog_reader_free(reader);
+        *error = FLOG_ERROR_READ;
+        return NULL;
+    }
+
+    reader->string_count = reader->header.next_string_id;
+    reader->strings = calloc(reader->string_count, sizeof(char *));
+    if (reader->strings == NULL) {
+        flog_binlog_reader_free(reader);
+        *error = FLOG_ERROR_ALLOC;
+        return NULL;
+    }
+
+    uint64_t offset = reader->header.last_string;
+    while (offset != 0) {
+        BinlogBlock block;
+        BinlogStringPayload payload;
+
+        if (offset + sizeof(block) + sizeof(payload) > reader->size) {
+            break;
+        }
+
+        memcpy(&block, reader->map + offset, sizeof(block));
+        memcpy(&payload, reader->map + offset + sizeof(block), sizeof(payload));
+
+        if (block.sync != BINLOG_SYNC || block.type != BLOCK_STRING || block.length < sizeof(payload) ||
+            offset + sizeof(block) + block.length > reader->size || payload.id >= reader->string_count) {
+            flog_binlog_reader_free(reader);
+            *error = FLOG_ERROR_READ;
+            return NULL;
+        }
+
+        size_t len = block.length - sizeof(payload);
+        char *str = malloc(len + 1);
+        if (str == NULL) {
+            flog_binlog_reader_free(reader);
+            *error = FLOG_ERROR_ALLOC;
+            return NULL;
+        }
+
+        memcpy(str, reader->map + offset + sizeof(block) + sizeof(payload), len);
+        str[len] = '\0';
+        reader->strings[payload.id] = str;
+
+        offset = payload.prev;
+    }
+
+    return reader;
+}
+
+void
+flog_binlog_reader_free(FlogBinlogReader *reader) {
+    assert(reader != NULL);
+
+    if (reader->strings != NULL) {
+        for (uint32_t i = 0; i < reader->string_count; i++) {
+            free(reader->strings[i]);
+        }
+        free(reader->strings);
+    }
+
+    munmap((void *) reader->map, reader->size);
+    free(reader);
+}
+
+uint64_t
+flog_binlog_reader_get_record_count(const FlogBinlogReader *reader) {
+    assert(reader != NULL);
+
+    return reader->header.record_count;
+}
+
+FlogError
+flog_binlog_reader_scan(const FlogBinlogReader *reader, uint64_t start, uint64_t end,
+                        const FlogBinlogQuery *query, FlogBinlogVisitor visitor, void *context,
+                        bool *stopped) {
+    uint64_t offset = start;
+
+    while (offset < end) {
+        BinlogBlock block;
+
+        if (offset + sizeof(block) > end) {
+            return FLOG_ERROR_READ;
+        }
+
+        memcpy(&block, reader->map + offset, sizeof(block));
+        if (block.sync != BINLOG_SYNC || offset + sizeof(block) + block.length > end) {
+            return FLOG_ERROR_READ;
+        }
+
+        if (block.type == BLOCK_RECORD && block.length >= sizeof(BinlogRecordPayload)) {
+            BinlogRecordPayload payload;
+            memcpy(&payload, reader->map + offset + sizeof(block), sizeof(payload));
+
+            if (flog_crc32c(0, reader->map + offset + sizeof(block), block.length) != block.checksum) {
+                return FLOG_ERROR_READ;
+            }
+
+            bool level_selected = query->level_mask == 0 || (query->level_mask & (1U << block.level)) != 0;
+            if (level_selected && payload.timestamp >= query->since && payload.timestamp <= query->until) {
+                FlogBinlogRecord record = {
+                    .timestamp = payload.timestamp,
+                    .level = (FlogConfigLevel) block.level,
+                    .message_type = (FlogConfigMessageType) block.message_type,
+                    .subsystem = "",
+                    .category = "",
+                    .message = (const char *) reader->map + offset + sizeof(block) + sizeof(payload),
+                    .message_len = block.length - sizeof(payload)
+                };
+
+                if (payload.subsystem_id < reader->string_count && reader->strings[payload.subsystem_id] != NULL) {
+                    record.subsystem = reader->strings[payload.subsystem_id];
+                }
+                if (payload.category_id < reader->string_count && reader->strings[payload.category_id] != NULL) {
+                    record.category = reader->strings[payload.category_id];
+                }
+
+                if (!visitor(&record, context)) {
+                    *stopped = true;
+                    return FLOG_ERROR_NONE;
+                }
+            }
+        }
+
+        offset += sizeof(block) + block.length;
+    }
+
+    return FLOG_ERROR_NONE;
+}
+
+FlogError
+flog_binlog_reader_query(const FlogBinlogReader *reader, const FlogBinlogQuery *query,
+                         FlogBinlogVisitor visitor, void *context) {
+    assert(reader != NULL);
+    assert(query != NULL);
+    assert(visitor != NULL);
+
+    // The index chain runs backwards from the most recent index block; collect
+    // it first so that ranges can be visited in file order
+    size_t range_count = 0;
+    size_t range_capacity = (size_t) (reader->header.record_count / reader->header.index_interval) + 1;
+    BinlogRange *ranges = calloc(range_capacity, sizeof(BinlogRange));
+    if (ranges == NULL) {
+        return FLOG_ERROR_ALLOC;
+    }
+
+    uint64_t tail = sizeof(BinlogHeader);
+    uint64_t offset = reader->header.last_index;
+
+    while (offset != 0 && range_count < range_capacity) {
+        BinlogBlock block;
+        BinlogIndexPayload index;
+
+        if (offset + sizeof(block) + sizeof(index) > reader->size) {
+            free(ranges);
+            return FLOG_ERROR_READ;
+        }
+
+        memcpy(&block, reader->map + offset, sizeof(block));
+        memcpy(&index, reader->map + offset + sizeof(block), sizeof(index));
+
+        if (block.sync != BINLOG_SYNC || block.type != BLOCK_INDEX || index.end > offset || index.first > index.end) {
+            free(ranges);
+            return FLOG_ERROR_READ;
+        }
+
+        if (range_count == 0) {
+            tail = offset + sizeof(block) + block.length;
+        }
+
+        ranges[range_count++] = (BinlogRange) {
+            .first = index.first,
+            .end = index.end,
+            .min = index.min,
+            .max = index.max,
+            .levels = index.levels
+        };
+
+        offset = index.prev;
+    }
+
+    FlogError error = FLOG_ERROR_NONE;
+    bool stopped = false;
+
+    for (size_t i = range_count; i > 0 && error == FLOG_ERROR_NONE && !stopped; i--) {
+        const BinlogRange *range = &ranges[i - 1];
+
+        if (range->max < query->since || range->min > query->until) {
+            continue;
+        }
+        if (query->level_mask != 0 && (range->levels & query->level_mask) == 0) {
+            continue;
+        }
+
+        error = flog_binlog_reader_scan(reader, range->first, range->end, query, visitor, context, &stopped);
+    }
+
+    free(ranges);
+
+    // Records appended since the most recent index block are not yet summarised,
+    // so the remainder of the file is always scanned
+    if (error == FLOG_ERROR_NONE && !stopped) {
+        error = flog_binlog_reader_scan(reader, tail, reader->size, query, visitor, context, &stopped);
+    }
+
+    return error;
+}
@@ -0,0 +1,214 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_BINLOG_H
+#define FLOG_BINLOG_H
+
+/*! \file binlog.h
+ *
+ *  Compact binary log format with a sparse time and level index.
+ *
+ *  A binary log file begins with a fixed-size header followed by a sequence of
+ *  blocks. Each block starts with a common block header identifying its type
+ *  and payload length:
+ *
+ *  - record blocks hold a timestamp, log level, message type, interned subsystem
+ *    and category identifiers, and the message bytes, protected by a CRC-32C
+ *    checksum so that torn or corrupt records are detected
+ *  - string blocks define the interned subsystem and category strings, and are
+ *    chained together so that writers can resolve existing identifiers
+ *  - index blocks are written after every \c BINLOG_INDEX_INTERVAL records and
+ *    summarise the time range and log levels of the records they cover, allowing
+ *    readers to skip whole ranges of the file without reading their records
+ *
+ *  Values are stored in host byte order.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "common.h"
+
+#define BINLOG_INDEX_INTERVAL 256
+
+/*! \brief A type representing a single log record in a binary log file. */
+typedef struct FlogBinlogRecordData {
+    uint64_t timestamp;
+    FlogConfigLevel level;
+    FlogConfigMessageType message_type;
+    const char *subsystem;
+    const char *category;
+    const char *message;
+    size_t message_len;
+} FlogBinlogRecord;
+
+/*! \brief A type representing the records to be selected from a binary log file.
+ *
+ *  Records are selected if their timestamp falls within the inclusive range
+ *  \c since to \c until, and their log level is present in \c level_mask (a bit
+ *  mask of <tt>1 << level</tt> values). A \c level_mask of zero selects all levels.
+ */
+typedef struct FlogBinlogQueryData {
+    uint64_t since;
+    uint64_t until;
+    unsigned int level_mask;
+} FlogBinlogQuery;
+
+/*! \brief A function called for each record selected from a binary log file.
+ *
+ *  \param record  A pointer to the selected record; the \c message member is
+ *                 \e not null-terminated and is valid only for the duration of
+ *                 the call
+ *  \param context The context pointer passed to flog_binlog_reader_query()
+ *
+ *  \return \c true to continue reading records, or \c false to stop
+ */
+typedef bool (*FlogBinlogVisitor)(const FlogBinlogRecord *record, void *context);
+
+/*! \struct FlogBinlogWriter
+ *
+ *  \brief An opaque type representing a FlogBinlogWriter object.
+ */
+typedef struct FlogBinlogWriterData FlogBinlogWriter;
+
+/*! \struct FlogBinlogReader
+ *
+ *  \brief An opaque type representing a FlogBinlogReader object.
+ */
+typedef struct FlogBinlogReaderData FlogBinlogReader;
+
+/*! \brief Create a FlogBinlogWriter object for appending records to a binary log file,
+ *         creating the file if necessary.
+ *
+ *  The file is held open until the writer is freed, and the interned subsystem and
+ *  category strings are kept in memory so that an append reads only the strings
+ *  interned by other writers since the last.
+ *
+ *  \param[in]  path  A pointer to the null-terminated binary log file path
+ *  \param[out] error A pointer to a FlogError object that will be used to represent
+ *                    an error condition on failure
+ *
+ *  \pre \c path is \e not \c NULL
+ *  \pre \c error is \e not \c NULL
+ *
+ *  \return If successful, a pointer to a FlogBinlogWriter object; if there is an
+ *          error a \c NULL pointer is returned and \c error will be set to a
+ *          FlogError variant representing an error condition
+ */
+FlogBinlogWriter * flog_binlog_writer_new(const char *path, FlogError *error);
+
+/*! \brief Free a FlogBinlogWriter object, closing its file.
+ *
+ *  \param writer A pointer to the FlogBinlogWriter object that should be freed
+ *
+ *  \pre \c writer is \e not \c NULL
+ */
+void flog_binlog_writer_free(FlogBinlogWriter *writer);
+
+/*! \brief Append a record to the binary log file of a FlogBinlogWriter.
+ *
+ *  The file is locked for the duration of the append so that concurrent writers
+ *  agree on interned string identifiers and index placement.
+ *
+ *  \param writer A pointer to the FlogBinlogWriter object
+ *  \param record A pointer to the record to append
+ *
+ *  \pre \c writer is \e not \c NULL
+ *  \pre \c record is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, otherwise
+ *          FLOG_ERROR_APPEND
+ */
+FlogError flog_binlog_writer_append(FlogBinlogWriter *writer, const FlogBinlogRecord *record);
+
+/*! \brief Append a single record to a binary log file, creating the file if necessary.
+ *
+ *  The file is opened and closed again for the one record; callers appending
+ *  more than one record should use a FlogBinlogWriter.
+ *
+ *  \param path   A pointer to the null-terminated binary log file path
+ *  \param record A pointer to the record to append
+ *
+ *  \pre \c path is \e not \c NULL
+ *  \pre \c record is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, otherwise
+ *          FLOG_ERROR_APPEND, or FLOG_ERROR_ALLOC if the writer cannot be allocated
+ */
+FlogError flog_binlog_append(const char *path, const FlogBinlogRecord *record);
+
+/*! \brief Create a FlogBinlogReader object for reading records from a binary log file.
+ *
+ *  \param[in]  path  A pointer to the null-terminated binary log file path
+ *  \param[out] error A pointer to a FlogError object that will be used to represent
+ *                    an error condition on failure
+ *
+ *  \pre \c path is \e not \c NULL
+ *  \pre \c error is \e not \c NULL
+ *
+ *  \return If successful, a pointer to a FlogBinlogReader object; if there is an
+ *          error a \c NULL pointer is returned and \c error will be set to a
+ *          FlogError variant representing an error condition
+ */
+FlogBinlogReader * flog_binlog_reader_new(const char *path, FlogError *error);
+
+/*! \brief Free a FlogBinlogReader object.
+ *
+ *  \param reader A pointer to the FlogBinlogReader object that should be freed
+ *
+ *  \pre \c reader is \e not \c NULL
+ */
+void flog_binlog_reader_free(FlogBinlogReader *reader);
+
+/*! \brief Get the number of records in the binary log file.
+ *
+ *  \param reader A pointer to the FlogBinlogReader object
+ *
+ *  \pre \c reader is \e not \c NULL
+ *
+ *  \return The number of records written to the file
+ */
+uint64_t flog_binlog_reader_get_record_count(const FlogBinlogReader *reader);
+
+/*! \brief Visit the records of a binary log file that match a query, in file order.
+ *
+ *  Ranges of the file whose index blocks show no overlap with the query are
+ *  skipped without reading their records.
+ *
+ *  \param reader  A pointer to the FlogBinlogReader object
+ *  \param query   A pointer to the FlogBinlogQuery object describing the records
+ *                 to select
+ *  \param visitor A function to call for each selected record
+ *  \param context An arbitrary pointer passed to each call of \c visitor
+ *
+ *  \pre \c reader is \e not \c NULL
+ *  \pre \c query is \e not \c NULL
+ *  \pre \c visitor is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, or FLOG_ERROR_READ
+ *          if a corrupt block or a record with a mismatched checksum is encountered
+ */
+FlogError flog_binlog_reader_query(const FlogBinlogReader *reader, const FlogBinlogQuery *query,
+                                   FlogBinlogVisitor visitor, void *context);
+
+#endif //FLOG_BINLOG_H
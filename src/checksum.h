@@ -0,0 +1,60 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_CHECKSUM_H
+#define FLOG_CHECKSUM_H
+
+/*! \file checksum.h
+ *
+ *  Checksum functions used to detect torn or corrupt log records, and a hash function
+ *  used to compare and sample messages.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*! \brief Compute the CRC-32C (Castagnoli) checksum of a buffer.
+ *
+ *  \param crc A previous checksum value to continue from, or zero to begin a new checksum
+ *  \param buf A pointer to the data to checksum
+ *  \param len The number of bytes to checksum
+ *
+ *  \pre \c buf is \e not \c NULL
+ *
+ *  \return The updated checksum value
+ */
+uint32_t flog_crc32c(uint32_t crc, const void *buf, size_t len);
+
+/*! \brief Compute a 64-bit hash of a buffer.
+ *
+ *  The hash is MurmurHash64A with a fixed seed, so it is the same in every process.
+ *
+ *  \param buf A pointer to the data to hash
+ *  \param len The number of bytes to hash
+ *
+ *  \pre \c buf is \e not \c NULL
+ *
+ *  \return The hash value
+ */
+uint64_t flog_hash64(const void *buf, size_t len);
+
+#endif //FLOG_CHECKSUM_H
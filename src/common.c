@@ -38,6 +38,23 @@ flog_error_map[] = {
     [FLOG_ERROR_OPTS]   = "invalid options",
     [FLOG_ERROR_FILE]   = "file path too long",
     [FLOG_ERROR_STAT]   = "unable to determine state of stdin file descriptor",
+    [FLOG_ERROR_FMT]    = "unknown output format",
+    [FLOG_ERROR_READ]   = "unable to read binary log file",
+    [FLOG_ERROR_WRITER] = "unknown append writer",
+    [FLOG_ERROR_PREFIX] = "unknown prefix field",
+    [FLOG_ERROR_FILES]  = "too many append files",
+    [FLOG_ERROR_TEMPLATE] = "invalid append file path template",
+    [FLOG_ERROR_BATCH]  = "unable to read batch file",
+    [FLOG_ERROR_LINE]   = "invalid batch file line",
+    [FLOG_ERROR_EXEC]   = "unable to run command",
+    [FLOG_ERROR_INPUT]  = "unable to read standard input",
+    [FLOG_ERROR_RECORD] = "invalid record option",
+    [FLOG_ERROR_FILTER] = "invalid filter option",
+    [FLOG_ERROR_DEDUP]  = "invalid dedup option",
+    [FLOG_ERROR_RATE]   = "invalid rate limit option",
+    [FLOG_ERROR_SAMPLE] = "invalid sample option",
+    [FLOG_ERROR_REDACT] = "invalid redact option",
+    [FLOG_ERROR_FIELDS] = "unknown field format",
 };
 
 const char *
@@ -57,6 +74,11 @@ flog_usage(void) {
         "\n"
         "Usage:\n"
         "    %s [options] message\n"
+        "    %s [options] --batch <file>\n"
+        "    %s [options] --serve\n"
+        "    %s [options] --exec [--] <command> [args...]\n"
+        "    %s [options] --tee --append <path>\n"
+        "    %s [options] --multiline\n"
         "\n"
         "Help Options:\n"
         "    -h, --help       Show this help message\n"
@@ -66,14 +88,60 @@ flog_usage(void) {
         "    -s, --subsystem <name>   Specify a subsystem name\n"
         "    -c, --category <name>    Specify a category name (requires subsystem option)\n"
         "    -l, --level <level>      Specify the log level ('default' if not provided)\n"
-        "    -a, --append <path>      Append the log message to a file (creating it if necessary)\n"
+        "    -a, --append <path>      Append the log message to a file (creating it if necessary; may be repeated)\n"
+        "    -f, --format <format>    Specify the append file format ('text' if not provided)\n"
+        "    -w, --writer <writer>    Specify the append file writer ('sync' if not provided)\n"
+        "        --fdatasync          Flush appended messages to storage before exiting\n"
+        "    -k, --checksum           Frame appended text messages with a length and checksum\n"
+        "    -t, --prefix <fields>    Prefix appended text messages with a comma-separated list of fields\n"
+        "        --stats              Print append file cache statistics before exiting\n"
         "    -p, --private            Mark the log message as private\n"
+        "        --batch <file>       Log each line of a file ('-' for stdin) as a message with its own options\n"
+        "        --serve              Log each line of stdin as a request, replying to lines starting with '?'\n"
+        "        --exec               Run a command, logging each line of its stdout, and of its stderr at error level\n"
+        "        --tee                Pass stdin through to the append file unchanged, logging each line\n"
+        "        --splice             As --tee, but move stdin into the file with splice(2) on Linux (not for shared files)\n"
+        "        --multiline          Log each record of stdin, or of --exec or --tee, joining indented lines to the last\n"
+        "        --record-start <re>  Start a record at each line matching an extended regular expression\n"
+        "        --record-max <n>     Split records longer than n bytes (8192 if not provided)\n"
+        "        --record-wait <ms>   Log a pending record after ms milliseconds without input (1000 if not provided)\n"
+        "        --include <re>       Log only records matching a literal or extended regular expression (may be repeated)\n"
+        "        --exclude <re>       Skip records matching a literal or extended regular expression (may be repeated)\n"
+        "        --dedup              Log a count in place of consecutive repeats of a message\n"
+        "        --dedup-wait <ms>    Log the count of repeats ms milliseconds after the first (30000 if not provided)\n"
+        "        --rate-limit <rule>  Limit the rate of messages matching a rule (may be repeated)\n"
+        "        --sample <rates>     Keep a fraction of the messages at each level, such as debug=0.01,info=0.1\n"
+        "        --redact <kinds>     Mask secrets in messages: bearer, aws-key, email, card or all (may be repeated)\n"
+        "        --fields <format>    Take the level, subsystem, category and message from the fields of each message\n"
         "\n"
         "Log Levels:\n"
         "    default, info, debug, error, fault\n"
+        "\n"
+        "Append File Formats:\n"
+        "    text, binary, json\n"
+        "\n"
+        "Message Field Formats:\n"
+        "    logfmt, json\n"
+        "\n"
+        "Append File Writers:\n"
+        "    sync, async (Linux io_uring, falling back to sync if unavailable)\n"
+        "\n"
+        "Append Prefix Fields:\n"
+        "    time, level, pid, subsystem, category\n"
+        "\n"
+        "Append File Path Variables:\n"
+        "    %%{subsystem}, %%{category}, %%{level}\n"
+        "\n"
+        "Rate Limit Rules:\n"
+        "    [[subsystem][:category][@level]=]<n>[/s|/m|/h], or [[subsystem][:category][@level]=]unlimited\n"
         "\n",
         PROGRAM_NAME,
         PROGRAM_VERSION,
+        PROGRAM_NAME,
+        PROGRAM_NAME,
+        PROGRAM_NAME,
+        PROGRAM_NAME,
+        PROGRAM_NAME,
         PROGRAM_NAME
     );
 }
@@ -42,6 +42,23 @@ typedef enum FlogErrorData {
     FLOG_ERROR_SUBSYS,
     FLOG_ERROR_FILE,
     FLOG_ERROR_STAT,
+    FLOG_ERROR_FMT,
+    FLOG_ERROR_READ,
+    FLOG_ERROR_WRITER,
+    FLOG_ERROR_PREFIX,
+    FLOG_ERROR_FILES,
+    FLOG_ERROR_TEMPLATE,
+    FLOG_ERROR_BATCH,
+    FLOG_ERROR_LINE,
+    FLOG_ERROR_EXEC,
+    FLOG_ERROR_INPUT,
+    FLOG_ERROR_RECORD,
+    FLOG_ERROR_FILTER,
+    FLOG_ERROR_DEDUP,
+    FLOG_ERROR_RATE,
+    FLOG_ERROR_SAMPLE,
+    FLOG_ERROR_REDACT,
+    FLOG_ERROR_FIELDS,
 } FlogError;
 
 /*! \brief Print usage information to stdout stream. */
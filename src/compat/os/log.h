@@ -0,0 +1,63 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_COMPAT_OS_LOG_H
+#define FLOG_COMPAT_OS_LOG_H
+
+/*! \file log.h
+ *
+ *  Stand-in for the unified logging system interface on platforms other than macOS.
+ *
+ *  Log events are formatted as the unified logging system would format them, with
+ *  privacy annotations such as \c %{public}s removed, and recorded in an in-memory
+ *  ring of the most recent events (see oslog.h). Arguments annotated \c %{private}
+ *  are recorded in full, and the event is marked as redacted. If the \c FLOG_OSLOG_FILE
+ *  environment variable names a file, each event is also appended to it as a line.
+ */
+
+#include <stdint.h>
+
+typedef struct os_log_s *os_log_t;
+typedef uint8_t os_log_type_t;
+
+#define OS_LOG_TYPE_DEFAULT 0x00
+#define OS_LOG_TYPE_INFO    0x01
+#define OS_LOG_TYPE_DEBUG   0x02
+#define OS_LOG_TYPE_ERROR   0x10
+#define OS_LOG_TYPE_FAULT   0x11
+
+#define OS_LOG_DEFAULT ((os_log_t) NULL)
+
+os_log_t os_log_create(const char *subsystem, const char *category);
+
+void os_release(void *object);
+
+void flog_oslog_emit(os_log_t log, os_log_type_t type, const char *format, ...);
+
+#define os_log_with_type(log, type, ...) flog_oslog_emit((log), (type), __VA_ARGS__)
+#define os_log(log, ...)       os_log_with_type((log), OS_LOG_TYPE_DEFAULT, __VA_ARGS__)
+#define os_log_info(log, ...)  os_log_with_type((log), OS_LOG_TYPE_INFO, __VA_ARGS__)
+#define os_log_debug(log, ...) os_log_with_type((log), OS_LOG_TYPE_DEBUG, __VA_ARGS__)
+#define os_log_error(log, ...) os_log_with_type((log), OS_LOG_TYPE_ERROR, __VA_ARGS__)
+#define os_log_fault(log, ...) os_log_with_type((log), OS_LOG_TYPE_FAULT, __VA_ARGS__)
+
+#endif //FLOG_COMPAT_OS_LOG_H
@@ -0,0 +1,140 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "oslog.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define OSLOG_FORMAT_LEN 256
+#define OSLOG_LINE_LEN (OSLOG_MESSAGE_LEN + 2 * OSLOG_NAME_LEN + 8)
+
+struct os_log_s {
+    char subsystem[OSLOG_NAME_LEN];
+    char category[OSLOG_NAME_LEN];
+};
+
+static FlogOsLogEvent ring[OSLOG_RING_SIZE];
+static size_t event_count = 0;
+static int file_fd = -1;
+static bool file_checked = false;
+
+void flog_oslog_write_file(const FlogOsLogEvent *event);
+
+os_log_t
+os_log_create(const char *subsystem, const char *category) {
+    os_log_t log = calloc(1, sizeof(struct os_log_s));
+    if (log == NULL) {
+        return OS_LOG_DEFAULT;
+    }
+
+    strlcpy(log->subsystem, subsystem, OSLOG_NAME_LEN);
+    strlcpy(log->category, category, OSLOG_NAME_LEN);
+
+    return log;
+}
+
+void
+os_release(void *object) {
+    free(object);
+}
+
+void
+flog_oslog_emit(os_log_t log, os_log_type_t type, const char *format, ...) {
+    FlogOsLogEvent *event = &ring[event_count++ % OSLOG_RING_SIZE];
+
+    event->type = type;
+    event->redacted = false;
+    strlcpy(event->subsystem, log != OS_LOG_DEFAULT ? log->subsystem : "", OSLOG_NAME_LEN);
+    strlcpy(event->category, log != OS_LOG_DEFAULT ? log->category : "", OSLOG_NAME_LEN);
+
+    // Privacy annotations such as %{public}s are removed to leave a printf(3) format
+    char plain_format[OSLOG_FORMAT_LEN];
+    size_t len = 0;
+    for (const char *f = format; *f != '\0' && len < OSLOG_FORMAT_LEN - 1; f++) {
+        plain_format[len++] = *f;
+        if (*f == '%' && *(f + 1) == '{') {
+            const char *end = strchr(f, '}');
+            if (end != NULL) {
+                size_t annotation_len = (size_t) (end - f - 2);
+                if (annotation_len == strlen("private") && strncmp(f + 2, "private", annotation_len) == 0) {
+                    event->redacted = true;
+                }
+                f = end;
+            }
+        }
+    }
+    plain_format[len] = '\0';
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(event->message, OSLOG_MESSAGE_LEN, plain_format, args);
+    va_end(args);
+
+    flog_oslog_write_file(event);
+}
+
+void
+flog_oslog_write_file(const FlogOsLogEvent *event) {
+    if (!file_checked) {
+        const char *path = getenv("FLOG_OSLOG_FILE");
+        if (path != NULL) {
+            file_fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        }
+        file_checked = true;
+    }
+
+    if (file_fd == -1) {
+        return;
+    }
+
+    char line[OSLOG_LINE_LEN];
+    int len = snprintf(line, OSLOG_LINE_LEN, "%02x %s:%s %s\n", event->type, event->subsystem, event->category,
+                       event->message);
+
+    if (len > 0) {
+        (void) write(file_fd, line, (size_t) len < OSLOG_LINE_LEN ? (size_t) len : OSLOG_LINE_LEN - 1);
+    }
+}
+
+size_t
+flog_oslog_get_event_count(void) {
+    return event_count;
+}
+
+const FlogOsLogEvent *
+flog_oslog_get_event(size_t age) {
+    size_t held = event_count < OSLOG_RING_SIZE ? event_count : OSLOG_RING_SIZE;
+    if (age >= held) {
+        return NULL;
+    }
+
+    return &ring[(event_count - 1 - age) % OSLOG_RING_SIZE];
+}
+
+void
+flog_oslog_reset(void) {
+    event_count = 0;
+}
@@ -0,0 +1,68 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_COMPAT_OSLOG_H
+#define FLOG_COMPAT_OSLOG_H
+
+/*! \file oslog.h
+ *
+ *  Functions for inspecting the log events recorded by the stand-in for the unified
+ *  logging system (see os/log.h), for use by unit tests.
+ */
+
+#include <os/log.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define OSLOG_RING_SIZE 16
+#define OSLOG_NAME_LEN 257
+#define OSLOG_MESSAGE_LEN 8193
+
+/*! \brief A log event recorded by the stand-in for the unified logging system. */
+typedef struct FlogOsLogEventData {
+    os_log_type_t type;
+    bool redacted;
+    char subsystem[OSLOG_NAME_LEN];
+    char category[OSLOG_NAME_LEN];
+    char message[OSLOG_MESSAGE_LEN];
+} FlogOsLogEvent;
+
+/*! \brief Get the number of log events recorded since the last reset, including
+ *         events that have since been overwritten in the ring.
+ *
+ *  \return The number of log events recorded
+ */
+size_t flog_oslog_get_event_count(void);
+
+/*! \brief Get a recent log event.
+ *
+ *  \param age The age of the log event, where 0 is the most recent event
+ *
+ *  \return A pointer to the log event, or \c NULL if \c age is not less than the
+ *          number of log events still held in the ring
+ */
+const FlogOsLogEvent * flog_oslog_get_event(size_t age);
+
+/*! \brief Discard all recorded log events. */
+void flog_oslog_reset(void);
+
+#endif //FLOG_COMPAT_OSLOG_H
@@ -0,0 +1,52 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string.h>
+
+// strlcpy(3) and strlcat(3) are only provided by glibc 2.38 and later
+#ifndef HAVE_STRLCPY
+
+size_t
+strlcpy(char *dst, const char *src, size_t size) {
+    size_t len = strlen(src);
+
+    if (size > 0) {
+        size_t copy_len = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, copy_len);
+        dst[copy_len] = '\0';
+    }
+
+    return len;
+}
+
+size_t
+strlcat(char *dst, const char *src, size_t size) {
+    size_t dst_len = strnlen(dst, size);
+
+    if (dst_len == size) {
+        return size + strlen(src);
+    }
+
+    return dst_len + strlcpy(dst + dst_len, src, size - dst_len);
+}
+
+#endif
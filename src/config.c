@@ -22,12 +22,19 @@
 
 #include "config.h"
 #include "common.h"
+#include "alias.h"
+#include "pattern.h"
+#include "sanitize.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <sys/syslimits.h>
 #include <string.h>
 #include <assert.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <errno.h>
 #include <popt.h>
 #include <unistd.h>
 #include <sys/stat.h>
@@ -36,244 +43,1797 @@
 #include "../test/testing.h"
 #endif
 
+#define CONFIG_APP_NAME "uk.co.fidgetbox.flog"
+#define CONFIG_ARENA_SIZE 512
+#define CONFIG_ARENA_BLOCK_SIZE 1024
+#define CONFIG_ARRAY_MIN 4
+#define CONFIG_LINE_ARG_MAX 256
+
+/*! \brief An enumerated type representing a token read by the fast argument parser. */
+typedef enum FastTokenData {
+    FAST_TOKEN_OPTION,
+    FAST_TOKEN_END,
+    FAST_TOKEN_REST,
+    FAST_TOKEN_UNSUPPORTED
+} FastToken;
+
 bool is_regular_file_or_pipe(int fd, FlogError *error);
 
-FlogConfigLevel flog_config_parse_level(const char *str);
+FlogConfig *flog_config_alloc(void);
+
+char *flog_config_arena_alloc(FlogConfig *config, size_t size);
+
+void *flog_config_arena_alloc_aligned(FlogConfig *config, size_t size, size_t align);
+
+void *flog_config_grow_array(FlogConfig *config, void *array, size_t count, size_t *capacity, size_t size,
+                             size_t align);
+
+const char *flog_config_copy_string(FlogConfig *config, const char *str, size_t len);
+
+FlogError flog_config_apply_option(FlogConfig *config, int option, const char *option_argument);
+
+FlogError flog_config_parse_args(FlogConfig *config, int argc, char *argv[], bool fast, poptContext *context,
+                                 const char ***message_args, size_t *message_count);
+
+FlogError flog_config_parse_popt(FlogConfig *config, poptContext context);
+
+bool flog_config_fast_parser_enabled(void);
+
+bool flog_config_can_parse_fast(int argc, char *argv[]);
+
+FastToken flog_config_next_fast_token(int argc, char *argv[], int *index, int *option, const char **option_argument);
+
+FlogError flog_config_parse_fast(FlogConfig *config, int argc, char *argv[], const char ***message_args,
+                                 size_t *message_count);
+
+FlogError flog_config_join_message(FlogConfig *config, const char *const *args, size_t count);
+
+FlogError flog_config_split_line(char *line, char *argv[], int *argc);
+
+FlogConfigFormat flog_config_parse_format(const char *str);
+
+FlogConfigFields flog_config_parse_fields(const char *str);
+
+FlogConfigWriter flog_config_parse_writer(const char *str);
+
+bool flog_config_parse_count(const char *str, long max, long *value);
+
+bool flog_config_parse_rate(const char *str, unsigned long *count, long *period);
+
+static struct poptOption options[] = {
+    { "version",       'v',  POPT_ARG_NONE,    NULL,  'v',  NULL,  NULL },
+    { "level",         'l',  POPT_ARG_STRING,  NULL,  'l',  NULL,  NULL },
+    { "subsystem",     's',  POPT_ARG_STRING,  NULL,  's',  NULL,  NULL },
+    { "category",      'c',  POPT_ARG_STRING,  NULL,  'c',  NULL,  NULL },
+    { "help",          'h',  POPT_ARG_NONE,    NULL,  'h',  NULL,  NULL },
+    { "private",       'p',  POPT_ARG_NONE,    NULL,  'p',  NULL,  NULL },
+    { "append",        'a',  POPT_ARG_STRING,  NULL,  'a',  NULL,  NULL },
+    { "format",        'f',  POPT_ARG_STRING,  NULL,  'f',  NULL,  NULL },
+    { "writer",        'w',  POPT_ARG_STRING,  NULL,  'w',  NULL,  NULL },
+    { "fdatasync",     '\0', POPT_ARG_NONE,    NULL,  'y',  NULL,  NULL },
+    { "checksum",      'k',  POPT_ARG_NONE,    NULL,  'k',  NULL,  NULL },
+    { "prefix",        't',  POPT_ARG_STRING,  NULL,  't',  NULL,  NULL },
+    { "stats",         '\0', POPT_ARG_NONE,    NULL,  'T',  NULL,  NULL },
+    { "batch",         '\0', POPT_ARG_STRING,  NULL,  'B',  NULL,  NULL },
+    { "serve",         '\0', POPT_ARG_NONE,    NULL,  'S',  NULL,  NULL },
+    { "exec",          '\0', POPT_ARG_NONE,    NULL,  'E',  NULL,  NULL },
+    { "tee",           '\0', POPT_ARG_NONE,    NULL,  'P',  NULL,  NULL },
+    { "splice",        '\0', POPT_ARG_NONE,    NULL,  'Z',  NULL,  NULL },
+    { "multiline",     '\0', POPT_ARG_NONE,    NULL,  'M',  NULL,  NULL },
+    { "record-start",  '\0', POPT_ARG_STRING,  NULL,  'R',  NULL,  NULL },
+    { "record-max",    '\0', POPT_ARG_STRING,  NULL,  'X',  NULL,  NULL },
+    { "record-wait",   '\0', POPT_ARG_STRING,  NULL,  'W',  NULL,  NULL },
+    { "include",       '\0', POPT_ARG_STRING,  NULL,  'i',  NULL,  NULL },
+    { "exclude",       '\0', POPT_ARG_STRING,  NULL,  'x',  NULL,  NULL },
+    { "dedup",         '\0', POPT_ARG_NONE,    NULL,  'D',  NULL,  NULL },
+    { "dedup-wait",    '\0', POPT_ARG_STRING,  NULL,  'G',  NULL,  NULL },
+    { "rate-limit",    '\0', POPT_ARG_STRING,  NULL,  'L',  NULL,  NULL },
+    { "sample",        '\0', POPT_ARG_STRING,  NULL,  'Q',  NULL,  NULL },
+    { "redact",        '\0', POPT_ARG_STRING,  NULL,  'K',  NULL,  NULL },
+    { "fields",        '\0', POPT_ARG_STRING,  NULL,  'F',  NULL,  NULL },
+    POPT_TABLEEND
+};
+
+/*! \brief A block of arena memory allocated once the space following a FlogConfig is exhausted. */
+typedef struct ConfigArenaBlock {
+    struct ConfigArenaBlock *next;
+    char data[];
+} ConfigArenaBlock;
+
+struct FlogConfigData {
+    FlogConfigLevel level;
+    FlogConfigMessageType message_type;
+    FlogConfigFormat format;
+    FlogConfigFields fields;
+    FlogConfigWriter writer;
+    const char *subsystem;
+    const char *category;
+    const char *output_files[OUTPUT_FILE_MAX];
+    size_t output_file_count;
+    const char *message;
+    const char *batch_file;
+    char *const *command;
+    const char *record_start;
+    size_t record_max;
+    int record_wait;
+    int dedup_wait;
+    unsigned int prefix;
+    bool datasync;
+    bool checksum;
+    bool stats;
+    bool serve;
+    bool exec;
+    bool tee;
+    bool splice;
+    bool multiline;
+    bool dedup;
+    bool version;
+    bool help;
+    // Members from here on are not copied when a batch line configuration is reset
+    // to its defaults (see flog_config_reset())
+    const FlogConfig *defaults;
+    bool fast_parser;
+    // Filters, rate limits, sample rates and redaction are whole-run options, so batch line
+    // configurations never have any; filters and rate limits are counted arrays in the arena
+    const char **filters[FLT_EXCLUDE + 1];
+    size_t filter_counts[FLT_EXCLUDE + 1];
+    size_t filter_capacities[FLT_EXCLUDE + 1];
+    FlogConfigRateLimit *rate_limits;
+    size_t rate_limit_count;
+    size_t rate_limit_capacity;
+    // Zero for levels that are not sampled
+    double sample_rates[LVL_UNKNOWN];
+    unsigned int redact;
+    // Strings are bump-allocated from the arena that follows the structure, then from
+    // chained blocks, and are all released by flog_config_free()
+    ConfigArenaBlock *blocks;
+    char *arena_next;
+    char *arena_end;
+    char arena[];
+};
+
+FlogConfig *
+flog_config_new(int argc, char *argv[], FlogError *error) {
+    assert(argv != NULL);
+    assert(error != NULL);
+
+    *error = FLOG_ERROR_NONE;
+
+    FlogConfig *config = flog_config_alloc();
+    if (config == NULL) {
+        *error = FLOG_ERROR_ALLOC;
+        return NULL;
+    }
+
+    poptContext context = NULL;
+    const char **message_args = NULL;
+    size_t message_count = 0;
+
+    *error = flog_config_parse_args(config, argc, argv, flog_config_fast_parser_enabled(), &context,
+                                    &message_args, &message_count);
+
+    if (*error != FLOG_ERROR_NONE) {
+        flog_config_free(config);
+        if (context != NULL) {
+            poptFreeContext(context);
+        }
+        return NULL;
+    }
+
+    if (flog_config_get_help_flag(config) || flog_config_get_version_flag(config)) {
+        if (context != NULL) {
+            poptFreeContext(context);
+        }
+        return config;
+    }
+
+    if (strlen(flog_config_get_category(config)) > 0 && strlen(flog_config_get_subsystem(config)) == 0) {
+        flog_config_free(config);
+        if (context != NULL) {
+            poptFreeContext(context);
+        }
+        *error = FLOG_ERROR_SUBSYS;
+        return NULL;
+    }
+
+    // Messages are read from the batch file, which may itself be stdin, from requests on
+    // stdin, from the output of the command given in place of a message, from each line
+    // of stdin as it is passed through to the append file, or from each record of stdin;
+    // the lines of a command's output or of passed through input may also form records
+    bool batch = strlen(flog_config_get_batch_file(config)) > 0;
+    bool serve = flog_config_get_serve_flag(config);
+    bool exec = flog_config_get_exec_flag(config);
+    bool tee = flog_config_get_tee_flag(config);
+    bool multiline = flog_config_get_multiline_flag(config);
+    if (batch || serve || exec || tee || multiline) {
+        const char *conflict = NULL;
+        if (batch + serve + exec + tee > 1) {
+            conflict = "the batch, serve, exec and tee options cannot be combined";
+        } else if (multiline && (batch || serve)) {
+            conflict = "the multiline option cannot be combined with the batch or serve options";
+        } else if (!exec && message_args != NULL) {
+            conflict = batch ? "the batch option cannot be combined with message arguments"
+                     : serve ? "the serve option cannot be combined with message arguments"
+                     : tee   ? "the tee option cannot be combined with message arguments"
+                             : "the multiline option cannot be combined with message arguments";
+        } else if (tee && (flog_config_get_output_file_count(config) == 0 ||
+                           flog_config_get_format(config) != FMT_TEXT ||
+                           flog_config_get_prefix(config) != PFX_NONE ||
+                           flog_config_get_checksum_flag(config))) {
+            conflict = "the tee option requires a text append file without a prefix or checksum";
+        } else if (exec && message_args == NULL) {
+            conflict = "the exec option requires a command";
+        } else if (exec) {
+            // The arguments are copied before the context holding them is freed
+            *error = flog_config_set_command(config, message_args, message_count);
+        }
+
+        if (context != NULL) {
+            poptFreeContext(context);
+        }
+
+        if (conflict != NULL) {
+            fprintf(stderr, "%s: %s\n", PROGRAM_NAME, conflict);
+            *error = FLOG_ERROR_OPTS;
+        }
+
+        if (*error != FLOG_ERROR_NONE) {
+            flog_config_free(config);
+            return NULL;
+        }
+
+        return config;
+    }
+
+    FlogError stream_error = FLOG_ERROR_NONE;
+
+    if (message_args != NULL) {
+        *error = flog_config_join_message(config, message_args, message_count);
+    } else if (is_regular_file_or_pipe(fileno(stdin), &stream_error)) {
+        *error = flog_config_set_message_from_stream(config, stdin);
+    } else {
+        flog_config_free(config);
+        if (context != NULL) {
+            poptFreeContext(context);
+        }
+
+        if (stream_error != FLOG_ERROR_NONE) {
+            *error = stream_error;
+        } else {
+            *error = FLOG_ERROR_MSG;
+        }
+
+        return NULL;
+    }
+
+    if (context != NULL) {
+        poptFreeContext(context);
+    }
+
+    if (*error != FLOG_ERROR_NONE) {
+        flog_config_free(config);
+        return NULL;
+    }
+
+    return config;
+}
+
+FlogConfig *
+flog_config_new_from_options(const char *options, FlogError *error) {
+    assert(options != NULL);
+    assert(error != NULL);
+
+    *error = FLOG_ERROR_NONE;
+
+    FlogConfig *config = flog_config_alloc();
+    if (config == NULL) {
+        *error = FLOG_ERROR_ALLOC;
+        return NULL;
+    }
+
+    // The options are split in place in a copy held by the arena
+    char *line = (char *) flog_config_copy_string(config, options, strlen(options));
+    if (line == NULL) {
+        flog_config_free(config);
+        *error = FLOG_ERROR_ALLOC;
+        return NULL;
+    }
+
+    char program_name[] = PROGRAM_NAME;
+    char *argv[CONFIG_LINE_ARG_MAX + 1] = { program_name };
+    int argc = 1;
+
+    if (flog_config_split_line(line, argv, &argc) != FLOG_ERROR_NONE) {
+        flog_config_free(config);
+        *error = FLOG_ERROR_OPTS;
+        return NULL;
+    }
+
+    poptContext context = NULL;
+    const char **message_args = NULL;
+    size_t message_count = 0;
+
+    *error = flog_config_parse_args(config, argc, argv, flog_config_fast_parser_enabled(), &context,
+                                    &message_args, &message_count);
+
+    if (*error == FLOG_ERROR_NONE && strlen(flog_config_get_category(config)) > 0 &&
+        strlen(flog_config_get_subsystem(config)) == 0) {
+        *error = FLOG_ERROR_SUBSYS;
+    }
+
+    if (*error == FLOG_ERROR_NONE && message_args != NULL) {
+        *error = flog_config_join_message(config, message_args, message_count);
+    }
+
+    if (context != NULL) {
+        poptFreeContext(context);
+    }
+
+    if (*error != FLOG_ERROR_NONE) {
+        flog_config_free(config);
+        return NULL;
+    }
+
+    return config;
+}
+
+FlogConfig *
+flog_config_new_with_defaults(const FlogConfig *defaults, FlogError *error) {
+    assert(defaults != NULL);
+    assert(error != NULL);
+
+    *error = FLOG_ERROR_NONE;
+
+    FlogConfig *config = flog_config_alloc();
+    if (config == NULL) {
+        *error = FLOG_ERROR_ALLOC;
+        return NULL;
+    }
+
+    // The alias sources are checked once rather than for every line
+    config->defaults = defaults;
+    config->fast_parser = flog_config_fast_parser_enabled();
+
+    flog_config_reset(config);
+
+    return config;
+}
+
+FlogError
+flog_config_parse_line(FlogConfig *config, char *line) {
+    assert(config != NULL);
+    assert(config->defaults != NULL);
+    assert(line != NULL);
+
+    flog_config_reset(config);
+
+    char program_name[] = PROGRAM_NAME;
+    char *argv[CONFIG_LINE_ARG_MAX + 1] = { program_name };
+    int argc = 1;
+
+    FlogError error = flog_config_split_line(line, argv, &argc);
+    if (error != FLOG_ERROR_NONE) {
+        return error;
+    }
+
+    poptContext context = NULL;
+    const char **message_args = NULL;
+    size_t message_count = 0;
+
+    error = flog_config_parse_args(config, argc, argv, config->fast_parser, &context, &message_args, &message_count);
+
+    if (error == FLOG_ERROR_NONE && strlen(flog_config_get_category(config)) > 0 &&
+        strlen(flog_config_get_subsystem(config)) == 0) {
+        error = FLOG_ERROR_SUBSYS;
+    }
+
+    if (error == FLOG_ERROR_NONE && message_args == NULL) {
+        error = FLOG_ERROR_MSG;
+    }
+
+    if (error == FLOG_ERROR_NONE) {
+        error = flog_config_join_message(config, message_args, message_count);
+    }
+
+    if (context != NULL) {
+        poptFreeContext(context);
+    }
+
+    return error;
+}
+
+FlogConfig *
+flog_config_alloc(void) {
+    FlogConfig *config = calloc(1, sizeof(struct FlogConfigData) + CONFIG_ARENA_SIZE);
+    if (config == NULL) {
+        return NULL;
+    }
+
+    config->arena_next = config->arena;
+    config->arena_end = config->arena + CONFIG_ARENA_SIZE;
+    config->subsystem = "";
+    config->category = "";
+    config->message = "";
+    config->batch_file = "";
+    config->record_start = "";
+    config->record_max = RECORD_MAX_DEFAULT;
+    config->record_wait = RECORD_WAIT_DEFAULT;
+    config->dedup_wait = DEDUP_WAIT_DEFAULT;
+
+    flog_config_set_level(config, LVL_DEFAULT);
+    flog_config_set_message_type(config, MSG_PUBLIC);
+    flog_config_set_format(config, FMT_TEXT);
+    flog_config_set_fields(config, FLD_NONE);
+    flog_config_set_writer(config, WRT_SYNC);
+    flog_config_set_datasync_flag(config, false);
+    flog_config_set_checksum_flag(config, false);
+    flog_config_set_prefix(config, PFX_NONE);
+    flog_config_set_stats_flag(config, false);
+    flog_config_set_serve_flag(config, false);
+    flog_config_set_exec_flag(config, false);
+    flog_config_set_tee_flag(config, false);
+    flog_config_set_splice_flag(config, false);
+    flog_config_set_multiline_flag(config, false);
+    flog_config_set_dedup_flag(config, false);
+    flog_config_set_version_flag(config, false);
+    flog_config_set_help_flag(config, false);
+
+    return config;
+}
+
+void
+flog_config_reset(FlogConfig *config) {
+    assert(config != NULL);
+    assert(config->defaults != NULL);
+
+    ConfigArenaBlock *block = config->blocks;
+    while (block != NULL) {
+        ConfigArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+
+    config->blocks = NULL;
+    config->arena_next = config->arena;
+    config->arena_end = config->arena + CONFIG_ARENA_SIZE;
+
+    // Strings copied from the defaults remain owned by the defaults object
+    memcpy(config, config->defaults, offsetof(struct FlogConfigData, defaults));
+    config->message = "";
+    config->batch_file = "";
+    config->command = NULL;
+}
+
+FlogError
+flog_config_split_line(char *line, char *argv[], int *argc) {
+    char *read = line;
+    char *write = line;
+
+    // Arguments are unquoted in place, which never makes them longer than the line
+    for (;;) {
+        while (*read == ' ' || *read == '\t' || *read == '\r' || *read == '\n') {
+            read++;
+        }
+
+        if (*read == '\0') {
+            return FLOG_ERROR_NONE;
+        }
+
+        if (*argc == CONFIG_LINE_ARG_MAX) {
+            return FLOG_ERROR_LINE;
+        }
+
+        argv[(*argc)++] = write;
+        char quote = '\0';
+
+        while (*read != '\0' && (quote != '\0' || strchr(" \t\r\n", *read) == NULL)) {
+            char c = *read++;
+
+            if (quote == '\'') {
+                if (c == '\'') {
+                    quote = '\0';
+                } else {
+                    *write++ = c;
+                }
+            } else if (c == '\\' && *read != '\0' && (quote == '\0' || *read == '"' || *read == '\\')) {
+                *write++ = *read++;
+            } else if (quote == '"' && c == '"') {
+                quote = '\0';
+            } else if (quote == '\0' && (c == '\'' || c == '"')) {
+                quote = c;
+            } else {
+                *write++ = c;
+            }
+        }
+
+        if (quote != '\0') {
+            return FLOG_ERROR_LINE;
+        }
+
+        char *next = *read == '\0' ? read : read + 1;
+        *write++ = '\0';
+        read = next;
+    }
+}
+
+FlogError
+flog_config_parse_args(FlogConfig *config, int argc, char *argv[], bool fast, poptContext *context,
+                       const char ***message_args, size_t *message_count) {
+    if (fast && flog_config_can_parse_fast(argc, argv)) {
+        return flog_config_parse_fast(config, argc, argv, message_args, message_count);
+    }
+
+    *context = poptGetContext(CONFIG_APP_NAME, argc, (const char**) argv, options, 0);
+    flog_alias_read_default(*context, CONFIG_APP_NAME);
+
+    FlogError error = flog_config_parse_popt(config, *context);
+    if ((*message_args = poptGetArgs(*context)) != NULL) {
+        while ((*message_args)[*message_count] != NULL) {
+            (*message_count)++;
+        }
+    }
+
+    return error;
+}
+
+FlogError
+flog_config_apply_option(FlogConfig *config, int option, const char *option_argument) {
+    // Options that affect the whole process are not accepted on batch lines
+    if (config->defaults != NULL && strchr("hvwyTBSEPZMRXWixDGLQK", option) != NULL) {
+        return FLOG_ERROR_LINE;
+    }
+
+    switch (option) {
+        case 'h':
+            flog_config_set_help_flag(config, true);
+            break;
+        case 'v':
+            flog_config_set_version_flag(config, true);
+            break;
+        case 'a':
+            return flog_config_add_output_file(config, option_argument);
+        case 'l':
+            flog_config_set_level(config, flog_config_parse_level(option_argument));
+            if (flog_config_get_level(config) == LVL_UNKNOWN) {
+                return FLOG_ERROR_LVL;
+            }
+            break;
+        case 'f':
+            flog_config_set_format(config, flog_config_parse_format(option_argument));
+            if (flog_config_get_format(config) == FMT_UNKNOWN) {
+                return FLOG_ERROR_FMT;
+            }
+            break;
+        case 'F':
+            flog_config_set_fields(config, flog_config_parse_fields(option_argument));
+            if (flog_config_get_fields(config) == FLD_UNKNOWN) {
+                return FLOG_ERROR_FIELDS;
+            }
+            break;
+        case 'w':
+            flog_config_set_writer(config, flog_config_parse_writer(option_argument));
+            if (flog_config_get_writer(config) == WRT_UNKNOWN) {
+                return FLOG_ERROR_WRITER;
+            }
+            break;
+        case 'y':
+            flog_config_set_datasync_flag(config, true);
+            break;
+        case 'k':
+            flog_config_set_checksum_flag(config, true);
+            break;
+        case 't':
+            flog_config_set_prefix(config, flog_config_parse_prefix(option_argument));
+            if (flog_config_get_prefix(config) == PFX_UNKNOWN) {
+                return FLOG_ERROR_PREFIX;
+            }
+            break;
+        case 'T':
+            flog_config_set_stats_flag(config, true);
+            break;
+        case 'B':
+            return flog_config_set_batch_file(config, option_argument);
+        case 'S':
+            flog_config_set_serve_flag(config, true);
+            break;
+        case 'E':
+            flog_config_set_exec_flag(config, true);
+            break;
+        case 'P':
+            flog_config_set_tee_flag(config, true);
+            break;
+        case 'Z':
+            // The splice option implies the tee option
+            flog_config_set_tee_flag(config, true);
+            flog_config_set_splice_flag(config, true);
+            break;
+        case 'M':
+            flog_config_set_multiline_flag(config, true);
+            break;
+        case 'R':
+            // Each of the record options implies the multiline option
+            flog_config_set_multiline_flag(config, true);
+            return flog_config_set_record_start(config, option_argument);
+        case 'X': {
+            long record_max;
+            flog_config_set_multiline_flag(config, true);
+            if (!flog_config_parse_count(option_argument, RECORD_MAX_DEFAULT, &record_max)) {
+                return FLOG_ERROR_RECORD;
+            }
+            return flog_config_set_record_max(config, (size_t) record_max);
+        }
+        case 'W': {
+            long record_wait;
+            flog_config_set_multiline_flag(config, true);
+            if (!flog_config_parse_count(option_argument, INT_MAX, &record_wait)) {
+                return FLOG_ERROR_RECORD;
+            }
+            return flog_config_set_record_wait(config, (int) record_wait);
+        }
+        case 'i':
+            return flog_config_add_filter(config, FLT_INCLUDE, option_argument);
+        case 'x':
+            return flog_config_add_filter(config, FLT_EXCLUDE, option_argument);
+        case 'D':
+            flog_config_set_dedup_flag(config, true);
+            break;
+        case 'G': {
+            long dedup_wait;
+            flog_config_set_dedup_flag(config, true);
+            if (!flog_config_parse_count(option_argument, INT_MAX, &dedup_wait)) {
+                return FLOG_ERROR_DEDUP;
+            }
+            return flog_config_set_dedup_wait(config, (int) dedup_wait);
+        }
+        case 'L':
+            return flog_config_add_rate_limit(config, option_argument);
+        case 'Q':
+            return flog_config_set_sample_rates(config, option_argument);
+        case 'K': {
+            unsigned int kinds = flog_config_parse_redact(option_argument);
+            if (kinds == RDT_UNKNOWN) {
+                return FLOG_ERROR_REDACT;
+            }
+            flog_config_set_redact(config, flog_config_get_redact(config) | kinds);
+            break;
+        }
+        case 's':
+            return flog_config_set_subsystem(config, option_argument);
+        case 'c':
+            return flog_config_set_category(config, option_argument);
+        case 'p':
+            flog_config_set_message_type(config, MSG_PRIVATE);
+            break;
+    }
+
+    return FLOG_ERROR_NONE;
+}
+
+FlogError
+flog_config_parse_popt(FlogConfig *config, poptContext context) {
+    int option;
+    while ((option = poptGetNextOpt(context)) > 0) {
+        char *option_argument = poptGetOptArg(context);
+
+        FlogError error = flog_config_apply_option(config, option, option_argument);
+        if (error != FLOG_ERROR_NONE) {
+            return error;
+        }
+
+        if (option == 'h' || option == 'v') {
+            return FLOG_ERROR_NONE;
+        }
+    }
+
+    if (option < -1) {
+        fprintf(stderr, "%s: %s %s\n",
+                PROGRAM_NAME,
+                poptStrerror(option),
+                poptBadOption(context, POPT_BADOPTION_NOALIAS));
+
+        return FLOG_ERROR_OPTS;
+    }
+
+    return FLOG_ERROR_NONE;
+}
+
+FastToken
+flog_config_next_fast_token(int argc, char *argv[], int *index, int *option, const char **option_argument) {
+    if (*index >= argc || argv[*index][0] != '-') {
+        return FAST_TOKEN_END;
+    }
+
+    const char *arg = argv[*index];
+    const char *attached = NULL;
+    const struct poptOption *entry = NULL;
+
+    if (strcmp(arg, "--") == 0) {
+        (*index)++;
+        return FAST_TOKEN_REST;
+    }
+
+    if (arg[1] == '-') {
+        const char *name = arg + 2;
+        size_t len = strcspn(name, "=");
+
+        for (const struct poptOption *o = options; o->longName != NULL || o->shortName != '\0'; o++) {
+            if (o->longName != NULL && strncmp(o->longName, name, len) == 0 && o->longName[len] == '\0') {
+                entry = o;
+                break;
+            }
+        }
+
+        if (name[len] == '=') {
+            attached = name + len + 1;
+        }
+    } else if (arg[1] != '\0' && arg[2] == '\0') {
+        for (const struct poptOption *o = options; o->longName != NULL || o->shortName != '\0'; o++) {
+            if (o->shortName == arg[1]) {
+                entry = o;
+                break;
+            }
+        }
+    }
+
+    if (entry == NULL) {
+        return FAST_TOKEN_UNSUPPORTED;
+    }
+
+    (*index)++;
+    *option = entry->val;
+    *option_argument = NULL;
+
+    if (entry->argInfo == POPT_ARG_NONE) {
+        return attached == NULL ? FAST_TOKEN_OPTION : FAST_TOKEN_UNSUPPORTED;
+    }
+
+    if (attached == NULL) {
+        if (*index >= argc) {
+            return FAST_TOKEN_UNSUPPORTED;
+        }
+        attached = argv[(*index)++];
+    }
+
+    // Empty arguments and arguments that look like options are left to popt, which
+    // decides whether they are values or missing arguments
+    if (attached[0] == '\0' || attached[0] == '-') {
+        return FAST_TOKEN_UNSUPPORTED;
+    }
+
+    *option_argument = attached;
+
+    return FAST_TOKEN_OPTION;
+}
+
+bool
+flog_config_fast_parser_enabled(void) {
+#ifdef UNIT_TESTING
+    if (force_popt_parser) {
+        return false;
+    }
+    if (force_fast_parser) {
+        return true;
+    }
+#endif
+
+    return !flog_alias_sources_exist();
+}
+
+bool
+flog_config_can_parse_fast(int argc, char *argv[]) {
+    if (argc < 1) {
+        return false;
+    }
+
+    int index = 1;
+    int option;
+    const char *option_argument;
+    FastToken token;
+
+    while ((token = flog_config_next_fast_token(argc, argv, &index, &option, &option_argument)) == FAST_TOKEN_OPTION) {
+        // Options after help or version are never parsed, so their syntax is irrelevant
+        if (option == 'h' || option == 'v') {
+            return true;
+        }
+    }
+
+    if (token == FAST_TOKEN_UNSUPPORTED) {
+        return false;
+    }
+
+    // popt permutes options that follow the message, which is left to popt
+    if (token == FAST_TOKEN_END) {
+        for (; index < argc; index++) {
+            if (argv[index][0] == '-') {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+FlogError
+flog_config_parse_fast(FlogConfig *config, int argc, char *argv[], const char ***message_args,
+                       size_t *message_count) {
+    int index = 1;
+    int option;
+    const char *option_argument;
+
+    while (flog_config_next_fast_token(argc, argv, &index, &option, &option_argument) == FAST_TOKEN_OPTION) {
+        FlogError error = flog_config_apply_option(config, option, option_argument);
+        if (error != FLOG_ERROR_NONE) {
+            return error;
+        }
+
+        if (option == 'h' || option == 'v') {
+            return FLOG_ERROR_NONE;
+        }
+    }
+
+    // The message arguments are passed with a count, as argv[argc] may not be NULL
+    *message_args = index < argc ? (const char **) &argv[index] : NULL;
+    *message_count = (size_t) (argc - index);
+
+    return FLOG_ERROR_NONE;
+}
+
+bool
+is_regular_file_or_pipe(int fd, FlogError *error) {
+    struct stat statbuf;
+
+    if (fstat(fd, &statbuf) == -1) {
+        *error = FLOG_ERROR_STAT;
+        return false;
+    }
+
+    return S_ISFIFO(statbuf.st_mode) || S_ISREG(statbuf.st_mode);
+}
+
+void
+flog_config_free(FlogConfig *config) {
+    assert(config != NULL);
+
+    ConfigArenaBlock *block = config->blocks;
+    while (block != NULL) {
+        ConfigArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+
+    free(config);
+}
+
+char *
+flog_config_arena_alloc(FlogConfig *config, size_t size) {
+    if ((size_t) (config->arena_end - config->arena_next) < size) {
+        size_t block_size = size > CONFIG_ARENA_BLOCK_SIZE ? size : CONFIG_ARENA_BLOCK_SIZE;
+
+        ConfigArenaBlock *block = malloc(sizeof(ConfigArenaBlock) + block_size);
+        if (block == NULL) {
+            return NULL;
+        }
+
+        block->next = config->blocks;
+        config->blocks = block;
+        config->arena_next = block->data;
+        config->arena_end = block->data + block_size;
+    }
+
+    char *ptr = config->arena_next;
+    config->arena_next += size;
+
+    return ptr;
+}
+
+void *
+flog_config_arena_alloc_aligned(FlogConfig *config, size_t size, size_t align) {
+    assert(config != NULL);
+    assert(align > 0);
+
+    // Arena allocations are not aligned, so room is left to align the block
+    char *block = flog_config_arena_alloc(config, size + align - 1);
+    if (block == NULL) {
+        return NULL;
+    }
+
+    uintptr_t offset = (uintptr_t) block % align;
+
+    return block + (offset > 0 ? align - offset : 0);
+}
+
+void *
+flog_config_grow_array(FlogConfig *config, void *array, size_t count, size_t *capacity, size_t size,
+                       size_t align) {
+    assert(config != NULL);
+    assert(capacity != NULL);
+    assert(count <= *capacity);
+
+    if (count < *capacity) {
+        return array;
+    }
+
+    // The outgrown array is left in the arena, released with the rest by flog_config_free()
+    size_t grown = *capacity > 0 ? *capacity * 2 : CONFIG_ARRAY_MIN;
+    void *copy = flog_config_arena_alloc_aligned(config, grown * size, align);
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    if (count > 0) {
+        memcpy(copy, array, count * size);
+    }
+
+    *capacity = grown;
+
+    return copy;
+}
+
+const char *
+flog_config_copy_string(FlogConfig *config, const char *str, size_t len) {
+    char *copy = flog_config_arena_alloc(config, len + 1);
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+
+    return copy;
+}
+
+const char *
+flog_config_get_subsystem(const FlogConfig *config) {
+    assert(config != NULL);
+
+    return config->subsystem;
+}
+
+FlogError
+flog_config_set_subsystem(FlogConfig *config, const char *subsystem) {
+    assert(config != NULL);
+    assert(subsystem != NULL);
+
+    size_t len = strnlen(subsystem, SUBSYSTEM_LEN);
+    if (len == SUBSYSTEM_LEN) {
+        fprintf(stderr, "%s: subsystem name truncated to %d bytes\n", PROGRAM_NAME, SUBSYSTEM_LEN - 1);
+        len--;
+    }
+
+    const char *copy = flog_config_copy_string(config, subsystem, len);
+    if (copy == NULL) {
+        return FLOG_ERROR_ALLOC;
+    }
+
+    config->subsystem = copy;
+
+    return FLOG_ERROR_NONE;
+}
+
+const char *
+flog_config_get_category(const FlogConfig *config) {
+    assert(config != NULL);
+
+    return config->category;
+}
+
+FlogError
+flog_config_set_category(FlogConfig *config, const char *category) {
+    assert(config != NULL);
+    assert(category != NULL);
+
+    size_t len = strnlen(category, CATEGORY_LEN);
+    if (len == CATEGORY_LEN) {
+        fprintf(stderr, "%s: category name truncated to %d bytes\n", PROGRAM_NAME, CATEGORY_LEN - 1);
+        len--;
+    }
+
+    const char *copy = flog_config_copy_string(config, category, len);
+    if (copy == NULL) {
+        return FLOG_ERROR_ALLOC;
+    }
+
+    config->category = copy;
+
+    return FLOG_ERROR_NONE;
+}
+
+const char *
+flog_config_get_output_file(const FlogConfig *config) {
+    assert(config != NULL);
+
+    return config->output_file_count > 0 ? config->output_files[0] : "";
+}
+
+FlogError
+flog_config_set_output_file(FlogConfig *config, const char *output_file) {
+    assert(config != NULL);
+    assert(output_file != NULL);
+
+    config->output_file_count = 0;
+
+    return flog_config_add_output_file(config, output_file);
+}
+
+FlogError
+flog_config_add_output_file(FlogConfig *config, const char *output_file) {
+    assert(config != NULL);
+    assert(output_file != NULL);
+
+    if (config->output_file_count == OUTPUT_FILE_MAX) {
+        return FLOG_ERROR_FILES;
+    }
+
+    size_t len = strnlen(output_file, PATH_MAX);
+    if (len == PATH_MAX) {
+        return FLOG_ERROR_FILE;
+    }
+
+    const char *path = flog_config_copy_string(config, output_file, len);
+    if (path == NULL) {
+        return FLOG_ERROR_ALLOC;
+    }
+
+    config->output_files[config->output_file_count++] = path;
+
+    return FLOG_ERROR_NONE;
+}
+
+size_t
+flog_config_get_output_file_count(const FlogConfig *config) {
+    assert(config != NULL);
+
+    return config->output_file_count;
+}
+
+const char *
+flog_config_get_output_file_at(const FlogConfig *config, size_t index) {
+    assert(config != NULL);
+    assert(index < config->output_file_count);
+
+    return config->output_files[index];
+}
+
+bool
+flog_config_get_dedup_flag(const FlogConfig *config) {
+    assert(config != NULL);
+
+    return config->dedup;
+}
+
+void
+flog_config_set_dedup_flag(FlogConfig *config, bool dedup) {
+    assert(config != NULL);
+
+    config->dedup = dedup;
+}
+
+int
+flog_config_get_dedup_wait(const FlogConfig *config) {
+    assert(config != NULL);
+
+    return config->dedup_wait;
+}
+
+FlogError
+flog_config_set_dedup_wait(FlogConfig *config, int dedup_wait) {
+    assert(config != NULL);
+
+    if (dedup_wait < 0) {
+        return FLOG_ERROR_DEDUP;
+    }
+
+    config->dedup_wait = dedup_wait;
+
+    return FLOG_ERROR_NONE;
+}
+
+FlogError
+flog_config_add_filter(FlogConfig *config, FlogConfigFilter filter, const char *pattern) {
+    assert(config != NULL);
+    assert(pattern != NULL);
+
+    size_t len = strlen(pattern);
+    if (len == 0 || config->filter_counts[filter] == FILTER_PATTERN_MAX || !flog_pattern_is_valid(pattern)) {
+        return FLOG_ERROR_FILTER;
+    }
+
+    const char *copy = flog_config_copy_string(config, pattern, len);
+    if (copy == NULL) {
+        return FLOG_ERROR_ALLOC;
+    }
+
+    const char **filters = flog_config_grow_array(config, config->filters[filter], config->filter_counts[filter],
+                                                  &config->filter_capacities[filter], sizeof(const char *),
+                                                  _Alignof(const char *));
+    if (filters == NULL) {
+        return FLOG_ERROR_ALLOC;
+    }
+
+    filters[config->filter_counts[filter]++] = copy;
+    config->filters[filter] = filters;
+
+    return FLOG_ERROR_NONE;
+}
+
+size_t
+flog_config_get_filter_count(const FlogConfig *config, FlogConfigFilter filter) {
+    assert(config != NULL);
+
+    return config->filter_counts[filter];
+}
+
+const char *
+flog_config_get_filter_at(const FlogConfig *config, FlogConfigFilter filter, size_t index) {
+    assert(config != NULL);
+    assert(index < config->filter_counts[filter]);
+
+    return config->filters[filter][index];
+}
+
+FlogError
+flog_config_add_rate_limit(FlogConfig *config, const char *rule) {
+    assert(config != NULL);
+    assert(rule != NULL);
+
+    if (config->rate_limit_count == RATE_LIMIT_MAX) {
+        return FLOG_ERROR_RATE;
+    }
+
+    // The rule is split in place, its selector fields remaining in the arena
+    char *selector = (char *) flog_config_copy_string(config, rule, strlen(rule));
+    if (selector == NULL) {
+        return FLOG_ERROR_ALLOC;
+    }
+
+    FlogConfigRateLimit limit = { .subsystem = "", .category = "", .level = LVL_UNKNOWN };
+
+    char *rate = strrchr(selector, '=');
+    if (rate != NULL) {
+        *rate++ = '\0';
+    } else {
+        rate = selector;
+        selector = "";
+    }
+
+    char *level = strrchr(selector, '@');
+    if (level != NULL) {
+        *level++ = '\0';
+        limit.level = flog_config_parse_level(level);
+        if (limit.level == LVL_UNKNOWN) {
+            return FLOG_ERROR_RATE;
+        }
+    }
+
+    char *category = strchr(selector, ':');
+    if (category != NULL) {
+        *category++ = '\0';
+        if (strlen(category) == 0 || strlen(category) >= CATEGORY_LEN) {
+            return FLOG_ERROR_RATE;
+        }
+
+        limit.category = category;
+    }
+
+    if (strlen(selector) >= SUBSYSTEM_LEN || !flog_config_parse_rate(rate, &limit.count, &limit.period)) {
+        return FLOG_ERROR_RATE;
+    }
+
+    limit.subsystem = selector;
+
+    FlogConfigRateLimit *limits = flog_config_grow_array(config, config->rate_limits, config->rate_limit_count,
+                                                         &config->rate_limit_capacity, sizeof(FlogConfigRateLimit),
+                                                         _Alignof(FlogConfigRateLimit));
+    if (limits == NULL) {
+        return FLOG_ERROR_ALLOC;
+    }
+
+    limits[config->rate_limit_count++] = limit;
+    config->rate_limits = limits;
+
+    return FLOG_ERROR_NONE;
+}
+
+size_t
+flog_config_get_rate_limit_count(const FlogConfig *config) {
+    assert(config != NULL);
+
+    return config->rate_limit_count;
+}
+
+const FlogConfigRateLimit *
+flog_config_get_rate_limit_at(const FlogConfig *config, size_t index) {
+    assert(config != NULL);
+    assert(index < config->rate_limit_count);
+
+    return &config->rate_limits[index];
+}
+
+FlogError
+flog_config_set_sample_rates(FlogConfig *config, const char *rates) {
+    assert(config != NULL);
+    assert(rates != NULL);
+
+    char *list = (char *) flog_config_copy_string(config, rates, strlen(rates));
+    if (list == NULL) {
+        return FLOG_ERROR_ALLOC;
+    }
+
+    // Rates are only applied once the whole list has been parsed
+    double sample_rates[LVL_UNKNOWN];
+    memcpy(sample_rates, config->sample_rates, sizeof(sample_rates));
+
+    char *next = list;
+    do {
+        char *pair = next;
+        next = strchr(pair, ',');
+        if (next != NULL) {
+            *next++ = '\0';
+        }
+
+        char *rate = strchr(pair, '=');
+        if (rate == NULL) {
+            return FLOG_ERROR_SAMPLE;
+        }
+
+        *rate++ = '\0';
+
+        FlogConfigLevel level = flog_config_parse_level(pair);
+        char *end = NULL;
+        double value = strtod(rate, &end);
+        if (level == LVL_UNKNOWN || end == rate || *end != '\0' || !(value > 0.0 && value <= 1.0)) {
+            return FLOG_ERROR_SAMPLE;
+        }
+
+        sample_rates[level] = value;
+    } while (next != NULL);
+
+    memcpy(config->sample_rates, sample_rates, sizeof(sample_rates));
+
+    return FLOG_ERROR_NONE;
+}
+
+double
+flog_config_get_sample_rate(const FlogConfig *config, FlogConfigLevel level) {
+    assert(config != NULL);
+    assert(level < LVL_UNKNOWN);
+
+    return config->sample_rates[level] > 0.0 ? config->sample_rates[level] : 1.0;
+}
+
+unsigned int
+flog_config_get_redact(const FlogConfig *config) {
+    assert(config != NULL);
+
+    return config->redact;
+}
+
+void
+flog_config_set_redact(FlogConfig *config, unsigned int kinds) {
+    assert(config != NULL);
+
+    config->redact = kinds;
+}
+
+unsigned int
+flog_config_parse_redact(const char *str) {
+    assert(str != NULL);
+
+    static const struct {
+        const char *name;
+        FlogConfigRedact kinds;
+    } names[] = {
+        { "bearer",   RDT_BEARER },
+        { "aws-key",  RDT_AWS_KEY },
+        { "email",    RDT_EMAIL },
+        { "card",     RDT_CARD },
+        { "all",      RDT_ALL },
+    };
+
+    unsigned int kinds = RDT_NONE;
+
+    do {
+        size_t len = strcspn(str, ",");
+        bool found = false;
+
+        for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+            if (strlen(names[i].name) == len && strncmp(str, names[i].name, len) == 0) {
+                kinds |= names[i].kinds;
+                found = true;
+                break;
+            }
+        }
+
+        if (!found) {
+            return RDT_UNKNOWN;
+        }
+
+        str += len;
+    } while (*str++ == ',');
+
+    return kinds;
+}
+
+FlogConfigLevel
+flog_config_get_level(const FlogConfig *config) {
+    assert(config != NULL);
+
+    return config->level;
+}
+
+void
+flog_config_set_level(FlogConfig *config, FlogConfigLevel level) {
+    assert(config != NULL);
+
+    config->level = level;
+}
+
+FlogConfigLevel
+flog_config_parse_level(const char *str) {
+    assert(str != NULL);
+
+    FlogConfigLevel level;
+
+    if (strcmp(str, "default") == 0) {
+        level = LVL_DEFAULT;
+    } else if (strcmp(str, "info") == 0) {
+        level = LVL_INFO;
+    } else if (strcmp(str, "debug") == 0) {
+        level = LVL_DEBUG;
+    } else if (strcmp(str, "error") == 0) {
+        level = LVL_ERROR;
+    } else if (strcmp(str, "fault") == 0) {
+        level = LVL_FAULT;
+    } else {
+        level = LVL_UNKNOWN;
+    }
+
+    return level;
+}
+
+const char *
+flog_config_level_string(FlogConfigLevel level) {
+    switch (level) {
+        case LVL_DEFAULT:
+            return "default";
+        case LVL_INFO:
+            return "info";
+        case LVL_DEBUG:
+            return "debug";
+        case LVL_ERROR:
+            return "error";
+        case LVL_FAULT:
+            return "fault";
+        default:
+            return "unknown";
+    }
+}
+
+FlogConfigFormat
+flog_config_get_format(const FlogConfig *config) {
+    assert(config != NULL);
+
+    return config->format;
+}
+
+void
+flog_config_set_format(FlogConfig *config, FlogConfigFormat format) {
+    assert(config != NULL);
+
+    config->format = format;
+}
+
+FlogConfigFormat
+flog_config_parse_format(const char *str) {
+    FlogConfigFormat format;
+
+    if (strcmp(str, "text") == 0) {
+        format = FMT_TEXT;
+    } else if (strcmp(str, "binary") == 0) {
+        format = FMT_BINARY;
+    } else if (strcmp(str, "json") == 0) {
+        format = FMT_JSON;
+    } else {
+        format = FMT_UNKNOWN;
+    }
+
+    return format;
+}
+
+FlogConfigFields
+flog_config_get_fields(const FlogConfig *config) {
+    assert(config != NULL);
+
+    return config->fields;
+}
+
+void
+flog_config_set_fields(FlogConfig *config, FlogConfigFields fields) {
+    assert(config != NULL);
+
+    config->fields = fields;
+}
+
+FlogConfigFields
+flog_config_parse_fields(const char *str) {
+    FlogConfigFields fields;
+
+    if (strcmp(str, "logfmt") == 0) {
+        fields = FLD_LOGFMT;
+    } else if (strcmp(str, "json") == 0) {
+        fields = FLD_JSON;
+    } else {
+        fields = FLD_UNKNOWN;
+    }
+
+    return fields;
+}
+
+FlogConfigWriter
+flog_config_get_writer(const FlogConfig *config) {
+    assert(config != NULL);
+
+    return config->writer;
+}
+
+void
+flog_config_set_writer(FlogConfig *config, FlogConfigWriter writer) {
+    assert(config != NULL);
+
+    config->writer = writer;
+}
+
+FlogConfigWriter
+flog_config_parse_writer(const char *str) {
+    FlogConfigWriter writer;
+
+    if (strcmp(str, "sync") == 0) {
+        writer = WRT_SYNC;
+    } else if (strcmp(str, "async") == 0) {
+        writer = WRT_ASYNC;
+    } else {
+        writer = WRT_UNKNOWN;
+    }
+
+    return writer;
+}
+
+bool
+flog_config_parse_count(const char *str, long max, long *value) {
+    char *end = NULL;
+
+    errno = 0;
+    long count = strtol(str, &end, 10);
+    if (errno != 0 || end == str || *end != '\0' || count < 0 || count > max) {
+        return false;
+    }
+
+    *value = count;
+
+    return true;
+}
+
+bool
+flog_config_parse_rate(const char *str, unsigned long *count, long *period) {
+    if (strcmp(str, "unlimited") == 0) {
+        *count = 0;
+        *period = 0;
+        return true;
+    }
+
+    char number[16];
+    const char *unit = strchr(str, '/');
+    size_t len = unit != NULL ? (size_t) (unit - str) : strlen(str);
+    if (len >= sizeof(number)) {
+        return false;
+    }
+
+    memcpy(number, str, len);
+    number[len] = '\0';
+
+    if (unit == NULL || strcmp(unit, "/s") == 0) {
+        *period = 1000;
+    } else if (strcmp(unit, "/m") == 0) {
+        *period = 60 * 1000;
+    } else if (strcmp(unit, "/h") == 0) {
+        *period = 60 * 60 * 1000;
+    } else {
+        return false;
+    }
+
+    long value;
+    if (!flog_config_parse_count(number, RATE_LIMIT_COUNT_MAX, &value) || value == 0) {
+        return false;
+    }
+
+    *count = (unsigned long) value;
+
+    return true;
+}
+
+bool
+flog_config_get_datasync_flag(const FlogConfig *config) {
+    assert(config != NULL);
+
+    return config->datasync;
+}
+
+void
+flog_config_set_datasync_flag(FlogConfig *config, bool datasync) {
+    assert(config != NULL);
+
+    config->datasync = datasync;
+}
 
-static struct poptOption options[] = {
-    { "version",    'v',  POPT_ARG_NONE,    NULL,  'v',  NULL,  NULL },
-    { "level",      'l',  POPT_ARG_STRING,  NULL,  'l',  NULL,  NULL },
-    { "subsystem",  's',  POPT_ARG_STRING,  NULL,  's',  NULL,  NULL },
-    { "category",   'c',  POPT_ARG_STRING,  NULL,  'c',  NULL,  NULL },
-    { "help",       'h',  POPT_ARG_NONE,    NULL,  'h',  NULL,  NULL },
-    { "private",    'p',  POPT_ARG_NONE,    NULL,  'p',  NULL,  NULL },
-    { "append",     'a',  POPT_ARG_STRING,  NULL,  'a',  NULL,  NULL },
-    POPT_TABLEEND
-};
+bool
+flog_config_get_checksum_flag(const FlogConfig *config) {
+    assert(config != NULL);
 
-struct FlogConfigData {
-    FlogConfigLevel level;
-    FlogConfigMessageType message_type;
-    char subsystem[SUBSYSTEM_LEN];
-    char category[CATEGORY_LEN];
-    char output_file[PATH_MAX];
-    char message[MESSAGE_LEN];
-    bool version;
-    bool help;
-};
+    return config->checksum;
+}
 
-FlogConfig *
-flog_config_new(int argc, char *argv[], FlogError *error) {
-    assert(argv != NULL);
-    assert(error != NULL);
+void
+flog_config_set_checksum_flag(FlogConfig *config, bool checksum) {
+    assert(config != NULL);
 
-    *error = FLOG_ERROR_NONE;
+    config->checksum = checksum;
+}
 
-    FlogConfig *config = calloc(1, sizeof(struct FlogConfigData));
-    if (config == NULL) {
-        *error = FLOG_ERROR_ALLOC;
-        return NULL;
-    }
+unsigned int
+flog_config_get_prefix(const FlogConfig *config) {
+    assert(config != NULL);
 
-    flog_config_set_level(config, LVL_DEFAULT);
-    flog_config_set_message_type(config, MSG_PUBLIC);
-    flog_config_set_version_flag(config, false);
-    flog_config_set_help_flag(config, false);
+    return config->prefix;
+}
 
-    poptContext context = poptGetContext("uk.co.fidgetbox.flog", argc, (const char**) argv, options, 0);
-    poptReadDefaultConfig(context, 0);
+void
+flog_config_set_prefix(FlogConfig *config, unsigned int fields) {
+    assert(config != NULL);
 
-    int option;
-    while ((option = poptGetNextOpt(context)) > 0) {
-        char *option_argument = poptGetOptArg(context);
+    config->prefix = fields;
+}
 
-        switch (option) {
-            case 'h':
-                flog_config_set_help_flag(config, true);
-                poptFreeContext(context);
-                return config;
-            case 'v':
-                flog_config_set_version_flag(config, true);
-                poptFreeContext(context);
-                return config;
-            case 'a':
-                *error = flog_config_set_output_file(config, option_argument);
-                if (*error != FLOG_ERROR_NONE) {
-                    flog_config_free(config);
-                    poptFreeContext(context);
-                    return NULL;
-                }
-                break;
-            case 'l':
-                flog_config_set_level(config, flog_config_parse_level(option_argument));
-                if (flog_config_get_level(config) == LVL_UNKNOWN) {
-                    flog_config_free(config);
-                    poptFreeContext(context);
-                    *error = FLOG_ERROR_LVL;
-                    return NULL;
-                }
-                break;
-            case 's':
-                flog_config_set_subsystem(config, option_argument);
-                break;
-            case 'c':
-                flog_config_set_category(config, option_argument);
-                break;
-            case 'p':
-                flog_config_set_message_type(config, MSG_PRIVATE);
+unsigned int
+flog_config_parse_prefix(const char *str) {
+    assert(str != NULL);
+
+    static const struct {
+        const char *name;
+        FlogConfigPrefix field;
+    } names[] = {
+        { "time",       PFX_TIME },
+        { "level",      PFX_LEVEL },
+        { "pid",        PFX_PID },
+        { "subsystem",  PFX_SUBSYSTEM },
+        { "category",   PFX_CATEGORY },
+    };
+
+    unsigned int fields = PFX_NONE;
+
+    do {
+        size_t len = strcspn(str, ",");
+        bool found = false;
+
+        for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+            if (strlen(names[i].name) == len && strncmp(str, names[i].name, len) == 0) {
+                fields |= names[i].field;
+                found = true;
                 break;
+            }
         }
-    }
 
-    if (option < -1) {
-        fprintf(stderr, "%s: %s %s\n",
-                PROGRAM_NAME,
-                poptStrerror(option),
-                poptBadOption(context, POPT_BADOPTION_NOALIAS));
+        if (!found) {
+            return PFX_UNKNOWN;
+        }
 
-        flog_config_free(config);
-        poptFreeContext(context);
-        *error = FLOG_ERROR_OPTS;
-        return NULL;
-    }
+        str += len;
+    } while (*str++ == ',');
 
-    if (strlen(flog_config_get_category(config)) > 0 && strlen(flog_config_get_subsystem(config)) == 0) {
-        flog_config_free(config);
-        poptFreeContext(context);
-        *error = FLOG_ERROR_SUBSYS;
-        return NULL;
-    }
+    return fields;
+}
 
-    const char **message_args;
-    FlogError stream_error = FLOG_ERROR_NONE;
+bool
+flog_config_get_stats_flag(const FlogConfig *config) {
+    assert(config != NULL);
 
-    if ((message_args = poptGetArgs(context)) != NULL) {
-        flog_config_set_message_from_args(config, message_args);
-    } else if (is_regular_file_or_pipe(fileno(stdin), &stream_error)) {
-        flog_config_set_message_from_stream(config, stdin);
-    } else {
-        flog_config_free(config);
-        poptFreeContext(context);
+    return config->stats;
+}
 
-        if (stream_error != FLOG_ERROR_NONE) {
-            *error = stream_error;
-        } else {
-            *error = FLOG_ERROR_MSG;
-        }
+void
+flog_config_set_stats_flag(FlogConfig *config, bool stats) {
+    assert(config != NULL);
 
-        return NULL;
-    }
+    config->stats = stats;
+}
 
-    poptFreeContext(context);
+bool
+flog_config_get_serve_flag(const FlogConfig *config) {
+    assert(config != NULL);
 
-    return config;
+    return config->serve;
+}
+
+void
+flog_config_set_serve_flag(FlogConfig *config, bool serve) {
+    assert(config != NULL);
+
+    config->serve = serve;
 }
 
 bool
-is_regular_file_or_pipe(int fd, FlogError *error) {
-    struct stat statbuf;
+flog_config_get_exec_flag(const FlogConfig *config) {
+    assert(config != NULL);
 
-    if (fstat(fd, &statbuf) == -1) {
-        *error = FLOG_ERROR_STAT;
-        return false;
-    }
+    return config->exec;
+}
 
-    return S_ISFIFO(statbuf.st_mode) || S_ISREG(statbuf.st_mode);
+void
+flog_config_set_exec_flag(FlogConfig *config, bool exec) {
+    assert(config != NULL);
+
+    config->exec = exec;
+}
+
+bool
+flog_config_get_tee_flag(const FlogConfig *config) {
+    assert(config != NULL);
+
+    return config->tee;
 }
 
 void
-flog_config_free(FlogConfig *config) {
+flog_config_set_tee_flag(FlogConfig *config, bool tee) {
     assert(config != NULL);
 
-    free(config);
+    config->tee = tee;
 }
 
-const char *
-flog_config_get_subsystem(const FlogConfig *config) {
+bool
+flog_config_get_splice_flag(const FlogConfig *config) {
     assert(config != NULL);
 
-    return config->subsystem;
+    return config->splice;
 }
 
 void
-flog_config_set_subsystem(FlogConfig *config, const char *subsystem) {
+flog_config_set_splice_flag(FlogConfig *config, bool splice) {
     assert(config != NULL);
-    assert(subsystem != NULL);
 
-    if (strlcpy(config->subsystem, subsystem, SUBSYSTEM_LEN) >= SUBSYSTEM_LEN) {
-        fprintf(stderr, "%s: subsystem name truncated to %d bytes\n", PROGRAM_NAME, SUBSYSTEM_LEN - 1);
-    }
+    config->splice = splice;
 }
 
-const char *
-flog_config_get_category(const FlogConfig *config) {
+bool
+flog_config_get_multiline_flag(const FlogConfig *config) {
     assert(config != NULL);
 
-    return config->category;
+    return config->multiline;
 }
 
 void
-flog_config_set_category(FlogConfig *config, const char *category) {
+flog_config_set_multiline_flag(FlogConfig *config, bool multiline) {
     assert(config != NULL);
-    assert(category != NULL);
 
-    if (strlcpy(config->category, category, CATEGORY_LEN) >= CATEGORY_LEN) {
-        fprintf(stderr, "%s: category name truncated to %d bytes\n", PROGRAM_NAME, CATEGORY_LEN - 1);
-    }
+    config->multiline = multiline;
 }
 
 const char *
-flog_config_get_output_file(const FlogConfig *config) {
+flog_config_get_record_start(const FlogConfig *config) {
     assert(config != NULL);
 
-    return config->output_file;
+    return config->record_start;
 }
 
 FlogError
-flog_config_set_output_file(FlogConfig *config, const char *output_file) {
+flog_config_set_record_start(FlogConfig *config, const char *pattern) {
     assert(config != NULL);
-    assert(output_file != NULL);
+    assert(pattern != NULL);
 
-    if (strlcpy(config->output_file, output_file, PATH_MAX) >= PATH_MAX) {
-        return FLOG_ERROR_FILE;
+    const char *copy = flog_config_copy_string(config, pattern, strlen(pattern));
+    if (copy == NULL) {
+        return FLOG_ERROR_ALLOC;
     }
 
+    config->record_start = copy;
+
     return FLOG_ERROR_NONE;
 }
 
-FlogConfigLevel
-flog_config_get_level(const FlogConfig *config) {
+size_t
+flog_config_get_record_max(const FlogConfig *config) {
     assert(config != NULL);
 
-    return config->level;
+    return config->record_max;
 }
 
-void
-flog_config_set_level(FlogConfig *config, FlogConfigLevel level) {
+FlogError
+flog_config_set_record_max(FlogConfig *config, size_t record_max) {
     assert(config != NULL);
 
-    config->level = level;
+    if (record_max == 0 || record_max > RECORD_MAX_DEFAULT) {
+        return FLOG_ERROR_RECORD;
+    }
+
+    config->record_max = record_max;
+
+    return FLOG_ERROR_NONE;
 }
 
-FlogConfigLevel
-flog_config_parse_level(const char *str) {
-    FlogConfigLevel level;
+int
+flog_config_get_record_wait(const FlogConfig *config) {
+    assert(config != NULL);
 
-    if (strcmp(str, "default") == 0) {
-        level = LVL_DEFAULT;
-    } else if (strcmp(str, "info") == 0) {
-        level = LVL_INFO;
-    } else if (strcmp(str, "debug") == 0) {
-        level = LVL_DEBUG;
-    } else if (strcmp(str, "error") == 0) {
-        level = LVL_ERROR;
-    } else if (strcmp(str, "fault") == 0) {
-        level = LVL_FAULT;
-    } else {
-        level = LVL_UNKNOWN;
+    return config->record_wait;
+}
+
+FlogError
+flog_config_set_record_wait(FlogConfig *config, int record_wait) {
+    assert(config != NULL);
+
+    if (record_wait < 0) {
+        return FLOG_ERROR_RECORD;
     }
 
-    return level;
+    config->record_wait = record_wait;
+
+    return FLOG_ERROR_NONE;
+}
+
+char *const *
+flog_config_get_command(const FlogConfig *config) {
+    assert(config != NULL);
+
+    return config->command;
+}
+
+FlogError
+flog_config_set_command(FlogConfig *config, const char *const *args, size_t count) {
+    assert(config != NULL);
+    assert(args != NULL);
+    assert(count > 0);
+
+    char **command = flog_config_arena_alloc_aligned(config, (count + 1) * sizeof(char *), _Alignof(char *));
+    if (command == NULL) {
+        return FLOG_ERROR_ALLOC;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        command[i] = (char *) flog_config_copy_string(config, args[i], strlen(args[i]));
+        if (command[i] == NULL) {
+            return FLOG_ERROR_ALLOC;
+        }
+    }
+
+    command[count] = NULL;
+    config->command = command;
+
+    return FLOG_ERROR_NONE;
+}
+
+const char *
+flog_config_get_batch_file(const FlogConfig *config) {
+    assert(config != NULL);
+
+    return config->batch_file;
+}
+
+FlogError
+flog_config_set_batch_file(FlogConfig *config, const char *batch_file) {
+    assert(config != NULL);
+    assert(batch_file != NULL);
+
+    size_t len = strnlen(batch_file, PATH_MAX);
+    if (len == PATH_MAX) {
+        return FLOG_ERROR_FILE;
+    }
+
+    const char *path = flog_config_copy_string(config, batch_file, len);
+    if (path == NULL) {
+        return FLOG_ERROR_ALLOC;
+    }
+
+    config->batch_file = path;
+
+    return FLOG_ERROR_NONE;
 }
 
 const char *
@@ -283,52 +1843,155 @@ flog_config_get_message(const FlogConfig *config) {
     return config->message;
 }
 
-void
+FlogError
 flog_config_set_message(FlogConfig *config, const char *message) {
     assert(config != NULL);
     assert(message != NULL);
 
-    if (strlcpy(config->message, message, MESSAGE_LEN) >= MESSAGE_LEN) {
+    size_t len = strnlen(message, MESSAGE_LEN);
+    if (len == MESSAGE_LEN) {
         fprintf(stderr, "%s: message string was truncated to %d bytes\n", PROGRAM_NAME, MESSAGE_LEN - 1);
+        len--;
     }
+
+    const char *copy = flog_config_copy_string(config, message, len);
+    if (copy == NULL) {
+        return FLOG_ERROR_ALLOC;
+    }
+
+    config->message = copy;
+
+    return FLOG_ERROR_NONE;
 }
 
-void
+FlogError
 flog_config_set_message_from_args(FlogConfig *config, const char **args) {
     assert(config != NULL);
     assert(args != NULL);
 
-    config->message[0] = '\0';
+    size_t count = 0;
+    while (args[count] != NULL) {
+        count++;
+    }
+
+    return flog_config_join_message(config, args, count);
+}
 
-    bool message_truncated = false;
-    while (*args != NULL) {
-        if (strlcat(config->message, *args, MESSAGE_LEN) >= MESSAGE_LEN) {
-            message_truncated = true;
-            break;
+FlogError
+flog_config_join_message(FlogConfig *config, const char *const *args, size_t count) {
+    // The joined length is measured first so that the message is copied into an
+    // allocation of exactly the right size
+    size_t len = 0;
+    for (size_t i = 0; i < count && len < MESSAGE_LEN; i++) {
+        len += strnlen(args[i], MESSAGE_LEN);
+        if (i + 1 < count) {
+            len++;
         }
-        if (*(args + 1) != NULL) {
-            if (strlcat(config->message, " ", MESSAGE_LEN) >= MESSAGE_LEN) {
-                message_truncated = true;
-                break;
-            }
+    }
+
+    bool message_truncated = false;
+    if (len >= MESSAGE_LEN) {
+        message_truncated = true;
+        len = MESSAGE_LEN - 1;
+    }
+
+    char *message = flog_config_arena_alloc(config, len + 1);
+    if (message == NULL) {
+        return FLOG_ERROR_ALLOC;
+    }
+
+    size_t offset = 0;
+    for (size_t i = 0; i < count && offset < len; i++) {
+        size_t arg_len = strnlen(args[i], len - offset);
+        memcpy(message + offset, args[i], arg_len);
+        offset += arg_len;
+
+        if (i + 1 < count && offset < len) {
+            message[offset++] = ' ';
         }
-        ++args;
     }
+    message[offset] = '\0';
+
+    config->message = message;
 
     if (message_truncated) {
         fprintf(stderr, "%s: message was truncated to %d bytes\n", PROGRAM_NAME, MESSAGE_LEN - 1);
     }
+
+    return FLOG_ERROR_NONE;
 }
 
-void
+FlogError
 flog_config_set_message_from_stream(FlogConfig *config, FILE *restrict stream) {
     assert(config != NULL);
     assert(stream != NULL);
 
-    if (fread(config->message, sizeof(char), MESSAGE_LEN, stream) >= MESSAGE_LEN) {
+    char buf[MESSAGE_LEN];
+    size_t len = fread(buf, sizeof(char), MESSAGE_LEN, stream);
+
+    bool truncated = false;
+    if (len >= MESSAGE_LEN) {
+        truncated = true;
+        len = MESSAGE_LEN - 1;
+    }
+
+    // The message ends at the first null byte read, as if read into a string
+    len = strnlen(buf, len);
+
+    // Invalid UTF-8 and control characters are replaced in a second buffer, which the
+    // message need only be copied to when it holds any
+    const char *message;
+    if (flog_sanitize_scan(buf, len) == len) {
+        message = flog_config_copy_string(config, buf, len);
+    } else {
+        char sanitized[MESSAGE_LEN];
+        bool sanitized_truncated;
+        size_t sanitized_len = flog_sanitize_copy(buf, len, sanitized, MESSAGE_LEN, &sanitized_truncated);
+        truncated = truncated || sanitized_truncated;
+        message = flog_config_copy_string(config, sanitized, sanitized_len);
+    }
+
+    if (truncated) {
+        fprintf(stderr, "%s: message was truncated to %d bytes\n", PROGRAM_NAME, MESSAGE_LEN - 1);
+    }
+
+    if (message == NULL) {
+        return FLOG_ERROR_ALLOC;
+    }
+
+    config->message = message;
+
+    return FLOG_ERROR_NONE;
+}
+
+FlogError
+flog_config_sanitize_message(FlogConfig *config) {
+    assert(config != NULL);
+
+    if (config->message == NULL) {
+        return FLOG_ERROR_NONE;
+    }
+
+    size_t len = strlen(config->message);
+    if (flog_sanitize_scan(config->message, len) == len) {
+        return FLOG_ERROR_NONE;
+    }
+
+    char sanitized[MESSAGE_LEN];
+    bool truncated;
+    size_t sanitized_len = flog_sanitize_copy(config->message, len, sanitized, MESSAGE_LEN, &truncated);
+    if (truncated) {
         fprintf(stderr, "%s: message was truncated to %d bytes\n", PROGRAM_NAME, MESSAGE_LEN - 1);
-        config->message[MESSAGE_LEN - 1] = '\0';
     }
+
+    const char *message = flog_config_copy_string(config, sanitized, sanitized_len);
+    if (message == NULL) {
+        return FLOG_ERROR_ALLOC;
+    }
+
+    config->message = message;
+
+    return FLOG_ERROR_NONE;
 }
 
 FlogConfigMessageType
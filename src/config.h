@@ -26,6 +26,10 @@
 /*! \file config.h
  *
  *  Configuration object and associated functions for command-line logging system.
+ *
+ *  Strings set on a FlogConfig object are copied, at their exact length, into an
+ *  arena owned by the object. Pointers returned by its getters remain valid until
+ *  the object is freed, even if the value is set again.
  */
 
 #include <stddef.h>
@@ -36,6 +40,13 @@
 #define SUBSYSTEM_LEN 257
 #define CATEGORY_LEN 257
 #define MESSAGE_LEN 8193
+#define OUTPUT_FILE_MAX 16
+#define RECORD_MAX_DEFAULT (MESSAGE_LEN - 1)
+#define RECORD_WAIT_DEFAULT 1000
+#define FILTER_PATTERN_MAX 32
+#define DEDUP_WAIT_DEFAULT 30000
+#define RATE_LIMIT_MAX 32
+#define RATE_LIMIT_COUNT_MAX 1000000
 
 /*! \brief An enumerated type representing the log level. */
 typedef enum FlogConfigLevelData {
@@ -53,6 +64,71 @@ typedef enum FlogConfigMessageTypeData {
     MSG_PRIVATE
 } FlogConfigMessageType;
 
+/*! \brief An enumerated type representing the append file format. */
+typedef enum FlogConfigFormatData {
+    FMT_TEXT,
+    FMT_BINARY,
+    FMT_JSON,
+    FMT_UNKNOWN
+} FlogConfigFormat;
+
+/*! \brief An enumerated type representing the format of the fields of a message. */
+typedef enum FlogConfigFieldsData {
+    FLD_NONE,
+    FLD_LOGFMT,
+    FLD_JSON,
+    FLD_UNKNOWN
+} FlogConfigFields;
+
+/*! \brief An enumerated type representing the append file writer backend. */
+typedef enum FlogConfigWriterData {
+    WRT_SYNC,
+    WRT_ASYNC,
+    WRT_UNKNOWN
+} FlogConfigWriter;
+
+/*! \brief An enumerated type representing the fields of an append file message prefix. */
+typedef enum FlogConfigPrefixData {
+    PFX_NONE = 0,
+    PFX_TIME = 1 << 0,
+    PFX_LEVEL = 1 << 1,
+    PFX_PID = 1 << 2,
+    PFX_SUBSYSTEM = 1 << 3,
+    PFX_CATEGORY = 1 << 4,
+    PFX_UNKNOWN = 1 << 5
+} FlogConfigPrefix;
+
+/*! \brief An enumerated type representing the kinds of secret masked in messages. */
+typedef enum FlogConfigRedactData {
+    RDT_NONE = 0,
+    RDT_BEARER = 1 << 0,
+    RDT_AWS_KEY = 1 << 1,
+    RDT_EMAIL = 1 << 2,
+    RDT_CARD = 1 << 3,
+    RDT_ALL = RDT_BEARER | RDT_AWS_KEY | RDT_EMAIL | RDT_CARD,
+    RDT_UNKNOWN = 1 << 4
+} FlogConfigRedact;
+
+/*! \brief An enumerated type representing the kind of a record filter pattern. */
+typedef enum FlogConfigFilterData {
+    FLT_INCLUDE,
+    FLT_EXCLUDE
+} FlogConfigFilter;
+
+/*! \brief A type representing a rate limit on the messages matching a selector.
+ *
+ *  An empty subsystem or category, or a level of LVL_UNKNOWN, matches any value.
+ */
+typedef struct FlogConfigRateLimitData {
+    const char *subsystem;
+    const char *category;
+    FlogConfigLevel level;
+    // Zero if the messages are never limited
+    unsigned long count;
+    // The period in milliseconds over which count messages may be logged
+    long period;
+} FlogConfigRateLimit;
+
 /*! \struct FlogConfig
  *
  *  \brief An opaque type representing a FlogConfig logger configuration object.
@@ -77,6 +153,78 @@ typedef struct FlogConfigData FlogConfig;
  */
 FlogConfig * flog_config_new(int argc, char *argv[], FlogError *error);
 
+/*! \brief Create a FlogConfig object from a string of command-line options.
+ *
+ *  The string is split into arguments as a line of a batch file is (see
+ *  flog_config_parse_line()), and may omit the message.
+ *
+ *  \param[in]  options A pointer to the null-terminated options string
+ *  \param[out] error   A pointer to a FlogError object that will be used to
+ *                      represent an error condition on failure
+ *
+ *  \pre \c options is \e not \c NULL
+ *  \pre \c error is \e not \c NULL
+ *
+ *  \return If successful, a pointer to a FlogConfig object; if there is an error
+ *          a \c NULL pointer is returned and \c error will be set to a FlogError
+ *          variant representing an error condition
+ */
+FlogConfig * flog_config_new_from_options(const char *options, FlogError *error);
+
+/*! \brief Create a FlogConfig object for the lines of a batch file.
+ *
+ *  The object starts as a copy of \c defaults, and is reset to it each time a
+ *  line is parsed with flog_config_parse_line(). Strings are shared with
+ *  \c defaults rather than copied, so \c defaults must outlive the object.
+ *
+ *  \param[in]  defaults A pointer to the FlogConfig object created from the
+ *                       command-line arguments
+ *  \param[out] error    A pointer to a FlogError object that will be used to
+ *                       represent an error condition on failure
+ *
+ *  \pre \c defaults is \e not \c NULL
+ *  \pre \c error is \e not \c NULL
+ *
+ *  \return If successful, a pointer to a FlogConfig object; if there is an error
+ *          a \c NULL pointer is returned and \c error will be set to a FlogError
+ *          variant representing an error condition
+ */
+FlogConfig * flog_config_new_with_defaults(const FlogConfig *defaults, FlogError *error);
+
+/*! \brief Reset a batch file FlogConfig object to its defaults and apply the
+ *         options and message on a line of a batch file.
+ *
+ *  The line is split into arguments at whitespace, honouring single quotes,
+ *  double quotes and backslash escapes, and parsed with the same rules as
+ *  command-line arguments. The help, version, writer, fdatasync, stats, batch,
+ *  serve, exec, tee, splice, multiline and record options affect the whole process
+ *  and are rejected.
+ *
+ *  \param config A pointer to a FlogConfig object created with
+ *                flog_config_new_with_defaults()
+ *  \param line   A pointer to the null-terminated line, which is modified in
+ *                place and must remain valid until the next line is parsed
+ *
+ *  \pre \c config is \e not \c NULL
+ *  \pre \c line is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE; FLOG_ERROR_LINE
+ *          if the line is malformed or contains an option that is not accepted
+ *          on batch lines, FLOG_ERROR_MSG if the line has no message, otherwise
+ *          some other variant representing an error condition
+ */
+FlogError flog_config_parse_line(FlogConfig *config, char *line);
+
+/*! \brief Reset a FlogConfig object created with flog_config_new_with_defaults()
+ *         to its defaults, releasing the strings set on it since.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *  \pre \c config was created with flog_config_new_with_defaults()
+ */
+void flog_config_reset(FlogConfig *config);
+
 /*! \brief Free a FlogConfig object.
  *
  *  \param config A pointer to the FlogConfig object that should be freed
@@ -102,8 +250,11 @@ const char * flog_config_get_subsystem(const FlogConfig *config);
  *
  *  \pre \c config is \e not \c NULL
  *  \pre \c subsystem is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, or FLOG_ERROR_ALLOC
+ *          if memory for the subsystem name could not be allocated
  */
-void flog_config_set_subsystem(FlogConfig *config, const char *subsystem);
+FlogError flog_config_set_subsystem(FlogConfig *config, const char *subsystem);
 
 /*! \brief Get the category name from a FlogConfig object.
  *
@@ -122,20 +273,25 @@ const char * flog_config_get_category(const FlogConfig *config);
  *
  *  \pre \c config is \e not \c NULL
  *  \pre \c category is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, or FLOG_ERROR_ALLOC
+ *          if memory for the category name could not be allocated
  */
-void flog_config_set_category(FlogConfig *config, const char *category);
+FlogError flog_config_set_category(FlogConfig *config, const char *category);
 
-/*! \brief Get the output file path from a FlogConfig object.
+/*! \brief Get the first output file path from a FlogConfig object.
  *
  *  \param config A pointer to the FlogConfig object
  *
  *  \pre \c config is \e not \c NULL
  *
- *  \return A pointer to the null-terminated output file path
+ *  \return A pointer to the null-terminated output file path, which is empty if
+ *          no output file has been set
  */
 const char * flog_config_get_output_file(const FlogConfig *config);
 
-/*! \brief Set the output file path for a FlogConfig object.
+/*! \brief Set the output file path for a FlogConfig object, replacing any output
+ *         file paths previously set or added.
  *
  *  \param config      A pointer to the FlogConfig object
  *  \param output_file A pointer to the null-terminated output file path
@@ -143,11 +299,50 @@ const char * flog_config_get_output_file(const FlogConfig *config);
  *  \pre \c config is \e not \c NULL
  *  \pre \c output_file is \e not \c NULL
  *
- *  \return If successful, the FlogError variant FLOG_ERROR_NONE, or FLOG_ERROR_FILE
- *          if the output_file path exceeds the maximum path limit
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE; FLOG_ERROR_FILE
+ *          if the output_file path exceeds the maximum path limit, or
+ *          FLOG_ERROR_ALLOC if memory for the path could not be allocated
  */
 FlogError flog_config_set_output_file(FlogConfig *config, const char *output_file);
 
+/*! \brief Add an output file path to a FlogConfig object.
+ *
+ *  \param config      A pointer to the FlogConfig object
+ *  \param output_file A pointer to the null-terminated output file path
+ *
+ *  \pre \c config is \e not \c NULL
+ *  \pre \c output_file is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE; FLOG_ERROR_FILE
+ *          if the output_file path exceeds the maximum path limit;
+ *          FLOG_ERROR_FILES if \c OUTPUT_FILE_MAX paths have already been added,
+ *          or FLOG_ERROR_ALLOC if memory for the path could not be allocated
+ */
+FlogError flog_config_add_output_file(FlogConfig *config, const char *output_file);
+
+/*! \brief Get the number of output file paths from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return The number of output file paths
+ */
+size_t flog_config_get_output_file_count(const FlogConfig *config);
+
+/*! \brief Get an output file path from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param index  The index of the output file path
+ *
+ *  \pre \c config is \e not \c NULL
+ *  \pre \c index is less than the number of output file paths
+ *
+ *  \return A pointer to the null-terminated output file path, which may be a
+ *          template (see router.h)
+ */
+const char * flog_config_get_output_file_at(const FlogConfig *config, size_t index);
+
 /*! \brief Get the log level value from a FlogConfig object.
  *
  *  \param config A pointer to the FlogConfig object
@@ -167,6 +362,607 @@ FlogConfigLevel flog_config_get_level(const FlogConfig *config);
  */
 void flog_config_set_level(FlogConfig *config, FlogConfigLevel level);
 
+/*! \brief Parse a log level name.
+ *
+ *  \param str A pointer to the null-terminated log level name
+ *
+ *  \pre \c str is \e not \c NULL
+ *
+ *  \return A FlogConfigLevel value representing the log level, or LVL_UNKNOWN
+ *          if the name is not recognised
+ */
+FlogConfigLevel flog_config_parse_level(const char *str);
+
+/*! \brief Return the name of a log level.
+ *
+ *  \param level A FlogConfigLevel value representing the log level
+ *
+ *  \return A pointer to the null-terminated log level name
+ */
+const char * flog_config_level_string(FlogConfigLevel level);
+
+/*! \brief Get the append file format from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return A FlogConfigFormat value representing the append file format
+ */
+FlogConfigFormat flog_config_get_format(const FlogConfig *config);
+
+/*! \brief Set the append file format for a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param format A FlogConfigFormat value representing the append file format
+ *
+ *  \pre \c config is \e not \c NULL
+ */
+void flog_config_set_format(FlogConfig *config, FlogConfigFormat format);
+
+/*! \brief Get the format of the fields of each message from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return A FlogConfigFields value representing the field format, or FLD_NONE if
+ *          messages are logged as they are given
+ */
+FlogConfigFields flog_config_get_fields(const FlogConfig *config);
+
+/*! \brief Set the format of the fields of each message for a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param fields A FlogConfigFields value representing the field format
+ *
+ *  \pre \c config is \e not \c NULL
+ */
+void flog_config_set_fields(FlogConfig *config, FlogConfigFields fields);
+
+/*! \brief Get the append file writer backend from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return A FlogConfigWriter value representing the append file writer backend
+ */
+FlogConfigWriter flog_config_get_writer(const FlogConfig *config);
+
+/*! \brief Set the append file writer backend for a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param writer A FlogConfigWriter value representing the append file writer backend
+ *
+ *  \pre \c config is \e not \c NULL
+ */
+void flog_config_set_writer(FlogConfig *config, FlogConfigWriter writer);
+
+/*! \brief Get the datasync flag from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return \c true if appended data should be flushed to storage otherwise \c false
+ */
+bool flog_config_get_datasync_flag(const FlogConfig *config);
+
+/*! \brief Set the datasync flag for a FlogConfig object.
+ *
+ *  \param config   A pointer to the FlogConfig object
+ *  \param datasync A boolean value representing whether appended data should be
+ *                  flushed to storage
+ *
+ *  \pre \c config is \e not \c NULL
+ */
+void flog_config_set_datasync_flag(FlogConfig *config, bool datasync);
+
+/*! \brief Get the checksum flag from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return \c true if appended text records should be framed with a checksum
+ *          otherwise \c false
+ */
+bool flog_config_get_checksum_flag(const FlogConfig *config);
+
+/*! \brief Set the checksum flag for a FlogConfig object.
+ *
+ *  \param config   A pointer to the FlogConfig object
+ *  \param checksum A boolean value representing whether appended text records
+ *                  should be framed with a checksum
+ *
+ *  \pre \c config is \e not \c NULL
+ */
+void flog_config_set_checksum_flag(FlogConfig *config, bool checksum);
+
+/*! \brief Get the append file message prefix fields from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return A bitwise OR of FlogConfigPrefix values, or PFX_NONE if appended
+ *          messages should not be prefixed
+ */
+unsigned int flog_config_get_prefix(const FlogConfig *config);
+
+/*! \brief Set the append file message prefix fields for a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param fields A bitwise OR of FlogConfigPrefix values
+ *
+ *  \pre \c config is \e not \c NULL
+ */
+void flog_config_set_prefix(FlogConfig *config, unsigned int fields);
+
+/*! \brief Parse a comma-separated list of prefix field names.
+ *
+ *  \param str A pointer to the null-terminated list of field names
+ *
+ *  \pre \c str is \e not \c NULL
+ *
+ *  \return A bitwise OR of FlogConfigPrefix values, or PFX_UNKNOWN if any name
+ *          is not recognised
+ */
+unsigned int flog_config_parse_prefix(const char *str);
+
+/*! \brief Get the stats flag from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return \c true if append file statistics should be printed before exiting
+ */
+bool flog_config_get_stats_flag(const FlogConfig *config);
+
+/*! \brief Set the stats flag for a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param stats  A boolean value representing whether append file statistics
+ *                should be printed before exiting
+ *
+ *  \pre \c config is \e not \c NULL
+ */
+void flog_config_set_stats_flag(FlogConfig *config, bool stats);
+
+/*! \brief Get the serve flag from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return \c true if log requests should be read from stdin until it is closed
+ *          otherwise \c false
+ */
+bool flog_config_get_serve_flag(const FlogConfig *config);
+
+/*! \brief Set the serve flag for a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param serve  A boolean value representing whether log requests should be
+ *                read from stdin until it is closed
+ *
+ *  \pre \c config is \e not \c NULL
+ */
+void flog_config_set_serve_flag(FlogConfig *config, bool serve);
+
+/*! \brief Get the exec flag from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return \c true if the output of the command returned by
+ *          flog_config_get_command() should be logged, otherwise \c false
+ */
+bool flog_config_get_exec_flag(const FlogConfig *config);
+
+/*! \brief Set the exec flag for a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param exec   A boolean value representing whether the output of a command
+ *                should be logged
+ *
+ *  \pre \c config is \e not \c NULL
+ */
+void flog_config_set_exec_flag(FlogConfig *config, bool exec);
+
+/*! \brief Get the tee flag from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return \c true if stdin should be passed through to the append files unchanged
+ *          while each of its lines is logged, otherwise \c false
+ */
+bool flog_config_get_tee_flag(const FlogConfig *config);
+
+/*! \brief Set the tee flag for a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param tee    A boolean value representing whether stdin should be passed
+ *                through to the append files
+ *
+ *  \pre \c config is \e not \c NULL
+ */
+void flog_config_set_tee_flag(FlogConfig *config, bool tee);
+
+/*! \brief Get the splice flag from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return \c true if stdin may be moved into the append file with \c tee(2) and
+ *          \c splice(2) rather than copied through it, otherwise \c false
+ */
+bool flog_config_get_splice_flag(const FlogConfig *config);
+
+/*! \brief Set the splice flag for a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param splice A boolean value representing whether stdin may be moved into the
+ *                append file without being copied through user space
+ *
+ *  \pre \c config is \e not \c NULL
+ */
+void flog_config_set_splice_flag(FlogConfig *config, bool splice);
+
+/*! \brief Get the multiline flag from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return \c true if lines read from stdin, or from the command or stream given by
+ *          the exec or tee options, should be joined into records that are each
+ *          logged as one message, otherwise \c false
+ */
+bool flog_config_get_multiline_flag(const FlogConfig *config);
+
+/*! \brief Set the multiline flag for a FlogConfig object.
+ *
+ *  \param config    A pointer to the FlogConfig object
+ *  \param multiline A boolean value representing whether lines should be joined
+ *                   into records
+ *
+ *  \pre \c config is \e not \c NULL
+ */
+void flog_config_set_multiline_flag(FlogConfig *config, bool multiline);
+
+/*! \brief Get the record start pattern from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return A pointer to the null-terminated POSIX extended regular expression that
+ *          matches the first line of each record, which is empty if lines starting
+ *          with whitespace continue the previous record
+ */
+const char * flog_config_get_record_start(const FlogConfig *config);
+
+/*! \brief Set the record start pattern for a FlogConfig object.
+ *
+ *  The pattern is compiled when records are assembled, not when it is set.
+ *
+ *  \param config  A pointer to the FlogConfig object
+ *  \param pattern A pointer to the null-terminated pattern
+ *
+ *  \pre \c config is \e not \c NULL
+ *  \pre \c pattern is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, or FLOG_ERROR_ALLOC
+ *          if memory for the pattern could not be allocated
+ */
+FlogError flog_config_set_record_start(FlogConfig *config, const char *pattern);
+
+/*! \brief Get the maximum record length from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return The length in bytes beyond which a record is logged in parts
+ */
+size_t flog_config_get_record_max(const FlogConfig *config);
+
+/*! \brief Set the maximum record length for a FlogConfig object.
+ *
+ *  \param config     A pointer to the FlogConfig object
+ *  \param record_max The length in bytes beyond which a record is logged in parts
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, or FLOG_ERROR_RECORD
+ *          if \c record_max is zero or exceeds the maximum message length
+ */
+FlogError flog_config_set_record_max(FlogConfig *config, size_t record_max);
+
+/*! \brief Get the record wait time from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return The time in milliseconds without input after which a pending record is
+ *          logged without waiting for the line that starts the next
+ */
+int flog_config_get_record_wait(const FlogConfig *config);
+
+/*! \brief Set the record wait time for a FlogConfig object.
+ *
+ *  \param config      A pointer to the FlogConfig object
+ *  \param record_wait The time in milliseconds without input after which a pending
+ *                     record is logged
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, or FLOG_ERROR_RECORD
+ *          if \c record_wait is negative
+ */
+FlogError flog_config_set_record_wait(FlogConfig *config, int record_wait);
+
+/*! \brief Get the dedup flag from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return \c true if repeats of the last message with the same subsystem, category
+ *          and level should be counted rather than logged (see dedup.h), otherwise
+ *          \c false
+ */
+bool flog_config_get_dedup_flag(const FlogConfig *config);
+
+/*! \brief Set the dedup flag for a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param dedup  A boolean value representing whether repeated messages should be
+ *                counted rather than logged
+ *
+ *  \pre \c config is \e not \c NULL
+ */
+void flog_config_set_dedup_flag(FlogConfig *config, bool dedup);
+
+/*! \brief Get the dedup wait time from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return The time in milliseconds after the first repeat of a message at which the
+ *          number of repeats is logged
+ */
+int flog_config_get_dedup_wait(const FlogConfig *config);
+
+/*! \brief Set the dedup wait time for a FlogConfig object.
+ *
+ *  \param config     A pointer to the FlogConfig object
+ *  \param dedup_wait The time in milliseconds after the first repeat of a message at
+ *                    which the number of repeats is logged
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, or FLOG_ERROR_DEDUP
+ *          if \c dedup_wait is negative
+ */
+FlogError flog_config_set_dedup_wait(FlogConfig *config, int dedup_wait);
+
+/*! \brief Add a record filter pattern to a FlogConfig object.
+ *
+ *  Filters are whole-run options, so configurations created with
+ *  flog_config_new_with_defaults() have none. The pattern is a POSIX extended
+ *  regular expression, which is matched as a literal string if it contains no
+ *  operators (see pattern.h).
+ *
+ *  \param config  A pointer to the FlogConfig object
+ *  \param filter  A FlogConfigFilter variant selecting the include or exclude patterns
+ *  \param pattern A pointer to the null-terminated pattern
+ *
+ *  \pre \c config is \e not \c NULL
+ *  \pre \c pattern is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE; FLOG_ERROR_FILTER
+ *          if the pattern is empty or invalid, or \c FILTER_PATTERN_MAX patterns of
+ *          its kind have already been added, or FLOG_ERROR_ALLOC if memory
+ *          for the pattern could not be allocated
+ */
+FlogError flog_config_add_filter(FlogConfig *config, FlogConfigFilter filter, const char *pattern);
+
+/*! \brief Get the number of record filter patterns of a kind from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param filter A FlogConfigFilter variant selecting the include or exclude patterns
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return The number of patterns
+ */
+size_t flog_config_get_filter_count(const FlogConfig *config, FlogConfigFilter filter);
+
+/*! \brief Get a record filter pattern from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param filter A FlogConfigFilter variant selecting the include or exclude patterns
+ *  \param index  The index of the pattern
+ *
+ *  \pre \c config is \e not \c NULL
+ *  \pre \c index is less than the number of patterns of the kind
+ *
+ *  \return A pointer to the null-terminated pattern
+ */
+const char * flog_config_get_filter_at(const FlogConfig *config, FlogConfigFilter filter, size_t index);
+
+/*! \brief Add a rate limit to a FlogConfig object.
+ *
+ *  Rate limits are whole-run options, so configurations created with
+ *  flog_config_new_with_defaults() have none. A rule has the form
+ *  <tt>[[subsystem][:category][\@level]=]rate</tt>, where \c rate is \c unlimited or
+ *  a count of messages optionally followed by \c /s, \c /m or \c /h (per second if
+ *  omitted), for example \c \@debug=1000/s or \c uk.co.fidgetbox.api:db=10/m.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param rule   A pointer to the null-terminated rate limit rule
+ *
+ *  \pre \c config is \e not \c NULL
+ *  \pre \c rule is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE; FLOG_ERROR_RATE if
+ *          the rule is invalid or \c RATE_LIMIT_MAX rules have already been added, or
+ *          FLOG_ERROR_ALLOC if memory for the rule could not be allocated
+ */
+FlogError flog_config_add_rate_limit(FlogConfig *config, const char *rule);
+
+/*! \brief Get the number of rate limits from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return The number of rate limits added
+ */
+size_t flog_config_get_rate_limit_count(const FlogConfig *config);
+
+/*! \brief Get a rate limit from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param index  The index of the rate limit, in the order the rules were added
+ *
+ *  \pre \c config is \e not \c NULL
+ *  \pre \c index is less than the number of rate limits
+ *
+ *  \return A pointer to the FlogConfigRateLimit, valid until the FlogConfig is freed
+ */
+const FlogConfigRateLimit * flog_config_get_rate_limit_at(const FlogConfig *config, size_t index);
+
+/*! \brief Set the sample rates of log levels for a FlogConfig object.
+ *
+ *  Sample rates are whole-run options, so configurations created with
+ *  flog_config_new_with_defaults() have none. Rates set by an earlier call are kept
+ *  for levels that \c rates does not name.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param rates  A pointer to a null-terminated comma-separated list of \c level=rate
+ *                pairs, where \c rate is a fraction greater than zero and at most one,
+ *                for example \c debug=0.01,info=0.1
+ *
+ *  \pre \c config is \e not \c NULL
+ *  \pre \c rates is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE; FLOG_ERROR_SAMPLE if
+ *          the list is invalid, in which case no rates are changed, or FLOG_ERROR_ALLOC
+ *          if memory for the list could not be allocated
+ */
+FlogError flog_config_set_sample_rates(FlogConfig *config, const char *rates);
+
+/*! \brief Get the sample rate of a log level from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param level  A FlogConfigLevel value other than LVL_UNKNOWN
+ *
+ *  \pre \c config is \e not \c NULL
+ *  \pre \c level is \e not LVL_UNKNOWN
+ *
+ *  \return The fraction of messages at the level that are kept, which is 1 if no
+ *          rate has been set
+ */
+double flog_config_get_sample_rate(const FlogConfig *config, FlogConfigLevel level);
+
+/*! \brief Get the kinds of secret masked in messages from a FlogConfig object.
+ *
+ *  Redaction is a whole-run option, so configurations created with
+ *  flog_config_new_with_defaults() mask none.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return A bitwise OR of FlogConfigRedact values, or RDT_NONE if messages are
+ *          logged unchanged
+ */
+unsigned int flog_config_get_redact(const FlogConfig *config);
+
+/*! \brief Set the kinds of secret masked in messages for a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param kinds  A bitwise OR of FlogConfigRedact values
+ *
+ *  \pre \c config is \e not \c NULL
+ */
+void flog_config_set_redact(FlogConfig *config, unsigned int kinds);
+
+/*! \brief Parse a comma-separated list of redaction kind names.
+ *
+ *  \param str A pointer to the null-terminated list of kind names, each one of
+ *             \c bearer, \c aws-key, \c email, \c card or \c all
+ *
+ *  \pre \c str is \e not \c NULL
+ *
+ *  \return A bitwise OR of FlogConfigRedact values, or RDT_UNKNOWN if any name is
+ *          not recognised
+ */
+unsigned int flog_config_parse_redact(const char *str);
+
+/*! \brief Get the command to run from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return A pointer to a \c NULL terminated argument vector whose first element
+ *          names the command, or \c NULL if no command has been set
+ */
+char *const * flog_config_get_command(const FlogConfig *config);
+
+/*! \brief Set the command to run for a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *  \param args   A pointer to an array of null-terminated arguments, the first of
+ *                which names the command
+ *  \param count  The number of arguments
+ *
+ *  \pre \c config is \e not \c NULL
+ *  \pre \c args is \e not \c NULL
+ *  \pre \c count is greater than zero
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, or FLOG_ERROR_ALLOC
+ *          if memory for the arguments could not be allocated
+ */
+FlogError flog_config_set_command(FlogConfig *config, const char *const *args, size_t count);
+
+/*! \brief Get the batch file path from a FlogConfig object.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return A pointer to the null-terminated batch file path, which is empty if
+ *          no batch file has been set, or \c - for stdin
+ */
+const char * flog_config_get_batch_file(const FlogConfig *config);
+
+/*! \brief Set the batch file path for a FlogConfig object.
+ *
+ *  \param config     A pointer to the FlogConfig object
+ *  \param batch_file A pointer to the null-terminated batch file path
+ *
+ *  \pre \c config is \e not \c NULL
+ *  \pre \c batch_file is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE; FLOG_ERROR_FILE
+ *          if the path exceeds the maximum path limit, or FLOG_ERROR_ALLOC if
+ *          memory for the path could not be allocated
+ */
+FlogError flog_config_set_batch_file(FlogConfig *config, const char *batch_file);
+
 /*! \brief Get the log message from a FlogConfig object.
  *
  *  \param config A pointer to the FlogConfig object
@@ -184,8 +980,11 @@ const char * flog_config_get_message(const FlogConfig *config);
  *
  *  \pre \c config is \e not \c NULL
  *  \pre \c category is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, or FLOG_ERROR_ALLOC
+ *          if memory for the message could not be allocated
  */
-void flog_config_set_message(FlogConfig *config, const char *message);
+FlogError flog_config_set_message(FlogConfig *config, const char *message);
 
 /*! \brief Set the log message for a FlogConfig object by combining multiple
  *         command-line arguments.
@@ -197,18 +996,42 @@ void flog_config_set_message(FlogConfig *config, const char *message);
  *
  *  \pre \c config is \e not \c NULL
  *  \pre \c args is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, or FLOG_ERROR_ALLOC
+ *          if memory for the message could not be allocated
  */
-void flog_config_set_message_from_args(FlogConfig *config, const char **args);
+FlogError flog_config_set_message_from_args(FlogConfig *config, const char **args);
 
 /*! \brief Set the log message for a FlogConfig object by reading from a stream.
+ *
+ *  Invalid UTF-8 sequences in the message are replaced with U+FFFD and control
+ *  characters other than tabs and line endings are escaped (see sanitize.h).
  *
  *  \param config A pointer to the FlogConfig object
  *  \param stream A pointer to a stream
  *
  *  \pre \c config is \e not \c NULL
  *  \pre \c stream is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, or FLOG_ERROR_ALLOC
+ *          if memory for the message could not be allocated
+ */
+FlogError flog_config_set_message_from_stream(FlogConfig *config, FILE *restrict stream);
+
+/*! \brief Sanitize the log message of a FlogConfig object.
+ *
+ *  Invalid UTF-8 sequences in the message are replaced with U+FFFD and control
+ *  characters other than tabs and line endings are escaped (see sanitize.h). A message
+ *  that needs neither is left as it is, and is not copied.
+ *
+ *  \param config A pointer to the FlogConfig object
+ *
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, or FLOG_ERROR_ALLOC
+ *          if memory for the sanitized message could not be allocated
  */
-void flog_config_set_message_from_stream(FlogConfig *config, FILE *restrict stream);
+FlogError flog_config_sanitize_message(FlogConfig *config);
 
 /*! \brief Get the log message type from a FlogConfig object.
  *
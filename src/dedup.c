@@ -0,0 +1,205 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "dedup.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "checksum.h"
+
+#ifdef UNIT_TESTING
+#include "../test/testing.h"
+#endif
+
+/*! \brief A type representing a group of messages and the repeats of its last message. */
+typedef struct DedupGroup {
+    char subsystem[SUBSYSTEM_LEN];
+    char category[CATEGORY_LEN];
+    FlogConfigLevel level;
+    uint64_t hash;
+    size_t len;
+    unsigned long count;
+    int64_t first_repeat;
+    uint64_t last_used;
+} DedupGroup;
+
+struct FlogDedupData {
+    int wait;
+    size_t group_count;
+    uint64_t tick;
+    // A summary made due by flog_dedup_is_repeat(), taken before any other
+    FlogDedupSummary due;
+    bool has_due;
+    DedupGroup groups[DEDUP_GROUP_MAX];
+};
+
+DedupGroup *flog_dedup_find_group(FlogDedup *dedup, const char *subsystem, const char *category,
+                                  FlogConfigLevel level);
+
+void flog_dedup_take_group(DedupGroup *group, FlogDedupSummary *summary);
+
+FlogDedup *
+flog_dedup_new(int wait, FlogError *error) {
+    assert(wait >= 0);
+    assert(error != NULL);
+
+    *error = FLOG_ERROR_NONE;
+
+    FlogDedup *dedup = calloc(1, sizeof(struct FlogDedupData));
+    if (dedup == NULL) {
+        *error = FLOG_ERROR_ALLOC;
+        return NULL;
+    }
+
+    dedup->wait = wait;
+
+    return dedup;
+}
+
+void
+flog_dedup_free(FlogDedup *dedup) {
+    assert(dedup != NULL);
+
+    free(dedup);
+}
+
+bool
+flog_dedup_is_repeat(FlogDedup *dedup, const char *subsystem, const char *category, FlogConfigLevel level,
+                     const char *message, int64_t now) {
+    assert(dedup != NULL);
+    assert(subsystem != NULL);
+    assert(category != NULL);
+    assert(message != NULL);
+    assert(!dedup->has_due);
+
+    size_t len = strlen(message);
+    uint64_t hash = flog_hash64(message, len);
+
+    DedupGroup *group = flog_dedup_find_group(dedup, subsystem, category, level);
+    if (group == NULL) {
+        if (dedup->group_count < DEDUP_GROUP_MAX) {
+            group = &dedup->groups[dedup->group_count++];
+        } else {
+            group = &dedup->groups[0];
+            for (size_t i = 1; i < DEDUP_GROUP_MAX; i++) {
+                if (dedup->groups[i].last_used < group->last_used) {
+                    group = &dedup->groups[i];
+                }
+            }
+
+            if (group->count > 0) {
+                flog_dedup_take_group(group, &dedup->due);
+                dedup->has_due = true;
+            }
+        }
+
+        strlcpy(group->subsystem, subsystem, SUBSYSTEM_LEN);
+        strlcpy(group->category, category, CATEGORY_LEN);
+        group->level = level;
+        group->count = 0;
+    } else if (group->hash == hash && group->len == len) {
+        if (group->count++ == 0) {
+            group->first_repeat = now;
+        }
+        group->last_used = ++dedup->tick;
+        return true;
+    } else if (group->count > 0) {
+        flog_dedup_take_group(group, &dedup->due);
+        dedup->has_due = true;
+    }
+
+    group->hash = hash;
+    group->len = len;
+    group->last_used = ++dedup->tick;
+
+    return false;
+}
+
+bool
+flog_dedup_next_summary(FlogDedup *dedup, int64_t now, FlogDedupSummary *summary) {
+    assert(dedup != NULL);
+    assert(summary != NULL);
+
+    if (dedup->has_due) {
+        *summary = dedup->due;
+        dedup->has_due = false;
+        return true;
+    }
+
+    for (size_t i = 0; i < dedup->group_count; i++) {
+        DedupGroup *group = &dedup->groups[i];
+        if (group->count > 0 && (now == INT64_MAX || now - group->first_repeat >= dedup->wait)) {
+            flog_dedup_take_group(group, summary);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int
+flog_dedup_get_timeout(const FlogDedup *dedup, int64_t now) {
+    assert(dedup != NULL);
+
+    if (dedup->has_due) {
+        return 0;
+    }
+
+    int timeout = -1;
+    for (size_t i = 0; i < dedup->group_count; i++) {
+        const DedupGroup *group = &dedup->groups[i];
+        if (group->count == 0) {
+            continue;
+        }
+
+        int64_t remaining = group->first_repeat + dedup->wait - now;
+        int group_timeout = remaining > 0 ? (int) remaining : 0;
+        if (timeout < 0 || group_timeout < timeout) {
+            timeout = group_timeout;
+        }
+    }
+
+    return timeout;
+}
+
+DedupGroup *
+flog_dedup_find_group(FlogDedup *dedup, const char *subsystem, const char *category, FlogConfigLevel level) {
+    for (size_t i = 0; i < dedup->group_count; i++) {
+        DedupGroup *group = &dedup->groups[i];
+        if (group->level == level && strcmp(group->subsystem, subsystem) == 0 &&
+            strcmp(group->category, category) == 0) {
+            return group;
+        }
+    }
+
+    return NULL;
+}
+
+void
+flog_dedup_take_group(DedupGroup *group, FlogDedupSummary *summary) {
+    memcpy(summary->subsystem, group->subsystem, SUBSYSTEM_LEN);
+    memcpy(summary->category, group->category, CATEGORY_LEN);
+    summary->level = group->level;
+    summary->count = group->count;
+
+    group->count = 0;
+}
@@ -0,0 +1,137 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_DEDUP_H
+#define FLOG_DEDUP_H
+
+/*! \file dedup.h
+ *
+ *  Dedup object and associated functions for suppressing repeated messages.
+ *
+ *  Messages are grouped by subsystem, category and level, and a message identical to
+ *  the last message of its group is a repeat. Repeats are counted rather than logged,
+ *  and the count is returned as a summary once a different message arrives for the
+ *  group, once the wait time has passed since the first repeat was counted, or when
+ *  all summaries are taken at the end of the input. Counting then starts again, so a
+ *  message repeated indefinitely is summarised once per wait time.
+ *
+ *  Only a 64-bit hash and the length of the last message of each group are kept, and
+ *  messages are compared by these alone. The most recently used \c DEDUP_GROUP_MAX
+ *  groups are tracked; a message from any other group replaces the least recently
+ *  used, whose count is returned as a summary.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "common.h"
+
+#define DEDUP_GROUP_MAX 16
+
+/*! \brief A type representing the number of repeats of the last message of a group. */
+typedef struct FlogDedupSummaryData {
+    char subsystem[SUBSYSTEM_LEN];
+    char category[CATEGORY_LEN];
+    FlogConfigLevel level;
+    unsigned long count;
+} FlogDedupSummary;
+
+/*! \struct FlogDedup
+ *
+ *  \brief An opaque type representing a FlogDedup repeated message suppressor object.
+ */
+typedef struct FlogDedupData FlogDedup;
+
+/*! \brief Create a FlogDedup object.
+ *
+ *  \param[in]  wait  The time in milliseconds after the first repeat of a message is
+ *                    counted at which its count is summarised
+ *  \param[out] error A pointer to a FlogError object that will be used to represent
+ *                    an error condition on failure
+ *
+ *  \pre \c wait is \e not negative
+ *  \pre \c error is \e not \c NULL
+ *
+ *  \return If successful, a pointer to a FlogDedup object; if there is an error a
+ *          \c NULL pointer is returned and \c error will be set to FLOG_ERROR_ALLOC
+ */
+FlogDedup * flog_dedup_new(int wait, FlogError *error);
+
+/*! \brief Free a FlogDedup object.
+ *
+ *  \param dedup A pointer to the FlogDedup object
+ *
+ *  \pre \c dedup is \e not \c NULL
+ */
+void flog_dedup_free(FlogDedup *dedup);
+
+/*! \brief Determine whether a message repeats the last message of its group, counting
+ *         it if so and otherwise making it the last message of the group.
+ *
+ *  A summary made due by the call, for the group of the message or for the group it
+ *  replaces, must be taken with flog_dedup_next_summary() before the message is logged
+ *  and before this function is called again.
+ *
+ *  \param dedup     A pointer to the FlogDedup object
+ *  \param subsystem A pointer to the null-terminated subsystem name
+ *  \param category  A pointer to the null-terminated category name
+ *  \param level     The log level of the message
+ *  \param message   A pointer to the null-terminated message
+ *  \param now       The current time in milliseconds, from a monotonic clock
+ *
+ *  \pre \c dedup, \c subsystem, \c category and \c message are \e not \c NULL
+ *  \pre no summary made due by a previous call remains to be taken
+ *
+ *  \return \c true if the message is a repeat and should not be logged, otherwise
+ *          \c false
+ */
+bool flog_dedup_is_repeat(FlogDedup *dedup, const char *subsystem, const char *category, FlogConfigLevel level,
+                          const char *message, int64_t now);
+
+/*! \brief Take the next summary that is due.
+ *
+ *  \param[in]  dedup   A pointer to the FlogDedup object
+ *  \param[in]  now     The current time in milliseconds, or \c INT64_MAX to take every
+ *                      pending summary
+ *  \param[out] summary A pointer to a FlogDedupSummary object that receives the summary
+ *
+ *  \pre \c dedup is \e not \c NULL
+ *  \pre \c summary is \e not \c NULL
+ *
+ *  \return \c true if a summary was taken, or \c false if none is due
+ */
+bool flog_dedup_next_summary(FlogDedup *dedup, int64_t now, FlogDedupSummary *summary);
+
+/*! \brief Get the time until the next summary is due.
+ *
+ *  \param dedup A pointer to the FlogDedup object
+ *  \param now   The current time in milliseconds
+ *
+ *  \pre \c dedup is \e not \c NULL
+ *
+ *  \return The time in milliseconds until the next summary is due, zero if one is
+ *          already due, or -1 if no repeats are being counted
+ */
+int flog_dedup_get_timeout(const FlogDedup *dedup, int64_t now);
+
+#endif //FLOG_DEDUP_H
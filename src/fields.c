@@ -0,0 +1,798 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "fields.h"
+#include "sanitize.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+
+#ifdef UNIT_TESTING
+#include "../test/testing.h"
+#endif
+
+#define SWAR_ONES UINT64_C(0x0101010101010101)
+#define SWAR_HIGHS UINT64_C(0x8080808080808080)
+#define CONTROL_MAX 0x20
+#define UNICODE_ESCAPE_LEN 4
+#define UNICODE_REPLACEMENT 0xfffd
+#define UTF8_CHAR_MAX 4
+#define ESCAPE_MAX 6
+#define CONTROL_ESCAPE_LEN 4
+#define NON_ASCII_MIN 0x80
+#define REPLACEMENT_LEN 3
+
+// The character following the backslash of the escape for each byte that needs one in
+// a JSON string, or zero for bytes that are copied as they are
+static const char json_escapes[256] = {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    ['"'] = '"',
+    ['\\'] = '\\'
+};
+
+bool flog_fields_parse_logfmt(FlogFields *fields, const char *p, const char *end);
+
+bool flog_fields_parse_json(FlogFields *fields, const char *p, const char *end);
+
+bool flog_fields_add(FlogFields *fields, const char *key, size_t key_len, const char *value, size_t value_len,
+                     bool quoted);
+
+const char * flog_fields_skip_space(const char *p, const char *end);
+
+const char * flog_fields_skip_string(const char *p, const char *end);
+
+const char * flog_fields_skip_json_value(const char *p, const char *end);
+
+bool flog_fields_read_hex(const char *p, const char *end, uint32_t *code);
+
+size_t flog_fields_encode_utf8(uint32_t code, char *out);
+
+size_t flog_fields_trim_character(const char *buf, size_t len, unsigned char next);
+
+bool flog_fields_needs_quotes(const char *value, size_t len);
+
+bool flog_fields_append(char *buf, size_t size, size_t *len, const char *str, size_t str_len);
+
+char * flog_fields_put_quoted(char *out, const char *value, size_t value_len);
+
+char * flog_fields_put_char(char *out, unsigned char c);
+
+char * flog_fields_put_characters(char *out, const char *value, size_t value_len, size_t start, size_t end,
+                                  size_t *next);
+
+char * flog_fields_put_sequence(char *out, const char *value, size_t len, size_t *consumed);
+
+uint64_t flog_fields_special_bytes(uint64_t word);
+
+size_t flog_fields_special_offset(const char *word, uint64_t special);
+
+bool
+flog_fields_parse(FlogFields *fields, FlogConfigFields format, const char *message) {
+    assert(fields != NULL);
+    assert(format == FLD_LOGFMT || format == FLD_JSON);
+    assert(message != NULL);
+
+    fields->count = 0;
+    const char *end = message + strlen(message);
+
+    if (format == FLD_JSON) {
+        return flog_fields_parse_json(fields, message, end);
+    }
+
+    return flog_fields_parse_logfmt(fields, message, end);
+}
+
+FlogField *
+flog_fields_find(FlogFields *fields, const char *const *keys) {
+    assert(fields != NULL);
+    assert(keys != NULL);
+
+    for (; *keys != NULL; keys++) {
+        size_t len = strlen(*keys);
+        for (size_t i = 0; i < fields->count; i++) {
+            FlogField *field = &fields->fields[i];
+            if (!field->taken && field->key_len == len && memcmp(field->key, *keys, len) == 0) {
+                return field;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+size_t
+flog_fields_copy_value(const FlogField *field, char *buf, size_t size) {
+    assert(field != NULL);
+    assert(buf != NULL);
+    assert(size > 0);
+
+    size_t len = 0;
+    if (field->value == NULL) {
+        buf[len] = '\0';
+        return len;
+    }
+
+    const char *p = field->value;
+    const char *end = field->value + field->value_len;
+
+    while (p < end) {
+        char decoded[UTF8_CHAR_MAX];
+        size_t decoded_len = 1;
+
+        if (!field->quoted || *p != '\\' || p + 1 == end) {
+            decoded[0] = *p++;
+        } else {
+            p++;
+            switch (*p) {
+                case 'b':
+                    decoded[0] = '\b';
+                    break;
+                case 'f':
+                    decoded[0] = '\f';
+                    break;
+                case 'n':
+                    decoded[0] = '\n';
+                    break;
+                case 'r':
+                    decoded[0] = '\r';
+                    break;
+                case 't':
+                    decoded[0] = '\t';
+                    break;
+                case 'u': {
+                    uint32_t code;
+                    if (!flog_fields_read_hex(p + 1, end, &code)) {
+                        decoded[0] = *p;
+                        break;
+                    }
+                    p += UNICODE_ESCAPE_LEN;
+
+                    // Characters outside the basic multilingual plane are escaped as a
+                    // surrogate pair, and a surrogate without its pair is replaced
+                    uint32_t low;
+                    if (code >= 0xd800 && code < 0xdc00 && end - p > 2 && p[1] == '\\' && p[2] == 'u' &&
+                        flog_fields_read_hex(p + 3, end, &low) && low >= 0xdc00 && low < 0xe000) {
+                        code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                        p += 2 + UNICODE_ESCAPE_LEN;
+                    } else if (code == 0 || (code >= 0xd800 && code < 0xe000)) {
+                        code = UNICODE_REPLACEMENT;
+                    }
+
+                    decoded_len = flog_fields_encode_utf8(code, decoded);
+                    break;
+                }
+                default:
+                    // Quotes, backslashes, slashes and unknown escapes stand for the byte itself
+                    decoded[0] = *p;
+            }
+            p++;
+        }
+
+        if (len + decoded_len >= size) {
+            len = flog_fields_trim_character(buf, len, (unsigned char) decoded[0]);
+            break;
+        }
+
+        memcpy(buf + len, decoded, decoded_len);
+        len += decoded_len;
+    }
+
+    buf[len] = '\0';
+
+    return len;
+}
+
+size_t
+flog_fields_copy_text(const FlogField *field, char *buf, size_t size) {
+    assert(field != NULL);
+    assert(buf != NULL);
+    assert(size > 0);
+
+    static const char hex[] = "0123456789abcdef";
+
+    char value[MESSAGE_LEN];
+    size_t value_len = flog_fields_copy_value(field, value, sizeof(value));
+
+    // Control characters decoded from escapes are escaped as the sanitizer escapes them,
+    // and so are line endings, which would otherwise split a record in a text file
+    size_t len = 0;
+    for (size_t i = 0; i < value_len; i++) {
+        unsigned char c = (unsigned char) value[i];
+        bool control = c < CONTROL_MAX && c != '\t';
+
+        if (len + (control ? CONTROL_ESCAPE_LEN : 1) >= size) {
+            len = flog_fields_trim_character(buf, len, c);
+            break;
+        }
+
+        if (control) {
+            buf[len++] = '\\';
+            buf[len++] = 'x';
+            buf[len++] = hex[c >> 4];
+            buf[len++] = hex[c & 0xf];
+        } else {
+            buf[len++] = (char) c;
+        }
+    }
+
+    buf[len] = '\0';
+
+    return len;
+}
+
+size_t
+flog_fields_trim_character(const char *buf, size_t len, unsigned char next) {
+    // A character cut by the end of the buffer is removed whole
+    if ((next & 0xc0) == 0x80) {
+        while (len > 0 && ((unsigned char) buf[len - 1] & 0xc0) == 0x80) {
+            len--;
+        }
+        if (len > 0 && (unsigned char) buf[len - 1] >= 0xc0) {
+            len--;
+        }
+    }
+
+    return len;
+}
+
+size_t
+flog_fields_render(const FlogFields *fields, char *buf, size_t size, size_t len) {
+    assert(fields != NULL);
+    assert(buf != NULL);
+    assert(len < size);
+
+    char value[MESSAGE_LEN];
+
+    for (size_t i = 0; i < fields->count; i++) {
+        const FlogField *field = &fields->fields[i];
+        if (field->taken) {
+            continue;
+        }
+
+        size_t start = len;
+        bool fits = (len == 0 || flog_fields_append(buf, size, &len, " ", 1)) &&
+                    flog_fields_append(buf, size, &len, field->key, field->key_len);
+
+        if (fits && field->value != NULL) {
+            size_t value_len = flog_fields_copy_value(field, value, sizeof(value));
+            fits = flog_fields_append(buf, size, &len, "=", 1);
+            if (fits && flog_fields_needs_quotes(value, value_len)) {
+                fits = flog_fields_append_quoted(buf, size, &len, value, value_len);
+            } else if (fits) {
+                fits = flog_fields_append(buf, size, &len, value, value_len);
+            }
+        }
+
+        if (!fits) {
+            len = start;
+        }
+    }
+
+    buf[len] = '\0';
+
+    return len;
+}
+
+FlogConfigLevel
+flog_fields_parse_level(const char *str) {
+    assert(str != NULL);
+
+    // Other names follow the levels of Apple's Logger API
+    static const struct {
+        const char *name;
+        FlogConfigLevel level;
+    } names[] = {
+        { "default",   LVL_DEFAULT },
+        { "notice",    LVL_DEFAULT },
+        { "info",      LVL_INFO },
+        { "debug",     LVL_DEBUG },
+        { "trace",     LVL_DEBUG },
+        { "error",     LVL_ERROR },
+        { "err",       LVL_ERROR },
+        { "warn",      LVL_ERROR },
+        { "warning",   LVL_ERROR },
+        { "fault",     LVL_FAULT },
+        { "crit",      LVL_FAULT },
+        { "critical",  LVL_FAULT },
+        { "fatal",     LVL_FAULT },
+        { "panic",     LVL_FAULT },
+    };
+
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcasecmp(str, names[i].name) == 0) {
+            return names[i].level;
+        }
+    }
+
+    return LVL_UNKNOWN;
+}
+
+size_t
+flog_fields_scan_plain(const char *str, size_t len) {
+    assert(str != NULL);
+
+    // A word holds a byte below 0x20, or a byte that is zero once it is XORed with a
+    // quote or backslash, if subtracting one from each byte borrows into a high bit
+    // that was clear; the test is exact for the whole word but not for the bytes
+    // after the first match (see flog_fields_special_offset())
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, str + i, sizeof(word));
+
+        uint64_t special = flog_fields_special_bytes(word);
+        if (special != 0) {
+            return i + flog_fields_special_offset(str + i, special);
+        }
+    }
+
+    for (; i < len; i++) {
+        unsigned char c = (unsigned char) str[i];
+        if (c < CONTROL_MAX || c == '"' || c == '\\') {
+            break;
+        }
+    }
+
+    return i;
+}
+
+uint64_t
+flog_fields_special_bytes(uint64_t word) {
+    uint64_t quotes = word ^ (SWAR_ONES * '"');
+    uint64_t backslashes = word ^ (SWAR_ONES * '\\');
+    uint64_t special = ((word - SWAR_ONES * CONTROL_MAX) & ~word) | ((quotes - SWAR_ONES) & ~quotes) |
+                       ((backslashes - SWAR_ONES) & ~backslashes);
+
+    return special & SWAR_HIGHS;
+}
+
+size_t
+flog_fields_special_offset(const char *word, uint64_t special) {
+    // The lowest flagged byte is always a true match, as borrows only carry upwards;
+    // on little-endian hosts it is the first in memory, and otherwise the word is
+    // read again a byte at a time
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    (void) word;
+    return (size_t) __builtin_ctzll(special) / 8;
+#else
+    (void) special;
+    size_t i = 0;
+    while ((unsigned char) word[i] >= CONTROL_MAX && word[i] != '"' && word[i] != '\\') {
+        i++;
+    }
+    return i;
+#endif
+}
+
+bool
+flog_fields_parse_logfmt(FlogFields *fields, const char *p, const char *end) {
+    bool has_pair = false;
+
+    while ((p = flog_fields_skip_space(p, end)) < end) {
+        const char *key = p;
+        while (p < end && (unsigned char) *p > ' ' && *p != '=' && *p != '"') {
+            p++;
+        }
+
+        size_t key_len = (size_t) (p - key);
+        if (key_len == 0 || (p < end && *p == '"')) {
+            return false;
+        }
+
+        const char *value = NULL;
+        size_t value_len = 0;
+        bool quoted = false;
+
+        if (p < end && *p == '=') {
+            p++;
+            if (p < end && *p == '"') {
+                const char *close = flog_fields_skip_string(p + 1, end);
+                if (close == NULL) {
+                    return false;
+                }
+
+                value = p + 1;
+                value_len = (size_t) (close - value);
+                quoted = true;
+                p = close + 1;
+
+                if (p < end && (unsigned char) *p > ' ') {
+                    return false;
+                }
+            } else {
+                value = p;
+                while (p < end && (unsigned char) *p > ' ') {
+                    p++;
+                }
+                value_len = (size_t) (p - value);
+            }
+
+            has_pair = true;
+        }
+
+        if (!flog_fields_add(fields, key, key_len, value, value_len, quoted)) {
+            return false;
+        }
+    }
+
+    // Plain text reads as a list of keys without values, which is not taken as logfmt
+    return has_pair;
+}
+
+bool
+flog_fields_parse_json(FlogFields *fields, const char *p, const char *end) {
+    p = flog_fields_skip_space(p, end);
+    if (p == end || *p != '{') {
+        return false;
+    }
+
+    p = flog_fields_skip_space(p + 1, end);
+    if (p < end && *p == '}') {
+        return flog_fields_skip_space(p + 1, end) == end;
+    }
+
+    while (p < end && *p == '"') {
+        const char *key = p + 1;
+        const char *key_end = flog_fields_skip_string(key, end);
+        if (key_end == NULL) {
+            return false;
+        }
+
+        p = flog_fields_skip_space(key_end + 1, end);
+        if (p == end || *p != ':') {
+            return false;
+        }
+
+        p = flog_fields_skip_space(p + 1, end);
+        bool quoted = p < end && *p == '"';
+        const char *value = quoted ? p + 1 : p;
+        const char *value_end = quoted ? flog_fields_skip_string(value, end) : flog_fields_skip_json_value(value, end);
+        if (value_end == NULL) {
+            return false;
+        }
+
+        if (!flog_fields_add(fields, key, (size_t) (key_end - key), value, (size_t) (value_end - value), quoted)) {
+            return false;
+        }
+
+        p = flog_fields_skip_space(quoted ? value_end + 1 : value_end, end);
+        if (p < end && *p == '}') {
+            return flog_fields_skip_space(p + 1, end) == end;
+        } else if (p == end || *p != ',') {
+            return false;
+        }
+
+        p = flog_fields_skip_space(p + 1, end);
+    }
+
+    return false;
+}
+
+bool
+flog_fields_add(FlogFields *fields, const char *key, size_t key_len, const char *value, size_t value_len,
+                bool quoted) {
+    if (fields->count == FIELDS_MAX) {
+        return false;
+    }
+
+    fields->fields[fields->count++] = (FlogField) {
+        .key = key,
+        .key_len = key_len,
+        .value = value,
+        .value_len = value_len,
+        .quoted = quoted,
+        .taken = false
+    };
+
+    return true;
+}
+
+const char *
+flog_fields_skip_space(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+        p++;
+    }
+
+    return p;
+}
+
+const char *
+flog_fields_skip_string(const char *p, const char *end) {
+    while (p < end) {
+        p += flog_fields_scan_plain(p, (size_t) (end - p));
+        if (p == end) {
+            break;
+        } else if (*p == '"') {
+            return p;
+        }
+
+        // An escape takes the byte after the backslash with it; control characters are tolerated
+        if (*p == '\\' && ++p == end) {
+            break;
+        }
+        p++;
+    }
+
+    return NULL;
+}
+
+const char *
+flog_fields_skip_json_value(const char *p, const char *end) {
+    const char *start = p;
+
+    // Nested objects and arrays are matched by depth alone, skipping their strings
+    if (p < end && (*p == '{' || *p == '[')) {
+        size_t depth = 0;
+        for (; p < end; p++) {
+            if (*p == '"') {
+                p = flog_fields_skip_string(p + 1, end);
+                if (p == NULL) {
+                    return NULL;
+                }
+            } else if (*p == '{' || *p == '[') {
+                depth++;
+            } else if ((*p == '}' || *p == ']') && --depth == 0) {
+                return p + 1;
+            }
+        }
+
+        return NULL;
+    }
+
+    // Numbers, true, false and null run to the next delimiter
+    while (p < end && strchr(" \t\n\r,}]", *p) == NULL) {
+        p++;
+    }
+
+    return p > start ? p : NULL;
+}
+
+bool
+flog_fields_read_hex(const char *p, const char *end, uint32_t *code) {
+    if (end - p < UNICODE_ESCAPE_LEN) {
+        return false;
+    }
+
+    *code = 0;
+    for (size_t i = 0; i < UNICODE_ESCAPE_LEN; i++) {
+        char c = p[i];
+        uint32_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = (uint32_t) (c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = (uint32_t) (c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digit = (uint32_t) (c - 'A' + 10);
+        } else {
+            return false;
+        }
+        *code = *code * 16 + digit;
+    }
+
+    return true;
+}
+
+size_t
+flog_fields_encode_utf8(uint32_t code, char *out) {
+    if (code < 0x80) {
+        out[0] = (char) code;
+        return 1;
+    } else if (code < 0x800) {
+        out[0] = (char) (0xc0 | (code >> 6));
+        out[1] = (char) (0x80 | (code & 0x3f));
+        return 2;
+    } else if (code < 0x10000) {
+        out[0] = (char) (0xe0 | (code >> 12));
+        out[1] = (char) (0x80 | ((code >> 6) & 0x3f));
+        out[2] = (char) (0x80 | (code & 0x3f));
+        return 3;
+    }
+
+    out[0] = (char) (0xf0 | (code >> 18));
+    out[1] = (char) (0x80 | ((code >> 12) & 0x3f));
+    out[2] = (char) (0x80 | ((code >> 6) & 0x3f));
+    out[3] = (char) (0x80 | (code & 0x3f));
+    return 4;
+}
+
+bool
+flog_fields_needs_quotes(const char *value, size_t len) {
+    if (len == 0) {
+        return true;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        if ((unsigned char) value[i] <= ' ' || value[i] == '=' || value[i] == '"' || value[i] == '\\') {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool
+flog_fields_append(char *buf, size_t size, size_t *len, const char *str, size_t str_len) {
+    if (*len + str_len >= size) {
+        return false;
+    }
+
+    memcpy(buf + *len, str, str_len);
+    *len += str_len;
+
+    return true;
+}
+
+bool
+flog_fields_append_quoted(char *buf, size_t size, size_t *len, const char *value, size_t value_len) {
+    assert(buf != NULL);
+    assert(len != NULL);
+    assert(value != NULL);
+
+    // When even a value made entirely of escapes would fit, with room for the last word
+    // to be stored whole, the space left is not checked for each run and escape
+    size_t room = *len < size ? size - *len : 0;
+    if (room > sizeof(uint64_t) + 2 && value_len < (room - sizeof(uint64_t) - 2) / ESCAPE_MAX) {
+        *len = (size_t) (flog_fields_put_quoted(buf + *len, value, value_len) - buf);
+        return true;
+    }
+
+    if (!flog_fields_append(buf, size, len, "\"", 1)) {
+        return false;
+    }
+
+    // Runs of bytes that need no escape are copied whole, found by the vector scan that
+    // sanitizes messages, which also stops at quotes, backslashes and control characters
+    size_t i = 0;
+    while (i < value_len) {
+        size_t run = flog_sanitize_scan_quoted(value + i, value_len - i);
+        if (!flog_fields_append(buf, size, len, value + i, run)) {
+            return false;
+        }
+
+        i += run;
+        if (i == value_len) {
+            break;
+        }
+
+        char escape[ESCAPE_MAX];
+        size_t consumed = 1;
+        char *escape_end = (unsigned char) value[i] < NON_ASCII_MIN
+                         ? flog_fields_put_char(escape, (unsigned char) value[i])
+                         : flog_fields_put_sequence(escape, value + i, value_len - i, &consumed);
+        if (!flog_fields_append(buf, size, len, escape, (size_t) (escape_end - escape))) {
+            return false;
+        }
+        i += consumed;
+    }
+
+    return flog_fields_append(buf, size, len, "\"", 1);
+}
+
+char *
+flog_fields_put_quoted(char *out, const char *value, size_t value_len) {
+    *out++ = '"';
+
+    // Each word is stored before it is tested, so that a run of plain ASCII costs a load
+    // and a store per word; a word that needs an escape is written again a byte at a
+    // time, as escapes tend to come together, and one that holds a multi-byte sequence
+    // a character at a time, as the sequence is validated and may end beyond the word
+    size_t i = 0;
+    while (i + sizeof(uint64_t) <= value_len) {
+        uint64_t word;
+        memcpy(&word, value + i, sizeof(word));
+        memcpy(out, &word, sizeof(word));
+
+        if ((flog_fields_special_bytes(word) | (word & SWAR_HIGHS)) == 0) {
+            out += sizeof(word);
+            i += sizeof(word);
+            continue;
+        }
+
+        if ((word & SWAR_HIGHS) != 0) {
+            size_t next;
+            out = flog_fields_put_characters(out, value, value_len, i, i + sizeof(word), &next);
+            i = next;
+            continue;
+        }
+
+        for (size_t j = i; j < i + sizeof(word); j++) {
+            out = flog_fields_put_char(out, (unsigned char) value[j]);
+        }
+        i += sizeof(word);
+    }
+
+    for (; i < value_len && (unsigned char) value[i] < NON_ASCII_MIN; i++) {
+        out = flog_fields_put_char(out, (unsigned char) value[i]);
+    }
+
+    if (i < value_len) {
+        size_t next;
+        out = flog_fields_put_characters(out, value, value_len, i, value_len, &next);
+    }
+
+    *out++ = '"';
+
+    return out;
+}
+
+char *
+flog_fields_put_characters(char *out, const char *value, size_t value_len, size_t start, size_t end,
+                           size_t *next) {
+    // The position reached is passed back through its own pointer, so that the caller's
+    // index is never taken by address and stays in a register in the word loop
+    size_t i = start;
+    while (i < end) {
+        unsigned char c = (unsigned char) value[i];
+        if (c < NON_ASCII_MIN) {
+            out = flog_fields_put_char(out, c);
+            i++;
+        } else {
+            size_t consumed;
+            out = flog_fields_put_sequence(out, value + i, value_len - i, &consumed);
+            i += consumed;
+        }
+    }
+
+    *next = i;
+    return out;
+}
+
+char *
+flog_fields_put_sequence(char *out, const char *value, size_t len, size_t *consumed) {
+    // Invalid sequences are replaced with U+FFFD, so that the string is always valid
+    // JSON; the replacement is no longer than the escape of a single byte
+    bool valid;
+    *consumed = flog_sanitize_sequence_length(value, len, &valid);
+    if (valid) {
+        memcpy(out, value, *consumed);
+        return out + *consumed;
+    }
+
+    memcpy(out, SANITIZE_REPLACEMENT, REPLACEMENT_LEN);
+
+    return out + REPLACEMENT_LEN;
+}
+
+char *
+flog_fields_put_char(char *out, unsigned char c) {
+    static const char hex[] = "0123456789abcdef";
+
+    char escape = json_escapes[c];
+    if (escape == 0) {
+        *out = (char) c;
+        return out + 1;
+    }
+
+    out[0] = '\\';
+    if (escape != 'u') {
+        out[1] = escape;
+        return out + 2;
+    }
+
+    memcpy(out + 1, "u00", 3);
+    out[4] = hex[c >> 4];
+    out[5] = hex[c & 0xf];
+
+    return out + ESCAPE_MAX;
+}
@@ -0,0 +1,204 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_FIELDS_H
+#define FLOG_FIELDS_H
+
+/*! \file fields.h
+ *
+ *  Helper functions for reading the fields of structured messages.
+ *
+ *  A message written as logfmt (\c key=value pairs separated by spaces, with values
+ *  that contain spaces quoted) or as a JSON object is parsed into a table of fields,
+ *  each a pair of slices of the message itself, so that nothing is copied or
+ *  allocated for a field until its value is needed. Quoted values are left escaped
+ *  in the message and decoded by flog_fields_copy_value(); nested JSON objects and
+ *  arrays are kept as the raw text of the value.
+ *
+ *  Quoted strings are scanned a 64-bit word at a time for the quotes, backslashes and
+ *  control characters that end a run of plain bytes (see flog_fields_scan_plain()),
+ *  rather than a byte at a time.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "config.h"
+
+#define FIELDS_MAX 64
+
+/*! \brief A type representing a field of a message, which refers to the message text. */
+typedef struct FlogFieldData {
+    const char *key;
+    size_t key_len;
+    // NULL for a logfmt key given without a value
+    const char *value;
+    size_t value_len;
+    // Set for the content of a quoted string, which may hold escapes
+    bool quoted;
+    // Set by the caller for fields that have been taken from the table
+    bool taken;
+} FlogField;
+
+/*! \brief A type representing the fields of a message. */
+typedef struct FlogFieldsData {
+    FlogField fields[FIELDS_MAX];
+    size_t count;
+} FlogFields;
+
+/*! \brief Parse the fields of a message.
+ *
+ *  A message is read as logfmt if it holds at least one \c key=value pair and nothing
+ *  that is not a key, a pair or a space, and as JSON if it holds a single object with
+ *  at most \c FIELDS_MAX members.
+ *
+ *  \param[out] fields  A pointer to the FlogFields object to fill, whose fields refer to
+ *                      \c message and are valid for as long as it is
+ *  \param[in]  format  The format of the message, FLD_LOGFMT or FLD_JSON
+ *  \param[in]  message A pointer to the null-terminated message
+ *
+ *  \pre \c fields is \e not \c NULL
+ *  \pre \c format is FLD_LOGFMT or FLD_JSON
+ *  \pre \c message is \e not \c NULL
+ *
+ *  \return \c true if the message was parsed, or \c false if it is not in the format
+ *          or has more than \c FIELDS_MAX fields
+ */
+bool flog_fields_parse(FlogFields *fields, FlogConfigFields format, const char *message);
+
+/*! \brief Find the first field with one of a list of keys that has not been taken.
+ *
+ *  \param fields A pointer to the FlogFields object
+ *  \param keys   A pointer to a \c NULL terminated list of null-terminated keys, in
+ *                order of preference
+ *
+ *  \pre \c fields is \e not \c NULL
+ *  \pre \c keys is \e not \c NULL
+ *
+ *  \return A pointer to the field, or \c NULL if no field has any of the keys
+ */
+FlogField * flog_fields_find(FlogFields *fields, const char *const *keys);
+
+/*! \brief Copy the value of a field, decoding any escapes.
+ *
+ *  The value is truncated at a UTF-8 character boundary if it does not fit.
+ *
+ *  \param field A pointer to the field
+ *  \param buf   A pointer to the buffer that receives the null-terminated value
+ *  \param size  The size of the buffer in bytes
+ *
+ *  \pre \c field is \e not \c NULL
+ *  \pre \c buf is \e not \c NULL
+ *  \pre \c size is \e not zero
+ *
+ *  \return The length of the copied value in bytes
+ */
+size_t flog_fields_copy_value(const FlogField *field, char *buf, size_t size);
+
+/*! \brief Copy the value of a field to be logged as text, decoding any escapes.
+ *
+ *  Control characters other than tabs, including those decoded from escapes such as
+ *  \c \\n and \c \\u001b, are escaped as \c \\xHH, so that a value cannot carry a
+ *  terminal escape sequence or a line ending into the log. The value is truncated at a
+ *  UTF-8 character boundary if it does not fit.
+ *
+ *  \param field A pointer to the field
+ *  \param buf   A pointer to the buffer that receives the null-terminated value
+ *  \param size  The size of the buffer in bytes
+ *
+ *  \pre \c field is \e not \c NULL
+ *  \pre \c buf is \e not \c NULL
+ *  \pre \c size is \e not zero
+ *
+ *  \return The length of the copied value in bytes
+ */
+size_t flog_fields_copy_text(const FlogField *field, char *buf, size_t size);
+
+/*! \brief Append the fields that have not been taken to a string as logfmt.
+ *
+ *  Each field is separated from the text before it by a space, and its value is
+ *  quoted if it is empty or holds a space, '=', a quote, a backslash or a control
+ *  character. Fields that do not fit whole in the buffer are left out.
+ *
+ *  \param fields A pointer to the FlogFields object
+ *  \param buf    A pointer to the buffer holding the null-terminated string
+ *  \param size   The size of the buffer in bytes
+ *  \param len    The length of the string in the buffer
+ *
+ *  \pre \c fields is \e not \c NULL
+ *  \pre \c buf is \e not \c NULL
+ *  \pre \c len is less than \c size
+ *
+ *  \return The length of the string after the fields are appended
+ */
+size_t flog_fields_render(const FlogFields *fields, char *buf, size_t size, size_t len);
+
+/*! \brief Parse a log level as named by common logging libraries.
+ *
+ *  Level names are matched in any case. Besides the names of the FlogConfigLevel
+ *  values, \c trace is read as debug, \c notice as default, \c warn, \c warning and
+ *  \c err as error, and \c crit, \c critical, \c fatal and \c panic as fault.
+ *
+ *  \param str A pointer to the null-terminated level name
+ *
+ *  \pre \c str is \e not \c NULL
+ *
+ *  \return A FlogConfigLevel value representing the log level, or LVL_UNKNOWN
+ */
+FlogConfigLevel flog_fields_parse_level(const char *str);
+
+/*! \brief Measure the run of bytes at the start of a string that need no escaping.
+ *
+ *  \param str A pointer to the string
+ *  \param len The length of the string in bytes
+ *
+ *  \pre \c str is \e not \c NULL
+ *
+ *  \return The number of bytes before the first double quote, backslash or control
+ *          character below 0x20, or \c len if there is none
+ */
+size_t flog_fields_scan_plain(const char *str, size_t len);
+
+/*! \brief Append a string to a buffer as a double-quoted JSON string.
+ *
+ *  Double quotes, backslashes and control characters below 0x20 are escaped, and each
+ *  invalid UTF-8 sequence is replaced with U+FFFD, so the result is always valid JSON.
+ *  When the buffer has room for every byte to be escaped, the string is copied a 64-bit
+ *  word at a time, and only the words that hold a byte to be escaped or a multi-byte
+ *  sequence are copied a character at a time; otherwise the runs that need no escape
+ *  are found with flog_sanitize_scan_quoted() and copied whole. Nothing is appended
+ *  that would leave no room in the buffer for a null terminator.
+ *
+ *  \param[out]    buf       A pointer to the buffer
+ *  \param[in]     size      The size of the buffer in bytes
+ *  \param[in,out] len       A pointer to the length of the buffer contents, which is
+ *                           advanced past the appended string
+ *  \param[in]     value     A pointer to the string
+ *  \param[in]     value_len The length of the string in bytes
+ *
+ *  \pre \c buf, \c len and \c value are \e not \c NULL
+ *
+ *  \return \c true if the whole quoted string was appended, or \c false if it did not
+ *          fit, in which case part of it may have been appended
+ */
+bool flog_fields_append_quoted(char *buf, size_t size, size_t *len, const char *value, size_t value_len);
+
+#endif //FLOG_FIELDS_H
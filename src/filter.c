@@ -0,0 +1,294 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "filter.h"
+#include "pattern.h"
+#include <assert.h>
+#include <regex.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef UNIT_TESTING
+#include "../test/testing.h"
+#endif
+
+/*! \brief A type representing the compiled patterns of one kind. */
+typedef struct FilterPatternSet {
+    // Literal patterns form an automaton with a transition for every state and byte
+    // class, where bytes that appear in no literal share class zero
+    uint32_t *transitions;
+    bool *accepting;
+    size_t class_count;
+    uint8_t classes[UINT8_MAX + 1];
+    bool has_literals;
+    regex_t regex;
+    bool has_regex;
+} FilterPatternSet;
+
+struct FlogFilterData {
+    FilterPatternSet sets[FLT_EXCLUDE + 1];
+};
+
+FlogError flog_filter_compile_set(FilterPatternSet *set, const FlogConfig *config, FlogConfigFilter kind);
+
+FlogError flog_filter_build_automaton(FilterPatternSet *set, char *const *literals, const size_t *lens,
+                                      size_t count);
+
+FlogError flog_filter_build_regex(FilterPatternSet *set, const char *const *patterns, size_t count);
+
+void flog_filter_free_set(FilterPatternSet *set);
+
+bool flog_filter_matches(const FilterPatternSet *set, const char *message);
+
+FlogFilter *
+flog_filter_new(const FlogConfig *config, FlogError *error) {
+    assert(config != NULL);
+    assert(error != NULL);
+
+    *error = FLOG_ERROR_NONE;
+
+    FlogFilter *filter = calloc(1, sizeof(struct FlogFilterData));
+    if (filter == NULL) {
+        *error = FLOG_ERROR_ALLOC;
+        return NULL;
+    }
+
+    *error = flog_filter_compile_set(&filter->sets[FLT_INCLUDE], config, FLT_INCLUDE);
+    if (*error == FLOG_ERROR_NONE) {
+        *error = flog_filter_compile_set(&filter->sets[FLT_EXCLUDE], config, FLT_EXCLUDE);
+    }
+
+    if (*error != FLOG_ERROR_NONE) {
+        flog_filter_free(filter);
+        return NULL;
+    }
+
+    return filter;
+}
+
+void
+flog_filter_free(FlogFilter *filter) {
+    assert(filter != NULL);
+
+    flog_filter_free_set(&filter->sets[FLT_INCLUDE]);
+    flog_filter_free_set(&filter->sets[FLT_EXCLUDE]);
+
+    free(filter);
+}
+
+bool
+flog_filter_accepts(const FlogFilter *filter, const char *message) {
+    assert(filter != NULL);
+    assert(message != NULL);
+
+    const FilterPatternSet *include = &filter->sets[FLT_INCLUDE];
+    if ((include->has_literals || include->has_regex) && !flog_filter_matches(include, message)) {
+        return false;
+    }
+
+    return !flog_filter_matches(&filter->sets[FLT_EXCLUDE], message);
+}
+
+FlogError
+flog_filter_compile_set(FilterPatternSet *set, const FlogConfig *config, FlogConfigFilter kind) {
+    size_t count = flog_config_get_filter_count(config, kind);
+    if (count == 0) {
+        return FLOG_ERROR_NONE;
+    }
+
+    char *literals[FILTER_PATTERN_MAX] = { NULL };
+    size_t lens[FILTER_PATTERN_MAX];
+    size_t literal_count = 0;
+    const char *patterns[FILTER_PATTERN_MAX];
+    size_t pattern_count = 0;
+    FlogError error = FLOG_ERROR_NONE;
+
+    for (size_t i = 0; i < count && error == FLOG_ERROR_NONE; i++) {
+        const char *pattern = flog_config_get_filter_at(config, kind, i);
+
+        // Every pattern is checked alone, so that joining them cannot change how any is read
+        if (!flog_pattern_is_valid(pattern)) {
+            error = FLOG_ERROR_FILTER;
+            break;
+        }
+
+        char *literal = malloc(strlen(pattern) + 1);
+        if (literal == NULL) {
+            error = FLOG_ERROR_ALLOC;
+            break;
+        }
+
+        if (flog_pattern_get_literal(pattern, literal, &lens[literal_count])) {
+            literals[literal_count++] = literal;
+        } else {
+            free(literal);
+            patterns[pattern_count++] = pattern;
+        }
+    }
+
+    if (error == FLOG_ERROR_NONE && literal_count > 0) {
+        error = flog_filter_build_automaton(set, literals, lens, literal_count);
+    }
+
+    if (error == FLOG_ERROR_NONE && pattern_count > 0) {
+        error = flog_filter_build_regex(set, patterns, pattern_count);
+    }
+
+    for (size_t i = 0; i < literal_count; i++) {
+        free(literals[i]);
+    }
+
+    return error;
+}
+
+FlogError
+flog_filter_build_automaton(FilterPatternSet *set, char *const *literals, const size_t *lens, size_t count) {
+    // Each byte that appears in a literal gets a class of its own
+    size_t state_max = 1;
+    set->class_count = 1;
+    for (size_t i = 0; i < count; i++) {
+        state_max += lens[i];
+        for (size_t j = 0; j < lens[i]; j++) {
+            uint8_t byte = (uint8_t) literals[i][j];
+            if (set->classes[byte] == 0) {
+                set->classes[byte] = (uint8_t) set->class_count++;
+            }
+        }
+    }
+
+    set->transitions = calloc(state_max * set->class_count, sizeof(uint32_t));
+    set->accepting = calloc(state_max, sizeof(bool));
+    uint32_t *fail = calloc(state_max, sizeof(uint32_t));
+    uint32_t *queue = calloc(state_max, sizeof(uint32_t));
+    if (set->transitions == NULL || set->accepting == NULL || fail == NULL || queue == NULL) {
+        free(fail);
+        free(queue);
+        return FLOG_ERROR_ALLOC;
+    }
+
+    set->has_literals = true;
+
+    // Build the trie of the literals; the root is never a child, so zero marks a
+    // missing transition
+    uint32_t state_count = 1;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t state = 0;
+        for (size_t j = 0; j < lens[i]; j++) {
+            uint32_t *next = &set->transitions[state * set->class_count + set->classes[(uint8_t) literals[i][j]]];
+            if (*next == 0) {
+                *next = state_count++;
+            }
+            state = *next;
+        }
+        set->accepting[state] = true;
+    }
+
+    // Visit the states breadth first, so that the failure state of each, which is
+    // shallower, is complete before it is used to fill in missing transitions
+    size_t head = 0;
+    size_t tail = 0;
+    for (size_t c = 0; c < set->class_count; c++) {
+        uint32_t child = set->transitions[c];
+        if (child != 0) {
+            queue[tail++] = child;
+        }
+    }
+
+    while (head < tail) {
+        uint32_t state = queue[head++];
+        set->accepting[state] = set->accepting[state] || set->accepting[fail[state]];
+
+        uint32_t *row = &set->transitions[state * set->class_count];
+        const uint32_t *fail_row = &set->transitions[fail[state] * set->class_count];
+        for (size_t c = 0; c < set->class_count; c++) {
+            if (row[c] != 0) {
+                fail[row[c]] = fail_row[c];
+                queue[tail++] = row[c];
+            } else {
+                row[c] = fail_row[c];
+            }
+        }
+    }
+
+    free(fail);
+    free(queue);
+
+    return FLOG_ERROR_NONE;
+}
+
+FlogError
+flog_filter_build_regex(FilterPatternSet *set, const char *const *patterns, size_t count) {
+    size_t len = 0;
+    for (size_t i = 0; i < count; i++) {
+        len += strlen(patterns[i]) + 3;
+    }
+
+    char *alternation = malloc(len);
+    if (alternation == NULL) {
+        return FLOG_ERROR_ALLOC;
+    }
+
+    // Each pattern is grouped, so that an alternation within it stays within it
+    char *end = alternation;
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) {
+            *end++ = '|';
+        }
+        *end++ = '(';
+        size_t pattern_len = strlen(patterns[i]);
+        memcpy(end, patterns[i], pattern_len);
+        end += pattern_len;
+        *end++ = ')';
+    }
+    *end = '\0';
+
+    set->has_regex = flog_pattern_compile(&set->regex, alternation);
+    free(alternation);
+
+    return set->has_regex ? FLOG_ERROR_NONE : FLOG_ERROR_FILTER;
+}
+
+void
+flog_filter_free_set(FilterPatternSet *set) {
+    free(set->transitions);
+    free(set->accepting);
+
+    if (set->has_regex) {
+        regfree(&set->regex);
+    }
+}
+
+bool
+flog_filter_matches(const FilterPatternSet *set, const char *message) {
+    if (set->has_literals) {
+        uint32_t state = 0;
+        for (const unsigned char *p = (const unsigned char *) message; *p != '\0'; p++) {
+            state = set->transitions[state * set->class_count + set->classes[*p]];
+            if (set->accepting[state]) {
+                return true;
+            }
+        }
+    }
+
+    return set->has_regex && regexec(&set->regex, message, 0, NULL, 0) == 0;
+}
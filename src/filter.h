@@ -0,0 +1,87 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_FILTER_H
+#define FLOG_FILTER_H
+
+/*! \file filter.h
+ *
+ *  Filter object and associated functions for selecting the records that are logged.
+ *
+ *  A record is logged if it matches any include pattern, or there are none, and
+ *  matches no exclude pattern. Patterns are POSIX extended regular expressions that
+ *  match anywhere in a record, and are compiled once when the filter is created.
+ *
+ *  Patterns that contain no operators (see flog_pattern_get_literal()) are matched
+ *  together by an Aho-Corasick automaton, which examines each byte of a record once
+ *  however many literal patterns there are. The remaining patterns of each kind are
+ *  joined into a single alternation, so that each record is matched against one
+ *  compiled expression rather than against each pattern in turn.
+ */
+
+#include <stdbool.h>
+#include "config.h"
+#include "common.h"
+
+/*! \struct FlogFilter
+ *
+ *  \brief An opaque type representing a FlogFilter record filter object.
+ */
+typedef struct FlogFilterData FlogFilter;
+
+/*! \brief Create a FlogFilter object from the filter patterns of a FlogConfig object.
+ *
+ *  \param[in]  config A pointer to the FlogConfig object
+ *  \param[out] error  A pointer to a FlogError object that will be used to represent
+ *                     an error condition on failure
+ *
+ *  \pre \c config is \e not \c NULL
+ *  \pre \c error is \e not \c NULL
+ *
+ *  \return If successful, a pointer to a FlogFilter object; if there is an error a
+ *          \c NULL pointer is returned and \c error will be set to FLOG_ERROR_FILTER
+ *          if a pattern is invalid, or FLOG_ERROR_ALLOC if memory could not be
+ *          allocated
+ */
+FlogFilter * flog_filter_new(const FlogConfig *config, FlogError *error);
+
+/*! \brief Free a FlogFilter object.
+ *
+ *  \param filter A pointer to the FlogFilter object
+ *
+ *  \pre \c filter is \e not \c NULL
+ */
+void flog_filter_free(FlogFilter *filter);
+
+/*! \brief Determine whether a record passes a filter and should be logged.
+ *
+ *  \param filter  A pointer to the FlogFilter object
+ *  \param message A pointer to the null-terminated record
+ *
+ *  \pre \c filter is \e not \c NULL
+ *  \pre \c message is \e not \c NULL
+ *
+ *  \return \c true if the record should be logged, otherwise \c false
+ */
+bool flog_filter_accepts(const FlogFilter *filter, const char *message);
+
+#endif //FLOG_FILTER_H
@@ -24,7 +24,32 @@
 #include <os/log.h>
 #include <sys/stat.h>
 #include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syslimits.h>
+#include <sys/wait.h>
+#include "assembler.h"
+#include "binlog.h"
+#include "dedup.h"
+#include "fields.h"
+#include "filter.h"
+#include "jsonl.h"
+#include "limiter.h"
+#include "prefix.h"
+#include "record.h"
+#include "router.h"
+#include "sample.h"
+#include "redact.h"
+#include "writer.h"
 #include "common.h"
 #include "config.h"
 
@@ -34,13 +59,133 @@
 
 #define OS_LOG_FORMAT_PUBLIC "%{public}s"
 #define OS_LOG_FORMAT_PRIVATE "%{private}s"
+#define LOG_CACHE_SIZE 8
+#define BINLOG_CACHE_SIZE 8
+
+// The keys of the fields a message's options are taken from, in order of preference
+static const char *const level_keys[] = { "level", "lvl", "severity", NULL };
+static const char *const subsystem_keys[] = { "subsystem", NULL };
+static const char *const category_keys[] = { "category", NULL };
+static const char *const message_keys[] = { "msg", "message", NULL };
+#define BATCH_LINE_LEN 16384
+#define SERVE_REPLY_PREFIX '?'
+#define SERVE_REPLY_SUCCESS '0'
+#define SERVE_REPLY_FAILURE '1'
+#define EXEC_STREAM_COUNT 2
+#define EXEC_BUFFER_SIZE 65536
+#define EXEC_PIPE_SIZE 1048576
+#define TEE_PIPE_SIZE 1048576
+#define SUMMARY_LEN 64
+#define RATE_STATE_NAME "flog-ratelimit"
+
+/*! \brief A log object created for a subsystem and category. */
+typedef struct FlogCliLogData {
+    char subsystem[SUBSYSTEM_LEN];
+    char category[CATEGORY_LEN];
+    os_log_t log;
+} FlogCliLog;
+
+/*! \brief A binary log writer held open for an append file path. */
+typedef struct FlogCliBinlogData {
+    char *path;
+    FlogBinlogWriter *writer;
+} FlogCliBinlog;
+
+/*! \brief A pipe from which the output of a command, or stdin, is read and logged by line,
+ *         or by record when its lines are joined by an assembler.
+ */
+typedef struct FlogCliStreamData {
+    const char *name;
+    int fd;
+    FlogConfigLevel level;
+    bool append;
+    size_t line_number;
+    FlogAssembler *assembler;
+    size_t record_line_number;
+    int record_wait;
+    int64_t record_time;
+    size_t len;
+    char buffer[EXEC_BUFFER_SIZE + 1];
+} FlogCliStream;
+
+extern char **environ;
 
 void flog_commit_public_message(FlogCli *flog);
 void flog_commit_private_message(FlogCli *flog);
+FlogError flog_append_message_binary(FlogCli *flog);
+os_log_t flog_cli_get_log(FlogCli *flog, const char *subsystem, const char *category);
+FlogBinlogWriter * flog_cli_get_binlog(FlogCli *flog, const char *path, FlogError *error);
+bool flog_cli_is_blank_line(const char *line);
+FlogError flog_cli_log_line(FlogCli *flog, FlogConfig *config, char *line);
+FlogError flog_cli_serve_request(FlogCli *flog, FlogConfig *config, char *request, bool overflow, int reply_fd);
+FlogError flog_cli_init_filter(FlogCli *flog, const FlogConfig *config);
+bool flog_cli_accepts_message(const FlogCli *flog, const char *message);
+FlogError flog_cli_init_dedup(FlogCli *flog, FlogConfig *config);
+void flog_cli_free_dedup(FlogCli *flog);
+FlogError flog_cli_init_limiter(FlogCli *flog, const FlogConfig *config, bool shared);
+void flog_cli_free_limiter(FlogCli *flog);
+bool flog_cli_is_single_message(const FlogConfig *config);
+FlogError flog_cli_init_summary_config(FlogCli *flog, FlogConfig *config);
+void flog_cli_init_sampling(FlogCli *flog, const FlogConfig *config);
+FlogError flog_cli_screen_message(FlogCli *flog, FlogConfig *config, bool *accepted);
+FlogError flog_cli_extract_fields(FlogConfig *config);
+FlogError flog_cli_log_summaries(FlogCli *flog, int64_t now);
+FlogError flog_cli_log_summary(FlogCli *flog, const char *subsystem, const char *category, FlogConfigLevel level,
+                               const char *message);
+int flog_cli_get_dedup_timeout(const FlogCli *flog);
+int flog_cli_min_timeout(int timeout, int other_timeout);
+FlogError flog_cli_await_summaries(FlogCli *flog, int fd);
+FlogError flog_cli_open_stream(FlogCliStream *stream, int *write_fd);
+FlogError flog_cli_init_stream(FlogCliStream *stream, const FlogConfig *config);
+void flog_cli_destroy_stream(FlogCliStream *stream);
+FlogError flog_cli_poll_streams(FlogCli *flog, FlogConfig *config, FlogCliStream streams[], size_t count,
+                                FlogError read_error);
+FlogError flog_cli_await_stream(FlogCli *flog, FlogConfig *config, FlogCliStream *stream);
+int flog_cli_get_stream_timeout(const FlogCliStream *stream);
+int64_t flog_cli_get_time_ms(void);
+int64_t flog_cli_get_time_ns(void);
+FlogError flog_cli_read_stream(FlogCli *flog, FlogConfig *config, FlogCliStream *stream, FlogError read_error);
+FlogError flog_cli_log_stream_lines(FlogCli *flog, FlogConfig *config, FlogCliStream *stream, bool closed);
+FlogError flog_cli_tee_copy(FlogCli *flog, FlogConfig *config, FlogCliStream *stream, FlogWriter *writers[],
+                            size_t writer_count);
+#ifdef __linux__
+FlogError flog_cli_tee_splice(FlogCli *flog, FlogConfig *config, FlogCliStream *stream, const char *path,
+                              bool *unsupported);
+#endif
+FlogError flog_cli_open_router(FlogCli *flog, FlogConfig *config);
+
+FlogWriter * flog_cli_open_tee_writer(FlogConfig *config, const char *path, bool create_parents, FlogError *error);
+FlogError flog_cli_log_stream_line(FlogCli *flog, FlogConfig *config, FlogCliStream *stream, const char *line);
+FlogError flog_cli_flush_stream_record(FlogCli *flog, FlogConfig *config, FlogCliStream *stream);
+FlogError flog_cli_log_stream_message(FlogCli *flog, FlogConfig *config, FlogCliStream *stream, const char *message,
+                                      size_t line_number);
 
 struct FlogCliData {
     FlogConfig *config;
     os_log_t log;
+    FlogRouter *router;
+    FlogPrefix *prefix;
+    // Allocated on first use, as a JSON record may need several times the message length
+    char *json;
+    FlogFilter *filter;
+    // Sample rates and redaction are taken from the configuration of the run, as batch
+    // lines have none
+    double sample_rates[LVL_UNKNOWN];
+    unsigned int redact;
+    FlogDedup *dedup;
+    FlogLimiter *limiter;
+    // Summaries of repeated and suppressed messages are logged with a configuration of
+    // their own, so that the configuration of the message that made them due is left intact
+    FlogConfig *summary_config;
+    // Log objects are kept for reuse by batch file lines with the same subsystem and category
+    FlogCliLog logs[LOG_CACHE_SIZE];
+    size_t log_count;
+    size_t log_next;
+    // Binary append files are held open, with their interned strings, for the records that follow
+    FlogCliBinlog binlogs[BINLOG_CACHE_SIZE];
+    size_t binlog_count;
+    size_t binlog_next;
+    int exit_status;
 };
 
 FlogCli *
@@ -57,13 +202,7 @@ flog_cli_new(FlogConfig *config, FlogError *error) {
     }
 
     flog_cli_set_config(flog, config);
-
-    const char *subsystem = flog_config_get_subsystem(config);
-    if (strlen(subsystem) != 0) {
-        flog->log = os_log_create(flog_config_get_subsystem(config), flog_config_get_category(config));
-    } else {
-        flog->log = OS_LOG_DEFAULT;
-    }
+    flog_cli_init_sampling(flog, config);
 
     return flog;
 }
@@ -72,8 +211,34 @@ void
 flog_cli_free(FlogCli *flog) {
     assert(flog != NULL);
 
-    if (flog->log != NULL && flog->log != OS_LOG_DEFAULT) {
-        os_release(flog->log);
+    for (size_t i = 0; i < flog->log_count; i++) {
+        os_release(flog->logs[i].log);
+    }
+
+    for (size_t i = 0; i < flog->binlog_count; i++) {
+        flog_binlog_writer_free(flog->binlogs[i].writer);
+        free(flog->binlogs[i].path);
+    }
+
+    if (flog->router != NULL) {
+        flog_router_free(flog->router);
+    }
+
+    if (flog->prefix != NULL) {
+        flog_prefix_free(flog->prefix);
+    }
+
+    free(flog->json);
+
+    if (flog->filter != NULL) {
+        flog_filter_free(flog->filter);
+    }
+
+    flog_cli_free_dedup(flog);
+    flog_cli_free_limiter(flog);
+
+    if (flog->summary_config != NULL) {
+        flog_config_free(flog->summary_config);
     }
 
     free(flog);
@@ -92,41 +257,1692 @@ flog_cli_set_config(FlogCli *flog, FlogConfig *config) {
     assert(config != NULL);
 
     flog->config = config;
+    flog->log = flog_cli_get_log(flog, flog_config_get_subsystem(config), flog_config_get_category(config));
 }
 
-void
-flog_commit_message(FlogCli *flog) {
+os_log_t
+flog_cli_get_log(FlogCli *flog, const char *subsystem, const char *category) {
+    if (strlen(subsystem) == 0) {
+        return OS_LOG_DEFAULT;
+    }
+
+    for (size_t i = 0; i < flog->log_count; i++) {
+        if (strcmp(flog->logs[i].subsystem, subsystem) == 0 && strcmp(flog->logs[i].category, category) == 0) {
+            return flog->logs[i].log;
+        }
+    }
+
+    FlogCliLog *entry;
+    if (flog->log_count < LOG_CACHE_SIZE) {
+        entry = &flog->logs[flog->log_count++];
+    } else {
+        entry = &flog->logs[flog->log_next];
+        flog->log_next = (flog->log_next + 1) % LOG_CACHE_SIZE;
+        os_release(entry->log);
+    }
+
+    strlcpy(entry->subsystem, subsystem, SUBSYSTEM_LEN);
+    strlcpy(entry->category, category, CATEGORY_LEN);
+    entry->log = os_log_create(subsystem, category);
+
+    return entry->log;
+}
+
+FlogBinlogWriter *
+flog_cli_get_binlog(FlogCli *flog, const char *path, FlogError *error) {
+    *error = FLOG_ERROR_NONE;
+
+    for (size_t i = 0; i < flog->binlog_count; i++) {
+        if (strcmp(flog->binlogs[i].path, path) == 0) {
+            return flog->binlogs[i].writer;
+        }
+    }
+
+    char *copy = strdup(path);
+    if (copy == NULL) {
+        *error = FLOG_ERROR_ALLOC;
+        return NULL;
+    }
+
+    FlogBinlogWriter *writer = flog_binlog_writer_new(path, error);
+    if (writer == NULL) {
+        free(copy);
+        return NULL;
+    }
+
+    FlogCliBinlog *entry;
+    if (flog->binlog_count < BINLOG_CACHE_SIZE) {
+        entry = &flog->binlogs[flog->binlog_count++];
+    } else {
+        entry = &flog->binlogs[flog->binlog_next];
+        flog->binlog_next = (flog->binlog_next + 1) % BINLOG_CACHE_SIZE;
+        flog_binlog_writer_free(entry->writer);
+        free(entry->path);
+    }
+
+    entry->path = copy;
+    entry->writer = writer;
+
+    return writer;
+}
+
+FlogError
+flog_cli_run(FlogCli *flog) {
     assert(flog != NULL);
 
     FlogConfig *config = flog_cli_get_config(flog);
-    if (flog_config_get_message_type(config) == MSG_PUBLIC) {
-        flog_commit_public_message(flog);
-    } else if (flog_config_get_message_type(config) == MSG_PRIVATE) {
-        flog_commit_private_message(flog);
+    const char *batch_file = flog_config_get_batch_file(config);
+    FlogError result = FLOG_ERROR_NONE;
+
+    flog->exit_status = 0;
+
+    FlogError init_error = flog_cli_init_screening(flog, config, flog_cli_is_single_message(config));
+    if (init_error != FLOG_ERROR_NONE) {
+        flog_print_error(init_error);
+        return init_error;
+    }
+
+    // Errors on individual lines and requests are reported with their number as they occur
+    if (flog_config_get_serve_flag(config)) {
+        result = flog_cli_serve(flog, STDIN_FILENO, STDOUT_FILENO);
+    } else if (flog_config_get_exec_flag(config)) {
+        result = flog_cli_exec(flog);
+    } else if (flog_config_get_tee_flag(config)) {
+        result = flog_cli_tee(flog, STDIN_FILENO, flog_config_get_splice_flag(config));
+    } else if (flog_config_get_multiline_flag(config)) {
+        result = flog_cli_read_records(flog, STDIN_FILENO);
+    } else if (strlen(batch_file) > 0) {
+        FILE *stream = strcmp(batch_file, "-") == 0 ? stdin : fopen(batch_file, "r");
+        if (stream == NULL) {
+            flog_print_error(FLOG_ERROR_BATCH);
+            return FLOG_ERROR_BATCH;
+        }
+
+        result = flog_cli_run_batch(flog, stream);
+        if (stream != stdin) {
+            fclose(stream);
+        }
+    } else {
+        bool accepted = false;
+        FlogError error = flog_cli_screen_message(flog, config, &accepted);
+        if (error != FLOG_ERROR_NONE) {
+            flog_print_error(error);
+            result = error;
+        }
+
+        if (accepted) {
+            // The subsystem and category may have been taken from the fields of the message
+            flog_cli_set_config(flog, config);
+
+            error = flog_append_message_output(flog);
+            if (error != FLOG_ERROR_NONE) {
+                flog_print_error(error);
+                return error;
+            }
+
+            flog_commit_message(flog);
+        }
+    }
+
+    // Repeats and suppressed messages still being counted at the end of the input are summarised
+    FlogError error = flog_cli_log_summaries(flog, INT64_MAX);
+    flog_cli_free_dedup(flog);
+    flog_cli_free_limiter(flog);
+    if (error != FLOG_ERROR_NONE) {
+        flog_print_error(error);
+        result = error;
+    }
+
+    error = flog_cli_flush(flog);
+    if (error != FLOG_ERROR_NONE) {
+        flog_print_error(error);
+        return error;
+    }
+
+    if (flog_config_get_stats_flag(config)) {
+        flog_cli_print_stats(flog);
+    }
+
+    return result;
+}
+
+FlogError
+flog_cli_init_screening(FlogCli *flog, FlogConfig *config, bool shared_limits) {
+    assert(flog != NULL);
+    assert(config != NULL);
+
+    // A FlogCli object may be run again with another configuration, as by the builtin
+    flog->redact = flog_config_get_redact(config);
+    flog_cli_init_sampling(flog, config);
+
+    FlogError error = flog_cli_init_filter(flog, config);
+    if (error == FLOG_ERROR_NONE) {
+        error = flog_cli_init_dedup(flog, config);
     }
+
+    if (error == FLOG_ERROR_NONE) {
+        error = flog_cli_init_limiter(flog, config, shared_limits);
+    }
+
+    if (error == FLOG_ERROR_NONE) {
+        error = flog_cli_init_summary_config(flog, config);
+    }
+
+    return error;
 }
 
 FlogError
-flog_append_message_output(FlogCli *flog) {
+flog_cli_run_batch(FlogCli *flog, FILE *stream) {
     assert(flog != NULL);
+    assert(stream != NULL);
 
-    FlogConfig *config = flog_cli_get_config(flog);
-    const char *output_file = flog_config_get_output_file(config);
+    FlogConfig *defaults = flog_cli_get_config(flog);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogConfig *config = flog_config_new_with_defaults(defaults, &error);
+    if (config == NULL) {
+        return error;
+    }
+
+    char *line = malloc(BATCH_LINE_LEN);
+    if (line == NULL) {
+        flog_config_free(config);
+        return FLOG_ERROR_ALLOC;
+    }
+
+    FlogError result = FLOG_ERROR_NONE;
+    size_t line_number = 0;
+
+    while (fgets(line, BATCH_LINE_LEN, stream) != NULL) {
+        line_number++;
+
+        size_t len = strlen(line);
+        if (len == BATCH_LINE_LEN - 1 && line[len - 1] != '\n' && !feof(stream)) {
+            // Discard the remainder of a line too long to parse
+            int c;
+            while ((c = fgetc(stream)) != EOF && c != '\n');
+            error = FLOG_ERROR_LINE;
+        } else if (flog_cli_is_blank_line(line)) {
+            continue;
+        } else {
+            error = flog_cli_log_line(flog, config, line);
+        }
+
+        if (error != FLOG_ERROR_NONE) {
+            fprintf(stderr, "%s: batch line %zu: %s\n", PROGRAM_NAME, line_number, flog_error_string(error));
+            result = error;
+        }
+    }
+
+    if (ferror(stream)) {
+        result = FLOG_ERROR_BATCH;
+    }
+
+    flog_cli_set_config(flog, defaults);
+
+    free(line);
+    flog_config_free(config);
+
+    return result;
+}
+
+FlogError
+flog_cli_serve(FlogCli *flog, int input_fd, int reply_fd) {
+    assert(flog != NULL);
+
+    FlogConfig *defaults = flog_cli_get_config(flog);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogConfig *config = flog_config_new_with_defaults(defaults, &error);
+    if (config == NULL) {
+        return error;
+    }
+
+    char *buffer = malloc(BATCH_LINE_LEN);
+    if (buffer == NULL) {
+        flog_config_free(config);
+        return FLOG_ERROR_ALLOC;
+    }
+
+    FlogError result = FLOG_ERROR_NONE;
+    size_t request_number = 0;
+    size_t start = 0;
+    size_t end = 0;
+    bool overflow = false;
+    bool closed = false;
+
+    // Requests are read with read(2) rather than through a stream, so that the requests
+    // already received are known to have been handled before blocking for more
+    while (!closed || end > start) {
+        char *request = buffer + start;
+        char *newline = memchr(request, '\n', end - start);
+
+        if (newline == NULL && !closed) {
+            memmove(buffer, request, end - start);
+            end -= start;
+            start = 0;
+
+            // Of a request too long to parse keep only the first byte, which may ask for a
+            // reply, and reject the request once its end has been read
+            if (end == BATCH_LINE_LEN - 1) {
+                overflow = true;
+                end = 1;
+            }
+
+            // Make appended messages visible before waiting for the next request
+            error = flog_cli_flush(flog);
+            if (error != FLOG_ERROR_NONE) {
+                result = error;
+            }
+
+            error = flog_cli_await_summaries(flog, input_fd);
+            if (error != FLOG_ERROR_NONE) {
+                result = error;
+            }
+
+            ssize_t count = read(input_fd, buffer + end, BATCH_LINE_LEN - 1 - end);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            } else if (count < 0) {
+                result = FLOG_ERROR_BATCH;
+                break;
+            }
+
+            closed = count == 0;
+            end += (size_t) count;
+            continue;
+        }
+
+        // A final request without a newline is handled once input is closed
+        if (newline == NULL) {
+            newline = buffer + end;
+        }
+
+        *newline = '\0';
+        start = (size_t) (newline - buffer) + (newline < buffer + end ? 1 : 0);
+        request_number++;
+
+        error = flog_cli_serve_request(flog, config, request, overflow, reply_fd);
+        if (error != FLOG_ERROR_NONE) {
+            fprintf(stderr, "%s: request %zu: %s\n", PROGRAM_NAME, request_number, flog_error_string(error));
+            result = error;
+        }
+
+        overflow = false;
+    }
+
+    flog_cli_set_config(flog, defaults);
+
+    free(buffer);
+    flog_config_free(config);
+
+    return result;
+}
+
+FlogError
+flog_cli_serve_request(FlogCli *flog, FlogConfig *config, char *request, bool overflow, int reply_fd) {
+    bool reply = request[0] == SERVE_REPLY_PREFIX;
+    if (reply) {
+        request++;
+    }
+
+    FlogError error = FLOG_ERROR_NONE;
+    if (overflow) {
+        error = FLOG_ERROR_LINE;
+    } else if (!flog_cli_is_blank_line(request)) {
+        error = flog_cli_log_line(flog, config, request);
+    }
+
+    // A reply confirms the message has been written to every append file, and a
+    // request without a message waits for all earlier messages
+    if (reply && error == FLOG_ERROR_NONE) {
+        error = flog_cli_flush(flog);
+    }
+
+    if (reply) {
+        char status = error == FLOG_ERROR_NONE ? SERVE_REPLY_SUCCESS : SERVE_REPLY_FAILURE;
+        while (write(reply_fd, &status, 1) < 0 && errno == EINTR);
+    }
+
+    return error;
+}
+
+bool
+flog_cli_is_blank_line(const char *line) {
+    const char *start = line + strspn(line, " \t\r\n");
+
+    return *start == '\0' || *start == '#';
+}
+
+FlogError
+flog_cli_log_line(FlogCli *flog, FlogConfig *config, char *line) {
+    FlogError error = flog_config_parse_line(config, line);
+    if (error == FLOG_ERROR_NONE) {
+        error = flog_config_sanitize_message(config);
+    }
+
+    if (error != FLOG_ERROR_NONE) {
+        return error;
+    }
+
+    return flog_cli_log_message(flog, config);
+}
+
+FlogError
+flog_cli_exec(FlogCli *flog) {
+    assert(flog != NULL);
+
+    FlogConfig *defaults = flog_cli_get_config(flog);
+    char *const *command = flog_config_get_command(defaults);
+    assert(command != NULL);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogConfig *config = flog_config_new_with_defaults(defaults, &error);
+    if (config == NULL) {
+        return error;
+    }
+
+    FlogCliStream *streams = calloc(EXEC_STREAM_COUNT, sizeof(FlogCliStream));
+    if (streams == NULL) {
+        flog_config_free(config);
+        return FLOG_ERROR_ALLOC;
+    }
+
+    // Lines written to stdout are logged at the configured level, and to stderr as errors
+    streams[0] = (FlogCliStream) { .name = "stdout", .fd = -1, .level = flog_config_get_level(defaults),
+                                   .append = true };
+    streams[1] = (FlogCliStream) { .name = "stderr", .fd = -1, .level = LVL_ERROR, .append = true };
+
+    int write_fds[EXEC_STREAM_COUNT] = { -1, -1 };
+    for (size_t i = 0; i < EXEC_STREAM_COUNT && error == FLOG_ERROR_NONE; i++) {
+        error = flog_cli_init_stream(&streams[i], defaults);
+        if (error == FLOG_ERROR_NONE) {
+            error = flog_cli_open_stream(&streams[i], &write_fds[i]);
+        }
+    }
+
+    // SIGCHLD is blocked until the command has been waited for, so that a shell that has
+    // loaded the builtin does not reap it first, but not in the command itself
+    sigset_t child_signal;
+    sigset_t saved_signals;
+    sigemptyset(&child_signal);
+    sigaddset(&child_signal, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &child_signal, &saved_signals);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    pid_t pid = -1;
+    int spawn_error = 0;
+
+    if (error == FLOG_ERROR_NONE && posix_spawn_file_actions_init(&actions) == 0) {
+        if (posix_spawnattr_init(&attr) == 0) {
+            posix_spawnattr_setsigmask(&attr, &saved_signals);
+            posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK);
+            posix_spawn_file_actions_adddup2(&actions, write_fds[0], STDOUT_FILENO);
+            posix_spawn_file_actions_adddup2(&actions, write_fds[1], STDERR_FILENO);
+
+            spawn_error = posix_spawnp(&pid, command[0], &actions, &attr, command, environ);
+            posix_spawnattr_destroy(&attr);
+        } else {
+            spawn_error = ENOMEM;
+        }
+
+        posix_spawn_file_actions_destroy(&actions);
+    } else if (error == FLOG_ERROR_NONE) {
+        spawn_error = ENOMEM;
+    }
+
+    if (spawn_error != 0) {
+        fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, command[0], strerror(spawn_error));
+        error = FLOG_ERROR_EXEC;
+        pid = -1;
+    }
+
+    // Only the command holds the write ends open, so each stream ends when it exits
+    for (size_t i = 0; i < EXEC_STREAM_COUNT; i++) {
+        if (write_fds[i] != -1) {
+            close(write_fds[i]);
+        }
+    }
+
+    FlogError result = error;
+    if (error == FLOG_ERROR_NONE) {
+        result = flog_cli_poll_streams(flog, config, streams, EXEC_STREAM_COUNT, FLOG_ERROR_EXEC);
+    }
+
+    for (size_t i = 0; i < EXEC_STREAM_COUNT; i++) {
+        if (streams[i].fd != -1) {
+            close(streams[i].fd);
+        }
+        flog_cli_destroy_stream(&streams[i]);
+    }
+
+    if (pid != -1) {
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR);
+
+        // The status of a command killed by a signal is reported as a shell would
+        flog->exit_status = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    }
+
+    sigprocmask(SIG_SETMASK, &saved_signals, NULL);
+
+    flog_cli_set_config(flog, defaults);
+
+    free(streams);
+    flog_config_free(config);
+
+    return result;
+}
+
+FlogError
+flog_cli_read_records(FlogCli *flog, int input_fd) {
+    assert(flog != NULL);
+
+    FlogConfig *defaults = flog_cli_get_config(flog);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogConfig *config = flog_config_new_with_defaults(defaults, &error);
+    if (config == NULL) {
+        return error;
+    }
+
+    FlogCliStream *stream = calloc(1, sizeof(FlogCliStream));
+    if (stream == NULL) {
+        flog_config_free(config);
+        return FLOG_ERROR_ALLOC;
+    }
+
+    // The stream is read through a duplicate, which is closed at the end of the input
+    // without closing input_fd
+    *stream = (FlogCliStream) { .name = "stdin", .fd = -1, .level = flog_config_get_level(defaults), .append = true };
+
+    error = flog_cli_init_stream(stream, defaults);
+    if (error == FLOG_ERROR_NONE) {
+        stream->fd = fcntl(input_fd, F_DUPFD_CLOEXEC, 0);
+        if (stream->fd < 0) {
+            error = FLOG_ERROR_INPUT;
+        }
+    }
+
+    if (error == FLOG_ERROR_NONE) {
+        error = flog_cli_poll_streams(flog, config, stream, 1, FLOG_ERROR_INPUT);
+    }
+
+    if (stream->fd != -1) {
+        close(stream->fd);
+    }
+
+    flog_cli_destroy_stream(stream);
+    flog_cli_set_config(flog, defaults);
+
+    free(stream);
+    flog_config_free(config);
+
+    return error;
+}
+
+FlogError
+flog_cli_tee(FlogCli *flog, int input_fd, bool zero_copy) {
+    assert(flog != NULL);
+
+    FlogConfig *defaults = flog_cli_get_config(flog);
+    size_t output_file_count = flog_config_get_output_file_count(defaults);
+    assert(output_file_count > 0);
+
+    // Each append file is opened, and its parent directories created, as for a message;
+    // the writers are held here rather than in the router, whose cache may close one
+    // writer to make room for the next
+    FlogWriter *writers[OUTPUT_FILE_MAX];
+    size_t writer_count = 0;
+    char path[PATH_MAX];
+    FlogError error = FLOG_ERROR_NONE;
+    for (size_t i = 0; i < output_file_count && error == FLOG_ERROR_NONE; i++) {
+        const char *output_file = flog_config_get_output_file_at(defaults, i);
+
+        error = flog_router_expand(output_file,
+                                   flog_config_get_subsystem(defaults),
+                                   flog_config_get_category(defaults),
+                                   flog_config_get_level(defaults),
+                                   path, PATH_MAX);
+        if (error == FLOG_ERROR_NONE) {
+            writers[writer_count] = flog_cli_open_tee_writer(defaults, path, flog_router_is_template(output_file),
+                                                             &error);
+        }
+        if (error == FLOG_ERROR_NONE) {
+            writer_count++;
+        }
+    }
+
+    FlogConfig *config = NULL;
+    if (error == FLOG_ERROR_NONE) {
+        config = flog_config_new_with_defaults(defaults, &error);
+    }
+
+    FlogCliStream *stream = NULL;
+    if (config != NULL) {
+        stream = calloc(1, sizeof(FlogCliStream));
+        error = stream != NULL ? FLOG_ERROR_NONE : FLOG_ERROR_ALLOC;
+    }
+
+    if (stream != NULL) {
+        *stream = (FlogCliStream) { .name = "stdin", .fd = input_fd, .level = flog_config_get_level(defaults) };
+        error = flog_cli_init_stream(stream, defaults);
+    }
+
+    if (error != FLOG_ERROR_NONE) {
+        free(stream);
+        if (config != NULL) {
+            flog_config_free(config);
+        }
+        for (size_t i = 0; i < writer_count; i++) {
+            flog_writer_free(writers[i]);
+        }
+        return error;
+    }
+
+    // Nothing is read from stdin until splicing is known to be possible, so the copying
+    // path can take over from the start
+    bool unsupported = true;
+#ifdef __linux__
+    if (zero_copy && output_file_count == 1) {
+        error = flog_cli_tee_splice(flog, config, stream, path, &unsupported);
+    }
+#else
+    (void) zero_copy;
+#endif
 
-    if (strlen(output_file) > 0) {
+    if (unsupported) {
+        error = flog_cli_tee_copy(flog, config, stream, writers, writer_count);
+    }
+
+    flog_cli_destroy_stream(stream);
+    flog_cli_set_config(flog, defaults);
 
-        mode_t original_umask = umask(S_IWGRP | S_IWOTH);
+    free(stream);
+    flog_config_free(config);
 
-        FILE *fd = fopen(output_file, "a");
-        if (fd == NULL) {
-            umask(original_umask);
-            return FLOG_ERROR_APPEND;
+    for (size_t i = 0; i < writer_count; i++) {
+        FlogError flush_error = flog_writer_flush(writers[i]);
+        if (error == FLOG_ERROR_NONE) {
+            error = flush_error;
         }
+        flog_writer_free(writers[i]);
+    }
+
+    return error;
+}
+
+FlogWriter *
+flog_cli_open_tee_writer(FlogConfig *config, const char *path, bool create_parents, FlogError *error) {
+    FlogConfigWriter backend = flog_config_get_writer(config);
+    bool datasync = flog_config_get_datasync_flag(config);
+
+    FlogWriter *writer = flog_writer_new(path, backend, datasync, error);
+    if (writer == NULL && errno == ENOENT && create_parents) {
+        flog_router_make_parents(path);
+        writer = flog_writer_new(path, backend, datasync, error);
+    }
 
-        umask(original_umask);
+    return writer;
+}
+
+FlogError
+flog_cli_tee_copy(FlogCli *flog, FlogConfig *config, FlogCliStream *stream, FlogWriter *writers[],
+                  size_t writer_count) {
+    FlogError result = FLOG_ERROR_NONE;
+
+    for (;;) {
+        FlogError error = flog_cli_await_stream(flog, config, stream);
+        if (error != FLOG_ERROR_NONE) {
+            result = error;
+        }
 
-        fprintf(fd, "%s", flog_config_get_message(config));
-        fclose(fd);
+        char *data = stream->buffer + stream->len;
+        ssize_t count = read(stream->fd, data, EXEC_BUFFER_SIZE - stream->len);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        } else if (count < 0) {
+            result = FLOG_ERROR_INPUT;
+            break;
+        } else if (count == 0) {
+            break;
+        }
+
+        for (size_t i = 0; i < writer_count; i++) {
+            error = flog_writer_write(writers[i], data, (size_t) count);
+            if (error != FLOG_ERROR_NONE) {
+                return error;
+            }
+        }
+
+        stream->len += (size_t) count;
+
+        error = flog_cli_log_stream_lines(flog, config, stream, false);
+        if (error != FLOG_ERROR_NONE) {
+            result = error;
+        }
+    }
+
+    FlogError error = flog_cli_log_stream_lines(flog, config, stream, true);
+
+    return result != FLOG_ERROR_NONE ? result : error;
+}
+
+#ifdef __linux__
+FlogError
+flog_cli_tee_splice(FlogCli *flog, FlogConfig *config, FlogCliStream *stream, const char *path,
+                    bool *unsupported) {
+    *unsupported = true;
+
+    struct stat input_stat;
+    if (fstat(stream->fd, &input_stat) < 0 || !S_ISFIFO(input_stat.st_mode)) {
+        return FLOG_ERROR_NONE;
+    }
+
+    // Data cannot be spliced into a file opened for appending, so the file is written
+    // through a descriptor of its own positioned at its end
+    int output_fd = open(path, O_WRONLY | O_CLOEXEC);
+    if (output_fd < 0) {
+        return FLOG_ERROR_APPEND;
+    }
+
+    int copy_fds[2];
+    if (lseek(output_fd, 0, SEEK_END) < 0 || pipe2(copy_fds, O_CLOEXEC) < 0) {
+        close(output_fd);
+        return FLOG_ERROR_APPEND;
+    }
+
+    // tee(2) duplicates at most a pipe's capacity, all of which is then drained, so it
+    // never waits for room in the copy pipe
+    fcntl(copy_fds[1], F_SETPIPE_SZ, TEE_PIPE_SIZE);
+    int capacity = fcntl(copy_fds[1], F_GETPIPE_SZ);
+    size_t chunk_size = capacity > 0 ? (size_t) capacity : EXEC_BUFFER_SIZE;
+
+    // Errors on lines are reported as they occur and do not stop the stream
+    FlogError stream_error = FLOG_ERROR_NONE;
+    FlogError line_error = FLOG_ERROR_NONE;
+
+    while (stream_error == FLOG_ERROR_NONE) {
+        FlogError error = flog_cli_await_stream(flog, config, stream);
+        if (error != FLOG_ERROR_NONE) {
+            line_error = error;
+        }
+
+        ssize_t count = tee(stream->fd, copy_fds[1], chunk_size, 0);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        } else if (count < 0 && errno == EINVAL && *unsupported) {
+            break;
+        } else if (count < 0) {
+            stream_error = FLOG_ERROR_INPUT;
+            break;
+        } else if (count == 0) {
+            break;
+        }
+
+        *unsupported = false;
+
+        // The bytes duplicated are moved into the file without being copied to user space,
+        size_t remaining = (size_t) count;
+        while (remaining > 0) {
+            ssize_t moved = splice(stream->fd, NULL, output_fd, NULL, remaining, SPLICE_F_MOVE);
+            if (moved < 0 && errno == EINTR) {
+                continue;
+            } else if (moved <= 0) {
+                stream_error = FLOG_ERROR_APPEND;
+                break;
+            }
+
+            remaining -= (size_t) moved;
+        }
+
+        // and their copy read once to be logged by line
+        remaining = (size_t) count;
+        while (remaining > 0 && stream_error == FLOG_ERROR_NONE) {
+            size_t space = EXEC_BUFFER_SIZE - stream->len;
+            ssize_t read_count = read(copy_fds[0], stream->buffer + stream->len, remaining < space ? remaining : space);
+            if (read_count < 0 && errno == EINTR) {
+                continue;
+            } else if (read_count <= 0) {
+                stream_error = FLOG_ERROR_INPUT;
+                break;
+            }
+
+            stream->len += (size_t) read_count;
+            remaining -= (size_t) read_count;
+
+            error = flog_cli_log_stream_lines(flog, config, stream, false);
+            if (error != FLOG_ERROR_NONE) {
+                line_error = error;
+            }
+        }
+    }
+
+    if (!*unsupported) {
+        FlogError error = flog_cli_log_stream_lines(flog, config, stream, true);
+        if (error != FLOG_ERROR_NONE) {
+            line_error = error;
+        }
+    }
+
+    close(copy_fds[0]);
+    close(copy_fds[1]);
+    close(output_fd);
+
+    return stream_error != FLOG_ERROR_NONE ? stream_error : line_error;
+}
+#endif
+
+int
+flog_cli_get_exit_status(const FlogCli *flog) {
+    assert(flog != NULL);
+
+    return flog->exit_status;
+}
+
+FlogError
+flog_cli_open_stream(FlogCliStream *stream, int *write_fd) {
+    int fds[2];
+    stream->fd = -1;
+
+    if (pipe(fds) < 0) {
+        return FLOG_ERROR_EXEC;
+    }
+
+    // Neither end is inherited by the command other than as its stdout or stderr
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
+#ifdef F_SETPIPE_SZ
+    // A larger pipe lets a command that writes in bursts continue while flog is appending
+    fcntl(fds[1], F_SETPIPE_SZ, EXEC_PIPE_SIZE);
+#endif
+
+    stream->fd = fds[0];
+    *write_fd = fds[1];
+
+    return FLOG_ERROR_NONE;
+}
+
+FlogError
+flog_cli_init_stream(FlogCliStream *stream, const FlogConfig *config) {
+    if (!flog_config_get_multiline_flag(config)) {
+        return FLOG_ERROR_NONE;
+    }
+
+    FlogError error = FLOG_ERROR_NONE;
+    const char *pattern = flog_config_get_record_start(config);
+
+    stream->assembler = flog_assembler_new(pattern, flog_config_get_record_max(config), &error);
+    if (stream->assembler == NULL && error == FLOG_ERROR_RECORD) {
+        fprintf(stderr, "%s: invalid record start pattern: %s\n", PROGRAM_NAME, pattern);
+    }
+
+    stream->record_wait = flog_config_get_record_wait(config);
+
+    return error;
+}
+
+void
+flog_cli_destroy_stream(FlogCliStream *stream) {
+    if (stream->assembler != NULL) {
+        flog_assembler_free(stream->assembler);
+        stream->assembler = NULL;
+    }
+}
+
+FlogError
+flog_cli_poll_streams(FlogCli *flog, FlogConfig *config, FlogCliStream streams[], size_t count,
+                      FlogError read_error) {
+    FlogError result = FLOG_ERROR_NONE;
+    struct pollfd fds[EXEC_STREAM_COUNT];
+    assert(count <= EXEC_STREAM_COUNT);
+
+    for (;;) {
+        // A stream holding part of a record is waited for no longer than its record wait,
+        // and repeated messages are waited for no longer than their dedup wait
+        nfds_t open_count = 0;
+        int timeout = flog_cli_get_dedup_timeout(flog);
+        for (size_t i = 0; i < count; i++) {
+            if (streams[i].fd != -1) {
+                fds[open_count++] = (struct pollfd) { .fd = streams[i].fd, .events = POLLIN };
+            }
+
+            timeout = flog_cli_min_timeout(timeout, flog_cli_get_stream_timeout(&streams[i]));
+        }
+
+        if (open_count == 0) {
+            break;
+        }
+
+        // Make appended messages visible before waiting for more input
+        FlogError flush_error = flog_cli_flush(flog);
+        if (flush_error != FLOG_ERROR_NONE) {
+            result = flush_error;
+        }
+
+        int ready = poll(fds, open_count, timeout);
+        if (ready < 0) {
+            if (errno != EINTR) {
+                result = read_error;
+                break;
+            }
+            continue;
+        }
+
+        // Each stream is read in turn, so that its lines are logged in the order written
+        for (size_t i = 0, j = 0; i < count; i++) {
+            FlogError stream_error = FLOG_ERROR_NONE;
+
+            if (streams[i].fd != -1 && fds[j++].revents != 0) {
+                stream_error = flog_cli_read_stream(flog, config, &streams[i], read_error);
+            } else if (flog_cli_get_stream_timeout(&streams[i]) == 0) {
+                stream_error = flog_cli_flush_stream_record(flog, config, &streams[i]);
+            }
+
+            if (stream_error != FLOG_ERROR_NONE) {
+                result = stream_error;
+            }
+        }
+
+        if (flog_cli_get_dedup_timeout(flog) == 0) {
+            FlogError summary_error = flog_cli_log_summaries(flog, flog_cli_get_time_ms());
+            if (summary_error != FLOG_ERROR_NONE) {
+                result = summary_error;
+            }
+        }
+    }
+
+    return result;
+}
+
+FlogError
+flog_cli_await_stream(FlogCli *flog, FlogConfig *config, FlogCliStream *stream) {
+    FlogError result = FLOG_ERROR_NONE;
+
+    // A record is only logged early if no more input arrives within its record wait, and
+    // repeated messages are summarised once their dedup wait has passed
+    for (;;) {
+        int timeout = flog_cli_min_timeout(flog_cli_get_stream_timeout(stream), flog_cli_get_dedup_timeout(flog));
+        if (timeout < 0) {
+            break;
+        }
+
+        struct pollfd fd = { .fd = stream->fd, .events = POLLIN };
+        int ready = poll(&fd, 1, timeout);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        } else if (ready != 0) {
+            break;
+        }
+
+        FlogError error = FLOG_ERROR_NONE;
+        if (flog_cli_get_stream_timeout(stream) == 0) {
+            error = flog_cli_flush_stream_record(flog, config, stream);
+        }
+
+        FlogError summary_error = flog_cli_log_summaries(flog, flog_cli_get_time_ms());
+        if (error != FLOG_ERROR_NONE || summary_error != FLOG_ERROR_NONE) {
+            result = error != FLOG_ERROR_NONE ? error : summary_error;
+        }
+    }
+
+    return result;
+}
+
+int
+flog_cli_get_stream_timeout(const FlogCliStream *stream) {
+    if (stream->assembler == NULL || flog_assembler_get_length(stream->assembler) == 0) {
+        return -1;
+    }
+
+    int64_t remaining = stream->record_time + stream->record_wait - flog_cli_get_time_ms();
+
+    return remaining > 0 ? (int) remaining : 0;
+}
+
+int64_t
+flog_cli_get_time_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (int64_t) now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+int64_t
+flog_cli_get_time_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (int64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+FlogError
+flog_cli_read_stream(FlogCli *flog, FlogConfig *config, FlogCliStream *stream, FlogError read_error) {
+    ssize_t count = read(stream->fd, stream->buffer + stream->len, EXEC_BUFFER_SIZE - stream->len);
+    if (count < 0 && errno == EINTR) {
+        return FLOG_ERROR_NONE;
+    }
+
+    bool closed = count <= 0;
+    if (closed) {
+        close(stream->fd);
+        stream->fd = -1;
+    } else {
+        stream->len += (size_t) count;
+    }
+
+    FlogError error = flog_cli_log_stream_lines(flog, config, stream, closed);
+
+    return count < 0 ? read_error : error;
+}
+
+FlogError
+flog_cli_log_stream_lines(FlogCli *flog, FlogConfig *config, FlogCliStream *stream, bool closed) {
+    FlogError result = FLOG_ERROR_NONE;
+    char *start = stream->buffer;
+    char *end = stream->buffer + stream->len;
+
+    // A line longer than a message is logged in parts rather than truncated, and a
+    // final line without a newline is logged once the stream is closed
+    while (start < end) {
+        size_t len = (size_t) (end - start);
+        size_t limit = len < MESSAGE_LEN - 1 ? len : MESSAGE_LEN - 1;
+        char *newline = memchr(start, '\n', limit);
+
+        char *next;
+        if (newline != NULL) {
+            next = newline + 1;
+        } else if (limit == MESSAGE_LEN - 1 || closed) {
+            newline = start + limit;
+            next = newline;
+        } else {
+            break;
+        }
+
+        char saved = *newline;
+        *newline = '\0';
+
+        FlogError error = flog_cli_log_stream_line(flog, config, stream, start);
+        if (error != FLOG_ERROR_NONE) {
+            result = error;
+        }
+
+        *newline = saved;
+        start = next;
+    }
+
+    stream->len = (size_t) (end - start);
+    memmove(stream->buffer, start, stream->len);
+
+    if (closed) {
+        FlogError error = flog_cli_flush_stream_record(flog, config, stream);
+        if (error != FLOG_ERROR_NONE) {
+            result = error;
+        }
+    }
+
+    return result;
+}
+
+FlogError
+flog_cli_log_stream_line(FlogCli *flog, FlogConfig *config, FlogCliStream *stream, const char *line) {
+    stream->line_number++;
+
+    if (*line == '\0') {
+        return FLOG_ERROR_NONE;
+    }
+
+    if (stream->assembler == NULL) {
+        return flog_cli_log_stream_message(flog, config, stream, line, stream->line_number);
+    }
+
+    // A line that starts a record logs the record held first, and the part of a line
+    // that does not fit in the record held starts the next
+    FlogError result = FLOG_ERROR_NONE;
+    if (flog_assembler_starts_record(stream->assembler, line)) {
+        result = flog_cli_flush_stream_record(flog, config, stream);
+    }
+
+    size_t len = strlen(line);
+    while (len > 0) {
+        if (flog_assembler_get_length(stream->assembler) == 0) {
+            stream->record_line_number = stream->line_number;
+        }
+
+        size_t count = flog_assembler_add_line(stream->assembler, line, len);
+        line += count;
+        len -= count;
+
+        if (len > 0) {
+            FlogError error = flog_cli_flush_stream_record(flog, config, stream);
+            if (error != FLOG_ERROR_NONE) {
+                result = error;
+            }
+        }
+    }
+
+    stream->record_time = flog_cli_get_time_ms();
+
+    return result;
+}
+
+FlogError
+flog_cli_flush_stream_record(FlogCli *flog, FlogConfig *config, FlogCliStream *stream) {
+    if (stream->assembler == NULL || flog_assembler_get_length(stream->assembler) == 0) {
+        return FLOG_ERROR_NONE;
+    }
+
+    FlogError error = flog_cli_log_stream_message(flog, config, stream, flog_assembler_get_record(stream->assembler),
+                                                  stream->record_line_number);
+    flog_assembler_clear(stream->assembler);
+
+    return error;
+}
+
+FlogError
+flog_cli_log_stream_message(FlogCli *flog, FlogConfig *config, FlogCliStream *stream, const char *message,
+                            size_t line_number) {
+    flog_config_reset(config);
+    flog_config_set_level(config, stream->level);
+
+    // Lines are read from another program, so are sanitized as a message read from the
+    // standard input stream is; lines passed through to the append files are only committed
+    FlogError error = flog_config_set_message(config, message);
+    if (error == FLOG_ERROR_NONE) {
+        error = flog_config_sanitize_message(config);
+    }
+
+    if (error == FLOG_ERROR_NONE && stream->append) {
+        error = flog_cli_log_message(flog, config);
+    } else if (error == FLOG_ERROR_NONE) {
+        bool accepted = false;
+        error = flog_cli_screen_message(flog, config, &accepted);
+        if (accepted) {
+            flog_cli_set_config(flog, config);
+            flog_commit_message(flog);
+        }
+    }
+
+    if (error != FLOG_ERROR_NONE) {
+        fprintf(stderr, "%s: %s line %zu: %s\n", PROGRAM_NAME, stream->name, line_number,
+                flog_error_string(error));
+    }
+
+    return error;
+}
+
+FlogError
+flog_cli_log_message(FlogCli *flog, FlogConfig *config) {
+    assert(flog != NULL);
+    assert(config != NULL);
+
+    bool accepted = false;
+    FlogError error = flog_cli_screen_message(flog, config, &accepted);
+    if (!accepted) {
+        return error;
+    }
+
+    flog_cli_set_config(flog, config);
+
+    // An error logging a summary before the message is reported once the message is logged
+    FlogError append_error = flog_append_message_output(flog);
+    if (append_error != FLOG_ERROR_NONE) {
+        return append_error;
+    }
+
+    flog_commit_message(flog);
+
+    return error;
+}
+
+FlogError
+flog_cli_init_filter(FlogCli *flog, const FlogConfig *config) {
+    // A FlogCli object may be run again with another configuration and its own filters
+    if (flog->filter != NULL) {
+        flog_filter_free(flog->filter);
+        flog->filter = NULL;
+    }
+
+    if (flog_config_get_filter_count(config, FLT_INCLUDE) == 0 &&
+        flog_config_get_filter_count(config, FLT_EXCLUDE) == 0) {
+        return FLOG_ERROR_NONE;
+    }
+
+    FlogError error = FLOG_ERROR_NONE;
+    flog->filter = flog_filter_new(config, &error);
+
+    return error;
+}
+
+bool
+flog_cli_accepts_message(const FlogCli *flog, const char *message) {
+    return flog->filter == NULL || flog_filter_accepts(flog->filter, message);
+}
+
+void
+flog_cli_init_sampling(FlogCli *flog, const FlogConfig *config) {
+    for (FlogConfigLevel level = LVL_DEFAULT; level < LVL_UNKNOWN; level++) {
+        flog->sample_rates[level] = flog_config_get_sample_rate(config, level);
+    }
+}
+
+FlogError
+flog_cli_init_dedup(FlogCli *flog, FlogConfig *config) {
+    flog_cli_free_dedup(flog);
+
+    if (!flog_config_get_dedup_flag(config)) {
+        return FLOG_ERROR_NONE;
+    }
+
+    FlogError error = FLOG_ERROR_NONE;
+    flog->dedup = flog_dedup_new(flog_config_get_dedup_wait(config), &error);
+
+    return error;
+}
+
+void
+flog_cli_free_dedup(FlogCli *flog) {
+    if (flog->dedup != NULL) {
+        flog_dedup_free(flog->dedup);
+        flog->dedup = NULL;
+    }
+}
+
+FlogError
+flog_cli_init_limiter(FlogCli *flog, const FlogConfig *config, bool shared) {
+    flog_cli_free_limiter(flog);
+
+    if (flog_config_get_rate_limit_count(config) == 0) {
+        return FLOG_ERROR_NONE;
+    }
+
+    // A process logging a single message shares its budget with others through a state file
+    char path[PATH_MAX];
+    const char *state_path = NULL;
+    if (shared) {
+        const char *dir = getenv("TMPDIR");
+        int len = snprintf(path, sizeof(path), "%s/%s-%u", dir != NULL && strlen(dir) > 0 ? dir : "/tmp",
+                           RATE_STATE_NAME, (unsigned) geteuid());
+        if (len > 0 && (size_t) len < sizeof(path)) {
+            state_path = path;
+        }
+    }
+
+    FlogError error = FLOG_ERROR_NONE;
+    flog->limiter = flog_limiter_new(config, state_path, &error);
+
+    return error;
+}
+
+void
+flog_cli_free_limiter(FlogCli *flog) {
+    if (flog->limiter != NULL) {
+        flog_limiter_free(flog->limiter);
+        flog->limiter = NULL;
+    }
+}
+
+bool
+flog_cli_is_single_message(const FlogConfig *config) {
+    return !flog_config_get_serve_flag(config) && !flog_config_get_exec_flag(config) &&
+           !flog_config_get_tee_flag(config) && !flog_config_get_multiline_flag(config) &&
+           strlen(flog_config_get_batch_file(config)) == 0;
+}
+
+FlogError
+flog_cli_init_summary_config(FlogCli *flog, FlogConfig *config) {
+    if (flog->summary_config != NULL) {
+        flog_config_free(flog->summary_config);
+        flog->summary_config = NULL;
+    }
+
+    if (flog->dedup == NULL && flog->limiter == NULL) {
+        return FLOG_ERROR_NONE;
+    }
+
+    FlogError error = FLOG_ERROR_NONE;
+    flog->summary_config = flog_config_new_with_defaults(config, &error);
+
+    return error;
+}
+
+FlogError
+flog_cli_screen_message(FlogCli *flog, FlogConfig *config, bool *accepted) {
+    // Messages are screened by the level, subsystem and category taken from their fields
+    FlogError error = flog_cli_extract_fields(config);
+    if (error != FLOG_ERROR_NONE) {
+        *accepted = false;
+        return error;
+    }
+
+    const char *message = flog_config_get_message(config);
+    const char *subsystem = flog_config_get_subsystem(config);
+    const char *category = flog_config_get_category(config);
+    FlogConfigLevel level = flog_config_get_level(config);
+    double sample_rate = level < LVL_UNKNOWN ? flog->sample_rates[level] : 1.0;
+
+    *accepted = flog_cli_accepts_message(flog, message);
+
+    // Messages dropped by sampling are neither counted as repeats nor take from a rate limit
+    if (*accepted && sample_rate < 1.0) {
+        *accepted = flog_sample_keeps(message, sample_rate);
+    }
+
+    if (*accepted && flog->dedup != NULL) {
+        int64_t now = flog_cli_get_time_ms();
+        *accepted = !flog_dedup_is_repeat(flog->dedup, subsystem, category, level, message, now);
+
+        // The count of repeats of the previous message is logged before the message itself
+        error = flog_cli_log_summaries(flog, now);
+    }
+
+    // Repeats are counted before they can take from the rate limit
+    if (*accepted && flog->limiter != NULL) {
+        unsigned long suppressed = 0;
+        *accepted = flog_limiter_acquire(flog->limiter, subsystem, category, level, flog_cli_get_time_ns(),
+                                         &suppressed);
+        if (suppressed > 0) {
+            char summary[SUMMARY_LEN];
+            snprintf(summary, sizeof(summary), "%lu messages suppressed by rate limit", suppressed);
+
+            FlogError summary_error = flog_cli_log_summary(flog, subsystem, category, level, summary);
+            if (error == FLOG_ERROR_NONE) {
+                error = summary_error;
+            }
+        }
+    }
+
+    // Secrets are masked in the message as it is logged and appended, but not in the
+    // text that it was filtered, sampled and compared by
+    if (*accepted && (flog->redact != RDT_NONE || sample_rate < 1.0)) {
+        char rewritten[MESSAGE_LEN];
+        strlcpy(rewritten, message, sizeof(rewritten));
+        bool changed = flog_redact_message(rewritten, flog->redact) > 0;
+
+        if (sample_rate < 1.0) {
+            flog_sample_annotate(rewritten, sizeof(rewritten), sample_rate);
+            changed = true;
+        }
+
+        FlogError rewrite_error = changed ? flog_config_set_message(config, rewritten) : FLOG_ERROR_NONE;
+        if (rewrite_error != FLOG_ERROR_NONE) {
+            *accepted = false;
+            error = rewrite_error;
+        }
+    }
+
+    return error;
+}
+
+FlogError
+flog_cli_extract_fields(FlogConfig *config) {
+    FlogConfigFields format = flog_config_get_fields(config);
+    FlogFields fields;
+
+    // Messages that are not in the format are logged as they are
+    if (format == FLD_NONE || !flog_fields_parse(&fields, format, flog_config_get_message(config))) {
+        return FLOG_ERROR_NONE;
+    }
+
+    char value[MESSAGE_LEN];
+    FlogError error = FLOG_ERROR_NONE;
+    bool taken = false;
+
+    FlogField *field = flog_fields_find(&fields, level_keys);
+    if (field != NULL) {
+        flog_fields_copy_value(field, value, sizeof(value));
+        FlogConfigLevel level = flog_fields_parse_level(value);
+        if (level != LVL_UNKNOWN) {
+            flog_config_set_level(config, level);
+            field->taken = taken = true;
+        }
+    }
+
+    field = flog_fields_find(&fields, subsystem_keys);
+    if (field != NULL) {
+        flog_fields_copy_text(field, value, sizeof(value));
+        error = flog_config_set_subsystem(config, value);
+        field->taken = taken = true;
+    }
+
+    field = flog_fields_find(&fields, category_keys);
+    if (error == FLOG_ERROR_NONE && field != NULL) {
+        flog_fields_copy_text(field, value, sizeof(value));
+        error = flog_config_set_category(config, value);
+        field->taken = taken = true;
+    }
+
+    // The fields that are left follow the message, so that none are lost
+    size_t len = 0;
+    field = flog_fields_find(&fields, message_keys);
+    if (error == FLOG_ERROR_NONE && field != NULL) {
+        len = flog_fields_copy_text(field, value, sizeof(value));
+        field->taken = taken = true;
+    } else {
+        value[len] = '\0';
+    }
+
+    if (error != FLOG_ERROR_NONE || !taken) {
+        return error;
+    }
+
+    flog_fields_render(&fields, value, sizeof(value), len);
+
+    return flog_config_set_message(config, value);
+}
+
+FlogError
+flog_cli_log_summaries(FlogCli *flog, int64_t now) {
+    FlogError result = FLOG_ERROR_NONE;
+    char message[SUMMARY_LEN];
+
+    FlogDedupSummary summary;
+    while (flog->dedup != NULL && flog_dedup_next_summary(flog->dedup, now, &summary)) {
+        snprintf(message, sizeof(message), "last message repeated %lu times", summary.count);
+
+        FlogError error = flog_cli_log_summary(flog, summary.subsystem, summary.category, summary.level, message);
+        if (error != FLOG_ERROR_NONE) {
+            result = error;
+        }
+    }
+
+    // Messages suppressed by a rate limit are otherwise summarised when it next allows one
+    FlogLimiterSummary limiter_summary;
+    while (now == INT64_MAX && flog->limiter != NULL && flog_limiter_next_summary(flog->limiter, &limiter_summary)) {
+        snprintf(message, sizeof(message), "%lu messages suppressed by rate limit", limiter_summary.count);
+
+        FlogError error = flog_cli_log_summary(flog, limiter_summary.subsystem, limiter_summary.category,
+                                               limiter_summary.level, message);
+        if (error != FLOG_ERROR_NONE) {
+            result = error;
+        }
+    }
+
+    return result;
+}
+
+FlogError
+flog_cli_log_summary(FlogCli *flog, const char *subsystem, const char *category, FlogConfigLevel level,
+                     const char *message) {
+    FlogConfig *previous = flog->config;
+    FlogConfig *config = flog->summary_config;
+
+    flog_config_reset(config);
+    flog_config_set_level(config, level);
+
+    FlogError error = flog_config_set_subsystem(config, subsystem);
+    if (error == FLOG_ERROR_NONE) {
+        error = flog_config_set_category(config, category);
+    }
+
+    if (error == FLOG_ERROR_NONE) {
+        error = flog_config_set_message(config, message);
+    }
+
+    // Input passed through to the append files is never added to
+    if (error == FLOG_ERROR_NONE) {
+        flog_cli_set_config(flog, config);
+        if (!flog_config_get_tee_flag(config)) {
+            error = flog_append_message_output(flog);
+        }
+    }
+
+    if (error == FLOG_ERROR_NONE) {
+        flog_commit_message(flog);
+    }
+
+    flog_cli_set_config(flog, previous);
+
+    return error;
+}
+
+int
+flog_cli_get_dedup_timeout(const FlogCli *flog) {
+    return flog->dedup != NULL ? flog_dedup_get_timeout(flog->dedup, flog_cli_get_time_ms()) : -1;
+}
+
+int
+flog_cli_min_timeout(int timeout, int other_timeout) {
+    // A negative timeout waits indefinitely
+    if (timeout < 0 || (other_timeout >= 0 && other_timeout < timeout)) {
+        return other_timeout;
+    }
+
+    return timeout;
+}
+
+FlogError
+flog_cli_await_summaries(FlogCli *flog, int fd) {
+    FlogError result = FLOG_ERROR_NONE;
+
+    // Repeats are summarised on time even while no input arrives
+    int timeout;
+    while ((timeout = flog_cli_get_dedup_timeout(flog)) >= 0) {
+        struct pollfd pollfd = { .fd = fd, .events = POLLIN };
+        int ready = poll(&pollfd, 1, timeout);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        } else if (ready != 0) {
+            break;
+        }
+
+        // Summaries are made visible as they would be had a request been handled
+        FlogError error = flog_cli_log_summaries(flog, flog_cli_get_time_ms());
+        if (error == FLOG_ERROR_NONE) {
+            error = flog_cli_flush(flog);
+        }
+
+        if (error != FLOG_ERROR_NONE) {
+            result = error;
+        }
+    }
+
+    return result;
+}
+
+void
+flog_commit_message(FlogCli *flog) {
+    assert(flog != NULL);
+
+    FlogConfig *config = flog_cli_get_config(flog);
+    if (flog_config_get_message_type(config) == MSG_PUBLIC) {
+        flog_commit_public_message(flog);
+    } else if (flog_config_get_message_type(config) == MSG_PRIVATE) {
+        flog_commit_private_message(flog);
+    }
+}
+
+FlogError
+flog_append_message_output(FlogCli *flog) {
+    assert(flog != NULL);
+
+    FlogConfig *config = flog_cli_get_config(flog);
+    size_t output_file_count = flog_config_get_output_file_count(config);
+
+    if (output_file_count > 0 && flog_config_get_format(config) == FMT_BINARY) {
+        return flog_append_message_binary(flog);
+    } else if (output_file_count > 0) {
+        FlogError error = flog_cli_open_router(flog, config);
+        if (error != FLOG_ERROR_NONE) {
+            return error;
+        }
+
+        // JSON records hold every field, so only the time is rendered as a prefix for them
+        bool json = flog_config_get_format(config) == FMT_JSON;
+        if (json && flog->json == NULL) {
+            flog->json = malloc(JSONL_LEN);
+            if (flog->json == NULL) {
+                return FLOG_ERROR_ALLOC;
+            }
+        }
+
+        // Batch file lines may each use different prefix fields
+        unsigned int prefix_fields = json ? PFX_TIME : flog_config_get_prefix(config);
+        if (prefix_fields != PFX_NONE && flog->prefix != NULL && flog_prefix_get_fields(flog->prefix) != prefix_fields) {
+            flog_prefix_free(flog->prefix);
+            flog->prefix = NULL;
+        }
+
+        if (prefix_fields != PFX_NONE && flog->prefix == NULL) {
+            error = FLOG_ERROR_NONE;
+            flog->prefix = flog_prefix_new(prefix_fields, &error);
+            if (flog->prefix == NULL) {
+                return error;
+            }
+        }
+
+        const char *message = flog_config_get_message(config);
+
+        FlogRecord record;
+        flog_record_init(&record);
+
+        char prefix[PREFIX_LEN];
+        size_t prefix_len = 0;
+        if (prefix_fields != PFX_NONE) {
+            struct timespec now;
+            clock_gettime(CLOCK_REALTIME, &now);
+
+            prefix_len = flog_prefix_render(flog->prefix, &now,
+                                            flog_config_get_level(config),
+                                            flog_config_get_subsystem(config),
+                                            flog_config_get_category(config),
+                                            prefix, PREFIX_LEN);
+        }
+
+        if (json) {
+            // The time is rendered with a trailing space, as it would precede a message
+            FlogJsonlRecord json_record = {
+                .time = prefix,
+                .time_len = prefix_len - 1,
+                .level = flog_config_get_level(config),
+                .message_type = flog_config_get_message_type(config),
+                .subsystem = flog_config_get_subsystem(config),
+                .category = flog_config_get_category(config),
+                .message = message,
+                .message_len = strlen(message)
+            };
+
+            size_t json_len = flog_jsonl_render(&json_record, flog->json, JSONL_LEN);
+            flog_record_append(&record, flog->json, json_len);
+        } else {
+            flog_record_append(&record, prefix, prefix_len);
+            flog_record_append(&record, message, strlen(message));
+        }
+
+        // Framing would leave lines that are not JSON, so JSON records are never framed
+        flog_record_finish(&record, !json && flog_config_get_checksum_flag(config));
+
+        int count;
+        const struct iovec *segments = flog_record_get_segments(&record, &count);
+
+        for (size_t i = 0; i < output_file_count; i++) {
+            const char *output_file = flog_config_get_output_file_at(config, i);
+
+            char path[PATH_MAX];
+            error = flog_router_expand(output_file,
+                                       flog_config_get_subsystem(config),
+                                       flog_config_get_category(config),
+                                       flog_config_get_level(config),
+                                       path, PATH_MAX);
+            if (error != FLOG_ERROR_NONE) {
+                return error;
+            }
+
+            FlogWriter *writer = flog_router_get_writer(flog->router, path,
+                                                        flog_router_is_template(output_file), &error);
+            if (writer == NULL) {
+                return error;
+            }
+
+            error = flog_writer_writev(writer, segments, count);
+            if (error != FLOG_ERROR_NONE) {
+                return error;
+            }
+        }
+    }
+
+    return FLOG_ERROR_NONE;
+}
+
+FlogError
+flog_cli_open_router(FlogCli *flog, FlogConfig *config) {
+    if (flog->router != NULL) {
+        return FLOG_ERROR_NONE;
+    }
+
+    FlogError error = FLOG_ERROR_NONE;
+    flog->router = flog_router_new(ROUTER_CACHE_SIZE,
+                                   flog_config_get_writer(config),
+                                   flog_config_get_datasync_flag(config),
+                                   &error);
+
+    return error;
+}
+
+FlogError
+flog_cli_flush(FlogCli *flog) {
+    assert(flog != NULL);
+
+    if (flog->router != NULL) {
+        return flog_router_flush(flog->router);
+    }
+
+    return FLOG_ERROR_NONE;
+}
+
+void
+flog_cli_print_stats(const FlogCli *flog) {
+    assert(flog != NULL);
+
+    FlogRouterStats stats = {0};
+    if (flog->router != NULL) {
+        flog_router_get_stats(flog->router, &stats);
+    }
+
+    fprintf(stderr, "%s: append file cache: %lu hits, %lu misses, %lu evictions, %zu open\n",
+            PROGRAM_NAME, stats.hits, stats.misses, stats.evictions, stats.open);
+}
+
+FlogError
+flog_append_message_binary(FlogCli *flog) {
+    assert(flog != NULL);
+
+    FlogConfig *config = flog_cli_get_config(flog);
+    const char *message = flog_config_get_message(config);
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    FlogBinlogRecord record = {
+        .timestamp = (uint64_t) now.tv_sec * 1000000000 + (uint64_t) now.tv_nsec,
+        .level = flog_config_get_level(config),
+        .message_type = flog_config_get_message_type(config),
+        .subsystem = flog_config_get_subsystem(config),
+        .category = flog_config_get_category(config),
+        .message = message,
+        .message_len = strlen(message)
+    };
+
+    for (size_t i = 0; i < flog_config_get_output_file_count(config); i++) {
+        char path[PATH_MAX];
+        FlogError error = flog_router_expand(flog_config_get_output_file_at(config, i),
+                                             record.subsystem, record.category, record.level,
+                                             path, PATH_MAX);
+        if (error != FLOG_ERROR_NONE) {
+            return error;
+        }
+
+        FlogBinlogWriter *writer = flog_cli_get_binlog(flog, path, &error);
+        if (writer == NULL) {
+            return error;
+        }
+
+        error = flog_binlog_writer_append(writer, &record);
+        if (error != FLOG_ERROR_NONE) {
+            return error;
+        }
     }
 
     return FLOG_ERROR_NONE;
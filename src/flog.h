@@ -23,6 +23,7 @@
 #ifndef FLOG_H
 #define FLOG_H
 
+#include <stdio.h>
 #include "config.h"
 #include "common.h"
 
@@ -80,6 +81,107 @@ FlogConfig * flog_cli_get_config(const FlogCli *flog);
  */
 void flog_cli_set_config(FlogCli *flog, FlogConfig *config);
 
+/*! \brief Prepare a FlogCli object to screen messages by the options of a FlogConfig
+ *         object.
+ *
+ *  The filters, sample rates, repeat detection, rate limits and redaction of the
+ *  configuration are applied by flog_cli_log_message(), replacing those of any earlier
+ *  configuration. flog_cli_run() calls this function for the configuration it runs.
+ *
+ *  \param flog          A pointer to the FlogCli object
+ *  \param config        A pointer to the FlogConfig object
+ *  \param shared_limits \c true if rate limits are shared with other processes through
+ *                       a state file, as by processes that each log a single message,
+ *                       or \c false if they are kept in memory
+ *
+ *  \pre \c flog is \e not \c NULL
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, otherwise some
+ *          other variant representing an error condition
+ */
+FlogError flog_cli_init_screening(FlogCli *flog, FlogConfig *config, bool shared_limits);
+
+/*! \brief Screen a message and, if it is accepted, append and commit it.
+ *
+ *  The options of the message are first taken from its fields, if any; it is then
+ *  filtered, sampled, compared with the message before it, counted against its rate
+ *  limit and finally redacted, in that order, as prepared by flog_cli_init_screening().
+ *  Summaries of repeated and suppressed messages are logged before it.
+ *
+ *  \param flog   A pointer to the FlogCli object
+ *  \param config A pointer to the FlogConfig object holding the message, which becomes
+ *                the FlogConfig object associated with the FlogCli object if the
+ *                message is accepted
+ *
+ *  \pre \c flog is \e not \c NULL
+ *  \pre \c config is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, otherwise some
+ *          other variant representing an error condition
+ */
+FlogError flog_cli_log_message(FlogCli *flog, FlogConfig *config);
+
+/*! \brief Log the message, batch file, requests or command output described by
+ *         the FlogConfig object associated with a FlogCli object, as the flog
+ *         command does.
+ *
+ *  The message is appended and committed, or the batch file, requests on stdin or
+ *  output of a command are logged, then appended messages are flushed and
+ *  statistics printed if requested. Errors are printed to stderr stream as they
+ *  occur.
+ *
+ *  \param flog A pointer to the FlogCli object
+ *
+ *  \pre \c flog is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, otherwise some
+ *          other variant representing an error condition
+ */
+FlogError flog_cli_run(FlogCli *flog);
+
+/*! \brief Log the message on each line of a batch file.
+ *
+ *  Each line is parsed with flog_config_parse_line() using the FlogConfig object
+ *  associated with the FlogCli object as its defaults, then appended and committed
+ *  as if it had been given on the command line. Blank lines and lines starting
+ *  with \c # are skipped. An error on a line is printed to stderr stream with its
+ *  line number, and the remaining lines are still processed.
+ *
+ *  \param flog   A pointer to the FlogCli object
+ *  \param stream A pointer to a stream from which lines are read
+ *
+ *  \pre \c flog is \e not \c NULL
+ *  \pre \c stream is \e not \c NULL
+ *
+ *  \return If every line was logged, the FlogError variant FLOG_ERROR_NONE;
+ *          FLOG_ERROR_BATCH if the stream could not be read, otherwise the variant
+ *          representing the error condition of the last line that failed
+ */
+FlogError flog_cli_run_batch(FlogCli *flog, FILE *stream);
+
+/*! \brief Log the message in each request read from a file descriptor until it
+ *         is closed.
+ *
+ *  Each request is a line parsed as a line of a batch file (see flog_cli_run_batch()).
+ *  A request starting with \c ? is answered with a single status byte written to
+ *  \c reply_fd once its message has been written to every append file: \c 0 on
+ *  success or \c 1 on failure. A \c ? request without a message answers once all
+ *  earlier messages have been written. Appended messages are flushed whenever no
+ *  further request has been received, so they are never held while waiting.
+ *
+ *  \param flog     A pointer to the FlogCli object
+ *  \param input_fd A file descriptor from which requests are read
+ *  \param reply_fd A file descriptor to which status bytes are written
+ *
+ *  \pre \c flog is \e not \c NULL
+ *
+ *  \return If every request was logged, the FlogError variant FLOG_ERROR_NONE;
+ *          FLOG_ERROR_BATCH if \c input_fd could not be read, otherwise the variant
+ *          representing the error condition of the last request that failed
+ */
+FlogError flog_cli_serve(FlogCli *flog, int input_fd, int reply_fd);
+
 /*! \brief Commit the current log message to the unified logging system.
  *
  *  \param flog A pointer to the FlogCli object
@@ -88,7 +190,13 @@ void flog_cli_set_config(FlogCli *flog, FlogConfig *config);
  */
 void flog_commit_message(FlogCli *flog);
 
-/*! \brief Append the log message to the output file if one has been specified.
+/*! \brief Append the log message to each output file that has been specified.
+ *
+ *  Output file path templates are expanded for the message, and text files are
+ *  opened on first use and kept open in a cache of bounded size for the lifetime
+ *  of the FlogCli object (see router.h). With the asynchronous writer backend the message may not
+ *  have been written when this function returns; use flog_cli_flush() to wait for
+ *  outstanding writes.
  *
  *  \param flog A pointer to the FlogCli object
  *
@@ -99,4 +207,117 @@ void flog_commit_message(FlogCli *flog);
  */
 FlogError flog_append_message_output(FlogCli *flog);
 
+/*! \brief Wait for all log messages appended to the output file to be written.
+ *
+ *  \param flog A pointer to the FlogCli object
+ *
+ *  \pre \c flog is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, otherwise some
+ *          other variant representing an error condition
+ */
+FlogError flog_cli_flush(FlogCli *flog);
+
+/*! \brief Print append file cache statistics to stderr stream.
+ *
+ *  \param flog A pointer to the FlogCli object
+ *
+ *  \pre \c flog is \e not \c NULL
+ */
+void flog_cli_print_stats(const FlogCli *flog);
+
+/*! \brief Run a command and log each line it writes until it exits.
+ *
+ *  The command returned by flog_config_get_command() is run with its stdout and
+ *  stderr streams connected to pipes, which are read as output arrives. Each line
+ *  written to stdout is logged with the options in the FlogConfig object associated
+ *  with the FlogCli object, and each line written to stderr is logged in the same
+ *  way at the error level, so that the lines of each stream are logged in the order
+ *  they were written. Empty lines are skipped, and a line longer than the maximum
+ *  message length is logged in parts. An error on a line is printed to stderr
+ *  stream with its stream and line number. Appended messages are flushed whenever
+ *  all output received so far has been logged. With the multiline option, the lines
+ *  of each stream are joined into records as by flog_cli_read_records().
+ *
+ *  \param flog A pointer to the FlogCli object
+ *
+ *  \pre \c flog is \e not \c NULL
+ *  \pre the FlogConfig object associated with \c flog has a command
+ *
+ *  \return If every line was logged, the FlogError variant FLOG_ERROR_NONE;
+ *          FLOG_ERROR_EXEC if the command could not be run or its output read,
+ *          otherwise the variant representing the error condition of the last
+ *          line that failed
+ */
+FlogError flog_cli_exec(FlogCli *flog);
+
+/*! \brief Join the lines read from a file descriptor into records, logging each
+ *         record until it is closed.
+ *
+ *  A line starts a new record if it matches the record start pattern of the
+ *  FlogConfig object associated with the FlogCli object, or if no pattern is set,
+ *  unless it starts with a space or tab; any other line is added to the record
+ *  before it. Each record is logged with the options in the FlogConfig object once
+ *  the line starting the next arrives, once no more input has arrived within the
+ *  record wait time, or once the input is closed, and a record longer than the
+ *  maximum record length is logged in parts. Empty lines are skipped. An error on a
+ *  record is printed to stderr stream with the number of its first line.
+ *
+ *  \param flog     A pointer to the FlogCli object
+ *  \param input_fd A file descriptor from which lines are read; it is left open
+ *
+ *  \pre \c flog is \e not \c NULL
+ *
+ *  \return If every record was logged, the FlogError variant FLOG_ERROR_NONE;
+ *          FLOG_ERROR_RECORD if the record start pattern is invalid, FLOG_ERROR_INPUT
+ *          if \c input_fd could not be read, otherwise the variant representing the
+ *          error condition of the last record that failed
+ */
+FlogError flog_cli_read_records(FlogCli *flog, int input_fd);
+
+/*! \brief Pass the data read from a file descriptor through to every append file
+ *         unchanged, logging each line of it until it is closed.
+ *
+ *  The data is appended exactly as read, so it is only suitable for text append
+ *  files without a prefix or checksum. Each line is committed with the options in
+ *  the FlogConfig object associated with the FlogCli object, but not appended again;
+ *  empty lines are not committed, and a line longer than the maximum message length
+ *  is committed in parts. With the multiline option, lines are joined into records
+ *  as by flog_cli_read_records() before they are committed.
+ *
+ *  On Linux, when \c input_fd is a pipe and there is a single append file, the data
+ *  is duplicated with tee(2) and moved into the file with splice(2), so that only
+ *  the copy committed to the unified logging system is read into user space. The
+ *  file is then written at its end through a descriptor opened without \c O_APPEND,
+ *  so the data may overwrite, rather than interleave with, data appended to the same
+ *  file by another process at the same time. Otherwise the data is read into user
+ *  space once and written to each file.
+ *
+ *  \param flog      A pointer to the FlogCli object
+ *  \param input_fd  A file descriptor from which data is read
+ *  \param zero_copy Whether to move the data into the append file without copying
+ *                   it through user space where possible
+ *
+ *  \pre \c flog is \e not \c NULL
+ *  \pre the FlogConfig object associated with \c flog has at least one append file
+ *
+ *  \return If all data was passed through and every line logged, the FlogError
+ *          variant FLOG_ERROR_NONE; FLOG_ERROR_INPUT if \c input_fd could not be
+ *          read, FLOG_ERROR_APPEND if an append file could not be written, otherwise
+ *          the variant representing the error condition of the last line that failed
+ */
+FlogError flog_cli_tee(FlogCli *flog, int input_fd, bool zero_copy);
+
+/*! \brief Get the exit status of the command last run by a FlogCli object.
+ *
+ *  \param flog A pointer to the FlogCli object
+ *
+ *  \pre \c flog is \e not \c NULL
+ *
+ *  \return The exit status of the command run by the last call to flog_cli_run(),
+ *          or 128 plus the number of the signal that terminated it, or \c 0 if no
+ *          command was run
+ */
+int flog_cli_get_exit_status(const FlogCli *flog);
+
 #endif //FLOG_H
@@ -0,0 +1,186 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// A loadable builtin for bash that runs flog in the shell process:
+//
+//     enable -f /usr/local/lib/bash/flog.so flog
+//
+// The logger, its log objects and open append files are kept between calls for the
+// life of the shell, so a call costs no more than parsing its options and writing
+// the message.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include "flog.h"
+#include "config.h"
+#include "common.h"
+
+#include <loadables.h>
+
+#define UNUSED(x) (void)(x)
+
+static FlogCli *builtin_flog = NULL;
+static FlogConfig *builtin_config = NULL;
+static pid_t builtin_pid = 0;
+static char builtin_name[] = PROGRAM_NAME;
+
+void flog_builtin_release(void);
+
+int
+flog_builtin(WORD_LIST *list) {
+    int argc = 1;
+    for (WORD_LIST *word = list; word != NULL; word = word->next) {
+        argc++;
+    }
+
+    if (argc == 1 && isatty(fileno(stdin))) {
+        flog_usage();
+        fflush(stdout);
+        return EX_USAGE;
+    }
+
+    char **argv = malloc(sizeof(char *) * (size_t) (argc + 1));
+    if (argv == NULL) {
+        flog_print_error(FLOG_ERROR_ALLOC);
+        return FLOG_ERROR_ALLOC;
+    }
+
+    argv[0] = builtin_name;
+    int index = 1;
+    for (WORD_LIST *word = list; word != NULL; word = word->next) {
+        argv[index++] = word->word->word;
+    }
+    argv[argc] = NULL;
+
+    // Every string is copied into the configuration, so the arguments are not kept
+    FlogError error = FLOG_ERROR_NONE;
+    FlogConfig *config = flog_config_new(argc, argv, &error);
+    free(argv);
+
+    if (config == NULL) {
+        if (error != FLOG_ERROR_OPTS) {
+            flog_print_error(error);
+        }
+        return error;
+    }
+
+    if (flog_config_get_version_flag(config) || flog_config_get_help_flag(config)) {
+        if (flog_config_get_version_flag(config)) {
+            flog_version();
+        } else {
+            flog_usage();
+        }
+        fflush(stdout);
+        flog_config_free(config);
+        return EXECUTION_SUCCESS;
+    }
+
+    // A subshell inherits the logger of the shell it was forked from, whose prefix
+    // holds the pid of that shell, so a new one is created
+    if (builtin_flog != NULL && builtin_pid != getpid()) {
+        flog_builtin_release();
+    }
+
+    // Append files are opened with the writer and datasync setting of the first call
+    if (builtin_flog != NULL &&
+        (flog_config_get_writer(builtin_config) != flog_config_get_writer(config) ||
+         flog_config_get_datasync_flag(builtin_config) != flog_config_get_datasync_flag(config))) {
+        flog_builtin_release();
+    }
+
+    if (builtin_flog == NULL) {
+        builtin_flog = flog_cli_new(config, &error);
+        if (builtin_flog == NULL) {
+            flog_config_free(config);
+            flog_print_error(error);
+            return error;
+        }
+        builtin_pid = getpid();
+    } else {
+        flog_cli_set_config(builtin_flog, config);
+        flog_config_free(builtin_config);
+    }
+
+    builtin_config = config;
+
+    error = flog_cli_run(builtin_flog);
+    int status = error != FLOG_ERROR_NONE ? (int) error : flog_cli_get_exit_status(builtin_flog);
+    fflush(stdout);
+
+    // Append files are only flushed to storage when closed, and a failed writer keeps
+    // its error, so neither is kept for the next call
+    if (error != FLOG_ERROR_NONE || flog_config_get_datasync_flag(config)) {
+        flog_builtin_release();
+    }
+
+    return status;
+}
+
+void
+flog_builtin_release(void) {
+    // The logger of the shell a subshell was forked from may share an io_uring
+    // instance and unwritten buffers with it, so it is abandoned rather than freed
+    if (builtin_flog != NULL) {
+        if (builtin_pid == getpid()) {
+            flog_cli_free(builtin_flog);
+        }
+        builtin_flog = NULL;
+    }
+
+    if (builtin_config != NULL) {
+        flog_config_free(builtin_config);
+        builtin_config = NULL;
+    }
+}
+
+int
+flog_builtin_load(char *name) {
+    UNUSED(name);
+
+    return 1;
+}
+
+void
+flog_builtin_unload(char *name) {
+    UNUSED(name);
+
+    flog_builtin_release();
+}
+
+char *flog_doc[] = {
+    "Write a log message to the unified logging system.",
+    "",
+    "Accepts the same options as the flog command, which is described in",
+    "flog(1), but runs in the shell process. Log objects and append files",
+    "are kept open between calls until the builtin is disabled.",
+    NULL
+};
+
+struct builtin flog_struct = {
+    "flog",
+    flog_builtin,
+    BUILTIN_ENABLED,
+    flog_doc,
+    "flog [options] message",
+    0
+};
@@ -0,0 +1,298 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <popt.h>
+#include "binlog.h"
+#include "record.h"
+#include "config.h"
+#include "common.h"
+
+#define CAT_PROGRAM_NAME "flog-cat"
+#define TIME_BUFF_SIZE 64
+
+static struct poptOption options[] = {
+    { "version",    'v',  POPT_ARG_NONE,    NULL,  'v',  NULL,  NULL },
+    { "help",       'h',  POPT_ARG_NONE,    NULL,  'h',  NULL,  NULL },
+    { "since",      'S',  POPT_ARG_STRING,  NULL,  'S',  NULL,  NULL },
+    { "until",      'U',  POPT_ARG_STRING,  NULL,  'U',  NULL,  NULL },
+    { "level",      'l',  POPT_ARG_STRING,  NULL,  'l',  NULL,  NULL },
+    { "checksum",   'k',  POPT_ARG_NONE,    NULL,  'k',  NULL,  NULL },
+    POPT_TABLEEND
+};
+
+static void
+flog_cat_usage(void) {
+    printf(
+        "%s %s\n"
+        "\n"
+        "Usage:\n"
+        "    %s [options] file...\n"
+        "\n"
+        "Help Options:\n"
+        "    -h, --help       Show this help message\n"
+        "    -v, --version    Print the version string\n"
+        "\n"
+        "Application Options:\n"
+        "    -S, --since <time>     Show records logged at or after a time\n"
+        "    -U, --until <time>     Show records logged at or before a time\n"
+        "    -l, --level <level>    Show records with a log level (may be repeated)\n"
+        "    -k, --checksum         Read text files appended with flog --checksum, reporting torn records\n"
+        "\n"
+        "Time Formats:\n"
+        "    seconds since the epoch, YYYY-MM-DDTHH:MM:SS, or YYYY-MM-DD HH:MM:SS (local time)\n"
+        "\n",
+        CAT_PROGRAM_NAME,
+        PROGRAM_VERSION,
+        CAT_PROGRAM_NAME
+    );
+}
+
+static bool
+flog_cat_parse_time(const char *str, uint64_t *timestamp) {
+    const char *ptr = str;
+    bool numeric = *ptr != '\0';
+
+    for (; *ptr != '\0'; ptr++) {
+        if (!isdigit((unsigned char) *ptr)) {
+            numeric = false;
+            break;
+        }
+    }
+
+    if (numeric) {
+        *timestamp = strtoull(str, NULL, 10) * 1000000000;
+        return true;
+    }
+
+    struct tm tm;
+    memset(&tm, 0, sizeof(tm));
+
+    const char *end = strptime(str, "%Y-%m-%dT%H:%M:%S", &tm);
+    if (end == NULL) {
+        end = strptime(str, "%Y-%m-%d %H:%M:%S", &tm);
+    }
+    if (end == NULL || *end != '\0') {
+        return false;
+    }
+
+    tm.tm_isdst = -1;
+    time_t seconds = mktime(&tm);
+    if (seconds == -1) {
+        return false;
+    }
+
+    *timestamp = (uint64_t) seconds * 1000000000;
+
+    return true;
+}
+
+static bool
+flog_cat_print_record(const FlogBinlogRecord *record, void *context) {
+    (void) context;
+
+    time_t seconds = (time_t) (record->timestamp / 1000000000);
+    long nanoseconds = (long) (record->timestamp % 1000000000);
+
+    struct tm tm;
+    char date[TIME_BUFF_SIZE];
+    char zone[TIME_BUFF_SIZE];
+
+    localtime_r(&seconds, &tm);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &tm);
+    strftime(zone, sizeof(zone), "%z", &tm);
+
+    printf("%s.%06ld%s %-7s ", date, nanoseconds / 1000, zone, flog_config_level_string(record->level));
+
+    if (record->subsystem[0] != '\0') {
+        printf("[%s%s%s] ", record->subsystem, record->category[0] != '\0' ? ":" : "", record->category);
+    }
+
+    fwrite(record->message, 1, record->message_len, stdout);
+    if (record->message_len == 0 || record->message[record->message_len - 1] != '\n') {
+        putchar('\n');
+    }
+
+    return true;
+}
+
+static FlogError
+flog_cat_print_framed_text(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        return FLOG_ERROR_READ;
+    }
+
+    struct stat statbuf;
+    if (fstat(fd, &statbuf) == -1) {
+        close(fd);
+        return FLOG_ERROR_READ;
+    }
+
+    size_t size = (size_t) statbuf.st_size;
+    if (size == 0) {
+        close(fd);
+        return FLOG_ERROR_NONE;
+    }
+
+    const char *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED) {
+        return FLOG_ERROR_READ;
+    }
+
+    size_t offset = 0;
+    size_t torn = 0;
+
+    while (offset < size) {
+        const char *payload;
+        size_t payload_len;
+        size_t consumed;
+
+        FlogRecordStatus status = flog_record_parse(map + offset, size - offset, &payload, &payload_len, &consumed);
+        if (status == RECORD_VALID) {
+            fwrite(payload, 1, payload_len, stdout);
+            putchar('\n');
+        } else if (status == RECORD_TORN) {
+            torn++;
+        } else {
+            torn++;
+            break;
+        }
+
+        offset += consumed;
+    }
+
+    munmap((void *) map, size);
+
+    if (torn > 0) {
+        fprintf(stderr, "%s: %s: %zu torn record%s\n", CAT_PROGRAM_NAME, path, torn, torn == 1 ? "" : "s");
+        return FLOG_ERROR_READ;
+    }
+
+    return FLOG_ERROR_NONE;
+}
+
+int
+main(int argc, char *argv[]) {
+    FlogBinlogQuery query = { .since = 0, .until = UINT64_MAX, .level_mask = 0 };
+    bool framed_text = false;
+
+    poptContext context = poptGetContext("uk.co.fidgetbox.flog-cat", argc, (const char **) argv, options, 0);
+
+    int option;
+    while ((option = poptGetNextOpt(context)) > 0) {
+        char *option_argument = poptGetOptArg(context);
+        FlogConfigLevel level;
+
+        switch (option) {
+            case 'h':
+                flog_cat_usage();
+                poptFreeContext(context);
+                return EXIT_SUCCESS;
+            case 'v':
+                printf("%s %s\n", CAT_PROGRAM_NAME, PROGRAM_VERSION);
+                poptFreeContext(context);
+                return EXIT_SUCCESS;
+            case 'S':
+            case 'U':
+                if (!flog_cat_parse_time(option_argument, option == 'S' ? &query.since : &query.until)) {
+                    fprintf(stderr, "%s: invalid time: %s\n", CAT_PROGRAM_NAME, option_argument);
+                    poptFreeContext(context);
+                    return FLOG_ERROR_OPTS;
+                }
+                break;
+            case 'l':
+                level = flog_config_parse_level(option_argument);
+                if (level == LVL_UNKNOWN) {
+                    fprintf(stderr, "%s: %s\n", CAT_PROGRAM_NAME, flog_error_string(FLOG_ERROR_LVL));
+                    poptFreeContext(context);
+                    return FLOG_ERROR_LVL;
+                }
+                query.level_mask |= 1U << level;
+                break;
+            case 'k':
+                framed_text = true;
+                break;
+        }
+    }
+
+    if (option < -1) {
+        fprintf(stderr, "%s: %s %s\n",
+                CAT_PROGRAM_NAME,
+                poptStrerror(option),
+                poptBadOption(context, POPT_BADOPTION_NOALIAS));
+        poptFreeContext(context);
+        return FLOG_ERROR_OPTS;
+    }
+
+    const char **paths = poptGetArgs(context);
+    if (paths == NULL) {
+        flog_cat_usage();
+        poptFreeContext(context);
+        return FLOG_ERROR_OPTS;
+    }
+
+    FlogError result = FLOG_ERROR_NONE;
+
+    for (; *paths != NULL; paths++) {
+        FlogError error = FLOG_ERROR_NONE;
+
+        if (framed_text) {
+            error = flog_cat_print_framed_text(*paths);
+            if (error != FLOG_ERROR_NONE) {
+                result = error;
+            }
+            continue;
+        }
+
+        FlogBinlogReader *reader = flog_binlog_reader_new(*paths, &error);
+        if (reader == NULL) {
+            fprintf(stderr, "%s: %s: %s\n", CAT_PROGRAM_NAME, *paths, flog_error_string(error));
+            result = error;
+            continue;
+        }
+
+        error = flog_binlog_reader_query(reader, &query, flog_cat_print_record, NULL);
+        if (error != FLOG_ERROR_NONE) {
+            fprintf(stderr, "%s: %s: %s\n", CAT_PROGRAM_NAME, *paths, flog_error_string(error));
+            result = error;
+        }
+
+        flog_binlog_reader_free(reader);
+    }
+
+    poptFreeContext(context);
+
+    return result;
+}
@@ -0,0 +1,656 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// The fortified declarations of syslog(3) would conflict with the definitions below
+#undef _FORTIFY_SOURCE
+
+#include "flog_syslog.h"
+#include <assert.h>
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <time.h>
+#include <unistd.h>
+#include "flog.h"
+#include "config.h"
+#include "common.h"
+
+/*! \brief The header of a message held in a thread's buffer, which is followed by
+ *         the identifier and message strings. */
+typedef struct SyslogRecordData {
+    FlogConfigLevel level;
+    int facility;
+    size_t ident_len;
+    size_t message_len;
+} SyslogRecord;
+
+/*! \brief A buffer of messages logged by a thread. */
+typedef struct SyslogBufferData {
+    struct SyslogBufferData *next;
+    pthread_mutex_t lock;
+    pthread_cond_t drained;
+    bool orphaned;
+    size_t len;
+    char data[SYSLOG_BUFFER_SIZE];
+} SyslogBuffer;
+
+/*! \brief An identifier passed to openlog, kept for the life of the process. */
+typedef struct SyslogIdentData {
+    struct SyslogIdentData *next;
+    char ident[];
+} SyslogIdent;
+
+typedef void (*SyslogOpenFunc)(const char *, int, int);
+typedef void (*SyslogWriteFunc)(int, const char *, va_list);
+typedef void (*SyslogCloseFunc)(void);
+typedef int (*SyslogMaskFunc)(int);
+
+void __syslog_chk(int priority, int flag, const char *format, ...);
+void __vsyslog_chk(int priority, int flag, const char *format, va_list ap);
+
+void flog_syslog_init(void);
+bool flog_syslog_start(void);
+void *flog_syslog_flusher(void *arg);
+SyslogBuffer *flog_syslog_get_buffer(void);
+void flog_syslog_release_buffer(void *buffer);
+void flog_syslog_push(SyslogBuffer *buffer, FlogConfigLevel level, int facility, const char *ident,
+                      const char *message, size_t message_len);
+void flog_syslog_commit(const char *data, size_t len);
+size_t flog_syslog_expand_format(const char *format, int error, char *expanded, size_t size);
+void flog_syslog_before_fork(void);
+void flog_syslog_after_fork_parent(void);
+void flog_syslog_after_fork_child(void);
+
+static const char *
+flog_syslog_facility_map[LOG_NFACILITIES] = {
+    [LOG_FAC(LOG_KERN)]     = "kern",
+    [LOG_FAC(LOG_USER)]     = "user",
+    [LOG_FAC(LOG_MAIL)]     = "mail",
+    [LOG_FAC(LOG_DAEMON)]   = "daemon",
+    [LOG_FAC(LOG_AUTH)]     = "auth",
+    [LOG_FAC(LOG_SYSLOG)]   = "syslog",
+    [LOG_FAC(LOG_LPR)]      = "lpr",
+    [LOG_FAC(LOG_NEWS)]     = "news",
+    [LOG_FAC(LOG_UUCP)]     = "uucp",
+    [LOG_FAC(LOG_CRON)]     = "cron",
+    [LOG_FAC(LOG_AUTHPRIV)] = "authpriv",
+    [LOG_FAC(LOG_FTP)]      = "ftp",
+    [LOG_FAC(LOG_LOCAL0)]   = "local0",
+    [LOG_FAC(LOG_LOCAL1)]   = "local1",
+    [LOG_FAC(LOG_LOCAL2)]   = "local2",
+    [LOG_FAC(LOG_LOCAL3)]   = "local3",
+    [LOG_FAC(LOG_LOCAL4)]   = "local4",
+    [LOG_FAC(LOG_LOCAL5)]   = "local5",
+    [LOG_FAC(LOG_LOCAL6)]   = "local6",
+    [LOG_FAC(LOG_LOCAL7)]   = "local7",
+};
+
+// The openlog state is read on every call without a lock; identifiers are interned,
+// so that each distinct one is copied once and never freed, as another thread may be
+// using it, however often openlog is called
+static _Atomic(const char *) syslog_ident = NULL;
+static pthread_mutex_t syslog_ident_lock = PTHREAD_MUTEX_INITIALIZER;
+static SyslogIdent *syslog_idents = NULL;
+static atomic_int syslog_option = 0;
+static atomic_int syslog_facility = LOG_USER;
+static atomic_int syslog_mask = 0xff;
+
+static pthread_once_t syslog_once = PTHREAD_ONCE_INIT;
+static bool syslog_enabled = false;
+static pthread_key_t syslog_buffer_key;
+static _Thread_local SyslogBuffer *syslog_thread_buffer = NULL;
+
+// Lock order: syslog_flush_lock, then syslog_lock, then a buffer lock
+static pthread_mutex_t syslog_flush_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t syslog_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t syslog_wake = PTHREAD_COND_INITIALIZER;
+static SyslogBuffer *syslog_buffers = NULL;
+static bool syslog_flusher_running = false;
+
+// Owned by whichever thread holds syslog_flush_lock
+static FlogConfig *syslog_defaults = NULL;
+static FlogConfig *syslog_config = NULL;
+static FlogCli *syslog_flog = NULL;
+static char *syslog_scratch = NULL;
+
+void
+openlog(const char *ident, int option, int facility) {
+    if (!flog_syslog_start()) {
+        ((SyslogOpenFunc) dlsym(RTLD_NEXT, "openlog"))(ident, option, facility);
+        return;
+    }
+
+    if (ident != NULL) {
+        const char *copy = flog_syslog_intern_ident(ident);
+        if (copy != NULL) {
+            atomic_store(&syslog_ident, copy);
+        }
+    }
+
+    atomic_store(&syslog_option, option);
+    if (facility != 0 && (facility & ~LOG_FACMASK) == 0) {
+        atomic_store(&syslog_facility, facility);
+    }
+}
+
+const char *
+flog_syslog_intern_ident(const char *ident) {
+    size_t len = strnlen(ident, SUBSYSTEM_LEN - 1);
+
+    // The identifier in use is checked first, as most processes pass the same one each time
+    const char *current = atomic_load(&syslog_ident);
+    if (current != NULL && strncmp(current, ident, len) == 0 && current[len] == '\0') {
+        return current;
+    }
+
+    pthread_mutex_lock(&syslog_ident_lock);
+
+    SyslogIdent *entry = syslog_idents;
+    while (entry != NULL && (strncmp(entry->ident, ident, len) != 0 || entry->ident[len] != '\0')) {
+        entry = entry->next;
+    }
+
+    if (entry == NULL) {
+        entry = malloc(sizeof(SyslogIdent) + len + 1);
+        if (entry != NULL) {
+            memcpy(entry->ident, ident, len);
+            entry->ident[len] = '\0';
+            entry->next = syslog_idents;
+            syslog_idents = entry;
+        }
+    }
+
+    pthread_mutex_unlock(&syslog_ident_lock);
+
+    return entry != NULL ? entry->ident : NULL;
+}
+
+void
+syslog(int priority, const char *format, ...) {
+    va_list ap;
+    va_start(ap, format);
+    vsyslog(priority, format, ap);
+    va_end(ap);
+}
+
+void
+__syslog_chk(int priority, int flag, const char *format, ...) {
+    (void) flag;
+
+    va_list ap;
+    va_start(ap, format);
+    vsyslog(priority, format, ap);
+    va_end(ap);
+}
+
+void
+__vsyslog_chk(int priority, int flag, const char *format, va_list ap) {
+    (void) flag;
+
+    vsyslog(priority, format, ap);
+}
+
+void
+vsyslog(int priority, const char *format, va_list ap) {
+    int saved_errno = errno;
+
+    if (!flog_syslog_start()) {
+        ((SyslogWriteFunc) dlsym(RTLD_NEXT, "vsyslog"))(priority, format, ap);
+        errno = saved_errno;
+        return;
+    }
+
+    if ((LOG_MASK(LOG_PRI(priority)) & atomic_load(&syslog_mask)) == 0) {
+        return;
+    }
+
+    int facility = priority & LOG_FACMASK;
+    if (facility == 0) {
+        facility = atomic_load(&syslog_facility);
+    }
+
+    const char *ident = atomic_load(&syslog_ident);
+    if (ident == NULL) {
+        ident = program_invocation_short_name;
+    }
+
+    char expanded[MESSAGE_LEN];
+    char message[MESSAGE_LEN];
+    if (strstr(format, "%m") != NULL) {
+        flog_syslog_expand_format(format, saved_errno, expanded, MESSAGE_LEN);
+        format = expanded;
+    }
+
+    int len = vsnprintf(message, MESSAGE_LEN, format, ap);
+    if (len < 0) {
+        errno = saved_errno;
+        return;
+    }
+
+    size_t message_len = (size_t) len < MESSAGE_LEN ? (size_t) len : MESSAGE_LEN - 1;
+
+    if (atomic_load(&syslog_option) & LOG_PERROR) {
+        if (atomic_load(&syslog_option) & LOG_PID) {
+            dprintf(STDERR_FILENO, "%s[%d]: %s\n", ident, (int) getpid(), message);
+        } else {
+            dprintf(STDERR_FILENO, "%s: %s\n", ident, message);
+        }
+    }
+
+    SyslogBuffer *buffer = flog_syslog_get_buffer();
+    if (buffer != NULL) {
+        flog_syslog_push(buffer, flog_syslog_level(priority), facility, ident, message, message_len);
+    }
+
+    errno = saved_errno;
+}
+
+void
+closelog(void) {
+    if (!syslog_enabled) {
+        ((SyslogCloseFunc) dlsym(RTLD_NEXT, "closelog"))();
+        return;
+    }
+
+    flog_syslog_flush();
+
+    atomic_store(&syslog_ident, NULL);
+    atomic_store(&syslog_option, 0);
+    atomic_store(&syslog_facility, LOG_USER);
+}
+
+int
+setlogmask(int mask) {
+    if (!flog_syslog_start()) {
+        return ((SyslogMaskFunc) dlsym(RTLD_NEXT, "setlogmask"))(mask);
+    }
+
+    if (mask == 0) {
+        return atomic_load(&syslog_mask);
+    }
+
+    return atomic_exchange(&syslog_mask, mask);
+}
+
+FlogConfigLevel
+flog_syslog_level(int priority) {
+    switch (LOG_PRI(priority)) {
+        case LOG_EMERG:
+        case LOG_ALERT:
+        case LOG_CRIT:
+            return LVL_FAULT;
+        case LOG_ERR:
+            return LVL_ERROR;
+        case LOG_INFO:
+            return LVL_INFO;
+        case LOG_DEBUG:
+            return LVL_DEBUG;
+        default:
+            return LVL_DEFAULT;
+    }
+}
+
+const char *
+flog_syslog_facility_name(int facility) {
+    int index = LOG_FAC(facility);
+
+    if ((facility & ~LOG_FACMASK) != 0 || index >= LOG_NFACILITIES || flog_syslog_facility_map[index] == NULL) {
+        return "";
+    }
+
+    return flog_syslog_facility_map[index];
+}
+
+void
+flog_syslog_flush(void) {
+    if (!syslog_enabled) {
+        return;
+    }
+
+    pthread_mutex_lock(&syslog_flush_lock);
+    pthread_mutex_lock(&syslog_lock);
+
+    SyslogBuffer **link = &syslog_buffers;
+    while (*link != NULL) {
+        SyslogBuffer *buffer = *link;
+
+        // Messages are copied out so that the thread can log again while they are written
+        pthread_mutex_lock(&buffer->lock);
+        size_t len = buffer->len;
+        memcpy(syslog_scratch, buffer->data, len);
+        buffer->len = 0;
+        bool orphaned = buffer->orphaned;
+        pthread_cond_broadcast(&buffer->drained);
+        pthread_mutex_unlock(&buffer->lock);
+
+        if (orphaned) {
+            *link = buffer->next;
+            pthread_mutex_destroy(&buffer->lock);
+            pthread_cond_destroy(&buffer->drained);
+            free(buffer);
+        } else {
+            link = &buffer->next;
+        }
+
+        flog_syslog_commit(syslog_scratch, len);
+    }
+
+    pthread_mutex_unlock(&syslog_lock);
+
+    FlogError error = flog_cli_flush(syslog_flog);
+    if (error != FLOG_ERROR_NONE) {
+        flog_print_error(error);
+    }
+
+    pthread_mutex_unlock(&syslog_flush_lock);
+}
+
+void
+flog_syslog_init(void) {
+    const char *options = getenv(SYSLOG_OPTIONS_ENV);
+
+    FlogError error = FLOG_ERROR_NONE;
+    syslog_defaults = flog_config_new_from_options(options != NULL ? options : "", &error);
+    if (syslog_defaults == NULL) {
+        fprintf(stderr, "%s: %s: %s; using syslog\n", PROGRAM_NAME, SYSLOG_OPTIONS_ENV, flog_error_string(error));
+        return;
+    }
+
+    syslog_config = flog_config_new_with_defaults(syslog_defaults, &error);
+    if (syslog_config != NULL) {
+        syslog_flog = flog_cli_new(syslog_config, &error);
+    }
+
+    // Rate limits are kept in memory, as the process is expected to log many messages
+    if (syslog_flog != NULL) {
+        error = flog_cli_init_screening(syslog_flog, syslog_defaults, false);
+    }
+
+    syslog_scratch = malloc(SYSLOG_BUFFER_SIZE);
+    if (syslog_scratch == NULL) {
+        error = FLOG_ERROR_ALLOC;
+    }
+
+    if (syslog_flog == NULL || error != FLOG_ERROR_NONE ||
+        pthread_key_create(&syslog_buffer_key, flog_syslog_release_buffer) != 0) {
+        fprintf(stderr, "%s: %s; using syslog\n", PROGRAM_NAME,
+                flog_error_string(error != FLOG_ERROR_NONE ? error : FLOG_ERROR_ALLOC));
+        return;
+    }
+
+    pthread_atfork(flog_syslog_before_fork, flog_syslog_after_fork_parent, flog_syslog_after_fork_child);
+    atexit(flog_syslog_flush);
+
+    syslog_enabled = true;
+}
+
+bool
+flog_syslog_start(void) {
+    pthread_once(&syslog_once, flog_syslog_init);
+
+    return syslog_enabled;
+}
+
+void *
+flog_syslog_flusher(void *arg) {
+    (void) arg;
+
+    pthread_mutex_lock(&syslog_lock);
+
+    for (;;) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += SYSLOG_FLUSH_INTERVAL * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        pthread_cond_timedwait(&syslog_wake, &syslog_lock, &deadline);
+
+        pthread_mutex_unlock(&syslog_lock);
+        flog_syslog_flush();
+        pthread_mutex_lock(&syslog_lock);
+    }
+
+    return NULL;
+}
+
+SyslogBuffer *
+flog_syslog_get_buffer(void) {
+    if (syslog_thread_buffer != NULL) {
+        return syslog_thread_buffer;
+    }
+
+    SyslogBuffer *buffer = calloc(1, sizeof(SyslogBuffer));
+    if (buffer == NULL) {
+        return NULL;
+    }
+
+    pthread_mutex_init(&buffer->lock, NULL);
+    pthread_cond_init(&buffer->drained, NULL);
+
+    pthread_mutex_lock(&syslog_lock);
+
+    // The flusher is started by the first message, and again in a forked child
+    if (!syslog_flusher_running) {
+        pthread_t thread;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        syslog_flusher_running = pthread_create(&thread, &attr, flog_syslog_flusher, NULL) == 0;
+        pthread_attr_destroy(&attr);
+    }
+
+    if (!syslog_flusher_running) {
+        pthread_mutex_unlock(&syslog_lock);
+        pthread_mutex_destroy(&buffer->lock);
+        pthread_cond_destroy(&buffer->drained);
+        free(buffer);
+        return NULL;
+    }
+
+    buffer->next = syslog_buffers;
+    syslog_buffers = buffer;
+
+    pthread_mutex_unlock(&syslog_lock);
+
+    pthread_setspecific(syslog_buffer_key, buffer);
+    syslog_thread_buffer = buffer;
+
+    return buffer;
+}
+
+void
+flog_syslog_release_buffer(void *buffer) {
+    SyslogBuffer *thread_buffer = buffer;
+
+    // The buffer is freed by the flusher once its messages have been written
+    pthread_mutex_lock(&thread_buffer->lock);
+    thread_buffer->orphaned = true;
+    pthread_mutex_unlock(&thread_buffer->lock);
+
+    pthread_cond_signal(&syslog_wake);
+}
+
+void
+flog_syslog_push(SyslogBuffer *buffer, FlogConfigLevel level, int facility, const char *ident,
+                 const char *message, size_t message_len) {
+    SyslogRecord record = {
+        .level = level,
+        .facility = facility,
+        .ident_len = strnlen(ident, SUBSYSTEM_LEN - 1),
+        .message_len = message_len
+    };
+
+    size_t size = sizeof(SyslogRecord) + record.ident_len + record.message_len;
+
+    pthread_mutex_lock(&buffer->lock);
+
+    // Only a thread whose buffer is full waits for the flusher
+    while (SYSLOG_BUFFER_SIZE - buffer->len < size) {
+        pthread_cond_signal(&syslog_wake);
+        pthread_cond_wait(&buffer->drained, &buffer->lock);
+    }
+
+    char *data = buffer->data + buffer->len;
+    memcpy(data, &record, sizeof(SyslogRecord));
+    memcpy(data + sizeof(SyslogRecord), ident, record.ident_len);
+    memcpy(data + sizeof(SyslogRecord) + record.ident_len, message, record.message_len);
+    buffer->len += size;
+
+    bool half_full = buffer->len >= SYSLOG_BUFFER_SIZE / 2;
+
+    pthread_mutex_unlock(&buffer->lock);
+
+    if (half_full) {
+        pthread_cond_signal(&syslog_wake);
+    }
+}
+
+void
+flog_syslog_commit(const char *data, size_t len) {
+    char ident[SUBSYSTEM_LEN];
+    char message[MESSAGE_LEN];
+
+    const char *end = data + len;
+    while (data < end) {
+        SyslogRecord record;
+        memcpy(&record, data, sizeof(SyslogRecord));
+        data += sizeof(SyslogRecord);
+
+        memcpy(ident, data, record.ident_len);
+        ident[record.ident_len] = '\0';
+        data += record.ident_len;
+
+        memcpy(message, data, record.message_len);
+        message[record.message_len] = '\0';
+        data += record.message_len;
+
+        flog_config_reset(syslog_config);
+
+        // A subsystem or category given in the options takes precedence
+        FlogError error = FLOG_ERROR_NONE;
+        if (strlen(flog_config_get_subsystem(syslog_defaults)) == 0) {
+            error = flog_config_set_subsystem(syslog_config, ident);
+            if (error == FLOG_ERROR_NONE) {
+                error = flog_config_set_category(syslog_config, flog_syslog_facility_name(record.facility));
+            }
+        }
+
+        flog_config_set_level(syslog_config, record.level);
+
+        // Messages are screened as the flog command screens them (see flog_cli_log_message())
+        if (error == FLOG_ERROR_NONE) {
+            error = flog_config_set_message(syslog_config, message);
+        }
+
+        if (error == FLOG_ERROR_NONE) {
+            error = flog_cli_log_message(syslog_flog, syslog_config);
+        }
+
+        if (error != FLOG_ERROR_NONE) {
+            flog_print_error(error);
+        }
+    }
+}
+
+size_t
+flog_syslog_expand_format(const char *format, int error, char *expanded, size_t size) {
+    const char *error_string = strerror(error);
+    size_t len = 0;
+
+    // %m is replaced with the error string, whose own % characters are escaped
+    for (const char *c = format; *c != '\0' && len + 2 < size; c++) {
+        if (c[0] == '%' && c[1] == '%') {
+            expanded[len++] = *c++;
+            expanded[len++] = *c;
+        } else if (c[0] == '%' && c[1] == 'm') {
+            for (const char *e = error_string; *e != '\0' && len + 2 < size; e++) {
+                if (*e == '%') {
+                    expanded[len++] = '%';
+                }
+                expanded[len++] = *e;
+            }
+            c++;
+        } else {
+            expanded[len++] = *c;
+        }
+    }
+
+    expanded[len] = '\0';
+
+    return len;
+}
+
+void
+flog_syslog_before_fork(void) {
+    pthread_mutex_lock(&syslog_ident_lock);
+    pthread_mutex_lock(&syslog_flush_lock);
+    pthread_mutex_lock(&syslog_lock);
+
+    for (SyslogBuffer *buffer = syslog_buffers; buffer != NULL; buffer = buffer->next) {
+        pthread_mutex_lock(&buffer->lock);
+    }
+}
+
+void
+flog_syslog_after_fork_parent(void) {
+    for (SyslogBuffer *buffer = syslog_buffers; buffer != NULL; buffer = buffer->next) {
+        pthread_mutex_unlock(&buffer->lock);
+    }
+
+    pthread_mutex_unlock(&syslog_lock);
+    pthread_mutex_unlock(&syslog_flush_lock);
+    pthread_mutex_unlock(&syslog_ident_lock);
+}
+
+void
+flog_syslog_after_fork_child(void) {
+    // Buffered messages are written by the parent, and only the forking thread exists
+    for (SyslogBuffer *buffer = syslog_buffers; buffer != NULL; buffer = buffer->next) {
+        buffer->len = 0;
+        buffer->orphaned = buffer != syslog_thread_buffer;
+        pthread_mutex_unlock(&buffer->lock);
+    }
+
+    // The logger may share an io_uring instance with the parent, so it is replaced
+    // (and the parent's copy abandoned) rather than used or freed
+    FlogError error = FLOG_ERROR_NONE;
+    FlogCli *flog = flog_cli_new(syslog_config, &error);
+    if (flog != NULL && flog_cli_init_screening(flog, syslog_defaults, false) == FLOG_ERROR_NONE) {
+        syslog_flog = flog;
+    }
+
+    syslog_flusher_running = false;
+
+    pthread_mutex_unlock(&syslog_lock);
+    pthread_mutex_unlock(&syslog_flush_lock);
+    pthread_mutex_unlock(&syslog_ident_lock);
+}
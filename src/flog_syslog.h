@@ -0,0 +1,93 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_SYSLOG_H
+#define FLOG_SYSLOG_H
+
+/*! \file flog_syslog.h
+ *
+ *  A preloadable library that replaces syslog(3) with the flog logging pipeline:
+ *
+ *  <tt>LD_PRELOAD=libflog_syslog.so FLOG_SYSLOG_OPTIONS='-a /var/log/daemon.log' daemon</tt>
+ *
+ *  The library defines \c openlog, \c syslog, \c vsyslog, \c closelog and
+ *  \c setlogmask (and the fortified \c __syslog_chk and \c __vsyslog_chk), so that
+ *  they take the place of the C library functions in a process it is preloaded
+ *  into. Each message is logged with the level mapped from its priority (see
+ *  flog_syslog_level()), the \c openlog identifier as its subsystem and the name of
+ *  its facility as its category, along with the flog options in the
+ *  \c FLOG_SYSLOG_OPTIONS environment variable.
+ *
+ *  A call to \c syslog formats the message into a buffer owned by the calling thread
+ *  and returns; a background thread commits and appends buffered messages every
+ *  \c SYSLOG_FLUSH_INTERVAL milliseconds, or sooner when a buffer is half full. A
+ *  thread only waits when its buffer is full. Buffered messages are also written
+ *  by \c closelog and when the process exits normally, but are lost if it exits
+ *  abnormally. If the options cannot be parsed, calls are passed on to the C library
+ *  functions.
+ */
+
+#include "config.h"
+
+#define SYSLOG_OPTIONS_ENV "FLOG_SYSLOG_OPTIONS"
+#define SYSLOG_BUFFER_SIZE 65536
+#define SYSLOG_FLUSH_INTERVAL 50
+
+/*! \brief Return the log level for a syslog priority.
+ *
+ *  \c LOG_EMERG, \c LOG_ALERT and \c LOG_CRIT map to \c LVL_FAULT; \c LOG_ERR to
+ *  \c LVL_ERROR; \c LOG_WARNING and \c LOG_NOTICE to \c LVL_DEFAULT; \c LOG_INFO to
+ *  \c LVL_INFO, and \c LOG_DEBUG to \c LVL_DEBUG.
+ *
+ *  \param priority A syslog priority, which may include a facility
+ *
+ *  \return A FlogConfigLevel value representing the log level
+ */
+FlogConfigLevel flog_syslog_level(int priority);
+
+/*! \brief Return the name of a syslog facility.
+ *
+ *  \param facility A syslog facility value such as \c LOG_DAEMON
+ *
+ *  \return A pointer to the null-terminated facility name, such as \c daemon, or
+ *          an empty string if the facility is not recognised
+ */
+const char * flog_syslog_facility_name(int facility);
+
+/*! \brief Return the copy of an openlog identifier kept for the life of the process.
+ *
+ *  Each distinct identifier, truncated to the length of a subsystem name, is copied
+ *  once, so that a process calling \c openlog before every message does not use more
+ *  memory with each call.
+ *
+ *  \param ident A pointer to the null-terminated identifier
+ *
+ *  \return A pointer to the copy, or \c NULL if memory for it could not be allocated
+ */
+const char * flog_syslog_intern_ident(const char *ident);
+
+/*! \brief Commit and append every buffered message, and wait for appended messages
+ *         to be written.
+ */
+void flog_syslog_flush(void);
+
+#endif //FLOG_SYSLOG_H
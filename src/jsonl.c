@@ -0,0 +1,84 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "jsonl.h"
+#include "fields.h"
+#include "config.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifdef UNIT_TESTING
+#include "../test/testing.h"
+#endif
+
+bool flog_jsonl_append(char *buf, size_t size, size_t *len, const char *str, size_t str_len);
+
+size_t
+flog_jsonl_render(const FlogJsonlRecord *record, char *buf, size_t size) {
+    assert(record != NULL);
+    assert(record->time != NULL);
+    assert(record->subsystem != NULL);
+    assert(record->category != NULL);
+    assert(record->message != NULL);
+    assert(buf != NULL);
+    assert(size > 0);
+
+    const char *level = flog_config_level_string(record->level);
+    const char *private = record->message_type == MSG_PRIVATE ? "true" : "false";
+
+    // Member names and values that never need escaping are copied as they are
+    size_t len = 0;
+    bool fits = flog_jsonl_append(buf, size, &len, "{\"ts\":\"", 7) &&
+                flog_jsonl_append(buf, size, &len, record->time, record->time_len) &&
+                flog_jsonl_append(buf, size, &len, "\",\"level\":\"", 11) &&
+                flog_jsonl_append(buf, size, &len, level, strlen(level)) &&
+                flog_jsonl_append(buf, size, &len, "\",\"subsystem\":", 14) &&
+                flog_fields_append_quoted(buf, size, &len, record->subsystem, strlen(record->subsystem)) &&
+                flog_jsonl_append(buf, size, &len, ",\"category\":", 12) &&
+                flog_fields_append_quoted(buf, size, &len, record->category, strlen(record->category)) &&
+                flog_jsonl_append(buf, size, &len, ",\"private\":", 11) &&
+                flog_jsonl_append(buf, size, &len, private, strlen(private)) &&
+                flog_jsonl_append(buf, size, &len, ",\"msg\":", 7) &&
+                flog_fields_append_quoted(buf, size, &len, record->message, record->message_len) &&
+                flog_jsonl_append(buf, size, &len, "}", 1);
+
+    if (!fits) {
+        len = 0;
+    }
+
+    buf[len] = '\0';
+
+    return len;
+}
+
+bool
+flog_jsonl_append(char *buf, size_t size, size_t *len, const char *str, size_t str_len) {
+    if (*len + str_len >= size) {
+        return false;
+    }
+
+    memcpy(buf + *len, str, str_len);
+    *len += str_len;
+
+    return true;
+}
@@ -0,0 +1,78 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_JSONL_H
+#define FLOG_JSONL_H
+
+/*! \file jsonl.h
+ *
+ *  Helper functions for rendering log messages appended to JSON Lines files.
+ *
+ *  Each record is a single line holding a JSON object with the members \c ts (the
+ *  local time in RFC 3339 format with microsecond precision), \c level, \c subsystem,
+ *  \c category, \c private and \c msg, in that order:
+ *
+ *  <tt>{"ts":"2026-10-19T09:00:00.123456+01:00","level":"error","subsystem":"com.example.app",
+ *  "category":"network","private":false,"msg":"request failed"}</tt>
+ *
+ *  Strings are escaped with flog_fields_append_quoted(), which copies them a 64-bit
+ *  word at a time and examines only the words that hold a byte to be escaped, so that
+ *  a record costs little more to render than the equivalent text prefix.
+ */
+
+#include <stddef.h>
+#include "config.h"
+#include "prefix.h"
+
+#define JSONL_LEN (PREFIX_TIME_LEN + 6 * (SUBSYSTEM_LEN + CATEGORY_LEN + MESSAGE_LEN) + 96)
+
+/*! \brief A type representing a single log record in a JSON Lines file. */
+typedef struct FlogJsonlRecordData {
+    const char *time;
+    size_t time_len;
+    FlogConfigLevel level;
+    FlogConfigMessageType message_type;
+    const char *subsystem;
+    const char *category;
+    const char *message;
+    size_t message_len;
+} FlogJsonlRecord;
+
+/*! \brief Render a record as a JSON object.
+ *
+ *  The object is not followed by a newline, and the buffer is always null-terminated.
+ *  The time is copied as it is and must need no escaping.
+ *
+ *  \param[in]  record A pointer to the record
+ *  \param[out] buf    A pointer to a buffer that will receive the object
+ *  \param[in]  size   The size of the buffer in bytes; \c JSONL_LEN is always
+ *                     sufficient for names and messages within the configured limits
+ *
+ *  \pre \c record, \c buf and the strings of \c record are \e not \c NULL
+ *  \pre \c size is greater than zero
+ *
+ *  \return The number of bytes rendered, excluding the null terminator, or zero if
+ *          the object does not fit in the buffer
+ */
+size_t flog_jsonl_render(const FlogJsonlRecord *record, char *buf, size_t size);
+
+#endif //FLOG_JSONL_H
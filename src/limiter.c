@@ -0,0 +1,290 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "limiter.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "checksum.h"
+
+#ifdef UNIT_TESTING
+#include "../test/testing.h"
+#endif
+
+#define LIMITER_FILE_MAGIC 0x666c6f6772617465u
+#define LIMITER_NS_PER_MS 1000000
+
+/*! \brief A type representing the bucket of a rate limit, as kept in memory or in a state file. */
+typedef struct LimiterSlot {
+    _Atomic uint64_t key;
+    // The time at which the bucket will next be full
+    _Atomic int64_t arrival;
+    _Atomic uint64_t suppressed;
+    uint64_t reserved;
+} LimiterSlot;
+
+/*! \brief A type representing the layout of a state file. */
+typedef struct LimiterFile {
+    _Atomic uint64_t magic;
+    uint64_t reserved;
+    LimiterSlot slots[LIMITER_SLOT_COUNT];
+} LimiterFile;
+
+/*! \brief A type representing a rate limit and its bucket. */
+typedef struct LimiterRule {
+    char subsystem[SUBSYSTEM_LEN];
+    char category[CATEGORY_LEN];
+    FlogConfigLevel level;
+    bool unlimited;
+    // The time in nanoseconds taken to refill one token, and the time by which the
+    // arrival time may run ahead of the current time while tokens remain
+    int64_t interval;
+    int64_t tolerance;
+    LimiterSlot *slot;
+    LimiterSlot local;
+    // The group of the last message suppressed, given to the summary of a bucket in memory
+    char last_subsystem[SUBSYSTEM_LEN];
+    char last_category[CATEGORY_LEN];
+    FlogConfigLevel last_level;
+} LimiterRule;
+
+struct FlogLimiterData {
+    LimiterFile *file;
+    size_t rule_count;
+    LimiterRule rules[];
+};
+
+LimiterFile *flog_limiter_map_file(const char *path);
+
+LimiterSlot *flog_limiter_find_slot(LimiterFile *file, const LimiterRule *rule);
+
+LimiterRule *flog_limiter_find_rule(FlogLimiter *limiter, const char *subsystem, const char *category,
+                                    FlogConfigLevel level);
+
+FlogLimiter *
+flog_limiter_new(const FlogConfig *config, const char *path, FlogError *error) {
+    assert(config != NULL);
+    assert(error != NULL);
+
+    *error = FLOG_ERROR_NONE;
+
+    size_t rule_count = flog_config_get_rate_limit_count(config);
+    FlogLimiter *limiter = calloc(1, sizeof(struct FlogLimiterData) + rule_count * sizeof(LimiterRule));
+    if (limiter == NULL) {
+        *error = FLOG_ERROR_ALLOC;
+        return NULL;
+    }
+
+    limiter->rule_count = rule_count;
+
+    for (size_t i = 0; i < rule_count; i++) {
+        const FlogConfigRateLimit *limit = flog_config_get_rate_limit_at(config, i);
+        LimiterRule *rule = &limiter->rules[i];
+
+        strlcpy(rule->subsystem, limit->subsystem, SUBSYSTEM_LEN);
+        strlcpy(rule->category, limit->category, CATEGORY_LEN);
+        rule->level = limit->level;
+        rule->unlimited = limit->count == 0;
+        rule->slot = &rule->local;
+
+        if (!rule->unlimited) {
+            rule->interval = (int64_t) limit->period * LIMITER_NS_PER_MS / (int64_t) limit->count;
+            rule->tolerance = rule->interval * (int64_t) (limit->count - 1);
+        }
+    }
+
+    if (path != NULL) {
+        limiter->file = flog_limiter_map_file(path);
+    }
+
+    // Rules that find no free slot in the state file keep their buckets in memory
+    for (size_t i = 0; limiter->file != NULL && i < rule_count; i++) {
+        LimiterRule *rule = &limiter->rules[i];
+        LimiterSlot *slot = rule->unlimited ? NULL : flog_limiter_find_slot(limiter->file, rule);
+        if (slot != NULL) {
+            rule->slot = slot;
+        }
+    }
+
+    return limiter;
+}
+
+void
+flog_limiter_free(FlogLimiter *limiter) {
+    assert(limiter != NULL);
+
+    if (limiter->file != NULL) {
+        munmap(limiter->file, sizeof(LimiterFile));
+    }
+
+    free(limiter);
+}
+
+bool
+flog_limiter_is_shared(const FlogLimiter *limiter) {
+    assert(limiter != NULL);
+
+    return limiter->file != NULL;
+}
+
+bool
+flog_limiter_acquire(FlogLimiter *limiter, const char *subsystem, const char *category, FlogConfigLevel level,
+                     int64_t now, unsigned long *suppressed) {
+    assert(limiter != NULL);
+    assert(subsystem != NULL);
+    assert(category != NULL);
+    assert(suppressed != NULL);
+
+    *suppressed = 0;
+
+    LimiterRule *rule = flog_limiter_find_rule(limiter, subsystem, category, level);
+    if (rule == NULL || rule->unlimited) {
+        return true;
+    }
+
+    LimiterSlot *slot = rule->slot;
+    int64_t arrival = atomic_load(&slot->arrival);
+    int64_t next_arrival;
+
+    do {
+        // An arrival time further ahead than any a bucket reaches was left by a state
+        // file from before the monotonic clock was last reset, and is ignored
+        int64_t start = now;
+        if (arrival > now && arrival - now <= rule->tolerance + rule->interval) {
+            start = arrival;
+        }
+
+        if (start - now > rule->tolerance) {
+            atomic_fetch_add(&slot->suppressed, 1);
+
+            strlcpy(rule->last_subsystem, subsystem, SUBSYSTEM_LEN);
+            strlcpy(rule->last_category, category, CATEGORY_LEN);
+            rule->last_level = level;
+
+            return false;
+        }
+
+        next_arrival = start + rule->interval;
+    } while (!atomic_compare_exchange_weak(&slot->arrival, &arrival, next_arrival));
+
+    *suppressed = (unsigned long) atomic_exchange(&slot->suppressed, 0);
+
+    return true;
+}
+
+bool
+flog_limiter_next_summary(FlogLimiter *limiter, FlogLimiterSummary *summary) {
+    assert(limiter != NULL);
+    assert(summary != NULL);
+
+    for (size_t i = 0; i < limiter->rule_count; i++) {
+        LimiterRule *rule = &limiter->rules[i];
+        if (rule->slot != &rule->local) {
+            continue;
+        }
+
+        unsigned long count = (unsigned long) atomic_exchange(&rule->local.suppressed, 0);
+        if (count > 0) {
+            memcpy(summary->subsystem, rule->last_subsystem, SUBSYSTEM_LEN);
+            memcpy(summary->category, rule->last_category, CATEGORY_LEN);
+            summary->level = rule->last_level;
+            summary->count = count;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+LimiterFile *
+flog_limiter_map_file(const char *path) {
+    int fd = open(path, O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd == -1) {
+        return NULL;
+    }
+
+    // The file may be in a directory shared with other users, so one they own is never used
+    struct stat statbuf;
+    LimiterFile *file = MAP_FAILED;
+
+    if (fstat(fd, &statbuf) == 0 && S_ISREG(statbuf.st_mode) && statbuf.st_uid == geteuid() &&
+        ((size_t) statbuf.st_size >= sizeof(LimiterFile) || ftruncate(fd, sizeof(LimiterFile)) == 0)) {
+        file = mmap(NULL, sizeof(LimiterFile), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+
+    close(fd);
+
+    if (file == MAP_FAILED) {
+        return NULL;
+    }
+
+    // A new file is zero-filled, and is marked by whichever process maps it first
+    uint64_t magic = 0;
+    if (!atomic_compare_exchange_strong(&file->magic, &magic, LIMITER_FILE_MAGIC) && magic != LIMITER_FILE_MAGIC) {
+        munmap(file, sizeof(LimiterFile));
+        return NULL;
+    }
+
+    return file;
+}
+
+LimiterSlot *
+flog_limiter_find_slot(LimiterFile *file, const LimiterRule *rule) {
+    // Processes using the same rule find the same slot, whatever the order of their rules
+    uint64_t fields[] = { (uint64_t) rule->level, (uint64_t) rule->interval, (uint64_t) rule->tolerance };
+    uint32_t crc = flog_crc32c(0, rule->subsystem, strlen(rule->subsystem) + 1);
+    crc = flog_crc32c(crc, rule->category, strlen(rule->category) + 1);
+    crc = flog_crc32c(crc, fields, sizeof(fields));
+
+    uint64_t key = ((uint64_t) crc << 32) | 1;
+
+    for (size_t i = 0; i < LIMITER_SLOT_COUNT; i++) {
+        LimiterSlot *slot = &file->slots[(crc + i) % LIMITER_SLOT_COUNT];
+
+        // An empty slot is claimed for the rule unless another process claims it first
+        uint64_t slot_key = 0;
+        if (atomic_compare_exchange_strong(&slot->key, &slot_key, key) || slot_key == key) {
+            return slot;
+        }
+    }
+
+    return NULL;
+}
+
+LimiterRule *
+flog_limiter_find_rule(FlogLimiter *limiter, const char *subsystem, const char *category, FlogConfigLevel level) {
+    for (size_t i = 0; i < limiter->rule_count; i++) {
+        LimiterRule *rule = &limiter->rules[i];
+        if ((rule->level == LVL_UNKNOWN || rule->level == level) &&
+            (rule->subsystem[0] == '\0' || strcmp(rule->subsystem, subsystem) == 0) &&
+            (rule->category[0] == '\0' || strcmp(rule->category, category) == 0)) {
+            return rule;
+        }
+    }
+
+    return NULL;
+}
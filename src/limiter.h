@@ -0,0 +1,139 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_LIMITER_H
+#define FLOG_LIMITER_H
+
+/*! \file limiter.h
+ *
+ *  Limiter object and associated functions for limiting the rate at which messages
+ *  are logged.
+ *
+ *  Each rate limit of a configuration is a token bucket holding up to \c count
+ *  tokens, refilled at \c count tokens per period, and a message matching the limit
+ *  is logged only if it can take a token. A message is checked against the first
+ *  limit it matches alone, so a limit of \c unlimited placed first exempts messages
+ *  from those that follow. Messages that are not logged are counted, and the count
+ *  is returned when the next message is allowed.
+ *
+ *  Buckets are kept as the theoretical arrival time of the next message (the
+ *  generic cell rate algorithm), a single 64-bit value updated by compare-and-swap,
+ *  so no lock is taken. A limiter created with a state file keeps its buckets in a
+ *  shared mapping of the file, so that short-lived processes using the same limits
+ *  share their budget; if the file cannot be used, the buckets are kept in memory.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "common.h"
+
+#define LIMITER_SLOT_COUNT 256
+
+/*! \brief A type representing the number of messages suppressed by a rate limit. */
+typedef struct FlogLimiterSummaryData {
+    char subsystem[SUBSYSTEM_LEN];
+    char category[CATEGORY_LEN];
+    FlogConfigLevel level;
+    unsigned long count;
+} FlogLimiterSummary;
+
+/*! \struct FlogLimiter
+ *
+ *  \brief An opaque type representing a FlogLimiter message rate limiter object.
+ */
+typedef struct FlogLimiterData FlogLimiter;
+
+/*! \brief Create a FlogLimiter object for the rate limits of a configuration.
+ *
+ *  \param[in]  config A pointer to the FlogConfig object whose rate limits are applied
+ *  \param[in]  path   A pointer to the null-terminated path of a state file shared
+ *                     with other processes, created if necessary, or \c NULL to keep
+ *                     the buckets in memory
+ *  \param[out] error  A pointer to a FlogError object that will be used to represent
+ *                     an error condition on failure
+ *
+ *  \pre \c config is \e not \c NULL
+ *  \pre \c error is \e not \c NULL
+ *
+ *  \return If successful, a pointer to a FlogLimiter object; if there is an error a
+ *          \c NULL pointer is returned and \c error will be set to FLOG_ERROR_ALLOC
+ */
+FlogLimiter * flog_limiter_new(const FlogConfig *config, const char *path, FlogError *error);
+
+/*! \brief Free a FlogLimiter object, unmapping its state file.
+ *
+ *  \param limiter A pointer to the FlogLimiter object
+ *
+ *  \pre \c limiter is \e not \c NULL
+ */
+void flog_limiter_free(FlogLimiter *limiter);
+
+/*! \brief Determine whether a FlogLimiter object keeps its buckets in a state file.
+ *
+ *  \param limiter A pointer to the FlogLimiter object
+ *
+ *  \pre \c limiter is \e not \c NULL
+ *
+ *  \return \c true if the buckets are shared through the state file, otherwise \c false
+ */
+bool flog_limiter_is_shared(const FlogLimiter *limiter);
+
+/*! \brief Take a token for a message from the bucket of the first limit it matches.
+ *
+ *  \param[in]  limiter    A pointer to the FlogLimiter object
+ *  \param[in]  subsystem  A pointer to the null-terminated subsystem name
+ *  \param[in]  category   A pointer to the null-terminated category name
+ *  \param[in]  level      The log level of the message
+ *  \param[in]  now        The current time in nanoseconds, from a monotonic clock
+ *  \param[out] suppressed A pointer to a value that receives the number of messages
+ *                         suppressed by the limit since a message was last allowed,
+ *                         by this or any process sharing the state file, if the
+ *                         message is allowed, and zero otherwise
+ *
+ *  \pre \c limiter, \c subsystem, \c category and \c suppressed are \e not \c NULL
+ *
+ *  \return \c true if the message should be logged, or \c false if it exceeds its
+ *          rate limit
+ */
+bool flog_limiter_acquire(FlogLimiter *limiter, const char *subsystem, const char *category, FlogConfigLevel level,
+                          int64_t now, unsigned long *suppressed);
+
+/*! \brief Take the count of messages suppressed by the next limit that has any.
+ *
+ *  The summary is given the subsystem, category and level of the last message the
+ *  limit suppressed. Counts in a state file are left to be returned to the next
+ *  message allowed by a process sharing it, so none are taken from a shared limiter.
+ *
+ *  \param[in]  limiter A pointer to the FlogLimiter object
+ *  \param[out] summary A pointer to a FlogLimiterSummary object that receives the
+ *                      summary
+ *
+ *  \pre \c limiter is \e not \c NULL
+ *  \pre \c summary is \e not \c NULL
+ *
+ *  \return \c true if a summary was taken, or \c false if no messages remain counted
+ */
+bool flog_limiter_next_summary(FlogLimiter *limiter, FlogLimiterSummary *summary);
+
+#endif //FLOG_LIMITER_H
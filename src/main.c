@@ -61,19 +61,12 @@ main(int argc, char *argv[]) {
         return error;
     }
 
-    error = FLOG_ERROR_NONE;
-    error = flog_append_message_output(flog);
-    if (error != FLOG_ERROR_NONE) {
-        flog_cli_free(flog);
-        flog_config_free(config);
-        flog_print_error(error);
-        return error;
-    }
-
-    flog_commit_message(flog);
+    // A command run with --exec that fails is reported with its own exit status
+    error = flog_cli_run(flog);
+    int status = error != FLOG_ERROR_NONE ? (int) error : flog_cli_get_exit_status(flog);
 
     flog_cli_free(flog);
     flog_config_free(config);
 
-    return EXIT_SUCCESS;
+    return status;
 }
@@ -0,0 +1,125 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pattern.h"
+#include <assert.h>
+#include <string.h>
+
+#ifdef UNIT_TESTING
+#include "../test/testing.h"
+#endif
+
+#define PATTERN_OPERATORS ".[]()*+?{}|^$"
+
+bool
+flog_pattern_compile(regex_t *regex, const char *pattern) {
+    assert(regex != NULL);
+    assert(pattern != NULL);
+
+    if (flog_pattern_has_backreference(pattern)) {
+        return false;
+    }
+
+    // Input is only tested for a match, so no submatch positions are recorded
+    return regcomp(regex, pattern, REG_EXTENDED | REG_NOSUB) == 0;
+}
+
+bool
+flog_pattern_is_valid(const char *pattern) {
+    assert(pattern != NULL);
+
+    regex_t regex;
+    if (!flog_pattern_compile(&regex, pattern)) {
+        return false;
+    }
+
+    regfree(&regex);
+
+    return true;
+}
+
+bool
+flog_pattern_has_backreference(const char *pattern) {
+    assert(pattern != NULL);
+
+    bool in_bracket = false;
+
+    for (const char *p = pattern; *p != '\0'; p++) {
+        if (in_bracket) {
+            // Character classes, collating symbols and equivalence classes may contain ']'
+            if (*p == '[' && (p[1] == ':' || p[1] == '.' || p[1] == '=')) {
+                const char terminator[] = { p[1], ']', '\0' };
+                const char *end = strstr(p + 2, terminator);
+                if (end == NULL) {
+                    return false;
+                }
+                p = end + 1;
+            } else if (*p == ']') {
+                in_bracket = false;
+            }
+        } else if (*p == '\\' && p[1] >= '1' && p[1] <= '9') {
+            return true;
+        } else if (*p == '\\' && p[1] != '\0') {
+            p++;
+        } else if (*p == '[') {
+            // A ']' first in a bracket expression, or after its '^', is a literal
+            in_bracket = true;
+            if (p[1] == '^') {
+                p++;
+            }
+            if (p[1] == ']') {
+                p++;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool
+flog_pattern_get_literal(const char *pattern, char *literal, size_t *len) {
+    assert(pattern != NULL);
+    assert(literal != NULL);
+    assert(len != NULL);
+
+    size_t count = 0;
+
+    for (const char *p = pattern; *p != '\0'; p++) {
+        if (*p == '\\') {
+            // Only escaped operators and backslashes are literal; other escapes such as
+            // \w are operators in some implementations
+            if (p[1] == '\0' || (p[1] != '\\' && strchr(PATTERN_OPERATORS, p[1]) == NULL)) {
+                return false;
+            }
+            p++;
+        } else if (strchr(PATTERN_OPERATORS, *p) != NULL) {
+            return false;
+        }
+
+        literal[count++] = *p;
+    }
+
+    literal[count] = '\0';
+    *len = count;
+
+    return true;
+}
@@ -0,0 +1,95 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_PATTERN_H
+#define FLOG_PATTERN_H
+
+/*! \file pattern.h
+ *
+ *  Helper functions for the POSIX extended regular expressions used to match
+ *  streamed input.
+ *
+ *  Patterns containing backreferences are rejected, so that every accepted pattern
+ *  can be matched by an automaton in time linear in the length of its input rather
+ *  than by backtracking, and so that accepted patterns can be combined into a single
+ *  alternation without renumbering their groups.
+ */
+
+#include <regex.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*! \brief Compile a POSIX extended regular expression for testing whether input
+ *         matches it.
+ *
+ *  \param[out] regex   A pointer to the regex_t object to compile into, which must be
+ *                      freed with regfree() if compilation succeeds
+ *  \param[in]  pattern A pointer to the null-terminated pattern
+ *
+ *  \pre \c regex is \e not \c NULL
+ *  \pre \c pattern is \e not \c NULL
+ *
+ *  \return \c true if the pattern was compiled, or \c false if it is invalid or
+ *          contains a backreference
+ */
+bool flog_pattern_compile(regex_t *regex, const char *pattern);
+
+/*! \brief Determine whether a pattern is accepted by flog_pattern_compile().
+ *
+ *  \param pattern A pointer to the null-terminated pattern
+ *
+ *  \pre \c pattern is \e not \c NULL
+ *
+ *  \return \c true if the pattern is a valid POSIX extended regular expression
+ *          without backreferences, otherwise \c false
+ */
+bool flog_pattern_is_valid(const char *pattern);
+
+/*! \brief Determine whether a pattern contains a backreference.
+ *
+ *  \param pattern A pointer to the null-terminated pattern
+ *
+ *  \pre \c pattern is \e not \c NULL
+ *
+ *  \return \c true if a backslash followed by a digit from 1 to 9 appears outside a
+ *          bracket expression, otherwise \c false
+ */
+bool flog_pattern_has_backreference(const char *pattern);
+
+/*! \brief Get the text matched by a pattern that contains no operators.
+ *
+ *  A pattern is literal if it contains none of the characters <tt>.[]()*+?{}|^$</tt>
+ *  other than those escaped with a backslash. Such a pattern matches its text, with
+ *  the escaping backslashes removed, anywhere in the input.
+ *
+ *  \param[in]  pattern A pointer to the null-terminated pattern
+ *  \param[out] literal A pointer to a buffer of at least the length of the pattern
+ *                      plus one byte, which receives the null-terminated text
+ *  \param[out] len     A pointer to the length of the text in bytes
+ *
+ *  \pre \c pattern, \c literal and \c len are \e not \c NULL
+ *
+ *  \return \c true if the pattern is literal, otherwise \c false
+ */
+bool flog_pattern_get_literal(const char *pattern, char *literal, size_t *len);
+
+#endif //FLOG_PATTERN_H
@@ -0,0 +1,179 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "prefix.h"
+#include "config.h"
+#include "common.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+
+#ifdef UNIT_TESTING
+#include "../test/testing.h"
+#endif
+
+#define PREFIX_PID_LEN 24
+#define PREFIX_OFFSET_LEN 8
+
+struct FlogPrefixData {
+    unsigned int fields;
+    time_t cached_second;
+    bool cache_valid;
+    char cached_time[PREFIX_TIME_LEN];
+    size_t cached_time_len;
+    char cached_offset[PREFIX_OFFSET_LEN];
+    size_t cached_offset_len;
+    char pid[PREFIX_PID_LEN];
+    size_t pid_len;
+};
+
+void flog_prefix_update_cache(FlogPrefix *prefix, time_t second);
+
+void flog_prefix_put(char *buf, size_t size, size_t *pos, const char *src, size_t len);
+
+FlogPrefix *
+flog_prefix_new(unsigned int fields, FlogError *error) {
+    assert(error != NULL);
+
+    *error = FLOG_ERROR_NONE;
+
+    FlogPrefix *prefix = calloc(1, sizeof(struct FlogPrefixData));
+    if (prefix == NULL) {
+        *error = FLOG_ERROR_ALLOC;
+        return NULL;
+    }
+
+    prefix->fields = fields;
+    prefix->cache_valid = false;
+
+    int len = snprintf(prefix->pid, PREFIX_PID_LEN, "[%ld] ", (long) getpid());
+    prefix->pid_len = (size_t) len;
+
+    return prefix;
+}
+
+void
+flog_prefix_free(FlogPrefix *prefix) {
+    assert(prefix != NULL);
+
+    free(prefix);
+}
+
+unsigned int
+flog_prefix_get_fields(const FlogPrefix *prefix) {
+    assert(prefix != NULL);
+
+    return prefix->fields;
+}
+
+size_t
+flog_prefix_render(FlogPrefix *prefix, const struct timespec *time, FlogConfigLevel level,
+                   const char *subsystem, const char *category, char *buf, size_t size) {
+    assert(prefix != NULL);
+    assert(time != NULL);
+    assert(subsystem != NULL);
+    assert(category != NULL);
+    assert(buf != NULL);
+    assert(size > 0);
+
+    size_t pos = 0;
+
+    if (prefix->fields & PFX_TIME) {
+        if (!prefix->cache_valid || time->tv_sec != prefix->cached_second) {
+            flog_prefix_update_cache(prefix, time->tv_sec);
+        }
+
+        // Only the sub-second digits change between records in the same second
+        char fraction[8] = ".000000";
+        long micros = time->tv_nsec / 1000;
+        for (int i = 6; i > 0; i--) {
+            fraction[i] = (char) ('0' + micros % 10);
+            micros /= 10;
+        }
+
+        flog_prefix_put(buf, size, &pos, prefix->cached_time, prefix->cached_time_len);
+        flog_prefix_put(buf, size, &pos, fraction, 7);
+        flog_prefix_put(buf, size, &pos, prefix->cached_offset, prefix->cached_offset_len);
+    }
+
+    if (prefix->fields & PFX_LEVEL) {
+        const char *name = flog_config_level_string(level);
+        flog_prefix_put(buf, size, &pos, name, strlen(name));
+        flog_prefix_put(buf, size, &pos, " ", 1);
+    }
+
+    if (prefix->fields & PFX_PID) {
+        flog_prefix_put(buf, size, &pos, prefix->pid, prefix->pid_len);
+    }
+
+    if (prefix->fields & PFX_SUBSYSTEM) {
+        size_t len = strlen(subsystem);
+        flog_prefix_put(buf, size, &pos, len > 0 ? subsystem : "-", len > 0 ? len : 1);
+        flog_prefix_put(buf, size, &pos, " ", 1);
+    }
+
+    if (prefix->fields & PFX_CATEGORY) {
+        size_t len = strlen(category);
+        flog_prefix_put(buf, size, &pos, len > 0 ? category : "-", len > 0 ? len : 1);
+        flog_prefix_put(buf, size, &pos, " ", 1);
+    }
+
+    buf[pos] = '\0';
+
+    return pos;
+}
+
+void
+flog_prefix_update_cache(FlogPrefix *prefix, time_t second) {
+    struct tm tm;
+    if (localtime_r(&second, &tm) == NULL) {
+        memset(&tm, 0, sizeof(tm));
+    }
+
+    prefix->cached_time_len = strftime(prefix->cached_time, PREFIX_TIME_LEN, "%Y-%m-%dT%H:%M:%S", &tm);
+
+    long offset = tm.tm_gmtoff / 60;
+    char sign = offset < 0 ? '-' : '+';
+    if (offset < 0) {
+        offset = -offset;
+    }
+
+    int len = snprintf(prefix->cached_offset, PREFIX_OFFSET_LEN, "%c%02ld:%02ld ",
+                       sign, (offset / 60) % 100, offset % 60);
+    prefix->cached_offset_len = (size_t) len;
+
+    prefix->cached_second = second;
+    prefix->cache_valid = true;
+}
+
+void
+flog_prefix_put(char *buf, size_t size, size_t *pos, const char *src, size_t len) {
+    size_t available = size - 1 - *pos;
+    if (len > available) {
+        len = available;
+    }
+
+    memcpy(buf + *pos, src, len);
+    *pos += len;
+}
@@ -0,0 +1,112 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_PREFIX_H
+#define FLOG_PREFIX_H
+
+/*! \file prefix.h
+ *
+ *  Prefix object and associated functions for rendering the metadata that precedes
+ *  log messages appended to text files.
+ *
+ *  A prefix consists of the selected fields, in the order timestamp, level, process
+ *  identifier, subsystem and category, each followed by a single space:
+ *
+ *  <tt>2026-10-19T09:00:00.123456+01:00 error [4242] com.example.app network </tt>
+ *
+ *  Timestamps are rendered in local time as RFC 3339 with microsecond precision.
+ *  The date, time and UTC offset are rendered only when the second changes and are
+ *  otherwise copied from a cached copy, so that only the sub-second digits are
+ *  formatted for each record. Empty subsystem and category names are rendered as
+ *  \c -.
+ */
+
+#include <stddef.h>
+#include <time.h>
+#include "config.h"
+#include "common.h"
+
+#define PREFIX_TIME_LEN 33
+#define PREFIX_LEN (PREFIX_TIME_LEN + 8 + 24 + SUBSYSTEM_LEN + CATEGORY_LEN)
+
+/*! \struct FlogPrefix
+ *
+ *  \brief An opaque type representing a FlogPrefix message prefix object.
+ */
+typedef struct FlogPrefixData FlogPrefix;
+
+/*! \brief Create a FlogPrefix object for rendering message prefixes.
+ *
+ *  \param[in]  fields A bitwise OR of FlogConfigPrefix values representing the
+ *                     fields to render
+ *  \param[out] error  A pointer to a FlogError object that will be used to represent
+ *                     an error condition on failure
+ *
+ *  \pre \c error is \e not \c NULL
+ *
+ *  \return If successful, a pointer to a FlogPrefix object; if there is an error
+ *          a \c NULL pointer is returned and \c error will be set to a FlogError
+ *          variant representing an error condition
+ */
+FlogPrefix * flog_prefix_new(unsigned int fields, FlogError *error);
+
+/*! \brief Free a FlogPrefix object.
+ *
+ *  \param prefix A pointer to the FlogPrefix object that should be freed
+ *
+ *  \pre \c prefix is \e not \c NULL
+ */
+void flog_prefix_free(FlogPrefix *prefix);
+
+/*! \brief Get the fields rendered by a FlogPrefix object.
+ *
+ *  \param prefix A pointer to the FlogPrefix object
+ *
+ *  \pre \c prefix is \e not \c NULL
+ *
+ *  \return A bitwise OR of FlogConfigPrefix values
+ */
+unsigned int flog_prefix_get_fields(const FlogPrefix *prefix);
+
+/*! \brief Render a message prefix.
+ *
+ *  Output that would exceed \c size bytes is truncated. The rendered prefix is
+ *  always null-terminated.
+ *
+ *  \param[in]  prefix    A pointer to the FlogPrefix object
+ *  \param[in]  time      A pointer to the time of the message
+ *  \param[in]  level     A FlogConfigLevel value representing the log level
+ *  \param[in]  subsystem A pointer to the null-terminated subsystem name
+ *  \param[in]  category  A pointer to the null-terminated category name
+ *  \param[out] buf       A pointer to a buffer that will receive the prefix
+ *  \param[in]  size      The size of the buffer in bytes; \c PREFIX_LEN is always
+ *                        sufficient for names within the configured limits
+ *
+ *  \pre \c prefix, \c time, \c subsystem, \c category and \c buf are \e not \c NULL
+ *  \pre \c size is greater than zero
+ *
+ *  \return The number of bytes rendered, excluding the null terminator
+ */
+size_t flog_prefix_render(FlogPrefix *prefix, const struct timespec *time, FlogConfigLevel level,
+                          const char *subsystem, const char *category, char *buf, size_t size);
+
+#endif //FLOG_PREFIX_H
@@ -0,0 +1,192 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "record.h"
+#include "checksum.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#ifdef UNIT_TESTING
+#include "../test/testing.h"
+#endif
+
+#define RECORD_PAYLOAD_MAX 0xffffffffU
+
+static char newline[] = "\n";
+
+bool flog_record_parse_hex(const char *buf, uint32_t *value);
+
+void
+flog_record_init(FlogRecord *record) {
+    assert(record != NULL);
+
+    // The first segment is reserved for the framing header
+    record->segments[0].iov_base = record->frame;
+    record->segments[0].iov_len = 0;
+    record->segment_count = 1;
+    record->len = 0;
+    record->frame[0] = '\0';
+}
+
+void
+flog_record_append(FlogRecord *record, const char *buf, size_t len) {
+    assert(record != NULL);
+    assert(buf != NULL);
+    assert(record->segment_count < RECORD_SEGMENT_MAX - 1);
+
+    if (len == 0) {
+        return;
+    }
+
+    record->segments[record->segment_count].iov_base = (void *) buf;
+    record->segments[record->segment_count].iov_len = len;
+    record->segment_count++;
+    record->len += len;
+}
+
+void
+flog_record_finish(FlogRecord *record, bool framed) {
+    assert(record != NULL);
+
+    size_t payload_len = record->len;
+    const struct iovec *last = &record->segments[record->segment_count - 1];
+
+    if (payload_len > 0 && ((const char *) last->iov_base)[last->iov_len - 1] == '\n') {
+        payload_len--;
+    } else {
+        record->segments[record->segment_count].iov_base = newline;
+        record->segments[record->segment_count].iov_len = 1;
+        record->segment_count++;
+        record->len++;
+    }
+
+    if (framed) {
+        uint32_t crc = 0;
+        size_t remaining = payload_len;
+
+        for (int i = 1; i < record->segment_count && remaining > 0; i++) {
+            size_t len = record->segments[i].iov_len < remaining ? record->segments[i].iov_len : remaining;
+            crc = flog_crc32c(crc, record->segments[i].iov_base, len);
+            remaining -= len;
+        }
+
+        snprintf(record->frame, sizeof(record->frame), "#%08x:%08x ",
+                 (unsigned int) (payload_len & RECORD_PAYLOAD_MAX), (unsigned int) crc);
+        record->segments[0].iov_len = RECORD_FRAME_LEN;
+        record->len += RECORD_FRAME_LEN;
+    }
+}
+
+const struct iovec *
+flog_record_get_segments(const FlogRecord *record, int *count) {
+    assert(record != NULL);
+    assert(count != NULL);
+
+    if (record->segments[0].iov_len == 0) {
+        *count = record->segment_count - 1;
+        return &record->segments[1];
+    }
+
+    *count = record->segment_count;
+    return record->segments;
+}
+
+size_t
+flog_record_get_length(const FlogRecord *record) {
+    assert(record != NULL);
+
+    return record->len;
+}
+
+bool
+flog_record_parse_hex(const char *buf, uint32_t *value) {
+    uint32_t result = 0;
+
+    for (int i = 0; i < 8; i++) {
+        char c = buf[i];
+        uint32_t digit;
+
+        if (c >= '0' && c <= '9') {
+            digit = (uint32_t) (c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = (uint32_t) (c - 'a' + 10);
+        } else {
+            return false;
+        }
+
+        result = (result << 4) | digit;
+    }
+
+    *value = result;
+
+    return true;
+}
+
+FlogRecordStatus
+flog_record_parse(const char *buf, size_t len, const char **payload, size_t *payload_len, size_t *consumed) {
+    assert(buf != NULL);
+    assert(payload != NULL);
+    assert(payload_len != NULL);
+    assert(consumed != NULL);
+
+    uint32_t frame_len;
+    uint32_t frame_crc;
+
+    if (len < RECORD_FRAME_LEN) {
+        *consumed = 0;
+        return RECORD_INCOMPLETE;
+    }
+
+    bool header_valid = buf[0] == '#' && buf[9] == ':' && buf[18] == ' ' &&
+                        flog_record_parse_hex(buf + 1, &frame_len) &&
+                        flog_record_parse_hex(buf + 10, &frame_crc);
+
+    if (header_valid && RECORD_FRAME_LEN + (size_t) frame_len + 1 > len) {
+        *consumed = 0;
+        return RECORD_INCOMPLETE;
+    }
+
+    if (header_valid && buf[RECORD_FRAME_LEN + frame_len] == '\n' &&
+        flog_crc32c(0, buf + RECORD_FRAME_LEN, frame_len) == frame_crc) {
+        *payload = buf + RECORD_FRAME_LEN;
+        *payload_len = frame_len;
+        *consumed = RECORD_FRAME_LEN + (size_t) frame_len + 1;
+        return RECORD_VALID;
+    }
+
+    // Resynchronise at the next line that begins with a framing header
+    const char *next = buf + 1;
+    const char *end = buf + len;
+
+    while ((next = memchr(next, '\n', (size_t) (end - next))) != NULL) {
+        next++;
+        if (next == end || *next == '#') {
+            break;
+        }
+    }
+
+    *consumed = next != NULL ? (size_t) (next - buf) : len;
+
+    return RECORD_TORN;
+}
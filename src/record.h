@@ -0,0 +1,137 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_RECORD_H
+#define FLOG_RECORD_H
+
+/*! \file record.h
+ *
+ *  Record type and associated functions for assembling log messages appended to
+ *  text files.
+ *
+ *  A record is described by a short list of segments that reference the caller's
+ *  buffers, so that it can be written with a single \c writev(2) on an \c O_APPEND
+ *  descriptor without first being copied. Records always end with a newline.
+ *
+ *  When framing is enabled each record begins with a fixed-width header of the
+ *  form <tt>#LLLLLLLL:CCCCCCCC </tt>, where \c L is the hexadecimal length of the
+ *  payload (excluding the trailing newline) and \c C is the hexadecimal CRC-32C
+ *  checksum of the payload, allowing readers to detect torn records.
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <sys/uio.h>
+
+#define RECORD_SEGMENT_MAX 8
+#define RECORD_FRAME_LEN 19
+
+/*! \brief An enumerated type representing the result of parsing a framed record. */
+typedef enum FlogRecordStatusData {
+    RECORD_VALID,
+    RECORD_TORN,
+    RECORD_INCOMPLETE
+} FlogRecordStatus;
+
+/*! \brief A type representing a record assembled from segments. */
+typedef struct FlogRecordData {
+    struct iovec segments[RECORD_SEGMENT_MAX];
+    int segment_count;
+    size_t len;
+    char frame[RECORD_FRAME_LEN + 1];
+} FlogRecord;
+
+/*! \brief Initialise an empty record.
+ *
+ *  \param record A pointer to the FlogRecord object
+ *
+ *  \pre \c record is \e not \c NULL
+ */
+void flog_record_init(FlogRecord *record);
+
+/*! \brief Append a segment to a record without copying it.
+ *
+ *  The buffer must remain valid until the record has been written. Empty segments
+ *  are ignored.
+ *
+ *  \param record A pointer to the FlogRecord object
+ *  \param buf    A pointer to the segment data
+ *  \param len    The number of bytes in the segment
+ *
+ *  \pre \c record is \e not \c NULL
+ *  \pre \c buf is \e not \c NULL
+ *  \pre fewer than <tt>RECORD_SEGMENT_MAX - 2</tt> segments have been appended
+ */
+void flog_record_append(FlogRecord *record, const char *buf, size_t len);
+
+/*! \brief Complete a record, adding a trailing newline and optionally a framing header.
+ *
+ *  \param record A pointer to the FlogRecord object
+ *  \param framed A boolean value representing whether a framing header should be added
+ *
+ *  \pre \c record is \e not \c NULL
+ */
+void flog_record_finish(FlogRecord *record, bool framed);
+
+/*! \brief Get the segments of a completed record.
+ *
+ *  \param record A pointer to the FlogRecord object
+ *  \param count  A pointer to an integer that will be set to the number of segments
+ *
+ *  \pre \c record is \e not \c NULL
+ *  \pre \c count is \e not \c NULL
+ *
+ *  \return A pointer to the first element of an array of segments
+ */
+const struct iovec * flog_record_get_segments(const FlogRecord *record, int *count);
+
+/*! \brief Get the total length of a completed record in bytes.
+ *
+ *  \param record A pointer to the FlogRecord object
+ *
+ *  \pre \c record is \e not \c NULL
+ *
+ *  \return The number of bytes in the record, including any framing header and the
+ *          trailing newline
+ */
+size_t flog_record_get_length(const FlogRecord *record);
+
+/*! \brief Parse a framed record from the beginning of a buffer.
+ *
+ *  \param[in]  buf         A pointer to the buffer
+ *  \param[in]  len         The number of bytes in the buffer
+ *  \param[out] payload     A pointer that will be set to the record payload if valid
+ *  \param[out] payload_len A pointer that will be set to the payload length if valid
+ *  \param[out] consumed    A pointer that will be set to the number of bytes to skip
+ *                          to reach the next record; for a torn record this is the
+ *                          position following the next newline
+ *
+ *  \pre \c buf, \c payload, \c payload_len and \c consumed are \e not \c NULL
+ *
+ *  \return RECORD_VALID if a complete record with a matching checksum was parsed,
+ *          RECORD_TORN if the record is corrupt, or RECORD_INCOMPLETE if the buffer
+ *          ends before the record does
+ */
+FlogRecordStatus flog_record_parse(const char *buf, size_t len, const char **payload,
+                                   size_t *payload_len, size_t *consumed);
+
+#endif //FLOG_RECORD_H
@@ -0,0 +1,356 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "redact.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include "config.h"
+
+#ifdef UNIT_TESTING
+#include "../test/testing.h"
+#endif
+
+#define BEARER_SCHEME "bearer"
+#define BEARER_SCHEME_LEN 6
+#define BEARER_TOKEN_MIN 16
+#define AWS_KEY_PREFIX_LEN 4
+#define AWS_KEY_PREFIX "AKIA"
+#define AWS_TEMPORARY_KEY_PREFIX "ASIA"
+#define AWS_KEY_LEN 20
+#define EMAIL_TLD_MIN 2
+#define CARD_DIGITS_MIN 13
+#define CARD_DIGITS_MAX 19
+#define CARD_GROUP_MAX 5
+
+// The kind of secret that can start at each byte; an e-mail address is found from its '@'
+static const uint8_t redact_triggers[UINT8_MAX + 1] = {
+    ['A'] = RDT_AWS_KEY,
+    ['B'] = RDT_BEARER,
+    ['b'] = RDT_BEARER,
+    ['@'] = RDT_EMAIL,
+    ['0'] = RDT_CARD,
+    ['1'] = RDT_CARD,
+    ['2'] = RDT_CARD,
+    ['3'] = RDT_CARD,
+    ['4'] = RDT_CARD,
+    ['5'] = RDT_CARD,
+    ['6'] = RDT_CARD,
+    ['7'] = RDT_CARD,
+    ['8'] = RDT_CARD,
+    ['9'] = RDT_CARD,
+};
+
+bool flog_redact_match_bearer(const char *message, size_t *start, size_t *end);
+
+bool flog_redact_match_aws_key(const char *message, size_t *start, size_t *end);
+
+bool flog_redact_match_email(const char *message, size_t floor, size_t *start, size_t *end);
+
+bool flog_redact_match_card(const char *message, size_t *start, size_t *end);
+bool flog_redact_is_card_grouping(const size_t groups[], size_t count);
+
+bool flog_redact_is_digit(char c);
+
+bool flog_redact_is_alpha(char c);
+
+bool flog_redact_is_alnum(char c);
+
+bool flog_redact_is_local(char c);
+
+bool flog_redact_follows_word(const char *message, size_t pos);
+
+size_t
+flog_redact_message(char *message, unsigned int kinds) {
+    assert(message != NULL);
+
+    size_t count = 0;
+    size_t floor = 0;
+    size_t i = 0;
+
+    while (message[i] != '\0') {
+        unsigned int kind = redact_triggers[(uint8_t) message[i]] & kinds;
+        if (kind == RDT_NONE) {
+            i++;
+            continue;
+        }
+
+        // A matcher that fails may move the end past bytes that cannot start a secret
+        size_t start = i;
+        size_t end = i + 1;
+        bool found = false;
+
+        switch (kind) {
+            case RDT_BEARER:
+                found = flog_redact_match_bearer(message, &start, &end);
+                break;
+            case RDT_AWS_KEY:
+                found = flog_redact_match_aws_key(message, &start, &end);
+                break;
+            case RDT_EMAIL:
+                found = flog_redact_match_email(message, floor, &start, &end);
+                break;
+            case RDT_CARD:
+                found = flog_redact_match_card(message, &start, &end);
+                break;
+        }
+
+        if (found) {
+            for (size_t j = start; j < end; j++) {
+                if (kind != RDT_CARD || flog_redact_is_digit(message[j])) {
+                    message[j] = REDACT_MASK;
+                }
+            }
+
+            // Masked bytes are never part of a later secret
+            floor = end;
+            count++;
+        }
+
+        i = end;
+    }
+
+    return count;
+}
+
+bool
+flog_redact_match_bearer(const char *message, size_t *start, size_t *end) {
+    size_t i = *start;
+    if (flog_redact_follows_word(message, i) || strncasecmp(&message[i], BEARER_SCHEME, BEARER_SCHEME_LEN) != 0) {
+        return false;
+    }
+
+    i += BEARER_SCHEME_LEN;
+    if (message[i] != ' ') {
+        return false;
+    }
+
+    while (message[i] == ' ') {
+        i++;
+    }
+
+    // Tokens are made of the characters allowed by RFC 6750, ending in any padding
+    size_t token = i;
+    while (flog_redact_is_alnum(message[i]) || (message[i] != '\0' && strchr("-._~+/", message[i]) != NULL)) {
+        i++;
+    }
+
+    while (message[i] == '=') {
+        i++;
+    }
+
+    if (i - token < BEARER_TOKEN_MIN) {
+        *end = i;
+        return false;
+    }
+
+    *start = token;
+    *end = i;
+
+    return true;
+}
+
+bool
+flog_redact_match_aws_key(const char *message, size_t *start, size_t *end) {
+    size_t i = *start;
+    if (flog_redact_follows_word(message, i)) {
+        return false;
+    }
+
+    if (strncmp(&message[i], AWS_KEY_PREFIX, AWS_KEY_PREFIX_LEN) != 0 &&
+        strncmp(&message[i], AWS_TEMPORARY_KEY_PREFIX, AWS_KEY_PREFIX_LEN) != 0) {
+        return false;
+    }
+
+    for (size_t j = AWS_KEY_PREFIX_LEN; j < AWS_KEY_LEN; j++) {
+        char c = message[i + j];
+        if (!flog_redact_is_digit(c) && (c < 'A' || c > 'Z')) {
+            return false;
+        }
+    }
+
+    if (flog_redact_is_alnum(message[i + AWS_KEY_LEN])) {
+        return false;
+    }
+
+    *end = i + AWS_KEY_LEN;
+
+    return true;
+}
+
+bool
+flog_redact_match_email(const char *message, size_t floor, size_t *start, size_t *end) {
+    size_t at = *start;
+
+    // The local part is found by looking back from the '@', but never into a secret
+    // already masked or past an earlier '@', so each byte is examined a bounded number
+    // of times
+    size_t local = at;
+    while (local > floor && flog_redact_is_local(message[local - 1])) {
+        local--;
+    }
+
+    if (local == at) {
+        return false;
+    }
+
+    size_t i = at + 1;
+    size_t labels = 0;
+    bool alpha_label = false;
+    size_t label_len = 0;
+
+    while (flog_redact_is_alnum(message[i])) {
+        size_t label = i;
+        alpha_label = true;
+        while (flog_redact_is_alnum(message[i]) || message[i] == '-') {
+            alpha_label = alpha_label && flog_redact_is_alpha(message[i]);
+            i++;
+        }
+
+        labels++;
+        label_len = i - label;
+
+        // A dot ends the address unless another label follows it
+        if (message[i] != '.' || !flog_redact_is_alnum(message[i + 1])) {
+            break;
+        }
+        i++;
+    }
+
+    if (labels < 2 || !alpha_label || label_len < EMAIL_TLD_MIN) {
+        return false;
+    }
+
+    *start = local;
+    *end = i;
+
+    return true;
+}
+
+bool
+flog_redact_match_card(const char *message, size_t *start, size_t *end) {
+    size_t i = *start;
+    if (flog_redact_follows_word(message, i)) {
+        return false;
+    }
+
+    // The whole run of digits is read, so that a number too long to be a card is
+    // skipped rather than examined again from each of its digits
+    size_t digits = 0;
+    size_t groups[CARD_GROUP_MAX] = {0};
+    size_t group_count = 1;
+    char separator = '\0';
+    bool uniform = true;
+    while (true) {
+        if (flog_redact_is_digit(message[i])) {
+            if (group_count <= CARD_GROUP_MAX) {
+                groups[group_count - 1]++;
+            }
+            digits++;
+            i++;
+        } else if ((message[i] == ' ' || message[i] == '-') && flog_redact_is_digit(message[i + 1])) {
+            uniform = uniform && (separator == '\0' || message[i] == separator);
+            separator = message[i];
+            group_count++;
+            i++;
+        } else {
+            break;
+        }
+    }
+
+    *end = i;
+
+    if (digits < CARD_DIGITS_MIN || digits > CARD_DIGITS_MAX || flog_redact_is_alnum(message[i])) {
+        return false;
+    }
+
+    // Separated digits are only a card number when grouped as cards are printed, so that
+    // lists of numbers are left alone
+    if (!uniform || group_count > CARD_GROUP_MAX || !flog_redact_is_card_grouping(groups, group_count)) {
+        return false;
+    }
+
+    // Every second digit from the right is doubled, and the digits of the result summed
+    unsigned int sum = 0;
+    bool doubled = false;
+    for (size_t j = i; j > *start; j--) {
+        char c = message[j - 1];
+        if (!flog_redact_is_digit(c)) {
+            continue;
+        }
+
+        unsigned int value = (unsigned int) (c - '0');
+        if (doubled) {
+            value = value * 2 > 9 ? value * 2 - 9 : value * 2;
+        }
+
+        sum += value;
+        doubled = !doubled;
+    }
+
+    return sum % 10 == 0;
+}
+
+bool
+flog_redact_is_card_grouping(const size_t groups[], size_t count) {
+    switch (count) {
+        case 1:
+            return true;
+        case 3:
+            // 4-6-5 and 4-6-4, as American Express and Diners Club numbers are printed
+            return groups[0] == 4 && groups[1] == 6 && (groups[2] == 5 || groups[2] == 4);
+        case 4:
+        case 5:
+            // 4-4-4-4, followed by a short final group on numbers of 17 to 19 digits
+            return groups[0] == 4 && groups[1] == 4 && groups[2] == 4 && groups[3] == 4 &&
+                   (count == 4 || groups[4] <= 3);
+        default:
+            return false;
+    }
+}
+
+bool
+flog_redact_is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool
+flog_redact_is_alpha(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+bool
+flog_redact_is_alnum(char c) {
+    return flog_redact_is_digit(c) || flog_redact_is_alpha(c);
+}
+
+bool
+flog_redact_is_local(char c) {
+    return flog_redact_is_alnum(c) || (c != '\0' && strchr("._%+-", c) != NULL);
+}
+
+bool
+flog_redact_follows_word(const char *message, size_t pos) {
+    return pos > 0 && flog_redact_is_alnum(message[pos - 1]);
+}
@@ -0,0 +1,67 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_REDACT_H
+#define FLOG_REDACT_H
+
+/*! \file redact.h
+ *
+ *  Helper functions for masking secrets in messages.
+ *
+ *  A message is scanned once from start to end. Each byte is looked up in a table of
+ *  the kinds of secret that can start at it, and a kind is only checked at the bytes
+ *  that can start it, so masking more kinds adds checks at a few bytes rather than
+ *  another pass over the message. Each secret found is overwritten with asterisks,
+ *  so that the message keeps its length and the text around the secret is intact.
+ *
+ *  The kinds of secret recognised are:
+ *
+ *  - \c RDT_BEARER: a token of at least 16 characters following the word \c Bearer,
+ *    in any case, and one or more spaces; only the token is masked
+ *  - \c RDT_AWS_KEY: an AWS access key ID, \c AKIA or \c ASIA followed by 16
+ *    uppercase letters or digits
+ *  - \c RDT_EMAIL: an e-mail address whose domain has at least two labels, the last
+ *    of which is at least two letters
+ *  - \c RDT_CARD: a payment card number of 13 to 19 digits, which may be grouped
+ *    4-4-4-4 (with a final group of up to three digits), 4-6-5 or 4-6-4 by single
+ *    spaces or by single hyphens, that passes the Luhn check; only the digits are masked
+ *
+ *  Except for e-mail addresses, a secret is only recognised where it is not part of
+ *  a longer word or number.
+ */
+
+#include <stddef.h>
+
+#define REDACT_MASK '*'
+
+/*! \brief Mask the secrets of the given kinds in a message.
+ *
+ *  \param message A pointer to the null-terminated message, which is modified in place
+ *  \param kinds   A bitwise OR of FlogConfigRedact values
+ *
+ *  \pre \c message is \e not \c NULL
+ *
+ *  \return The number of secrets masked
+ */
+size_t flog_redact_message(char *message, unsigned int kinds);
+
+#endif //FLOG_REDACT_H
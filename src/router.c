@@ -0,0 +1,471 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "router.h"
+#include "writer.h"
+#include "config.h"
+#include "common.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <sys/syslimits.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
+#ifdef UNIT_TESTING
+#include "../test/testing.h"
+#endif
+
+#define ROUTER_FD_RESERVE 32
+#define ROUTER_DEFAULT_VALUE "default"
+
+// Parent directories are created without group or other write permission (see writer.c)
+#define ROUTER_DIR_MODE (S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH)
+
+/*! \brief A template variable, indexing its name in router_variables. */
+typedef enum RouterVariableData {
+    VAR_SUBSYSTEM,
+    VAR_CATEGORY,
+    VAR_LEVEL,
+    VAR_UNKNOWN
+} RouterVariable;
+
+static const char *const router_variables[] = { "subsystem", "category", "level" };
+
+typedef struct RouterEntryData {
+    char *path;
+    uint32_t hash;
+    FlogWriter *writer;
+    struct RouterEntryData *chain;
+    struct RouterEntryData *newer;
+    struct RouterEntryData *older;
+} RouterEntry;
+
+struct FlogRouterData {
+    FlogConfigWriter backend;
+    bool datasync;
+    size_t capacity;
+    RouterEntry *entries;
+    RouterEntry *spare;
+    RouterEntry **buckets;
+    size_t bucket_mask;
+    RouterEntry *newest;
+    RouterEntry *oldest;
+    FlogRouterStats stats;
+    FlogError error;
+};
+
+uint32_t flog_router_hash(const char *path);
+
+RouterEntry * flog_router_lookup(const FlogRouter *router, const char *path, uint32_t hash);
+
+void flog_router_unlink(FlogRouter *router, RouterEntry *entry);
+
+void flog_router_push_newest(FlogRouter *router, RouterEntry *entry);
+
+void flog_router_evict(FlogRouter *router);
+
+FlogError flog_router_append_value(const char *value, char *buf, size_t size, size_t *pos);
+
+RouterVariable flog_router_find_variable(const char *name, const char **end);
+
+FlogRouter *
+flog_router_new(size_t capacity, FlogConfigWriter backend, bool datasync, FlogError *error) {
+    assert(capacity > 0);
+    assert(error != NULL);
+
+    *error = FLOG_ERROR_NONE;
+
+    // Asynchronous writers hold a second descriptor for their ring, so allowing two
+    // descriptors per writer keeps the cache within half of the limit
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+        size_t available = limit.rlim_cur > ROUTER_FD_RESERVE * 2 ? (limit.rlim_cur - ROUTER_FD_RESERVE) / 4 : 1;
+        if (capacity > available) {
+            capacity = available;
+        }
+    }
+
+    FlogRouter *router = calloc(1, sizeof(struct FlogRouterData));
+    if (router == NULL) {
+        *error = FLOG_ERROR_ALLOC;
+        return NULL;
+    }
+
+    size_t bucket_count = 1;
+    while (bucket_count < capacity * 2) {
+        bucket_count <<= 1;
+    }
+
+    router->entries = calloc(capacity, sizeof(RouterEntry));
+    router->buckets = calloc(bucket_count, sizeof(RouterEntry *));
+    if (router->entries == NULL || router->buckets == NULL) {
+        free(router->entries);
+        free(router->buckets);
+        free(router);
+        *error = FLOG_ERROR_ALLOC;
+        return NULL;
+    }
+
+    for (size_t i = 0; i < capacity; i++) {
+        router->entries[i].chain = router->spare;
+        router->spare = &router->entries[i];
+    }
+
+    router->backend = backend;
+    router->datasync = datasync;
+    router->capacity = capacity;
+    router->bucket_mask = bucket_count - 1;
+    router->error = FLOG_ERROR_NONE;
+
+    return router;
+}
+
+void
+flog_router_free(FlogRouter *router) {
+    assert(router != NULL);
+
+    while (router->oldest != NULL) {
+        flog_router_evict(router);
+    }
+
+    free(router->entries);
+    free(router->buckets);
+    free(router);
+}
+
+size_t
+flog_router_get_capacity(const FlogRouter *router) {
+    assert(router != NULL);
+
+    return router->capacity;
+}
+
+FlogWriter *
+flog_router_get_writer(FlogRouter *router, const char *path, bool create_parents, FlogError *error) {
+    assert(router != NULL);
+    assert(path != NULL);
+    assert(error != NULL);
+
+    *error = FLOG_ERROR_NONE;
+
+    uint32_t hash = flog_router_hash(path);
+    RouterEntry *entry = flog_router_lookup(router, path, hash);
+
+    if (entry != NULL) {
+        router->stats.hits++;
+        if (entry != router->newest) {
+            flog_router_unlink(router, entry);
+            flog_router_push_newest(router, entry);
+        }
+        return entry->writer;
+    }
+
+    router->stats.misses++;
+
+    if (router->spare == NULL) {
+        flog_router_evict(router);
+    }
+
+    char *entry_path = strdup(path);
+    if (entry_path == NULL) {
+        *error = FLOG_ERROR_ALLOC;
+        return NULL;
+    }
+
+    FlogWriter *writer = flog_writer_new(path, router->backend, router->datasync, error);
+
+    if (writer == NULL && errno == ENOENT && create_parents) {
+        flog_router_make_parents(path);
+        writer = flog_writer_new(path, router->backend, router->datasync, error);
+    }
+
+    // Descriptors may be held elsewhere in the process, so give up cached ones
+    while (writer == NULL && (errno == EMFILE || errno == ENFILE) && router->oldest != NULL) {
+        flog_router_evict(router);
+        writer = flog_writer_new(path, router->backend, router->datasync, error);
+    }
+
+    if (writer == NULL) {
+        free(entry_path);
+        return NULL;
+    }
+
+    entry = router->spare;
+    router->spare = entry->chain;
+
+    entry->path = entry_path;
+    entry->hash = hash;
+    entry->writer = writer;
+    entry->chain = router->buckets[hash & router->bucket_mask];
+    router->buckets[hash & router->bucket_mask] = entry;
+
+    flog_router_push_newest(router, entry);
+    router->stats.open++;
+
+    return writer;
+}
+
+FlogError
+flog_router_flush(FlogRouter *router) {
+    assert(router != NULL);
+
+    FlogError result = router->error;
+
+    for (RouterEntry *entry = router->newest; entry != NULL; entry = entry->older) {
+        FlogError error = flog_writer_flush(entry->writer);
+        if (result == FLOG_ERROR_NONE) {
+            result = error;
+        }
+    }
+
+    return result;
+}
+
+void
+flog_router_get_stats(const FlogRouter *router, FlogRouterStats *stats) {
+    assert(router != NULL);
+    assert(stats != NULL);
+
+    *stats = router->stats;
+}
+
+bool
+flog_router_is_template(const char *path) {
+    assert(path != NULL);
+
+    // Only a known variable makes a template, so that paths which merely contain '%'
+    // continue to name the same file
+    for (const char *p = path; *p != '\0'; p++) {
+        if (p[0] == '%' && p[1] == '%') {
+            p++;
+        } else if (p[0] == '%' && p[1] == '{') {
+            const char *end;
+            if (flog_router_find_variable(p + 2, &end) != VAR_UNKNOWN) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+FlogError
+flog_router_expand(const char *template, const char *subsystem, const char *category,
+                   FlogConfigLevel level, char *buf, size_t size) {
+    assert(template != NULL);
+    assert(subsystem != NULL);
+    assert(category != NULL);
+    assert(buf != NULL);
+
+    size_t pos = 0;
+    const char *p = template;
+    bool expand = flog_router_is_template(template);
+
+    while (*p != '\0') {
+        FlogError error = FLOG_ERROR_NONE;
+
+        if (expand && p[0] == '%' && p[1] == '%') {
+            error = flog_router_append_value("%", buf, size, &pos);
+            p += 2;
+        } else if (expand && p[0] == '%' && p[1] == '{') {
+            const char *end;
+            const char *value;
+
+            switch (flog_router_find_variable(p + 2, &end)) {
+                case VAR_SUBSYSTEM:
+                    value = subsystem;
+                    break;
+                case VAR_CATEGORY:
+                    value = category;
+                    break;
+                case VAR_LEVEL:
+                    value = flog_config_level_string(level);
+                    break;
+                default:
+                    return FLOG_ERROR_TEMPLATE;
+            }
+
+            error = flog_router_append_value(value, buf, size, &pos);
+            p = end + 1;
+        } else {
+            if (pos + 1 >= size) {
+                return FLOG_ERROR_FILE;
+            }
+            buf[pos++] = *p++;
+        }
+
+        if (error != FLOG_ERROR_NONE) {
+            return error;
+        }
+    }
+
+    if (pos >= size) {
+        return FLOG_ERROR_FILE;
+    }
+
+    buf[pos] = '\0';
+
+    return FLOG_ERROR_NONE;
+}
+
+RouterVariable
+flog_router_find_variable(const char *name, const char **end) {
+    *end = strchr(name, '}');
+    if (*end == NULL) {
+        return VAR_UNKNOWN;
+    }
+
+    size_t len = (size_t) (*end - name);
+    for (size_t i = 0; i < sizeof(router_variables) / sizeof(router_variables[0]); i++) {
+        if (strlen(router_variables[i]) == len && strncmp(name, router_variables[i], len) == 0) {
+            return (RouterVariable) i;
+        }
+    }
+
+    return VAR_UNKNOWN;
+}
+
+uint32_t
+flog_router_hash(const char *path) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *) path; *p != '\0'; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+RouterEntry *
+flog_router_lookup(const FlogRouter *router, const char *path, uint32_t hash) {
+    for (RouterEntry *entry = router->buckets[hash & router->bucket_mask]; entry != NULL; entry = entry->chain) {
+        if (entry->hash == hash && strcmp(entry->path, path) == 0) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+void
+flog_router_unlink(FlogRouter *router, RouterEntry *entry) {
+    if (entry->newer != NULL) {
+        entry->newer->older = entry->older;
+    } else {
+        router->newest = entry->older;
+    }
+
+    if (entry->older != NULL) {
+        entry->older->newer = entry->newer;
+    } else {
+        router->oldest = entry->newer;
+    }
+
+    entry->newer = NULL;
+    entry->older = NULL;
+}
+
+void
+flog_router_push_newest(FlogRouter *router, RouterEntry *entry) {
+    entry->newer = NULL;
+    entry->older = router->newest;
+
+    if (router->newest != NULL) {
+        router->newest->newer = entry;
+    } else {
+        router->oldest = entry;
+    }
+
+    router->newest = entry;
+}
+
+void
+flog_router_evict(FlogRouter *router) {
+    RouterEntry *entry = router->oldest;
+    if (entry == NULL) {
+        return;
+    }
+
+    flog_router_unlink(router, entry);
+
+    RouterEntry **link = &router->buckets[entry->hash & router->bucket_mask];
+    while (*link != entry) {
+        link = &(*link)->chain;
+    }
+    *link = entry->chain;
+
+    FlogError error = flog_writer_flush(entry->writer);
+    if (router->error == FLOG_ERROR_NONE) {
+        router->error = error;
+    }
+
+    flog_writer_free(entry->writer);
+    free(entry->path);
+
+    entry->path = NULL;
+    entry->writer = NULL;
+    entry->chain = router->spare;
+    router->spare = entry;
+
+    router->stats.evictions++;
+    router->stats.open--;
+}
+
+void
+flog_router_make_parents(const char *path) {
+    assert(path != NULL);
+
+    char dir[PATH_MAX];
+    if (strlcpy(dir, path, PATH_MAX) >= PATH_MAX) {
+        return;
+    }
+
+    for (char *p = dir + 1; *p != '\0'; p++) {
+        if (*p == '/') {
+            *p = '\0';
+            mkdir(dir, ROUTER_DIR_MODE);
+            *p = '/';
+        }
+    }
+}
+
+FlogError
+flog_router_append_value(const char *value, char *buf, size_t size, size_t *pos) {
+    if (value[0] == '\0') {
+        value = ROUTER_DEFAULT_VALUE;
+    }
+
+    bool dots = strcmp(value, ".") == 0 || strcmp(value, "..") == 0;
+
+    for (const char *p = value; *p != '\0'; p++) {
+        if (*pos + 1 >= size) {
+            return FLOG_ERROR_FILE;
+        }
+        buf[(*pos)++] = (*p == '/' || dots) ? '_' : *p;
+    }
+
+    return FLOG_ERROR_NONE;
+}
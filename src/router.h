@@ -0,0 +1,190 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_ROUTER_H
+#define FLOG_ROUTER_H
+
+/*! \file router.h
+ *
+ *  Router object and associated functions for routing log messages to append files.
+ *
+ *  Append file paths may be templates containing the variables \c %{subsystem},
+ *  \c %{category} and \c %{level}, which are replaced with the corresponding
+ *  values for each message (\c %% is replaced with a single \c %). A path with no
+ *  known variable is not a template and is used as it is, \c % included. Values are
+ *  sanitised so that they always form a single path component: \c / is replaced
+ *  with \c _, as are the names \c . and \c .., and empty values are replaced with
+ *  \c default.
+ *
+ *  A router keeps the writers for recently used files open in a cache of bounded
+ *  size, so that messages routed to many distinct files do not reopen a file for
+ *  each message or exhaust the file descriptor limit. When the cache is full the
+ *  least recently used writer is flushed and closed. Cache hits, misses and
+ *  evictions are counted and can be retrieved with flog_router_get_stats().
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "config.h"
+#include "writer.h"
+#include "common.h"
+
+#define ROUTER_CACHE_SIZE 64
+
+/*! \brief A type representing the cache statistics of a router. */
+typedef struct FlogRouterStatsData {
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+    size_t open;
+} FlogRouterStats;
+
+/*! \struct FlogRouter
+ *
+ *  \brief An opaque type representing a FlogRouter append file router object.
+ */
+typedef struct FlogRouterData FlogRouter;
+
+/*! \brief Create a FlogRouter object.
+ *
+ *  The cache capacity is reduced if necessary so that the writers it holds open
+ *  use no more than half of the available file descriptors.
+ *
+ *  \param[in]  capacity The maximum number of writers to keep open
+ *  \param[in]  backend  A FlogConfigWriter value representing the preferred writer
+ *                       backend for opened files
+ *  \param[in]  datasync A boolean value representing whether written data should be
+ *                       flushed to storage with \c fdatasync(2)
+ *  \param[out] error    A pointer to a FlogError object that will be used to represent
+ *                       an error condition on failure
+ *
+ *  \pre \c capacity is greater than zero
+ *  \pre \c error is \e not \c NULL
+ *
+ *  \return If successful, a pointer to a FlogRouter object; if there is an error
+ *          a \c NULL pointer is returned and \c error will be set to a FlogError
+ *          variant representing an error condition
+ */
+FlogRouter * flog_router_new(size_t capacity, FlogConfigWriter backend, bool datasync, FlogError *error);
+
+/*! \brief Free a FlogRouter object, flushing and closing every open writer.
+ *
+ *  \param router A pointer to the FlogRouter object that should be freed
+ *
+ *  \pre \c router is \e not \c NULL
+ */
+void flog_router_free(FlogRouter *router);
+
+/*! \brief Get the cache capacity of a FlogRouter object.
+ *
+ *  \param router A pointer to the FlogRouter object
+ *
+ *  \pre \c router is \e not \c NULL
+ *
+ *  \return The maximum number of writers the router keeps open
+ */
+size_t flog_router_get_capacity(const FlogRouter *router);
+
+/*! \brief Create the missing parent directories of an append file.
+ *
+ *  Directories are created with permissions that deny write access to the group and
+ *  others. Failures are ignored, and reported by the open of the file that follows.
+ *
+ *  \param path A pointer to the null-terminated file path
+ *
+ *  \pre \c path is \e not \c NULL
+ */
+void flog_router_make_parents(const char *path);
+
+/*! \brief Get a writer for an append file, opening it if it is not already open.
+ *
+ *  The returned writer remains valid until the next call to this function or
+ *  until the router is freed.
+ *
+ *  \param[in]  router         A pointer to the FlogRouter object
+ *  \param[in]  path           A pointer to the null-terminated file path
+ *  \param[in]  create_parents A boolean value representing whether missing parent
+ *                             directories should be created
+ *  \param[out] error          A pointer to a FlogError object that will be used to
+ *                             represent an error condition on failure
+ *
+ *  \pre \c router, \c path and \c error are \e not \c NULL
+ *
+ *  \return If successful, a pointer to a FlogWriter object; if there is an error
+ *          a \c NULL pointer is returned and \c error will be set to a FlogError
+ *          variant representing an error condition
+ */
+FlogWriter * flog_router_get_writer(FlogRouter *router, const char *path, bool create_parents, FlogError *error);
+
+/*! \brief Flush every open writer.
+ *
+ *  \param router A pointer to the FlogRouter object
+ *
+ *  \pre \c router is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, otherwise
+ *          FLOG_ERROR_APPEND if any write failed, including writes by writers
+ *          that have since been evicted
+ */
+FlogError flog_router_flush(FlogRouter *router);
+
+/*! \brief Get the cache statistics of a FlogRouter object.
+ *
+ *  \param[in]  router A pointer to the FlogRouter object
+ *  \param[out] stats  A pointer to a FlogRouterStats object that will be filled
+ *
+ *  \pre \c router is \e not \c NULL
+ *  \pre \c stats is \e not \c NULL
+ */
+void flog_router_get_stats(const FlogRouter *router, FlogRouterStats *stats);
+
+/*! \brief Determine whether an append file path contains template variables.
+ *
+ *  \param path A pointer to the null-terminated file path
+ *
+ *  \pre \c path is \e not \c NULL
+ *
+ *  \return \c true if the path contains a known variable, otherwise \c false
+ */
+bool flog_router_is_template(const char *path);
+
+/*! \brief Expand an append file path template.
+ *
+ *  A path that is not a template (see flog_router_is_template()) is copied unchanged.
+ *
+ *  \param[in]  template  A pointer to the null-terminated path template
+ *  \param[in]  subsystem A pointer to the null-terminated subsystem name
+ *  \param[in]  category  A pointer to the null-terminated category name
+ *  \param[in]  level     A FlogConfigLevel value representing the log level
+ *  \param[out] buf       A pointer to a buffer that will receive the expanded path
+ *  \param[in]  size      The size of the buffer in bytes
+ *
+ *  \pre \c template, \c subsystem, \c category and \c buf are \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE; FLOG_ERROR_TEMPLATE
+ *          if a template also contains an unknown or unterminated variable, or
+ *          FLOG_ERROR_FILE if the expanded path does not fit in the buffer
+ */
+FlogError flog_router_expand(const char *template, const char *subsystem, const char *category,
+                             FlogConfigLevel level, char *buf, size_t size);
+
+#endif //FLOG_ROUTER_H
@@ -0,0 +1,69 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "sample.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "checksum.h"
+
+#ifdef UNIT_TESTING
+#include "../test/testing.h"
+#endif
+
+// 2^64, the number of distinct hash values
+#define SAMPLE_HASH_RANGE 18446744073709551616.0
+
+bool
+flog_sample_keeps(const char *message, double rate) {
+    assert(message != NULL);
+
+    if (rate >= 1.0) {
+        return true;
+    }
+
+    // A message is kept if its hash falls in the first fraction of the hash range
+    uint64_t threshold = (uint64_t) (rate * SAMPLE_HASH_RANGE);
+
+    return flog_hash64(message, strlen(message)) < threshold;
+}
+
+void
+flog_sample_annotate(char *message, size_t size, double rate) {
+    assert(message != NULL);
+    assert(size >= SAMPLE_ANNOTATION_LEN);
+
+    char annotation[SAMPLE_ANNOTATION_LEN];
+    int annotation_len = snprintf(annotation, sizeof(annotation), " [sample_rate=%g]", rate);
+
+    // A character cut by the annotation is removed whole
+    size_t len = strnlen(message, size - 1);
+    if (len + (size_t) annotation_len >= size) {
+        len = size - 1 - (size_t) annotation_len;
+        while (len > 0 && ((unsigned char) message[len] & 0xc0) == 0x80) {
+            len--;
+        }
+    }
+
+    memcpy(message + len, annotation, (size_t) annotation_len + 1);
+}
@@ -0,0 +1,67 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_SAMPLE_H
+#define FLOG_SAMPLE_H
+
+/*! \file sample.h
+ *
+ *  Helper functions for keeping a fraction of the messages logged at a level.
+ *
+ *  Whether a message is kept depends only on a 64-bit hash of its text and the
+ *  sample rate, so a message is kept or dropped consistently by every process using
+ *  the same rate, and a message kept at one rate is also kept at any higher rate.
+ *  Kept messages are annotated with their sample rate, so that counts taken from the
+ *  log can be scaled back up.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SAMPLE_ANNOTATION_LEN 32
+
+/*! \brief Determine whether a message is kept at a sample rate.
+ *
+ *  \param message A pointer to the null-terminated message
+ *  \param rate    The fraction of messages kept, greater than zero and at most one
+ *
+ *  \pre \c message is \e not \c NULL
+ *
+ *  \return \c true if the message should be logged, otherwise \c false
+ */
+bool flog_sample_keeps(const char *message, double rate);
+
+/*! \brief Append the annotation of a sample rate to a message.
+ *
+ *  The annotation has the form <tt> [sample_rate=0.01]</tt>. The message is truncated
+ *  at a UTF-8 character boundary if necessary, so that the annotation always fits.
+ *
+ *  \param message A pointer to the null-terminated message, in a buffer of \c size bytes
+ *  \param size    The size of the buffer in bytes, at least \c SAMPLE_ANNOTATION_LEN
+ *  \param rate    The sample rate at which the message was kept
+ *
+ *  \pre \c message is \e not \c NULL
+ *  \pre \c size is at least \c SAMPLE_ANNOTATION_LEN
+ */
+void flog_sample_annotate(char *message, size_t size, double rate);
+
+#endif //FLOG_SAMPLE_H
@@ -0,0 +1,557 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "sanitize.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#ifdef UNIT_TESTING
+#include "../test/testing.h"
+#endif
+
+#define SWAR_ONES UINT64_C(0x0101010101010101)
+#define SWAR_HIGHS UINT64_C(0x8080808080808080)
+#define SWAR_LOWS UINT64_C(0x7f7f7f7f7f7f7f7f)
+#define VECTOR_LEN 16
+#define PRINTABLE_MIN 0x20
+#define PRINTABLE_MAX 0x7f
+#define CONTINUATION_MIN 0x80
+#define CONTINUATION_MAX 0xbf
+#define REPLACEMENT_LEN 3
+#define ESCAPE_LEN 4
+
+#if defined(__SSSE3__) || (defined(__ARM_NEON) && defined(__aarch64__))
+// The errors that a pair of bytes can show, looked up from the high and low nibbles of
+// the first byte and the high nibble of the second (see Keiser and Lemire, "Validating
+// UTF-8 In Less Than One Instruction Per Byte"); a pair is invalid if an error is set
+// in all three tables, except that a continuation byte that follows another is only
+// invalid where it is not the third or fourth byte of a sequence
+#define UTF8_TOO_SHORT 0x01
+#define UTF8_TOO_LONG 0x02
+#define UTF8_OVERLONG_3 0x04
+#define UTF8_TOO_LARGE 0x08
+#define UTF8_SURROGATE 0x10
+#define UTF8_OVERLONG_2 0x20
+#define UTF8_TOO_LARGE_1000 0x40
+#define UTF8_OVERLONG_4 0x40
+#define UTF8_TWO_CONTINUATIONS 0x80
+#define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTINUATIONS)
+#define UTF8_TOO_LARGE_ANY (UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000)
+#define UTF8_CONTINUATION (UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUATIONS)
+
+static const uint8_t utf8_first_high[VECTOR_LEN] = {
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TWO_CONTINUATIONS, UTF8_TWO_CONTINUATIONS, UTF8_TWO_CONTINUATIONS, UTF8_TWO_CONTINUATIONS,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+};
+
+static const uint8_t utf8_first_low[VECTOR_LEN] = {
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+    UTF8_CARRY | UTF8_OVERLONG_2,
+    UTF8_CARRY,
+    UTF8_CARRY,
+    UTF8_CARRY | UTF8_TOO_LARGE,
+    UTF8_TOO_LARGE_ANY, UTF8_TOO_LARGE_ANY, UTF8_TOO_LARGE_ANY,
+    UTF8_TOO_LARGE_ANY, UTF8_TOO_LARGE_ANY, UTF8_TOO_LARGE_ANY, UTF8_TOO_LARGE_ANY,
+    UTF8_TOO_LARGE_ANY,
+    UTF8_TOO_LARGE_ANY | UTF8_SURROGATE,
+    UTF8_TOO_LARGE_ANY, UTF8_TOO_LARGE_ANY
+};
+
+static const uint8_t utf8_second_high[VECTOR_LEN] = {
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_CONTINUATION | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+    UTF8_CONTINUATION | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+    UTF8_CONTINUATION | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    UTF8_CONTINUATION | UTF8_SURROGATE | UTF8_TOO_LARGE,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+};
+
+// A vector ends in an incomplete sequence if its last byte is a leading byte, its
+// second last leads a sequence of three or four bytes, or its third last one of four
+static const uint8_t utf8_incomplete_max[VECTOR_LEN] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xef, 0xdf, 0xbf
+};
+#endif
+
+size_t flog_sanitize_skip_valid(const unsigned char *str, size_t len);
+
+size_t flog_sanitize_skip_quoted(const unsigned char *str, size_t len);
+
+#if defined(__SSSE3__) || (defined(__ARM_NEON) && defined(__aarch64__))
+size_t flog_sanitize_boundary(const unsigned char *str, size_t i, bool incomplete);
+#endif
+
+size_t flog_sanitize_allowed_length(const unsigned char *str, size_t len);
+
+size_t flog_sanitize_unit(const unsigned char *str, size_t len, char *escape, const char **unit, size_t *unit_len);
+
+size_t flog_sanitize_utf8_length(const unsigned char *str, size_t len, bool *valid);
+
+size_t
+flog_sanitize_scan(const char *str, size_t len) {
+    assert(str != NULL);
+
+    const unsigned char *bytes = (const unsigned char *) str;
+
+    size_t i = 0;
+    while (i < len) {
+        i += flog_sanitize_skip_valid(bytes + i, len - i);
+
+        // The bytes from where the vector scan stopped are read one at a time for at
+        // least a vector's length, to find the byte to be sanitized, if any, or to pass
+        // a line ending before the vector scan is resumed
+        size_t end = i + VECTOR_LEN;
+        while (i < len && i < end) {
+            if (bytes[i] >= PRINTABLE_MIN && bytes[i] <= PRINTABLE_MAX) {
+                i++;
+                continue;
+            }
+
+            size_t allowed = flog_sanitize_allowed_length(bytes + i, len - i);
+            if (allowed == 0) {
+                return i;
+            }
+            i += allowed;
+        }
+    }
+
+    return i;
+}
+
+size_t
+flog_sanitize_scan_quoted(const char *str, size_t len) {
+    assert(str != NULL);
+
+    const unsigned char *bytes = (const unsigned char *) str;
+
+    size_t i = 0;
+    while (i < len) {
+        i += flog_sanitize_skip_quoted(bytes + i, len - i);
+
+        // As in flog_sanitize_scan(), except that every control character, double quote
+        // and backslash ends the run
+        size_t end = i + VECTOR_LEN;
+        while (i < len && i < end) {
+            if (bytes[i] >= PRINTABLE_MIN && bytes[i] <= PRINTABLE_MAX) {
+                if (bytes[i] == '"' || bytes[i] == '\\') {
+                    return i;
+                }
+                i++;
+                continue;
+            }
+
+            bool valid = false;
+            size_t sequence_len = 0;
+            if (bytes[i] >= CONTINUATION_MIN) {
+                sequence_len = flog_sanitize_utf8_length(bytes + i, len - i, &valid);
+            }
+            if (!valid) {
+                return i;
+            }
+            i += sequence_len;
+        }
+    }
+
+    return i;
+}
+
+size_t
+flog_sanitize_sequence_length(const char *str, size_t len, bool *valid) {
+    assert(str != NULL);
+    assert(len > 0);
+    assert(valid != NULL);
+
+    return flog_sanitize_utf8_length((const unsigned char *) str, len, valid);
+}
+
+size_t
+flog_sanitize_copy(const char *str, size_t len, char *buf, size_t size, bool *truncated) {
+    assert(str != NULL);
+    assert(buf != NULL);
+    assert(size > 0);
+    assert(truncated != NULL);
+
+    const unsigned char *bytes = (const unsigned char *) str;
+
+    *truncated = false;
+
+    size_t pos = 0;
+    size_t i = 0;
+    while (i < len && !*truncated) {
+        // Runs that need nothing done are copied whole, and cut short only between characters
+        size_t run = flog_sanitize_scan(str + i, len - i);
+        if (run > size - 1 - pos) {
+            run = size - 1 - pos;
+            while (run > 0 && (bytes[i + run] & 0xc0) == CONTINUATION_MIN) {
+                run--;
+            }
+            *truncated = true;
+        }
+
+        memcpy(buf + pos, str + i, run);
+        pos += run;
+        i += run;
+
+        // Bytes to be sanitized tend to come together, so the bytes that follow one are
+        // copied a character at a time for a vector's length before the next run is found
+        size_t end = i + VECTOR_LEN;
+        while (i < len && i < end && !*truncated) {
+            char escape[ESCAPE_LEN];
+            const char *unit;
+            size_t unit_len;
+            size_t consumed = flog_sanitize_unit(bytes + i, len - i, escape, &unit, &unit_len);
+
+            if (unit_len > size - 1 - pos) {
+                *truncated = true;
+                break;
+            }
+
+            memcpy(buf + pos, unit, unit_len);
+            pos += unit_len;
+            i += consumed;
+        }
+    }
+
+    buf[pos] = '\0';
+
+    return pos;
+}
+
+// Inlined into flog_sanitize_skip_valid() and flog_sanitize_skip_quoted(), so that the tests
+// for the bytes that end a run of a JSON string are compiled out of the scan for sanitizing
+#if defined(__SSSE3__)
+static inline size_t
+flog_sanitize_skip(const unsigned char *str, size_t len, bool quoted) {
+    const __m128i first_high = _mm_loadu_si128((const __m128i *) utf8_first_high);
+    const __m128i first_low = _mm_loadu_si128((const __m128i *) utf8_first_low);
+    const __m128i second_high = _mm_loadu_si128((const __m128i *) utf8_second_high);
+    const __m128i incomplete_max = _mm_loadu_si128((const __m128i *) utf8_incomplete_max);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    const __m128i control_max = _mm_set1_epi8(PRINTABLE_MIN - 1);
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i zero = _mm_setzero_si128();
+    // Within a JSON string no control character is allowed, and quotes and backslashes end the run
+    const __m128i escaped = quoted ? _mm_set1_epi8((char) 0xff) : zero;
+
+    __m128i previous = zero;
+    __m128i previous_incomplete = zero;
+
+    size_t i = 0;
+    for (; i + VECTOR_LEN <= len; i += VECTOR_LEN) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) (str + i));
+
+        // Bytes below 0x20 are those left unchanged by the unsigned minimum with 0x1f
+        __m128i controls = _mm_cmpeq_epi8(_mm_min_epu8(chunk, control_max), chunk);
+        __m128i allowed = _mm_andnot_si128(escaped, _mm_or_si128(_mm_cmpeq_epi8(chunk, tab),
+                                                                 _mm_cmpeq_epi8(chunk, newline)));
+        __m128i error = _mm_or_si128(_mm_andnot_si128(allowed, controls),
+                                     _mm_and_si128(escaped, _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                                         _mm_cmpeq_epi8(chunk, backslash))));
+        __m128i incomplete = zero;
+
+        if (_mm_movemask_epi8(chunk) == 0) {
+            error = _mm_or_si128(error, previous_incomplete);
+        } else {
+            __m128i prev1 = _mm_alignr_epi8(chunk, previous, VECTOR_LEN - 1);
+            __m128i prev2 = _mm_alignr_epi8(chunk, previous, VECTOR_LEN - 2);
+            __m128i prev3 = _mm_alignr_epi8(chunk, previous, VECTOR_LEN - 3);
+
+            __m128i special = _mm_and_si128(
+                _mm_and_si128(_mm_shuffle_epi8(first_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                              _mm_shuffle_epi8(first_low, _mm_and_si128(prev1, nibble))),
+                _mm_shuffle_epi8(second_high, _mm_and_si128(_mm_srli_epi16(chunk, 4), nibble)));
+
+            // Only bytes that follow a leading byte of three or four bytes by two or three
+            // places, respectively, are left with a high bit by the saturating subtractions
+            __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8((char) (0xe0 - CONTINUATION_MIN)));
+            __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8((char) (0xf0 - CONTINUATION_MIN)));
+            __m128i must_continue = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8((char) 0x80));
+
+            error = _mm_or_si128(error, _mm_xor_si128(must_continue, special));
+            incomplete = _mm_subs_epu8(chunk, incomplete_max);
+        }
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, zero)) != 0xffff) {
+            break;
+        }
+
+        previous = chunk;
+        previous_incomplete = incomplete;
+    }
+
+    return flog_sanitize_boundary(str, i, _mm_movemask_epi8(_mm_cmpeq_epi8(previous_incomplete, zero)) != 0xffff);
+}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+static inline size_t
+flog_sanitize_skip(const unsigned char *str, size_t len, bool quoted) {
+    const uint8x16_t first_high = vld1q_u8(utf8_first_high);
+    const uint8x16_t first_low = vld1q_u8(utf8_first_low);
+    const uint8x16_t second_high = vld1q_u8(utf8_second_high);
+    const uint8x16_t incomplete_max = vld1q_u8(utf8_incomplete_max);
+    const uint8x16_t nibble = vdupq_n_u8(0x0f);
+    const uint8x16_t min = vdupq_n_u8(PRINTABLE_MIN);
+    const uint8x16_t tab = vdupq_n_u8('\t');
+    const uint8x16_t newline = vdupq_n_u8('\n');
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t zero = vdupq_n_u8(0);
+    // Within a JSON string no control character is allowed, and quotes and backslashes end the run
+    const uint8x16_t escaped = quoted ? vdupq_n_u8(0xff) : zero;
+
+    uint8x16_t previous = zero;
+    uint8x16_t previous_incomplete = zero;
+
+    size_t i = 0;
+    for (; i + VECTOR_LEN <= len; i += VECTOR_LEN) {
+        uint8x16_t chunk = vld1q_u8(str + i);
+
+        uint8x16_t allowed = vbicq_u8(vorrq_u8(vceqq_u8(chunk, tab), vceqq_u8(chunk, newline)), escaped);
+        uint8x16_t error = vorrq_u8(vbicq_u8(vcltq_u8(chunk, min), allowed),
+                                    vandq_u8(escaped, vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash))));
+        uint8x16_t incomplete = zero;
+
+        if (vmaxvq_u8(chunk) < CONTINUATION_MIN) {
+            error = vorrq_u8(error, previous_incomplete);
+        } else {
+            uint8x16_t prev1 = vextq_u8(previous, chunk, VECTOR_LEN - 1);
+            uint8x16_t prev2 = vextq_u8(previous, chunk, VECTOR_LEN - 2);
+            uint8x16_t prev3 = vextq_u8(previous, chunk, VECTOR_LEN - 3);
+
+            uint8x16_t special = vandq_u8(
+                vandq_u8(vqtbl1q_u8(first_high, vshrq_n_u8(prev1, 4)), vqtbl1q_u8(first_low, vandq_u8(prev1, nibble))),
+                vqtbl1q_u8(second_high, vshrq_n_u8(chunk, 4)));
+
+            // Only bytes that follow a leading byte of three or four bytes by two or three
+            // places, respectively, are left with a high bit by the saturating subtractions
+            uint8x16_t third = vqsubq_u8(prev2, vdupq_n_u8(0xe0 - CONTINUATION_MIN));
+            uint8x16_t fourth = vqsubq_u8(prev3, vdupq_n_u8(0xf0 - CONTINUATION_MIN));
+            uint8x16_t must_continue = vandq_u8(vorrq_u8(third, fourth), vdupq_n_u8(0x80));
+
+            error = vorrq_u8(error, veorq_u8(must_continue, special));
+            incomplete = vqsubq_u8(chunk, incomplete_max);
+        }
+
+        if (vmaxvq_u8(error) != 0) {
+            break;
+        }
+
+        previous = chunk;
+        previous_incomplete = incomplete;
+    }
+
+    return flog_sanitize_boundary(str, i, vmaxvq_u8(previous_incomplete) != 0);
+}
+#else
+static inline size_t
+flog_sanitize_skip(const unsigned char *str, size_t len, bool quoted) {
+    // Only printable ASCII, tabs and newlines are skipped, leaving multi-byte sequences
+    // to be read a byte at a time
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    // Bytes below 0x20, and bytes of 0x80 and above, which are negative as signed
+    // bytes, are the bytes that compare less than 0x20
+    const __m128i min = _mm_set1_epi8(PRINTABLE_MIN);
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i escaped = quoted ? _mm_set1_epi8((char) 0xff) : _mm_setzero_si128();
+    for (; i + VECTOR_LEN <= len; i += VECTOR_LEN) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) (str + i));
+        __m128i allowed = _mm_andnot_si128(escaped, _mm_or_si128(_mm_cmpeq_epi8(chunk, tab),
+                                                                 _mm_cmpeq_epi8(chunk, newline)));
+        __m128i ends = _mm_and_si128(escaped, _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                           _mm_cmpeq_epi8(chunk, backslash)));
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_andnot_si128(allowed, _mm_cmplt_epi8(chunk, min)), ends)) != 0) {
+            return i;
+        }
+    }
+#endif
+
+    // Each byte below 0x20 is flagged by a clear high bit once 0x60 is added to its
+    // low seven bits, and each tab, newline, quote and backslash by the same test once
+    // XORed with it; the additions cannot carry between bytes, so every byte is flagged
+    // exactly. Within a JSON string the tab and newline are flagged rather than allowed
+    uint64_t allowed_mask = quoted ? 0 : ~UINT64_C(0);
+    uint64_t escaped_mask = ~allowed_mask;
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, str + i, sizeof(word));
+
+        uint64_t tabs = word ^ (SWAR_ONES * '\t');
+        uint64_t newlines = word ^ (SWAR_ONES * '\n');
+        uint64_t quotes = word ^ (SWAR_ONES * '"');
+        uint64_t backslashes = word ^ (SWAR_ONES * '\\');
+        uint64_t controls = ~(((word & SWAR_LOWS) + SWAR_ONES * (CONTINUATION_MIN - PRINTABLE_MIN)) | word);
+        uint64_t allowed = (~(((tabs & SWAR_LOWS) + SWAR_LOWS) | tabs) |
+                            ~(((newlines & SWAR_LOWS) + SWAR_LOWS) | newlines)) & allowed_mask;
+        uint64_t ends = (~(((quotes & SWAR_LOWS) + SWAR_LOWS) | quotes) |
+                         ~(((backslashes & SWAR_LOWS) + SWAR_LOWS) | backslashes)) & escaped_mask;
+        if ((((controls & ~allowed) | ends | word) & SWAR_HIGHS) != 0) {
+            break;
+        }
+    }
+
+    return i;
+}
+#endif
+
+size_t
+flog_sanitize_skip_valid(const unsigned char *str, size_t len) {
+    return flog_sanitize_skip(str, len, false);
+}
+
+size_t
+flog_sanitize_skip_quoted(const unsigned char *str, size_t len) {
+    return flog_sanitize_skip(str, len, true);
+}
+
+#if defined(__SSSE3__) || (defined(__ARM_NEON) && defined(__aarch64__))
+size_t
+flog_sanitize_boundary(const unsigned char *str, size_t i, bool incomplete) {
+    // A sequence left incomplete at the end of the last vector that was valid is read
+    // again from its leading byte
+    if (incomplete) {
+        while ((str[i - 1] & 0xc0) == CONTINUATION_MIN) {
+            i--;
+        }
+        i--;
+    }
+
+    return i;
+}
+#endif
+
+size_t
+flog_sanitize_allowed_length(const unsigned char *str, size_t len) {
+    if (str[0] == '\t' || str[0] == '\n') {
+        return 1;
+    }
+
+    // Carriage returns are kept only as part of a line ending
+    if (str[0] == '\r') {
+        return len > 1 && str[1] == '\n' ? 2 : 0;
+    }
+
+    if (str[0] < PRINTABLE_MIN) {
+        return 0;
+    }
+
+    bool valid;
+    size_t sequence_len = flog_sanitize_utf8_length(str, len, &valid);
+
+    return valid ? sequence_len : 0;
+}
+
+size_t
+flog_sanitize_unit(const unsigned char *str, size_t len, char *escape, const char **unit, size_t *unit_len) {
+    static const char hex[] = "0123456789abcdef";
+
+    // A character that needs nothing done is its own unit
+    size_t allowed = str[0] >= PRINTABLE_MIN && str[0] <= PRINTABLE_MAX ? 1 : flog_sanitize_allowed_length(str, len);
+    if (allowed > 0) {
+        *unit = (const char *) str;
+        *unit_len = allowed;
+        return allowed;
+    }
+
+    if (str[0] < PRINTABLE_MIN) {
+        escape[0] = '\\';
+        escape[1] = 'x';
+        escape[2] = hex[str[0] >> 4];
+        escape[3] = hex[str[0] & 0xf];
+        *unit = escape;
+        *unit_len = ESCAPE_LEN;
+        return 1;
+    }
+
+    bool valid;
+    *unit = SANITIZE_REPLACEMENT;
+    *unit_len = REPLACEMENT_LEN;
+
+    return flog_sanitize_utf8_length(str, len, &valid);
+}
+
+size_t
+flog_sanitize_utf8_length(const unsigned char *str, size_t len, bool *valid) {
+    // The second byte is limited for the leading bytes whose sequences could otherwise
+    // be overlong, encode surrogates or exceed U+10FFFF (see RFC 3629)
+    unsigned char c = str[0];
+    unsigned char min = CONTINUATION_MIN;
+    unsigned char max = CONTINUATION_MAX;
+    size_t sequence_len;
+
+    if (c >= 0xc2 && c <= 0xdf) {
+        sequence_len = 2;
+    } else if (c == 0xe0) {
+        sequence_len = 3;
+        min = 0xa0;
+    } else if (c == 0xed) {
+        sequence_len = 3;
+        max = 0x9f;
+    } else if (c >= 0xe1 && c <= 0xef) {
+        sequence_len = 3;
+    } else if (c == 0xf0) {
+        sequence_len = 4;
+        min = 0x90;
+    } else if (c == 0xf4) {
+        sequence_len = 4;
+        max = 0x8f;
+    } else if (c >= 0xf1 && c <= 0xf3) {
+        sequence_len = 4;
+    } else {
+        *valid = false;
+        return 1;
+    }
+
+    // An invalid sequence extends as far as it could have been valid, so that it is
+    // replaced once rather than once for each byte
+    size_t i = 1;
+    while (i < sequence_len && i < len && str[i] >= min && str[i] <= max) {
+        min = CONTINUATION_MIN;
+        max = CONTINUATION_MAX;
+        i++;
+    }
+
+    *valid = i == sequence_len;
+
+    return i;
+}
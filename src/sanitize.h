@@ -0,0 +1,116 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_SANITIZE_H
+#define FLOG_SANITIZE_H
+
+/*! \file sanitize.h
+ *
+ *  Helper functions for making messages read from a stream safe to log.
+ *
+ *  A message is left as it is if it is valid UTF-8 and holds no control characters
+ *  below 0x20 other than tabs, newlines and carriage returns that precede a newline.
+ *  Otherwise each byte that does not begin a valid sequence, along with the
+ *  continuation bytes that follow it as far as the sequence could be valid, is
+ *  replaced with U+FFFD, and each other control character is escaped as \c \\xHH, so
+ *  that binary data and terminal escape sequences reach neither the log nor the
+ *  append files.
+ *
+ *  Messages are validated 16 bytes at a time with SSSE3 or NEON where they are
+ *  available, using the table lookups described by Keiser and Lemire in "Validating
+ *  UTF-8 In Less Than One Instruction Per Byte". Processors with only SSE2, or with
+ *  neither, have printable ASCII scanned 16 bytes or a 64-bit word at a time instead,
+ *  with multi-byte sequences read a byte at a time. Once a byte to be sanitized is
+ *  found, the bytes that follow it are read a byte at a time for at least 16 bytes
+ *  before the vector scan is resumed.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SANITIZE_REPLACEMENT "\xef\xbf\xbd"
+
+/*! \brief Measure the run of bytes at the start of a string that need no sanitizing.
+ *
+ *  \param str A pointer to the string
+ *  \param len The length of the string in bytes
+ *
+ *  \pre \c str is \e not \c NULL
+ *
+ *  \return The number of bytes before the first invalid UTF-8 sequence or control
+ *          character to be escaped, or \c len if there is none
+ */
+size_t flog_sanitize_scan(const char *str, size_t len);
+
+/*! \brief Measure the run of bytes at the start of a string that can be written
+ *         unchanged inside a JSON string.
+ *
+ *  The string is scanned as by flog_sanitize_scan(), in the same vector loop, except
+ *  that every control character below 0x20, double quote and backslash also ends the
+ *  run.
+ *
+ *  \param str A pointer to the string
+ *  \param len The length of the string in bytes
+ *
+ *  \pre \c str is \e not \c NULL
+ *
+ *  \return The number of bytes before the first invalid UTF-8 sequence, control
+ *          character, double quote or backslash, or \c len if there is none
+ */
+size_t flog_sanitize_scan_quoted(const char *str, size_t len);
+
+/*! \brief Measure the UTF-8 sequence at the start of a string.
+ *
+ *  \param[in]  str   A pointer to the string, which starts with a byte of 0x80 or above
+ *  \param[in]  len   The length of the string in bytes
+ *  \param[out] valid A pointer to a boolean value that will be set to \c true if the
+ *                    sequence is valid
+ *
+ *  \pre \c str and \c valid are \e not \c NULL
+ *  \pre \c len is greater than zero
+ *
+ *  \return The length of a valid sequence, or otherwise the number of bytes to be
+ *          replaced with a single U+FFFD: the first byte, and the continuation bytes
+ *          that follow it as far as the sequence could have been valid
+ */
+size_t flog_sanitize_sequence_length(const char *str, size_t len, bool *valid);
+
+/*! \brief Copy a string, replacing invalid UTF-8 sequences and escaping control characters.
+ *
+ *  The copy is always null-terminated. A replacement or escape that would not fit is
+ *  left out along with the rest of the string, rather than being cut short.
+ *
+ *  \param[in]  str       A pointer to the string
+ *  \param[in]  len       The length of the string in bytes
+ *  \param[out] buf       A pointer to a buffer that will receive the copy
+ *  \param[in]  size      The size of the buffer in bytes
+ *  \param[out] truncated A pointer to a boolean value that will be set to \c true if
+ *                        the copy was truncated to fit the buffer
+ *
+ *  \pre \c str, \c buf and \c truncated are \e not \c NULL
+ *  \pre \c size is greater than zero
+ *
+ *  \return The number of bytes copied, excluding the null terminator
+ */
+size_t flog_sanitize_copy(const char *str, size_t len, char *buf, size_t size, bool *truncated);
+
+#endif //FLOG_SANITIZE_H
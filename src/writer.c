@@ -0,0 +1,486 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "writer.h"
+#include "common.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define WRITER_URING
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+#endif
+
+#ifdef UNIT_TESTING
+#include "../test/testing.h"
+#endif
+
+// Append files are created without group or other write permission; the mode is given
+// to open(2) rather than set with umask(2), which is shared by every thread of a process
+#define WRITER_FILE_MODE (S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)
+
+#ifdef WRITER_URING
+#define URING_ENTRIES (WRITER_BATCH_COUNT * 2)
+#define URING_FSYNC_DATA UINT64_MAX
+
+typedef struct UringData {
+    int fd;
+    unsigned char *sq_ring;
+    size_t sq_ring_size;
+    unsigned char *cq_ring;
+    size_t cq_ring_size;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_cqe *cqes;
+} Uring;
+#endif
+
+struct FlogWriterData {
+    int fd;
+    FlogConfigWriter backend;
+    bool datasync;
+    FlogError error;
+#ifdef WRITER_URING
+    Uring ring;
+    char *buffers;
+    size_t lengths[WRITER_BATCH_COUNT];
+    // Set from when a batch is queued until its write completes
+    bool in_flight[WRITER_BATCH_COUNT];
+    unsigned current;
+    // Entries written to the submission queue but not yet submitted, and those submitted
+    // but not yet completed
+    unsigned queued;
+    unsigned outstanding;
+#endif
+};
+
+FlogError flog_writer_write_once(int fd, const struct iovec *iov, int count, size_t len);
+FlogError flog_writer_datasync(int fd);
+
+FlogError
+flog_writer_write_once(int fd, const struct iovec *iov, int count, size_t len) {
+    ssize_t written;
+
+    do {
+        written = writev(fd, iov, count);
+    } while (written == -1 && errno == EINTR);
+
+    // Completing a short write with a second call would allow another process
+    // to append between the two parts, so the remainder is treated as lost
+    if (written < 0 || (size_t) written != len) {
+        return FLOG_ERROR_APPEND;
+    }
+
+    return FLOG_ERROR_NONE;
+}
+
+FlogError
+flog_writer_datasync(int fd) {
+#ifdef __APPLE__
+    int result = fsync(fd);
+#else
+    int result = fdatasync(fd);
+#endif
+    return result == 0 ? FLOG_ERROR_NONE : FLOG_ERROR_APPEND;
+}
+
+#ifdef WRITER_URING
+bool flog_writer_uring_init(FlogWriter *writer);
+void flog_writer_uring_exit(FlogWriter *writer);
+void flog_writer_uring_queue(FlogWriter *writer, unsigned batch);
+bool flog_writer_uring_submit(FlogWriter *writer);
+bool flog_writer_uring_reap(FlogWriter *writer, bool wait);
+
+bool
+flog_writer_uring_init(FlogWriter *writer) {
+    Uring *ring = &writer->ring;
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    ring->fd = (int) syscall(__NR_io_uring_setup, URING_ENTRIES, &params);
+    if (ring->fd == -1) {
+        return false;
+    }
+
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) == 0) {
+        close(ring->fd);
+        return false;
+    }
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (ring->cq_ring_size > ring->sq_ring_size) {
+        ring->sq_ring_size = ring->cq_ring_size;
+    }
+    ring->cq_ring_size = ring->sq_ring_size;
+
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring == MAP_FAILED) {
+        close(ring->fd);
+        return false;
+    }
+    ring->cq_ring = ring->sq_ring;
+
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        munmap(ring->sq_ring, ring->sq_ring_size);
+        close(ring->fd);
+        return false;
+    }
+
+    ring->sq_head = (unsigned *) (ring->sq_ring + params.sq_off.head);
+    ring->sq_tail = (unsigned *) (ring->sq_ring + params.sq_off.tail);
+    ring->sq_mask = (unsigned *) (ring->sq_ring + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned *) (ring->sq_ring + params.sq_off.array);
+    ring->cq_head = (unsigned *) (ring->cq_ring + params.cq_off.head);
+    ring->cq_tail = (unsigned *) (ring->cq_ring + params.cq_off.tail);
+    ring->cq_mask = (unsigned *) (ring->cq_ring + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *) (ring->cq_ring + params.cq_off.cqes);
+
+    writer->buffers = malloc((size_t) WRITER_BATCH_SIZE * WRITER_BATCH_COUNT);
+    if (writer->buffers == NULL) {
+        flog_writer_uring_exit(writer);
+        return false;
+    }
+
+    struct iovec iovecs[WRITER_BATCH_COUNT];
+    for (unsigned i = 0; i < WRITER_BATCH_COUNT; i++) {
+        iovecs[i].iov_base = writer->buffers + (size_t) i * WRITER_BATCH_SIZE;
+        iovecs[i].iov_len = WRITER_BATCH_SIZE;
+    }
+
+    if (syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS, iovecs, WRITER_BATCH_COUNT) == -1) {
+        flog_writer_uring_exit(writer);
+        return false;
+    }
+
+    return true;
+}
+
+void
+flog_writer_uring_exit(FlogWriter *writer) {
+    Uring *ring = &writer->ring;
+
+    munmap(ring->sqes, ring->sqes_size);
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->fd);
+
+    free(writer->buffers);
+    writer->buffers = NULL;
+}
+
+void
+flog_writer_uring_queue(FlogWriter *writer, unsigned batch) {
+    Uring *ring = &writer->ring;
+    unsigned tail = *ring->sq_tail + writer->queued;
+    unsigned mask = *ring->sq_mask;
+
+    // Every queued entry is linked to the next, so that a chain of batches reaches the
+    // file in order and a failed or short write cancels the writes that follow it
+    struct io_uring_sqe *sqe = &ring->sqes[tail & mask];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_WRITE_FIXED;
+    sqe->flags = IOSQE_IO_LINK;
+    sqe->fd = writer->fd;
+    sqe->addr = (uint64_t) (uintptr_t) (writer->buffers + (size_t) batch * WRITER_BATCH_SIZE);
+    sqe->len = (uint32_t) writer->lengths[batch];
+    sqe->buf_index = (uint16_t) batch;
+    sqe->user_data = batch;
+    ring->sq_array[tail & mask] = tail & mask;
+    tail++;
+
+    if (writer->datasync) {
+        sqe = &ring->sqes[tail & mask];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_FSYNC;
+        sqe->flags = IOSQE_IO_LINK;
+        sqe->fd = writer->fd;
+        sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+        sqe->user_data = URING_FSYNC_DATA;
+        ring->sq_array[tail & mask] = tail & mask;
+        tail++;
+    }
+
+    writer->queued += writer->datasync ? 2 : 1;
+    writer->in_flight[batch] = true;
+}
+
+bool
+flog_writer_uring_submit(FlogWriter *writer) {
+    // A link cannot span submissions, so a chain is only submitted once the previous one
+    // has completed, taking with it every batch queued in the meantime
+    if (writer->queued == 0 || writer->outstanding > 0) {
+        return true;
+    }
+
+    Uring *ring = &writer->ring;
+    unsigned tail = *ring->sq_tail + writer->queued;
+    unsigned count = writer->queued;
+
+    ring->sqes[(tail - 1) & *ring->sq_mask].flags &= (uint8_t) ~IOSQE_IO_LINK;
+    __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+    writer->queued = 0;
+
+    int submitted;
+    do {
+        submitted = (int) syscall(__NR_io_uring_enter, ring->fd, count, 0, 0, NULL, 0);
+    } while (submitted == -1 && errno == EINTR);
+
+    if (submitted != (int) count) {
+        return false;
+    }
+
+    writer->outstanding += count;
+
+    return true;
+}
+
+bool
+flog_writer_uring_reap(FlogWriter *writer, bool wait) {
+    Uring *ring = &writer->ring;
+
+    if (wait && writer->outstanding > 0) {
+        int result;
+        do {
+            result = (int) syscall(__NR_io_uring_enter, ring->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        } while (result == -1 && errno == EINTR);
+
+        if (result == -1) {
+            return false;
+        }
+    }
+
+    unsigned head = *ring->cq_head;
+    unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; head++) {
+        const struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+        writer->outstanding--;
+
+        if (cqe->user_data == URING_FSYNC_DATA) {
+            if (cqe->res < 0) {
+                writer->error = FLOG_ERROR_APPEND;
+            }
+            continue;
+        }
+
+        unsigned batch = (unsigned) cqe->user_data;
+        size_t length = writer->lengths[batch];
+
+        if (cqe->res < 0) {
+            writer->error = FLOG_ERROR_APPEND;
+        } else if ((size_t) cqe->res < length) {
+            writer->error = FLOG_ERROR_APPEND;
+        }
+
+        writer->lengths[batch] = 0;
+        writer->in_flight[batch] = false;
+    }
+
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+
+    return true;
+}
+#endif
+
+FlogWriter *
+flog_writer_new(const char *path, FlogConfigWriter backend, bool datasync, FlogError *error) {
+    assert(path != NULL);
+    assert(error != NULL);
+
+    *error = FLOG_ERROR_NONE;
+
+    FlogWriter *writer = calloc(1, sizeof(struct FlogWriterData));
+    if (writer == NULL) {
+        *error = FLOG_ERROR_ALLOC;
+        return NULL;
+    }
+
+    writer->fd = open(path, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, WRITER_FILE_MODE);
+
+    if (writer->fd == -1) {
+        int open_errno = errno;
+        free(writer);
+        errno = open_errno;
+        *error = FLOG_ERROR_APPEND;
+        return NULL;
+    }
+
+    writer->backend = WRT_SYNC;
+    writer->datasync = datasync;
+    writer->error = FLOG_ERROR_NONE;
+
+#ifdef WRITER_URING
+    if (backend == WRT_ASYNC && flog_writer_uring_init(writer)) {
+        writer->backend = WRT_ASYNC;
+    }
+#else
+    (void) backend;
+#endif
+
+    return writer;
+}
+
+void
+flog_writer_free(FlogWriter *writer) {
+    assert(writer != NULL);
+
+    flog_writer_flush(writer);
+
+#ifdef WRITER_URING
+    if (writer->backend == WRT_ASYNC) {
+        flog_writer_uring_exit(writer);
+    }
+#endif
+
+    close(writer->fd);
+    free(writer);
+}
+
+FlogConfigWriter
+flog_writer_get_backend(const FlogWriter *writer) {
+    assert(writer != NULL);
+
+    return writer->backend;
+}
+
+FlogError
+flog_writer_write(FlogWriter *writer, const char *buf, size_t len) {
+    assert(writer != NULL);
+    assert(buf != NULL);
+
+    struct iovec iov = { .iov_base = (void *) buf, .iov_len = len };
+
+    return flog_writer_writev(writer, &iov, 1);
+}
+
+FlogError
+flog_writer_writev(FlogWriter *writer, const struct iovec *iov, int count) {
+    assert(writer != NULL);
+    assert(iov != NULL);
+
+    if (writer->error != FLOG_ERROR_NONE) {
+        return writer->error;
+    }
+
+    size_t len = 0;
+    for (int i = 0; i < count; i++) {
+        len += iov[i].iov_len;
+    }
+
+#ifdef WRITER_URING
+    if (writer->backend == WRT_ASYNC) {
+        size_t *length = &writer->lengths[writer->current];
+
+        if (*length + len > WRITER_BATCH_SIZE && *length > 0) {
+            flog_writer_uring_queue(writer, writer->current);
+
+            // Move to the next buffer, waiting for the kernel to release one
+            // only if every buffer is still in flight
+            writer->current = (writer->current + 1) % WRITER_BATCH_COUNT;
+            flog_writer_uring_reap(writer, false);
+            if (!flog_writer_uring_submit(writer)) {
+                writer->error = FLOG_ERROR_APPEND;
+                return writer->error;
+            }
+            while (writer->in_flight[writer->current]) {
+                if (!flog_writer_uring_reap(writer, true) || !flog_writer_uring_submit(writer)) {
+                    writer->error = FLOG_ERROR_APPEND;
+                    return writer->error;
+                }
+            }
+            length = &writer->lengths[writer->current];
+        }
+
+        if (len > WRITER_BATCH_SIZE) {
+            // Too large to batch; preserve ordering by draining earlier batches first
+            if (flog_writer_flush(writer) != FLOG_ERROR_NONE) {
+                return writer->error;
+            }
+            writer->error = flog_writer_write_once(writer->fd, iov, count, len);
+            if (writer->error == FLOG_ERROR_NONE && writer->datasync) {
+                writer->error = flog_writer_datasync(writer->fd);
+            }
+            return writer->error;
+        }
+
+        char *batch = writer->buffers + (size_t) writer->current * WRITER_BATCH_SIZE;
+        for (int i = 0; i < count; i++) {
+            memcpy(batch + *length, iov[i].iov_base, iov[i].iov_len);
+            *length += iov[i].iov_len;
+        }
+
+        return writer->error;
+    }
+#endif
+
+    writer->error = flog_writer_write_once(writer->fd, iov, count, len);
+    if (writer->error == FLOG_ERROR_NONE && writer->datasync) {
+        writer->error = flog_writer_datasync(writer->fd);
+    }
+
+    return writer->error;
+}
+
+FlogError
+flog_writer_flush(FlogWriter *writer) {
+    assert(writer != NULL);
+
+#ifdef WRITER_URING
+    if (writer->backend == WRT_ASYNC) {
+        if (writer->lengths[writer->current] > 0 && !writer->in_flight[writer->current]) {
+            flog_writer_uring_queue(writer, writer->current);
+            writer->current = (writer->current + 1) % WRITER_BATCH_COUNT;
+        }
+
+        while (writer->queued > 0 || writer->outstanding > 0) {
+            if (!flog_writer_uring_submit(writer) || !flog_writer_uring_reap(writer, true)) {
+                writer->error = FLOG_ERROR_APPEND;
+                break;
+            }
+        }
+    }
+#endif
+
+    return writer->error;
+}
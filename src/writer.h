@@ -0,0 +1,140 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLOG_WRITER_H
+#define FLOG_WRITER_H
+
+/*! \file writer.h
+ *
+ *  Append writer object and associated functions for writing log messages to files.
+ *
+ *  Each call appends its data with exactly one \c writev(2) on an \c O_APPEND
+ *  descriptor (or as part of one larger batched write), so records written by
+ *  concurrent processes are never interleaved. The synchronous backend issues a
+ *  \c writev(2) per call. The asynchronous backend,
+ *  available on Linux, copies data into a set of registered buffers and submits
+ *  them through io_uring, keeping several batches in flight so that callers only
+ *  wait on the filesystem when every buffer is in use. Batches are submitted as
+ *  linked chains, so they reach the file in order. If io_uring is unavailable
+ *  the synchronous backend is used instead.
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <sys/uio.h>
+#include "config.h"
+#include "common.h"
+
+#define WRITER_BATCH_SIZE (64 * 1024)
+#define WRITER_BATCH_COUNT 4
+
+/*! \struct FlogWriter
+ *
+ *  \brief An opaque type representing a FlogWriter append writer object.
+ */
+typedef struct FlogWriterData FlogWriter;
+
+/*! \brief Create a FlogWriter object for appending to a file, creating the file if necessary.
+ *
+ *  \param[in]  path      A pointer to the null-terminated file path
+ *  \param[in]  backend   A FlogConfigWriter value representing the preferred writer backend
+ *  \param[in]  datasync  A boolean value representing whether written data should be
+ *                        flushed to storage with \c fdatasync(2)
+ *  \param[out] error     A pointer to a FlogError object that will be used to represent
+ *                        an error condition on failure
+ *
+ *  \pre \c path is \e not \c NULL
+ *  \pre \c error is \e not \c NULL
+ *
+ *  \return If successful, a pointer to a FlogWriter object; if there is an error
+ *          a \c NULL pointer is returned and \c error will be set to a FlogError
+ *          variant representing an error condition (if the file could not be opened
+ *          \c errno is left set by \c open(2))
+ */
+FlogWriter * flog_writer_new(const char *path, FlogConfigWriter backend, bool datasync, FlogError *error);
+
+/*! \brief Free a FlogWriter object, waiting for any outstanding writes to complete.
+ *
+ *  \param writer A pointer to the FlogWriter object that should be freed
+ *
+ *  \pre \c writer is \e not \c NULL
+ */
+void flog_writer_free(FlogWriter *writer);
+
+/*! \brief Get the backend in use by a FlogWriter object.
+ *
+ *  \param writer A pointer to the FlogWriter object
+ *
+ *  \pre \c writer is \e not \c NULL
+ *
+ *  \return A FlogConfigWriter value representing the backend in use, which is
+ *          WRT_SYNC if the asynchronous backend was requested but is unavailable
+ */
+FlogConfigWriter flog_writer_get_backend(const FlogWriter *writer);
+
+/*! \brief Append data to the file associated with a FlogWriter object.
+ *
+ *  With the asynchronous backend the data may not have reached the file when
+ *  this function returns; errors from earlier writes are reported by subsequent
+ *  calls or by flog_writer_flush().
+ *
+ *  \param writer A pointer to the FlogWriter object
+ *  \param buf    A pointer to the data to append
+ *  \param len    The number of bytes to append
+ *
+ *  \pre \c writer is \e not \c NULL
+ *  \pre \c buf is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, otherwise
+ *          FLOG_ERROR_APPEND
+ */
+FlogError flog_writer_write(FlogWriter *writer, const char *buf, size_t len);
+
+/*! \brief Append data gathered from multiple buffers to the file associated with a
+ *         FlogWriter object.
+ *
+ *  The buffers are appended as a single unit; see flog_writer_write().
+ *
+ *  \param writer A pointer to the FlogWriter object
+ *  \param iov    A pointer to an array of buffers to append
+ *  \param count  The number of elements in the \c iov array
+ *
+ *  \pre \c writer is \e not \c NULL
+ *  \pre \c iov is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, otherwise
+ *          FLOG_ERROR_APPEND
+ */
+FlogError flog_writer_writev(FlogWriter *writer, const struct iovec *iov, int count);
+
+/*! \brief Wait for all data appended with a FlogWriter object to be written.
+ *
+ *  \param writer A pointer to the FlogWriter object
+ *
+ *  \pre \c writer is \e not \c NULL
+ *
+ *  \return If successful, the FlogError variant FLOG_ERROR_NONE, otherwise
+ *          FLOG_ERROR_APPEND
+ */
+FlogError flog_writer_flush(FlogWriter *writer);
+
+#endif //FLOG_WRITER_H
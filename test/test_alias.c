@@ -0,0 +1,329 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdbool.h>
+#include <ftw.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <popt.h>
+#include "alias.h"
+
+#define TEST_APP_NAME "uk.co.fidgetbox.test"
+#define TEST_DIR_TEMPLATE "/tmp/flog.XXXXXXXX"
+#define TEST_DIR_LEN 32
+#define TEST_PATH_LEN 256
+
+#define TEST_ALIAS_FAIL TEST_APP_NAME " alias --fail -l fault -s uk.co.fidgetbox.server\n"
+#define TEST_ALIAS_QUIET TEST_APP_NAME " alias -q -l debug\n"
+
+#define UNUSED(x) (void)(x)
+
+typedef struct TestPathsData {
+    char dir[TEST_DIR_LEN];
+    char source[TEST_PATH_LEN];
+    char cache[TEST_PATH_LEN];
+} TestPaths;
+
+static struct poptOption options[] = {
+    { "level",      'l',  POPT_ARG_STRING,  NULL,  'l',  NULL,  NULL },
+    { "subsystem",  's',  POPT_ARG_STRING,  NULL,  's',  NULL,  NULL },
+    POPT_TABLEEND
+};
+
+static int
+create_alias_paths(void **state) {
+    TestPaths *paths = calloc(1, sizeof(TestPaths));
+    if (paths == NULL) {
+        return 1;
+    }
+
+    strcpy(paths->dir, TEST_DIR_TEMPLATE);
+    if (mkdtemp(paths->dir) == NULL) {
+        free(paths);
+        return 1;
+    }
+
+    snprintf(paths->source, TEST_PATH_LEN, "%s/popt", paths->dir);
+    snprintf(paths->cache, TEST_PATH_LEN, "%s/cache/flog/" TEST_APP_NAME ".aliases", paths->dir);
+    *state = paths;
+
+    return 0;
+}
+
+static int
+remove_entry(const char *path, const struct stat *statbuf, int type, struct FTW *ftw) {
+    UNUSED(statbuf);
+    UNUSED(type);
+    UNUSED(ftw);
+
+    return remove(path);
+}
+
+static int
+remove_alias_paths(void **state) {
+    TestPaths *paths = *state;
+
+    nftw(paths->dir, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+    free(paths);
+
+    return 0;
+}
+
+static void
+write_file(const char *path, const char *content) {
+    FILE *file = fopen(path, "w");
+    assert_non_null(file);
+    fputs(content, file);
+    fclose(file);
+}
+
+// Read aliases into a new context for an argument list and return the first parsed
+// option and its argument
+static FlogAliasStatus
+read_aliases(const TestPaths *paths, const char *cache, const char *arg, int *option, char **option_argument) {
+    const char *argv[] = { "test", arg, NULL };
+    const char *sources[] = { paths->source };
+
+    poptContext context = poptGetContext(TEST_APP_NAME, 2, argv, options, 0);
+    FlogAliasStatus status = flog_alias_read(context, TEST_APP_NAME, sources, 1, cache);
+
+    *option = poptGetNextOpt(context);
+    *option_argument = poptGetOptArg(context);
+
+    poptFreeContext(context);
+
+    return status;
+}
+
+static void
+flog_alias_read_with_null_context_arg_fails(void **state) {
+    UNUSED(state);
+
+    const char *sources[] = { "/dev/null" };
+    expect_assert_failure(flog_alias_read(NULL, TEST_APP_NAME, sources, 1, NULL));
+}
+
+static void
+flog_alias_read_with_null_sources_arg_fails(void **state) {
+    UNUSED(state);
+
+    const char *argv[] = { "test", NULL };
+    poptContext context = poptGetContext(TEST_APP_NAME, 1, argv, options, 0);
+
+    expect_assert_failure(flog_alias_read(context, TEST_APP_NAME, NULL, 0, NULL));
+
+    poptFreeContext(context);
+}
+
+static void
+flog_alias_read_builds_and_loads_cache(void **state) {
+    TestPaths *paths = *state;
+    write_file(paths->source, TEST_ALIAS_FAIL);
+
+    int option;
+    char *option_argument;
+
+    assert_int_equal(read_aliases(paths, paths->cache, "--fail", &option, &option_argument), ALIAS_CACHE_MISS);
+    assert_int_equal(option, 'l');
+    assert_string_equal(option_argument, "fault");
+    free(option_argument);
+
+    struct stat statbuf;
+    assert_int_equal(stat(paths->cache, &statbuf), 0);
+    assert_int_equal(statbuf.st_mode & 0777, 0600);
+
+    assert_int_equal(read_aliases(paths, paths->cache, "--fail", &option, &option_argument), ALIAS_CACHE_HIT);
+    assert_int_equal(option, 'l');
+    assert_string_equal(option_argument, "fault");
+    free(option_argument);
+}
+
+static void
+flog_alias_read_short_alias_succeeds(void **state) {
+    TestPaths *paths = *state;
+    write_file(paths->source, TEST_ALIAS_FAIL TEST_ALIAS_QUIET);
+
+    int option;
+    char *option_argument;
+
+    assert_int_equal(read_aliases(paths, paths->cache, "-q", &option, &option_argument), ALIAS_CACHE_MISS);
+    assert_int_equal(option, 'l');
+    assert_string_equal(option_argument, "debug");
+    free(option_argument);
+
+    assert_int_equal(read_aliases(paths, paths->cache, "-q", &option, &option_argument), ALIAS_CACHE_HIT);
+    assert_int_equal(option, 'l');
+    assert_string_equal(option_argument, "debug");
+    free(option_argument);
+}
+
+static void
+flog_alias_read_with_modified_source_rebuilds_cache(void **state) {
+    TestPaths *paths = *state;
+    write_file(paths->source, TEST_ALIAS_FAIL);
+
+    int option;
+    char *option_argument;
+
+    assert_int_equal(read_aliases(paths, paths->cache, "--fail", &option, &option_argument), ALIAS_CACHE_MISS);
+    free(option_argument);
+
+    write_file(paths->source, TEST_APP_NAME " alias --fail -l error\n");
+
+    assert_int_equal(read_aliases(paths, paths->cache, "--fail", &option, &option_argument), ALIAS_CACHE_MISS);
+    assert_int_equal(option, 'l');
+    assert_string_equal(option_argument, "error");
+    free(option_argument);
+
+    unlink(paths->source);
+
+    assert_int_equal(read_aliases(paths, paths->cache, "--fail", &option, &option_argument), ALIAS_CACHE_MISS);
+    assert_int_equal(option, POPT_ERROR_BADOPT);
+    assert_int_equal(read_aliases(paths, paths->cache, "--fail", &option, &option_argument), ALIAS_CACHE_HIT);
+}
+
+static void
+flog_alias_read_with_corrupt_cache_rebuilds_cache(void **state) {
+    TestPaths *paths = *state;
+    write_file(paths->source, TEST_ALIAS_FAIL);
+
+    int option;
+    char *option_argument;
+
+    assert_int_equal(read_aliases(paths, paths->cache, "--fail", &option, &option_argument), ALIAS_CACHE_MISS);
+    free(option_argument);
+
+    struct stat statbuf;
+    assert_int_equal(stat(paths->cache, &statbuf), 0);
+    assert_int_equal(truncate(paths->cache, statbuf.st_size - 8), 0);
+
+    assert_int_equal(read_aliases(paths, paths->cache, "--fail", &option, &option_argument), ALIAS_CACHE_MISS);
+    assert_string_equal(option_argument, "fault");
+    free(option_argument);
+
+    write_file(paths->cache, "FLOGALS garbage that is long enough to hold a header");
+    chmod(paths->cache, 0600);
+
+    assert_int_equal(read_aliases(paths, paths->cache, "--fail", &option, &option_argument), ALIAS_CACHE_MISS);
+    assert_string_equal(option_argument, "fault");
+    free(option_argument);
+
+    assert_int_equal(read_aliases(paths, paths->cache, "--fail", &option, &option_argument), ALIAS_CACHE_HIT);
+    free(option_argument);
+}
+
+static void
+flog_alias_read_with_exec_entry_is_uncached(void **state) {
+    TestPaths *paths = *state;
+    write_file(paths->source, TEST_ALIAS_FAIL TEST_APP_NAME " exec --run /bin/true\n");
+
+    int option;
+    char *option_argument;
+
+    assert_int_equal(read_aliases(paths, paths->cache, "--fail", &option, &option_argument), ALIAS_UNCACHED);
+    assert_int_equal(option, 'l');
+    free(option_argument);
+
+    struct stat statbuf;
+    assert_int_not_equal(stat(paths->cache, &statbuf), 0);
+}
+
+static void
+flog_alias_read_selects_application_entries(void **state) {
+    TestPaths *paths = *state;
+    write_file(paths->source,
+        "# comment\n"
+        "\n"
+        "other.app alias --fail -l info\n"
+        "uk.co.fidgetbox.* alias --glob -s \\\n"
+        "    uk.co.fidgetbox.glob\n"
+        TEST_APP_NAME " alias --fail -l fault --POPTdesc=$\"Log a failure\"\n");
+
+    int option;
+    char *option_argument;
+
+    assert_int_equal(read_aliases(paths, paths->cache, "--fail", &option, &option_argument), ALIAS_CACHE_MISS);
+    assert_int_equal(option, 'l');
+    assert_string_equal(option_argument, "fault");
+    free(option_argument);
+
+    assert_int_equal(read_aliases(paths, paths->cache, "--glob", &option, &option_argument), ALIAS_CACHE_HIT);
+    assert_int_equal(option, 's');
+    assert_string_equal(option_argument, "uk.co.fidgetbox.glob");
+    free(option_argument);
+
+    // The description is not passed on as an option
+    const char *argv[] = { "test", "--fail", NULL };
+    const char *sources[] = { paths->source };
+    poptContext context = poptGetContext(TEST_APP_NAME, 2, argv, options, 0);
+    assert_int_equal(flog_alias_read(context, TEST_APP_NAME, sources, 1, paths->cache), ALIAS_CACHE_HIT);
+    assert_int_equal(poptGetNextOpt(context), 'l');
+    assert_int_equal(poptGetNextOpt(context), -1);
+    poptFreeContext(context);
+}
+
+static void
+flog_alias_read_without_cache_succeeds(void **state) {
+    TestPaths *paths = *state;
+    write_file(paths->source, TEST_ALIAS_FAIL);
+
+    int option;
+    char *option_argument;
+
+    assert_int_equal(read_aliases(paths, NULL, "--fail", &option, &option_argument), ALIAS_CACHE_MISS);
+    assert_string_equal(option_argument, "fault");
+    free(option_argument);
+
+    assert_int_equal(read_aliases(paths, NULL, "--fail", &option, &option_argument), ALIAS_CACHE_MISS);
+    assert_string_equal(option_argument, "fault");
+    free(option_argument);
+}
+
+int main(void) {
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+
+    const struct CMUnitTest tests[] = {
+        // flog_alias_read() precondition tests
+        cmocka_unit_test(flog_alias_read_with_null_context_arg_fails),
+        cmocka_unit_test(flog_alias_read_with_null_sources_arg_fails),
+
+        // flog_alias_read() cache tests
+        cmocka_unit_test_setup_teardown(flog_alias_read_builds_and_loads_cache, create_alias_paths, remove_alias_paths),
+        cmocka_unit_test_setup_teardown(flog_alias_read_short_alias_succeeds, create_alias_paths, remove_alias_paths),
+        cmocka_unit_test_setup_teardown(flog_alias_read_with_modified_source_rebuilds_cache, create_alias_paths, remove_alias_paths),
+        cmocka_unit_test_setup_teardown(flog_alias_read_with_corrupt_cache_rebuilds_cache, create_alias_paths, remove_alias_paths),
+        cmocka_unit_test_setup_teardown(flog_alias_read_with_exec_entry_is_uncached, create_alias_paths, remove_alias_paths),
+        cmocka_unit_test_setup_teardown(flog_alias_read_selects_application_entries, create_alias_paths, remove_alias_paths),
+        cmocka_unit_test_setup_teardown(flog_alias_read_without_cache_succeeds, create_alias_paths, remove_alias_paths),
+    };
+
+    return cmocka_run_group_tests_name("FlogAlias tests", tests, NULL, NULL);
+}
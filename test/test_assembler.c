@@ -0,0 +1,261 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdbool.h>
+#include "assembler.h"
+#include "common.h"
+
+#define TEST_MAX_LEN 64
+#define TEST_START_PATTERN "^[0-9]{4}-[0-9]{2}-[0-9]{2} "
+#define TEST_FIRST_LINE "Exception in thread \"main\" java.lang.IllegalStateException"
+#define TEST_CONTINUATION_LINE "\tat com.example.App.main(App.java:42)"
+
+#define UNUSED(x) (void)(x)
+
+extern bool fail_calloc;
+
+static int
+enable_calloc_failure(void **state) {
+    UNUSED(state);
+    fail_calloc = true;
+    return 0;
+}
+
+static int
+disable_calloc_failure(void **state) {
+    UNUSED(state);
+    fail_calloc = false;
+    return 0;
+}
+
+static void
+flog_assembler_new_with_null_start_pattern_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    expect_assert_failure(flog_assembler_new(NULL, TEST_MAX_LEN, &error));
+}
+
+static void
+flog_assembler_new_with_zero_max_len_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    expect_assert_failure(flog_assembler_new("", 0, &error));
+}
+
+static void
+flog_assembler_new_with_null_error_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_assembler_new("", TEST_MAX_LEN, NULL));
+}
+
+static void
+flog_assembler_new_with_calloc_failure_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogAssembler *assembler = flog_assembler_new("", TEST_MAX_LEN, &error);
+
+    assert_null(assembler);
+    assert_int_equal(error, FLOG_ERROR_ALLOC);
+}
+
+static void
+flog_assembler_new_with_invalid_pattern_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogAssembler *assembler = flog_assembler_new("[0-9", TEST_MAX_LEN, &error);
+
+    assert_null(assembler);
+    assert_int_equal(error, FLOG_ERROR_RECORD);
+}
+
+static void
+flog_assembler_new_with_backreference_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogAssembler *assembler = flog_assembler_new("^(a+)\\1", TEST_MAX_LEN, &error);
+
+    assert_null(assembler);
+    assert_int_equal(error, FLOG_ERROR_RECORD);
+}
+
+static void
+flog_assembler_free_with_null_assembler_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_assembler_free(NULL));
+}
+
+static void
+flog_assembler_new_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_ALLOC;
+    FlogAssembler *assembler = flog_assembler_new(TEST_START_PATTERN, TEST_MAX_LEN, &error);
+
+    assert_non_null(assembler);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_string_equal(flog_assembler_get_record(assembler), "");
+    assert_int_equal(flog_assembler_get_length(assembler), 0);
+
+    flog_assembler_free(assembler);
+}
+
+static bool
+is_accepted_pattern(const char *pattern) {
+    FlogError error = FLOG_ERROR_NONE;
+    FlogAssembler *assembler = flog_assembler_new(pattern, TEST_MAX_LEN, &error);
+    if (assembler == NULL) {
+        return false;
+    }
+
+    flog_assembler_free(assembler);
+
+    return true;
+}
+
+static void
+flog_assembler_new_with_bracket_backslash_succeeds(void **state) {
+    UNUSED(state);
+
+    assert_true(is_accepted_pattern("^\\\\1"));
+
+    // A backslash in a bracket expression is a literal, not the start of a backreference
+    assert_true(is_accepted_pattern("^[\\1]"));
+    assert_true(is_accepted_pattern("^[]\\1]"));
+    assert_true(is_accepted_pattern("^[[:digit:]\\1]"));
+
+    assert_false(is_accepted_pattern("[a](b)\\2"));
+}
+
+static void
+flog_assembler_starts_record_with_indentation_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogAssembler *assembler = flog_assembler_new("", TEST_MAX_LEN, &error);
+    assert_non_null(assembler);
+
+    assert_true(flog_assembler_starts_record(assembler, TEST_FIRST_LINE));
+    assert_false(flog_assembler_starts_record(assembler, TEST_CONTINUATION_LINE));
+    assert_false(flog_assembler_starts_record(assembler, "  File \"app.py\", line 1"));
+
+    flog_assembler_free(assembler);
+}
+
+static void
+flog_assembler_starts_record_with_pattern_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogAssembler *assembler = flog_assembler_new(TEST_START_PATTERN, TEST_MAX_LEN, &error);
+    assert_non_null(assembler);
+
+    assert_true(flog_assembler_starts_record(assembler, "2026-10-19 09:00:00 ERROR request failed"));
+    assert_false(flog_assembler_starts_record(assembler, TEST_FIRST_LINE));
+    assert_false(flog_assembler_starts_record(assembler, "Caused by: 2026-10-19 "));
+
+    flog_assembler_free(assembler);
+}
+
+static void
+flog_assembler_add_line_joins_lines(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogAssembler *assembler = flog_assembler_new("", TEST_MAX_LEN, &error);
+    assert_non_null(assembler);
+
+    assert_int_equal(flog_assembler_add_line(assembler, "first", 5), 5);
+    assert_int_equal(flog_assembler_add_line(assembler, "  second", 8), 8);
+
+    assert_string_equal(flog_assembler_get_record(assembler), "first\n  second");
+    assert_int_equal(flog_assembler_get_length(assembler), 14);
+
+    flog_assembler_clear(assembler);
+
+    assert_string_equal(flog_assembler_get_record(assembler), "");
+    assert_int_equal(flog_assembler_get_length(assembler), 0);
+
+    flog_assembler_free(assembler);
+}
+
+static void
+flog_assembler_add_line_stops_at_max_len(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogAssembler *assembler = flog_assembler_new("", 8, &error);
+    assert_non_null(assembler);
+
+    assert_int_equal(flog_assembler_add_line(assembler, "abcde", 5), 5);
+
+    // Only part of a line fits after the newline joining it to the record
+    assert_int_equal(flog_assembler_add_line(assembler, "fghij", 5), 2);
+    assert_string_equal(flog_assembler_get_record(assembler), "abcde\nfg");
+
+    // Nothing more is added to a full record, but a line is always added to an empty one
+    assert_int_equal(flog_assembler_add_line(assembler, "hij", 3), 0);
+
+    flog_assembler_clear(assembler);
+    assert_int_equal(flog_assembler_add_line(assembler, "klmnopqrst", 10), 8);
+    assert_string_equal(flog_assembler_get_record(assembler), "klmnopqr");
+
+    flog_assembler_free(assembler);
+}
+
+int main(void) {
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+
+    const struct CMUnitTest tests[] = {
+        // flog_assembler_new() and flog_assembler_free() failure tests
+        cmocka_unit_test(flog_assembler_new_with_null_start_pattern_arg_fails),
+        cmocka_unit_test(flog_assembler_new_with_zero_max_len_arg_fails),
+        cmocka_unit_test(flog_assembler_new_with_null_error_arg_fails),
+        cmocka_unit_test_setup_teardown(flog_assembler_new_with_calloc_failure_fails, enable_calloc_failure, disable_calloc_failure),
+        cmocka_unit_test(flog_assembler_new_with_invalid_pattern_fails),
+        cmocka_unit_test(flog_assembler_new_with_backreference_fails),
+        cmocka_unit_test(flog_assembler_free_with_null_assembler_arg_fails),
+
+        // flog_assembler_new() success tests
+        cmocka_unit_test(flog_assembler_new_succeeds),
+        cmocka_unit_test(flog_assembler_new_with_bracket_backslash_succeeds),
+
+        // flog_assembler_starts_record() and flog_assembler_add_line() tests
+        cmocka_unit_test(flog_assembler_starts_record_with_indentation_succeeds),
+        cmocka_unit_test(flog_assembler_starts_record_with_pattern_succeeds),
+        cmocka_unit_test(flog_assembler_add_line_joins_lines),
+        cmocka_unit_test(flog_assembler_add_line_stops_at_max_len),
+    };
+
+    return cmocka_run_group_tests_name("FlogAssembler tests", tests, NULL, NULL);
+}
@@ -0,0 +1,491 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "binlog.h"
+#include "common.h"
+
+#define TEST_MESSAGE "test message"
+#define TEST_SUBSYSTEM "subsystem"
+#define TEST_CATEGORY "category"
+#define TEST_PATH_TEMPLATE "/tmp/flog.XXXXXXXX"
+#define TEST_PATH_LEN 32
+#define TEST_RECORD_COUNT (BINLOG_INDEX_INTERVAL * 4 + 10)
+#define TEST_TIMESTAMP_BASE 1000000000000ULL
+
+#define UNUSED(x) (void)(x)
+
+typedef struct TestVisitData {
+    size_t count;
+    uint64_t first_timestamp;
+    uint64_t last_timestamp;
+    unsigned int levels;
+    bool strings_match;
+    bool messages_match;
+    size_t stop_after;
+} TestVisit;
+
+static int
+create_binlog_path(void **state) {
+    char *path = malloc(TEST_PATH_LEN);
+    if (path == NULL) {
+        return 1;
+    }
+
+    strcpy(path, TEST_PATH_TEMPLATE);
+
+    int fd = mkstemp(path);
+    if (fd == -1) {
+        free(path);
+        return 1;
+    }
+
+    // flog_binlog_append() creates the file on first use so start without one
+    close(fd);
+    unlink(path);
+
+    *state = path;
+
+    return 0;
+}
+
+static int
+remove_binlog_path(void **state) {
+    unlink(*state);
+    free(*state);
+
+    return 0;
+}
+
+static bool
+test_visitor(const FlogBinlogRecord *record, void *context) {
+    TestVisit *visit = context;
+
+    if (visit->count == 0) {
+        visit->first_timestamp = record->timestamp;
+    }
+    visit->last_timestamp = record->timestamp;
+    visit->levels |= 1U << record->level;
+
+    if (strcmp(record->subsystem, TEST_SUBSYSTEM) != 0 || strcmp(record->category, TEST_CATEGORY) != 0) {
+        visit->strings_match = false;
+    }
+    if (record->message_len != strlen(TEST_MESSAGE) ||
+        memcmp(record->message, TEST_MESSAGE, record->message_len) != 0) {
+        visit->messages_match = false;
+    }
+
+    visit->count++;
+
+    return visit->stop_after == 0 || visit->count < visit->stop_after;
+}
+
+static void
+append_test_records(const char *path, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        FlogBinlogRecord record = {
+            .timestamp = TEST_TIMESTAMP_BASE + i,
+            .level = i % 2 == 0 ? LVL_INFO : LVL_ERROR,
+            .message_type = MSG_PUBLIC,
+            .subsystem = TEST_SUBSYSTEM,
+            .category = TEST_CATEGORY,
+            .message = TEST_MESSAGE,
+            .message_len = strlen(TEST_MESSAGE)
+        };
+
+        assert_int_equal(flog_binlog_append(path, &record), FLOG_ERROR_NONE);
+    }
+}
+
+static bool
+test_string_visitor(const FlogBinlogRecord *record, void *context) {
+    TestVisit *visit = context;
+
+    // Each message names the subsystem and category it was appended with
+    char expected[64];
+    snprintf(expected, sizeof(expected), "%s/%s", record->subsystem, record->category);
+    if (record->message_len != strlen(expected) || memcmp(record->message, expected, record->message_len) != 0) {
+        visit->strings_match = false;
+    }
+
+    visit->count++;
+
+    return true;
+}
+
+static void
+append_string_record(FlogBinlogWriter *writer, const char *subsystem, const char *category) {
+    char message[64];
+    snprintf(message, sizeof(message), "%s/%s", subsystem, category);
+
+    FlogBinlogRecord record = {
+        .timestamp = TEST_TIMESTAMP_BASE,
+        .level = LVL_INFO,
+        .message_type = MSG_PUBLIC,
+        .subsystem = subsystem,
+        .category = category,
+        .message = message,
+        .message_len = strlen(message)
+    };
+
+    assert_int_equal(flog_binlog_writer_append(writer, &record), FLOG_ERROR_NONE);
+}
+
+static void
+assert_string_records(const char *path, size_t count) {
+    FlogError error = FLOG_ERROR_NONE;
+    FlogBinlogReader *reader = flog_binlog_reader_new(path, &error);
+    assert_non_null(reader);
+
+    TestVisit visit = { .strings_match = true };
+    FlogBinlogQuery query = { .since = 0, .until = UINT64_MAX, .level_mask = 0 };
+
+    assert_int_equal(flog_binlog_reader_query(reader, &query, test_string_visitor, &visit), FLOG_ERROR_NONE);
+    assert_int_equal(visit.count, count);
+    assert_true(visit.strings_match);
+
+    flog_binlog_reader_free(reader);
+}
+
+static void
+flog_binlog_append_with_null_path_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogBinlogRecord record = {0};
+
+    expect_assert_failure(flog_binlog_append(NULL, &record));
+}
+
+static void
+flog_binlog_append_with_null_record_arg_fails(void **state) {
+    expect_assert_failure(flog_binlog_append(*state, NULL));
+}
+
+static void
+flog_binlog_reader_new_with_null_path_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error;
+
+    expect_assert_failure(flog_binlog_reader_new(NULL, &error));
+}
+
+static void
+flog_binlog_reader_new_with_null_error_arg_fails(void **state) {
+    expect_assert_failure(flog_binlog_reader_new(*state, NULL));
+}
+
+static void
+flog_binlog_reader_free_with_null_reader_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_binlog_reader_free(NULL));
+}
+
+static void
+flog_binlog_reader_new_with_missing_file_fails(void **state) {
+    FlogError error = FLOG_ERROR_NONE;
+
+    FlogBinlogReader *reader = flog_binlog_reader_new(*state, &error);
+
+    assert_null(reader);
+    assert_int_equal(error, FLOG_ERROR_READ);
+}
+
+static void
+flog_binlog_reader_new_with_text_file_fails(void **state) {
+    FILE *file = fopen(*state, "w");
+    assert_non_null(file);
+    for (int i = 0; i < 16; i++) {
+        fprintf(file, "%s\n", TEST_MESSAGE);
+    }
+    fclose(file);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogBinlogReader *reader = flog_binlog_reader_new(*state, &error);
+
+    assert_null(reader);
+    assert_int_equal(error, FLOG_ERROR_READ);
+}
+
+static void
+flog_binlog_append_to_text_file_fails(void **state) {
+    FILE *file = fopen(*state, "w");
+    assert_non_null(file);
+    for (int i = 0; i < 16; i++) {
+        fprintf(file, "%s\n", TEST_MESSAGE);
+    }
+    fclose(file);
+
+    FlogBinlogRecord record = {
+        .subsystem = "",
+        .category = "",
+        .message = TEST_MESSAGE,
+        .message_len = strlen(TEST_MESSAGE)
+    };
+
+    assert_int_equal(flog_binlog_append(*state, &record), FLOG_ERROR_APPEND);
+}
+
+static void
+flog_binlog_append_and_read_succeeds(void **state) {
+    append_test_records(*state, TEST_RECORD_COUNT);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogBinlogReader *reader = flog_binlog_reader_new(*state, &error);
+
+    assert_non_null(reader);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_binlog_reader_get_record_count(reader), TEST_RECORD_COUNT);
+
+    TestVisit visit = { .strings_match = true, .messages_match = true };
+    FlogBinlogQuery query = { .since = 0, .until = UINT64_MAX, .level_mask = 0 };
+
+    assert_int_equal(flog_binlog_reader_query(reader, &query, test_visitor, &visit), FLOG_ERROR_NONE);
+    assert_int_equal(visit.count, TEST_RECORD_COUNT);
+    assert_int_equal(visit.first_timestamp, TEST_TIMESTAMP_BASE);
+    assert_int_equal(visit.last_timestamp, TEST_TIMESTAMP_BASE + TEST_RECORD_COUNT - 1);
+    assert_int_equal(visit.levels, (1U << LVL_INFO) | (1U << LVL_ERROR));
+    assert_true(visit.strings_match);
+    assert_true(visit.messages_match);
+
+    flog_binlog_reader_free(reader);
+}
+
+static void
+flog_binlog_query_with_time_range_succeeds(void **state) {
+    append_test_records(*state, TEST_RECORD_COUNT);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogBinlogReader *reader = flog_binlog_reader_new(*state, &error);
+    assert_non_null(reader);
+
+    // A range spanning an index boundary and part of the unindexed tail
+    TestVisit visit = { .strings_match = true, .messages_match = true };
+    FlogBinlogQuery query = {
+        .since = TEST_TIMESTAMP_BASE + BINLOG_INDEX_INTERVAL - 5,
+        .until = TEST_TIMESTAMP_BASE + BINLOG_INDEX_INTERVAL + 5,
+        .level_mask = 0
+    };
+
+    assert_int_equal(flog_binlog_reader_query(reader, &query, test_visitor, &visit), FLOG_ERROR_NONE);
+    assert_int_equal(visit.count, 11);
+    assert_int_equal(visit.first_timestamp, query.since);
+    assert_int_equal(visit.last_timestamp, query.until);
+
+    TestVisit tail_visit = { .strings_match = true, .messages_match = true };
+    FlogBinlogQuery tail_query = {
+        .since = TEST_TIMESTAMP_BASE + TEST_RECORD_COUNT - 3,
+        .until = UINT64_MAX,
+        .level_mask = 0
+    };
+
+    assert_int_equal(flog_binlog_reader_query(reader, &tail_query, test_visitor, &tail_visit), FLOG_ERROR_NONE);
+    assert_int_equal(tail_visit.count, 3);
+
+    flog_binlog_reader_free(reader);
+}
+
+static void
+flog_binlog_query_with_level_mask_succeeds(void **state) {
+    append_test_records(*state, TEST_RECORD_COUNT);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogBinlogReader *reader = flog_binlog_reader_new(*state, &error);
+    assert_non_null(reader);
+
+    TestVisit visit = { .strings_match = true, .messages_match = true };
+    FlogBinlogQuery query = { .since = 0, .until = UINT64_MAX, .level_mask = 1U << LVL_ERROR };
+
+    assert_int_equal(flog_binlog_reader_query(reader, &query, test_visitor, &visit), FLOG_ERROR_NONE);
+    assert_int_equal(visit.count, TEST_RECORD_COUNT / 2);
+    assert_int_equal(visit.levels, 1U << LVL_ERROR);
+
+    TestVisit fault_visit = { .strings_match = true, .messages_match = true };
+    FlogBinlogQuery fault_query = { .since = 0, .until = UINT64_MAX, .level_mask = 1U << LVL_FAULT };
+
+    assert_int_equal(flog_binlog_reader_query(reader, &fault_query, test_visitor, &fault_visit), FLOG_ERROR_NONE);
+    assert_int_equal(fault_visit.count, 0);
+
+    flog_binlog_reader_free(reader);
+}
+
+static void
+flog_binlog_query_stops_when_visitor_returns_false(void **state) {
+    append_test_records(*state, TEST_RECORD_COUNT);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogBinlogReader *reader = flog_binlog_reader_new(*state, &error);
+    assert_non_null(reader);
+
+    TestVisit visit = { .strings_match = true, .messages_match = true, .stop_after = 3 };
+    FlogBinlogQuery query = { .since = 0, .until = UINT64_MAX, .level_mask = 0 };
+
+    assert_int_equal(flog_binlog_reader_query(reader, &query, test_visitor, &visit), FLOG_ERROR_NONE);
+    assert_int_equal(visit.count, 3);
+
+    flog_binlog_reader_free(reader);
+}
+
+static void
+flog_binlog_append_without_subsystem_succeeds(void **state) {
+    FlogBinlogRecord record = {
+        .timestamp = TEST_TIMESTAMP_BASE,
+        .level = LVL_DEFAULT,
+        .message_type = MSG_PRIVATE,
+        .subsystem = "",
+        .category = "",
+        .message = TEST_MESSAGE,
+        .message_len = strlen(TEST_MESSAGE)
+    };
+
+    assert_int_equal(flog_binlog_append(*state, &record), FLOG_ERROR_NONE);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogBinlogReader *reader = flog_binlog_reader_new(*state, &error);
+    assert_non_null(reader);
+
+    TestVisit visit = { .strings_match = true, .messages_match = true };
+    FlogBinlogQuery query = { .since = 0, .until = UINT64_MAX, .level_mask = 0 };
+
+    assert_int_equal(flog_binlog_reader_query(reader, &query, test_visitor, &visit), FLOG_ERROR_NONE);
+    assert_int_equal(visit.count, 1);
+    assert_false(visit.strings_match);
+    assert_true(visit.messages_match);
+
+    flog_binlog_reader_free(reader);
+}
+
+static void
+flog_binlog_writer_new_with_null_path_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    expect_assert_failure(flog_binlog_writer_new(NULL, &error));
+}
+
+static void
+flog_binlog_writer_new_with_null_error_arg_fails(void **state) {
+    expect_assert_failure(flog_binlog_writer_new(*state, NULL));
+}
+
+static void
+flog_binlog_writer_free_with_null_writer_arg_fails(void **state) {
+    UNUSED(state);
+
+    expect_assert_failure(flog_binlog_writer_free(NULL));
+}
+
+static void
+flog_binlog_writer_append_with_null_record_arg_fails(void **state) {
+    FlogError error = FLOG_ERROR_NONE;
+    FlogBinlogWriter *writer = flog_binlog_writer_new(*state, &error);
+    assert_non_null(writer);
+
+    expect_assert_failure(flog_binlog_writer_append(writer, NULL));
+
+    flog_binlog_writer_free(writer);
+}
+
+static void
+flog_binlog_writer_append_resolves_strings_of_other_writers(void **state) {
+    FlogError error = FLOG_ERROR_NONE;
+    FlogBinlogWriter *writer = flog_binlog_writer_new(*state, &error);
+    FlogBinlogWriter *other = flog_binlog_writer_new(*state, &error);
+    assert_non_null(writer);
+    assert_non_null(other);
+
+    // Strings interned by one writer must be found, not interned again, by the other
+    append_string_record(writer, "api", "db");
+    append_string_record(other, "web", "db");
+    append_string_record(writer, "web", "cache");
+    append_string_record(other, "api", "cache");
+    append_string_record(writer, "api", "db");
+
+    flog_binlog_writer_free(writer);
+    flog_binlog_writer_free(other);
+
+    assert_string_records(*state, 5);
+}
+
+static void
+flog_binlog_writer_append_to_truncated_file_succeeds(void **state) {
+    FlogError error = FLOG_ERROR_NONE;
+    FlogBinlogWriter *writer = flog_binlog_writer_new(*state, &error);
+    assert_non_null(writer);
+
+    append_string_record(writer, "api", "db");
+    append_string_record(writer, "web", "cache");
+    assert_int_equal(truncate(*state, 0), 0);
+
+    // The strings held by the writer no longer exist in the file
+    append_string_record(writer, "web", "db");
+    append_string_record(writer, "api", "cache");
+
+    flog_binlog_writer_free(writer);
+
+    assert_string_records(*state, 2);
+}
+
+int main(void) {
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+
+    const struct CMUnitTest tests[] = {
+        // flog_binlog_append() precondition tests
+        cmocka_unit_test(flog_binlog_append_with_null_path_arg_fails),
+        cmocka_unit_test_setup_teardown(flog_binlog_append_with_null_record_arg_fails, create_binlog_path, remove_binlog_path),
+
+        // flog_binlog_reader_new() and flog_binlog_reader_free() precondition tests
+        cmocka_unit_test(flog_binlog_reader_new_with_null_path_arg_fails),
+        cmocka_unit_test_setup_teardown(flog_binlog_reader_new_with_null_error_arg_fails, create_binlog_path, remove_binlog_path),
+        cmocka_unit_test(flog_binlog_reader_free_with_null_reader_arg_fails),
+
+        // flog_binlog_writer_new(), flog_binlog_writer_free() and flog_binlog_writer_append() precondition tests
+        cmocka_unit_test(flog_binlog_writer_new_with_null_path_arg_fails),
+        cmocka_unit_test_setup_teardown(flog_binlog_writer_new_with_null_error_arg_fails, create_binlog_path, remove_binlog_path),
+        cmocka_unit_test(flog_binlog_writer_free_with_null_writer_arg_fails),
+        cmocka_unit_test_setup_teardown(flog_binlog_writer_append_with_null_record_arg_fails, create_binlog_path, remove_binlog_path),
+
+        // flog_binlog_reader_new() and flog_binlog_append() failure tests
+        cmocka_unit_test_setup_teardown(flog_binlog_reader_new_with_missing_file_fails, create_binlog_path, remove_binlog_path),
+        cmocka_unit_test_setup_teardown(flog_binlog_reader_new_with_text_file_fails, create_binlog_path, remove_binlog_path),
+        cmocka_unit_test_setup_teardown(flog_binlog_append_to_text_file_fails, create_binlog_path, remove_binlog_path),
+
+        // flog_binlog_append() and flog_binlog_reader_query() success tests
+        cmocka_unit_test_setup_teardown(flog_binlog_append_and_read_succeeds, create_binlog_path, remove_binlog_path),
+        cmocka_unit_test_setup_teardown(flog_binlog_query_with_time_range_succeeds, create_binlog_path, remove_binlog_path),
+        cmocka_unit_test_setup_teardown(flog_binlog_query_with_level_mask_succeeds, create_binlog_path, remove_binlog_path),
+        cmocka_unit_test_setup_teardown(flog_binlog_query_stops_when_visitor_returns_false, create_binlog_path, remove_binlog_path),
+        cmocka_unit_test_setup_teardown(flog_binlog_append_without_subsystem_succeeds, create_binlog_path, remove_binlog_path),
+        cmocka_unit_test_setup_teardown(flog_binlog_writer_append_resolves_strings_of_other_writers, create_binlog_path, remove_binlog_path),
+        cmocka_unit_test_setup_teardown(flog_binlog_writer_append_to_truncated_file_succeeds, create_binlog_path, remove_binlog_path),
+    };
+
+    return cmocka_run_group_tests_name("FlogBinlog tests", tests, NULL, NULL);
+}
@@ -33,7 +33,7 @@
 #define UNUSED(x) (void)(x)
 
 #define ERROR_STRING_LEN 64
-#define STDOUT_BUFF_SIZE 1024
+#define STDOUT_BUFF_SIZE 4096
 #define STDERR_BUFF_SIZE 1024
 
 static FILE *saved_stdout = NULL;
@@ -107,12 +107,17 @@ static void
 flog_usage_succeeds(void **state) {
     UNUSED(state);
 
-    char expected_string[1024] = {0};
+    char expected_string[STDOUT_BUFF_SIZE] = {0};
     sprintf(expected_string,
         "%s %s\n"
         "\n"
         "Usage:\n"
         "    %s [options] message\n"
+        "    %s [options] --batch <file>\n"
+        "    %s [options] --serve\n"
+        "    %s [options] --exec [--] <command> [args...]\n"
+        "    %s [options] --tee --append <path>\n"
+        "    %s [options] --multiline\n"
         "\n"
         "Help Options:\n"
         "    -h, --help       Show this help message\n"
@@ -122,14 +127,60 @@ flog_usage_succeeds(void **state) {
         "    -s, --subsystem <name>   Specify a subsystem name\n"
         "    -c, --category <name>    Specify a category name (requires subsystem option)\n"
         "    -l, --level <level>      Specify the log level ('default' if not provided)\n"
-        "    -a, --append <path>      Append the log message to a file (creating it if necessary)\n"
+        "    -a, --append <path>      Append the log message to a file (creating it if necessary; may be repeated)\n"
+        "    -f, --format <format>    Specify the append file format ('text' if not provided)\n"
+        "    -w, --writer <writer>    Specify the append file writer ('sync' if not provided)\n"
+        "        --fdatasync          Flush appended messages to storage before exiting\n"
+        "    -k, --checksum           Frame appended text messages with a length and checksum\n"
+        "    -t, --prefix <fields>    Prefix appended text messages with a comma-separated list of fields\n"
+        "        --stats              Print append file cache statistics before exiting\n"
         "    -p, --private            Mark the log message as private\n"
+        "        --batch <file>       Log each line of a file ('-' for stdin) as a message with its own options\n"
+        "        --serve              Log each line of stdin as a request, replying to lines starting with '?'\n"
+        "        --exec               Run a command, logging each line of its stdout, and of its stderr at error level\n"
+        "        --tee                Pass stdin through to the append file unchanged, logging each line\n"
+        "        --splice             As --tee, but move stdin into the file with splice(2) on Linux (not for shared files)\n"
+        "        --multiline          Log each record of stdin, or of --exec or --tee, joining indented lines to the last\n"
+        "        --record-start <re>  Start a record at each line matching an extended regular expression\n"
+        "        --record-max <n>     Split records longer than n bytes (8192 if not provided)\n"
+        "        --record-wait <ms>   Log a pending record after ms milliseconds without input (1000 if not provided)\n"
+        "        --include <re>       Log only records matching a literal or extended regular expression (may be repeated)\n"
+        "        --exclude <re>       Skip records matching a literal or extended regular expression (may be repeated)\n"
+        "        --dedup              Log a count in place of consecutive repeats of a message\n"
+        "        --dedup-wait <ms>    Log the count of repeats ms milliseconds after the first (30000 if not provided)\n"
+        "        --rate-limit <rule>  Limit the rate of messages matching a rule (may be repeated)\n"
+        "        --sample <rates>     Keep a fraction of the messages at each level, such as debug=0.01,info=0.1\n"
+        "        --redact <kinds>     Mask secrets in messages: bearer, aws-key, email, card or all (may be repeated)\n"
+        "        --fields <format>    Take the level, subsystem, category and message from the fields of each message\n"
         "\n"
         "Log Levels:\n"
         "    default, info, debug, error, fault\n"
+        "\n"
+        "Append File Formats:\n"
+        "    text, binary, json\n"
+        "\n"
+        "Message Field Formats:\n"
+        "    logfmt, json\n"
+        "\n"
+        "Append File Writers:\n"
+        "    sync, async (Linux io_uring, falling back to sync if unavailable)\n"
+        "\n"
+        "Append Prefix Fields:\n"
+        "    time, level, pid, subsystem, category\n"
+        "\n"
+        "Append File Path Variables:\n"
+        "    %%{subsystem}, %%{category}, %%{level}\n"
+        "\n"
+        "Rate Limit Rules:\n"
+        "    [[subsystem][:category][@level]=]<n>[/s|/m|/h], or [[subsystem][:category][@level]=]unlimited\n"
         "\n",
         PROGRAM_NAME,
         PROGRAM_VERSION,
+        PROGRAM_NAME,
+        PROGRAM_NAME,
+        PROGRAM_NAME,
+        PROGRAM_NAME,
+        PROGRAM_NAME,
         PROGRAM_NAME
     );
 
@@ -222,6 +273,33 @@ flog_error_string_file_succeeds(void **state) {
     assert_string_equal(msg, "file path too long");
 }
 
+static void
+flog_error_string_fmt_succeeds(void **state) {
+    UNUSED(state);
+
+    const char *msg = flog_error_string(FLOG_ERROR_FMT);
+
+    assert_string_equal(msg, "unknown output format");
+}
+
+static void
+flog_error_string_read_succeeds(void **state) {
+    UNUSED(state);
+
+    const char *msg = flog_error_string(FLOG_ERROR_READ);
+
+    assert_string_equal(msg, "unable to read binary log file");
+}
+
+static void
+flog_error_string_writer_succeeds(void **state) {
+    UNUSED(state);
+
+    const char *msg = flog_error_string(FLOG_ERROR_WRITER);
+
+    assert_string_equal(msg, "unknown append writer");
+}
+
 static void
 flog_print_error_none_succeeds(void **state) {
     UNUSED(state);
@@ -318,6 +396,210 @@ flog_print_error_file_succeeds(void **state) {
     assert_string_equal(*state, expected_string);
 }
 
+static void
+flog_print_error_fmt_succeeds(void **state) {
+    UNUSED(state);
+
+    char expected_string[ERROR_STRING_LEN] = {0};
+    sprintf(expected_string, "%s: unknown output format\n", PROGRAM_NAME);
+
+    flog_print_error(FLOG_ERROR_FMT);
+
+    assert_string_equal(*state, expected_string);
+}
+
+static void
+flog_print_error_read_succeeds(void **state) {
+    UNUSED(state);
+
+    char expected_string[ERROR_STRING_LEN] = {0};
+    sprintf(expected_string, "%s: unable to read binary log file\n", PROGRAM_NAME);
+
+    flog_print_error(FLOG_ERROR_READ);
+
+    assert_string_equal(*state, expected_string);
+}
+
+static void
+flog_error_string_prefix_succeeds(void **state) {
+    UNUSED(state);
+
+    const char *msg = flog_error_string(FLOG_ERROR_PREFIX);
+
+    assert_string_equal(msg, "unknown prefix field");
+}
+
+static void
+flog_error_string_files_succeeds(void **state) {
+    UNUSED(state);
+
+    const char *msg = flog_error_string(FLOG_ERROR_FILES);
+
+    assert_string_equal(msg, "too many append files");
+}
+
+static void
+flog_error_string_template_succeeds(void **state) {
+    UNUSED(state);
+
+    const char *msg = flog_error_string(FLOG_ERROR_TEMPLATE);
+
+    assert_string_equal(msg, "invalid append file path template");
+}
+
+static void
+flog_error_string_batch_succeeds(void **state) {
+    UNUSED(state);
+
+    const char *msg = flog_error_string(FLOG_ERROR_BATCH);
+
+    assert_string_equal(msg, "unable to read batch file");
+}
+
+static void
+flog_error_string_line_succeeds(void **state) {
+    UNUSED(state);
+
+    const char *msg = flog_error_string(FLOG_ERROR_LINE);
+
+    assert_string_equal(msg, "invalid batch file line");
+}
+
+static void
+flog_error_string_exec_succeeds(void **state) {
+    UNUSED(state);
+
+    const char *msg = flog_error_string(FLOG_ERROR_EXEC);
+
+    assert_string_equal(msg, "unable to run command");
+}
+
+static void
+flog_error_string_input_succeeds(void **state) {
+    UNUSED(state);
+
+    const char *msg = flog_error_string(FLOG_ERROR_INPUT);
+
+    assert_string_equal(msg, "unable to read standard input");
+}
+
+static void
+flog_error_string_record_succeeds(void **state) {
+    UNUSED(state);
+
+    const char *msg = flog_error_string(FLOG_ERROR_RECORD);
+
+    assert_string_equal(msg, "invalid record option");
+}
+
+static void
+flog_print_error_writer_succeeds(void **state) {
+    UNUSED(state);
+
+    char expected_string[ERROR_STRING_LEN] = {0};
+    sprintf(expected_string, "%s: unknown append writer\n", PROGRAM_NAME);
+
+    flog_print_error(FLOG_ERROR_WRITER);
+
+    assert_string_equal(*state, expected_string);
+}
+
+static void
+flog_print_error_prefix_succeeds(void **state) {
+    UNUSED(state);
+
+    char expected_string[ERROR_STRING_LEN] = {0};
+    sprintf(expected_string, "%s: unknown prefix field\n", PROGRAM_NAME);
+
+    flog_print_error(FLOG_ERROR_PREFIX);
+
+    assert_string_equal(*state, expected_string);
+}
+
+static void
+flog_print_error_files_succeeds(void **state) {
+    UNUSED(state);
+
+    char expected_string[ERROR_STRING_LEN] = {0};
+    sprintf(expected_string, "%s: too many append files\n", PROGRAM_NAME);
+
+    flog_print_error(FLOG_ERROR_FILES);
+
+    assert_string_equal(*state, expected_string);
+}
+
+static void
+flog_print_error_template_succeeds(void **state) {
+    UNUSED(state);
+
+    char expected_string[ERROR_STRING_LEN] = {0};
+    sprintf(expected_string, "%s: invalid append file path template\n", PROGRAM_NAME);
+
+    flog_print_error(FLOG_ERROR_TEMPLATE);
+
+    assert_string_equal(*state, expected_string);
+}
+
+static void
+flog_print_error_batch_succeeds(void **state) {
+    UNUSED(state);
+
+    char expected_string[ERROR_STRING_LEN] = {0};
+    sprintf(expected_string, "%s: unable to read batch file\n", PROGRAM_NAME);
+
+    flog_print_error(FLOG_ERROR_BATCH);
+
+    assert_string_equal(*state, expected_string);
+}
+
+static void
+flog_print_error_line_succeeds(void **state) {
+    UNUSED(state);
+
+    char expected_string[ERROR_STRING_LEN] = {0};
+    sprintf(expected_string, "%s: invalid batch file line\n", PROGRAM_NAME);
+
+    flog_print_error(FLOG_ERROR_LINE);
+
+    assert_string_equal(*state, expected_string);
+}
+
+static void
+flog_print_error_exec_succeeds(void **state) {
+    UNUSED(state);
+
+    char expected_string[ERROR_STRING_LEN] = {0};
+    sprintf(expected_string, "%s: unable to run command\n", PROGRAM_NAME);
+
+    flog_print_error(FLOG_ERROR_EXEC);
+
+    assert_string_equal(*state, expected_string);
+}
+
+static void
+flog_print_error_input_succeeds(void **state) {
+    UNUSED(state);
+
+    char expected_string[ERROR_STRING_LEN] = {0};
+    sprintf(expected_string, "%s: unable to read standard input\n", PROGRAM_NAME);
+
+    flog_print_error(FLOG_ERROR_INPUT);
+
+    assert_string_equal(*state, expected_string);
+}
+
+static void
+flog_print_error_record_succeeds(void **state) {
+    UNUSED(state);
+
+    char expected_string[ERROR_STRING_LEN] = {0};
+    sprintf(expected_string, "%s: invalid record option\n", PROGRAM_NAME);
+
+    flog_print_error(FLOG_ERROR_RECORD);
+
+    assert_string_equal(*state, expected_string);
+}
+
 int main(void) {
     cmocka_set_message_output(CM_OUTPUT_TAP);
 
@@ -337,6 +619,17 @@ int main(void) {
         cmocka_unit_test(flog_error_string_opts_succeeds),
         cmocka_unit_test(flog_error_string_subsys_succeeds),
         cmocka_unit_test(flog_error_string_file_succeeds),
+        cmocka_unit_test(flog_error_string_fmt_succeeds),
+        cmocka_unit_test(flog_error_string_read_succeeds),
+        cmocka_unit_test(flog_error_string_writer_succeeds),
+        cmocka_unit_test(flog_error_string_prefix_succeeds),
+        cmocka_unit_test(flog_error_string_files_succeeds),
+        cmocka_unit_test(flog_error_string_template_succeeds),
+        cmocka_unit_test(flog_error_string_batch_succeeds),
+        cmocka_unit_test(flog_error_string_line_succeeds),
+        cmocka_unit_test(flog_error_string_exec_succeeds),
+        cmocka_unit_test(flog_error_string_input_succeeds),
+        cmocka_unit_test(flog_error_string_record_succeeds),
 
         // flog_print_error() success tests
         cmocka_unit_test_setup_teardown(flog_print_error_none_succeeds, capture_stderr, restore_stderr),
@@ -347,6 +640,17 @@ int main(void) {
         cmocka_unit_test_setup_teardown(flog_print_error_opts_succeeds, capture_stderr, restore_stderr),
         cmocka_unit_test_setup_teardown(flog_print_error_subsys_succeeds, capture_stderr, restore_stderr),
         cmocka_unit_test_setup_teardown(flog_print_error_file_succeeds, capture_stderr, restore_stderr),
+        cmocka_unit_test_setup_teardown(flog_print_error_fmt_succeeds, capture_stderr, restore_stderr),
+        cmocka_unit_test_setup_teardown(flog_print_error_read_succeeds, capture_stderr, restore_stderr),
+        cmocka_unit_test_setup_teardown(flog_print_error_writer_succeeds, capture_stderr, restore_stderr),
+        cmocka_unit_test_setup_teardown(flog_print_error_prefix_succeeds, capture_stderr, restore_stderr),
+        cmocka_unit_test_setup_teardown(flog_print_error_files_succeeds, capture_stderr, restore_stderr),
+        cmocka_unit_test_setup_teardown(flog_print_error_template_succeeds, capture_stderr, restore_stderr),
+        cmocka_unit_test_setup_teardown(flog_print_error_batch_succeeds, capture_stderr, restore_stderr),
+        cmocka_unit_test_setup_teardown(flog_print_error_line_succeeds, capture_stderr, restore_stderr),
+        cmocka_unit_test_setup_teardown(flog_print_error_exec_succeeds, capture_stderr, restore_stderr),
+        cmocka_unit_test_setup_teardown(flog_print_error_input_succeeds, capture_stderr, restore_stderr),
+        cmocka_unit_test_setup_teardown(flog_print_error_record_succeeds, capture_stderr, restore_stderr),
     };
 
     return cmocka_run_group_tests_name("Common function tests", tests, NULL, NULL);
@@ -28,6 +28,7 @@
 #include <cmocka.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <sys/syslimits.h>
 #include <unistd.h>
 #include "config.h"
@@ -64,6 +65,69 @@
 #define TEST_OPTION_APPEND_SHORT "-a"
 #define TEST_OPTION_APPEND_LONG "--append"
 
+#define TEST_OPTION_FORMAT_SHORT "-f"
+#define TEST_OPTION_FORMAT_LONG "--format"
+
+#define TEST_OPTION_FORMAT_VALUE_TEXT "text"
+#define TEST_OPTION_FORMAT_VALUE_BINARY "binary"
+#define TEST_OPTION_FORMAT_VALUE_JSON "json"
+#define TEST_OPTION_FORMAT_VALUE_UNKNOWN "unknown"
+
+#define TEST_OPTION_WRITER_SHORT "-w"
+#define TEST_OPTION_WRITER_LONG "--writer"
+
+#define TEST_OPTION_WRITER_VALUE_SYNC "sync"
+#define TEST_OPTION_WRITER_VALUE_ASYNC "async"
+#define TEST_OPTION_WRITER_VALUE_UNKNOWN "unknown"
+
+#define TEST_OPTION_FDATASYNC_LONG "--fdatasync"
+
+#define TEST_OPTION_CHECKSUM_SHORT "-k"
+#define TEST_OPTION_CHECKSUM_LONG "--checksum"
+
+#define TEST_OPTION_STATS_LONG "--stats"
+
+#define TEST_OPTION_BATCH_LONG "--batch"
+#define TEST_OPTION_BATCH_VALUE_STDIN "-"
+
+#define TEST_OPTION_SERVE_LONG "--serve"
+#define TEST_OPTION_EXEC_LONG "--exec"
+#define TEST_OPTION_END "--"
+#define TEST_COMMAND "printf"
+#define TEST_OPTION_TEE_LONG "--tee"
+#define TEST_OPTION_SPLICE_LONG "--splice"
+#define TEST_OPTION_MULTILINE_LONG "--multiline"
+#define TEST_OPTION_RECORD_START_LONG "--record-start"
+#define TEST_OPTION_RECORD_MAX_LONG "--record-max"
+#define TEST_OPTION_RECORD_WAIT_LONG "--record-wait"
+#define TEST_RECORD_START "^[0-9]{4}-"
+#define TEST_RECORD_MAX "100"
+#define TEST_RECORD_MAX_TOO_LONG "8193"
+#define TEST_RECORD_WAIT "250"
+#define TEST_RECORD_WAIT_INVALID "soon"
+#define TEST_OPTION_INCLUDE_LONG "--include"
+#define TEST_OPTION_EXCLUDE_LONG "--exclude"
+#define TEST_FILTER_LITERAL "error"
+#define TEST_FILTER_REGEX "^WARN [0-9]+"
+#define TEST_FILTER_INVALID "[unterminated"
+#define TEST_OPTION_DEDUP_LONG "--dedup"
+#define TEST_OPTION_DEDUP_WAIT_LONG "--dedup-wait"
+#define TEST_DEDUP_WAIT "5000"
+#define TEST_DEDUP_WAIT_INVALID "never"
+#define TEST_OPTION_RATE_LIMIT_LONG "--rate-limit"
+#define TEST_RATE_LIMIT "100/s"
+#define TEST_RATE_LIMIT_SELECTOR "uk.co.fidgetbox.api:db@debug=10/m"
+#define TEST_OPTION_SAMPLE_LONG "--sample"
+#define TEST_SAMPLE_RATES "debug=0.01,info=0.1"
+#define TEST_OPTION_REDACT_LONG "--redact"
+#define TEST_OPTION_FIELDS_LONG "--fields"
+
+#define TEST_OPTION_PREFIX_SHORT "-t"
+#define TEST_OPTION_PREFIX_LONG "--prefix"
+#define TEST_OPTION_PREFIX_VALUE_ALL "time,level,pid,subsystem,category"
+#define TEST_OPTION_PREFIX_VALUE_TIME_LEVEL "time,level"
+#define TEST_OPTION_PREFIX_VALUE_UNKNOWN "time,unknown"
+
 #define TEST_OPTION_PRIVATE_SHORT "-p"
 #define TEST_OPTION_PRIVATE_LONG "--private"
 
@@ -71,6 +135,7 @@
 #define TEST_OPTION_INVALID_LONG "--invalid"
 
 #define TEST_PATH "/tmp/test-file"
+#define TEST_PATH_TEMPLATE "/tmp/%{subsystem}/%{category}.log"
 
 #define TEST_ERROR 255
 
@@ -83,6 +148,8 @@
 #define UNUSED(x) (void)(x)
 
 extern bool fail_calloc;
+extern bool force_fast_parser;
+extern bool force_popt_parser;
 
 static int
 enable_calloc_failure(void **state) {
@@ -98,6 +165,22 @@ disable_calloc_failure(void **state) {
     return 0;
 }
 
+static int
+use_fast_parser(void **state) {
+    UNUSED(state);
+    force_fast_parser = true;
+    force_popt_parser = false;
+    return 0;
+}
+
+static int
+use_popt_parser(void **state) {
+    UNUSED(state);
+    force_fast_parser = false;
+    force_popt_parser = true;
+    return 0;
+}
+
 static void
 flog_config_new_with_null_arg_values_fails(void **state) {
     UNUSED(state);
@@ -340,6 +423,78 @@ flog_config_new_with_long_append_opt_and_long_path_fails(void **state) {
     free(path);
 }
 
+static void
+flog_config_new_with_short_format_opt_and_unknown_value_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_FORMAT_SHORT,
+        TEST_OPTION_FORMAT_VALUE_UNKNOWN,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_FMT);
+}
+
+static void
+flog_config_new_with_long_format_opt_and_unknown_value_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_FORMAT_LONG,
+        TEST_OPTION_FORMAT_VALUE_UNKNOWN,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_FMT);
+}
+
+static void
+flog_config_new_with_short_writer_opt_and_unknown_value_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_WRITER_SHORT,
+        TEST_OPTION_WRITER_VALUE_UNKNOWN,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_WRITER);
+}
+
+static void
+flog_config_new_with_short_prefix_opt_and_unknown_value_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_PREFIX_SHORT,
+        TEST_OPTION_PREFIX_VALUE_UNKNOWN,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_PREFIX);
+}
+
 static void
 flog_config_new_with_message_from_unsupported_stream_fails(void **state) {
     UNUSED(state);
@@ -568,6 +723,52 @@ flog_config_new_with_short_append_opt_and_path_succeeds(void **state) {
     flog_config_free(config);
 }
 
+static void
+flog_config_new_with_multiple_append_opts_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_APPEND_SHORT,
+        TEST_PATH,
+        TEST_OPTION_APPEND_LONG,
+        TEST_PATH_TEMPLATE,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_output_file_count(config), 2);
+    assert_string_equal(flog_config_get_output_file_at(config, 0), TEST_PATH);
+    assert_string_equal(flog_config_get_output_file_at(config, 1), TEST_PATH_TEMPLATE);
+    assert_string_equal(flog_config_get_output_file(config), TEST_PATH);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_stats_opt_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_STATS_LONG,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_true(flog_config_get_stats_flag(config));
+
+    flog_config_free(config);
+}
+
 static void
 flog_config_new_with_long_level_opt_and_default_value_succeeds(void **state) {
     UNUSED(state);
@@ -693,33 +894,35 @@ flog_config_new_with_long_private_opt_and_message_succeeds(void **state) {
 }
 
 static void
-flog_config_new_with_short_version_opt_succeeds(void **state) {
+flog_config_new_with_short_format_opt_and_text_value_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
-        TEST_OPTION_VERSION_SHORT
+        TEST_OPTION_FORMAT_SHORT,
+        TEST_OPTION_FORMAT_VALUE_TEXT,
+        TEST_MESSAGE
     )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
     assert_non_null(config);
-    assert_true(flog_config_get_version_flag(config));
     assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_format(config), FMT_TEXT);
 
     flog_config_free(config);
 }
 
 static void
-flog_config_new_with_long_append_opt_and_path_succeeds(void **state) {
+flog_config_new_with_short_format_opt_and_binary_value_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
-        TEST_OPTION_APPEND_LONG,
-        TEST_PATH,
+        TEST_OPTION_FORMAT_SHORT,
+        TEST_OPTION_FORMAT_VALUE_BINARY,
         TEST_MESSAGE
     )
 
@@ -727,357 +930,1809 @@ flog_config_new_with_long_append_opt_and_path_succeeds(void **state) {
 
     assert_non_null(config);
     assert_int_equal(error, FLOG_ERROR_NONE);
-    assert_string_equal(flog_config_get_output_file(config), TEST_PATH);
+    assert_int_equal(flog_config_get_format(config), FMT_BINARY);
 
     flog_config_free(config);
 }
 
-
 static void
-flog_config_new_with_message_from_pipe_stream_succeeds(void **state) {
+flog_config_new_with_long_format_opt_and_binary_value_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
-        TEST_PROGRAM_NAME
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_FORMAT_LONG,
+        TEST_OPTION_FORMAT_VALUE_BINARY,
+        TEST_MESSAGE
     )
 
-    int pipe_fd[2];
-    const char *message = "0123456789ABCDEF";
-
-    // Create a pipe and allocate a file descriptor pair for reading the message string
-    if (pipe(pipe_fd) == -1) {
-        perror("pipe");
-        fail();
-    };
-
-    // Write a test message to the write end of the pipe and close its file descriptor
-    write(pipe_fd[1], message, strlen(message));
-    close(pipe_fd[1]);
-
-    // Associate a stream with the read end of the pipe
-    FILE *pipe_file = fdopen(pipe_fd[0], "r");
-    if (pipe_file == NULL) {
-        perror("fdopen");
-        close(pipe_fd[0]);
-        fail();
-    }
-
-    // Save stdin and reassign temporarily to the pipe stream
-    FILE *saved_stdin = stdin;
-    stdin = pipe_file;
-
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
-    // Ensure stdin stream is restored before making assertions in order to avoid impacting
-    // other tests if an assertion fails and leaves stdin pointing to the pipe stream
-    fclose(pipe_file);
-    stdin = saved_stdin;
-
     assert_non_null(config);
     assert_int_equal(error, FLOG_ERROR_NONE);
-    assert_string_equal(flog_config_get_message(config), message);
+    assert_int_equal(flog_config_get_format(config), FMT_BINARY);
 
     flog_config_free(config);
 }
 
 static void
-flog_config_new_with_message_from_regular_file_stream_succeeds(void **state) {
+flog_config_new_with_long_format_opt_and_json_value_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
-        TEST_PROGRAM_NAME
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_FORMAT_LONG,
+        TEST_OPTION_FORMAT_VALUE_JSON,
+        TEST_MESSAGE
     )
 
-    int fd;
-    char template[] = "/tmp/flog.XXXXXXXX";
-
-    // Create a temporary file for reading the message string
-    if ((fd = mkstemp(template)) == -1) {
-        perror("mkstemp");
-        fail();
-    }
-
-    // Write a test message to the temporary file
-    const char *message = "0123456789ABCDEF";
-    write(fd, message, strlen(message));
-
-    // Associate a stream with the temporary file
-    FILE *temp_file = fdopen(fd, "r");
-    if (temp_file == NULL) {
-        perror("fdopen");
-        close(fd);
-        fail();
-    }
-
-    // Set the file position indicator for the stream to the beginning of the file
-    rewind(temp_file);
-
-    // Save stdin and reassign temporarily to the temporary file stream
-    FILE *saved_stdin = stdin;
-    stdin = temp_file;
-
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
-    // Ensure stdin stream is restored before making assertions in order to avoid impacting
-    // other tests if an assertion fails and leaves stdin pointing to the temporary file stream
-    fclose(temp_file);
-    stdin = saved_stdin;
-
     assert_non_null(config);
     assert_int_equal(error, FLOG_ERROR_NONE);
-    assert_string_equal(flog_config_get_message(config), message);
+    assert_int_equal(flog_config_get_format(config), FMT_JSON);
 
     flog_config_free(config);
-    unlink(template);
 }
 
 static void
-flog_config_new_with_long_version_opt_succeeds(void **state) {
+flog_config_new_with_short_writer_opt_and_async_value_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
-        TEST_OPTION_VERSION_LONG
+        TEST_OPTION_WRITER_SHORT,
+        TEST_OPTION_WRITER_VALUE_ASYNC,
+        TEST_MESSAGE
     )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
     assert_non_null(config);
-    assert_true(flog_config_get_version_flag(config));
     assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_writer(config), WRT_ASYNC);
 
     flog_config_free(config);
 }
 
 static void
-flog_config_new_with_short_help_opt_succeeds(void **state) {
+flog_config_new_with_long_writer_opt_and_sync_value_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
-        TEST_OPTION_HELP_SHORT
+        TEST_OPTION_WRITER_LONG,
+        TEST_OPTION_WRITER_VALUE_SYNC,
+        TEST_MESSAGE
     )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
     assert_non_null(config);
-    assert_true(flog_config_get_help_flag(config));
     assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_writer(config), WRT_SYNC);
 
     flog_config_free(config);
 }
 
 static void
-flog_config_new_with_long_help_opt_succeeds(void **state) {
+flog_config_new_with_long_fdatasync_opt_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
-        TEST_OPTION_HELP_LONG
+        TEST_OPTION_FDATASYNC_LONG,
+        TEST_MESSAGE
     )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
     assert_non_null(config);
-    assert_true(flog_config_get_help_flag(config));
     assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_true(flog_config_get_datasync_flag(config));
 
     flog_config_free(config);
 }
 
 static void
-flog_config_get_subsystem_with_null_config_arg_fails(void **state) {
-    UNUSED(state);
-    expect_assert_failure(flog_config_get_subsystem(NULL));
-}
-
-static void
-flog_config_set_subsystem_with_null_config_arg_fails(void **state) {
-    UNUSED(state);
-    expect_assert_failure(flog_config_set_subsystem(NULL, TEST_SUBSYSTEM));
-}
-
-static void
-flog_config_set_subsystem_with_null_subsystem_arg_fails(void **state) {
+flog_config_new_with_short_checksum_opt_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
+        TEST_OPTION_CHECKSUM_SHORT,
         TEST_MESSAGE
     )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
-    expect_assert_failure(flog_config_set_subsystem(config, NULL))
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_true(flog_config_get_checksum_flag(config));
 
     flog_config_free(config);
- }
+}
 
 static void
-flog_config_get_subsystem_succeeds(void **state) {
+flog_config_new_with_long_checksum_opt_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
+        TEST_OPTION_CHECKSUM_LONG,
         TEST_MESSAGE
     )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
-    assert_string_equal(flog_config_get_subsystem(config), "");
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_true(flog_config_get_checksum_flag(config));
 
     flog_config_free(config);
 }
 
 static void
-flog_config_set_and_get_subsystem_succeeds(void **state) {
+flog_config_new_with_short_prefix_opt_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
+        TEST_OPTION_PREFIX_SHORT,
+        TEST_OPTION_PREFIX_VALUE_TIME_LEVEL,
         TEST_MESSAGE
     )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
-    flog_config_set_subsystem(config, TEST_SUBSYSTEM);
-    assert_string_equal(flog_config_get_subsystem(config), TEST_SUBSYSTEM);
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_prefix(config), PFX_TIME | PFX_LEVEL);
 
     flog_config_free(config);
 }
 
 static void
-flog_config_set_subsystem_with_long_subsystem_truncates(void **state) {
+flog_config_new_with_long_prefix_opt_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
+        TEST_OPTION_PREFIX_LONG,
+        TEST_OPTION_PREFIX_VALUE_ALL,
         TEST_MESSAGE
     )
 
-    char *subsystem = malloc(SUBSYSTEM_LEN + 1);
-    memset(subsystem, TEST_CHAR, SUBSYSTEM_LEN);
-    subsystem[SUBSYSTEM_LEN] = '\0';
-
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
-    flog_config_set_subsystem(config, subsystem);
-    assert_int_equal(strlen(flog_config_get_subsystem(config)), strlen(subsystem) - 1);
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_prefix(config), PFX_TIME | PFX_LEVEL | PFX_PID | PFX_SUBSYSTEM | PFX_CATEGORY);
 
     flog_config_free(config);
-    free(subsystem);
-}
-
-static void
-flog_config_get_category_with_null_config_arg_fails(void **state) {
-    UNUSED(state);
-    expect_assert_failure(flog_config_get_category(NULL));
-}
-
-static void
-flog_config_set_category_with_null_config_arg_fails(void **state) {
-    UNUSED(state);
-    expect_assert_failure(flog_config_set_category(NULL, TEST_CATEGORY));
 }
 
 static void
-flog_config_set_category_with_null_category_arg_fails(void **state) {
+flog_config_new_with_long_level_opt_and_attached_value_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
+        TEST_OPTION_LEVEL_LONG "=" TEST_OPTION_LEVEL_VALUE_ERROR,
         TEST_MESSAGE
     )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
-    expect_assert_failure(flog_config_set_category(config, NULL));
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_level(config), LVL_ERROR);
+    assert_string_equal(flog_config_get_message(config), TEST_MESSAGE);
 
     flog_config_free(config);
 }
 
 static void
-flog_config_get_category_succeeds(void **state) {
+flog_config_new_with_opts_after_message_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
+        TEST_MESSAGE,
+        TEST_OPTION_LEVEL_SHORT,
+        TEST_OPTION_LEVEL_VALUE_FAULT
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_level(config), LVL_FAULT);
+    assert_string_equal(flog_config_get_message(config), TEST_MESSAGE);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_clustered_short_opts_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "-pk",
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_message_type(config), MSG_PRIVATE);
+    assert_true(flog_config_get_checksum_flag(config));
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_end_of_opts_marker_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_PRIVATE_SHORT,
+        "--",
+        TEST_OPTION_INVALID_SHORT,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_message_type(config), MSG_PRIVATE);
+    assert_string_equal(flog_config_get_message(config), TEST_OPTION_INVALID_SHORT " " TEST_MESSAGE);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_missing_opt_value_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_LEVEL_SHORT
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_OPTS);
+}
+
+static void
+flog_config_new_with_short_version_opt_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_VERSION_SHORT
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_true(flog_config_get_version_flag(config));
+    assert_int_equal(error, FLOG_ERROR_NONE);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_long_append_opt_and_path_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_APPEND_LONG,
+        TEST_PATH,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_string_equal(flog_config_get_output_file(config), TEST_PATH);
+
+    flog_config_free(config);
+}
+
+
+static void
+flog_config_new_with_message_from_pipe_stream_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME
+    )
+
+    int pipe_fd[2];
+    const char *message = "0123456789ABCDEF";
+
+    // Create a pipe and allocate a file descriptor pair for reading the message string
+    if (pipe(pipe_fd) == -1) {
+        perror("pipe");
+        fail();
+    };
+
+    // Write a test message to the write end of the pipe and close its file descriptor
+    write(pipe_fd[1], message, strlen(message));
+    close(pipe_fd[1]);
+
+    // Associate a stream with the read end of the pipe
+    FILE *pipe_file = fdopen(pipe_fd[0], "r");
+    if (pipe_file == NULL) {
+        perror("fdopen");
+        close(pipe_fd[0]);
+        fail();
+    }
+
+    // Save stdin and reassign temporarily to the pipe stream
+    FILE *saved_stdin = stdin;
+    stdin = pipe_file;
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    // Ensure stdin stream is restored before making assertions in order to avoid impacting
+    // other tests if an assertion fails and leaves stdin pointing to the pipe stream
+    fclose(pipe_file);
+    stdin = saved_stdin;
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_string_equal(flog_config_get_message(config), message);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_message_from_regular_file_stream_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME
+    )
+
+    int fd;
+    char template[] = "/tmp/flog.XXXXXXXX";
+
+    // Create a temporary file for reading the message string
+    if ((fd = mkstemp(template)) == -1) {
+        perror("mkstemp");
+        fail();
+    }
+
+    // Write a test message to the temporary file
+    const char *message = "0123456789ABCDEF";
+    write(fd, message, strlen(message));
+
+    // Associate a stream with the temporary file
+    FILE *temp_file = fdopen(fd, "r");
+    if (temp_file == NULL) {
+        perror("fdopen");
+        close(fd);
+        fail();
+    }
+
+    // Set the file position indicator for the stream to the beginning of the file
+    rewind(temp_file);
+
+    // Save stdin and reassign temporarily to the temporary file stream
+    FILE *saved_stdin = stdin;
+    stdin = temp_file;
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    // Ensure stdin stream is restored before making assertions in order to avoid impacting
+    // other tests if an assertion fails and leaves stdin pointing to the temporary file stream
+    fclose(temp_file);
+    stdin = saved_stdin;
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_string_equal(flog_config_get_message(config), message);
+
+    flog_config_free(config);
+    unlink(template);
+}
+
+static void
+flog_config_new_with_long_version_opt_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_VERSION_LONG
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_true(flog_config_get_version_flag(config));
+    assert_int_equal(error, FLOG_ERROR_NONE);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_short_help_opt_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_HELP_SHORT
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_true(flog_config_get_help_flag(config));
+    assert_int_equal(error, FLOG_ERROR_NONE);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_long_help_opt_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_HELP_LONG
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_true(flog_config_get_help_flag(config));
+    assert_int_equal(error, FLOG_ERROR_NONE);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_get_subsystem_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_config_get_subsystem(NULL));
+}
+
+static void
+flog_config_set_subsystem_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_config_set_subsystem(NULL, TEST_SUBSYSTEM));
+}
+
+static void
+flog_config_set_subsystem_with_null_subsystem_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    expect_assert_failure(flog_config_set_subsystem(config, NULL))
+
+    flog_config_free(config);
+ }
+
+static void
+flog_config_get_subsystem_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_string_equal(flog_config_get_subsystem(config), "");
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_and_get_subsystem_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    flog_config_set_subsystem(config, TEST_SUBSYSTEM);
+    assert_string_equal(flog_config_get_subsystem(config), TEST_SUBSYSTEM);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_subsystem_again_keeps_previous_value_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_SUBSYSTEM_SHORT,
+        TEST_SUBSYSTEM,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    const char *subsystem = flog_config_get_subsystem(config);
+
+    assert_int_equal(flog_config_set_subsystem(config, TEST_CATEGORY), FLOG_ERROR_NONE);
+    assert_string_equal(flog_config_get_subsystem(config), TEST_CATEGORY);
+    assert_string_equal(subsystem, TEST_SUBSYSTEM);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_subsystem_with_long_subsystem_truncates(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    char *subsystem = malloc(SUBSYSTEM_LEN + 1);
+    memset(subsystem, TEST_CHAR, SUBSYSTEM_LEN);
+    subsystem[SUBSYSTEM_LEN] = '\0';
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    flog_config_set_subsystem(config, subsystem);
+    assert_int_equal(strlen(flog_config_get_subsystem(config)), strlen(subsystem) - 1);
+
+    flog_config_free(config);
+    free(subsystem);
+}
+
+static void
+flog_config_get_category_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_config_get_category(NULL));
+}
+
+static void
+flog_config_set_category_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_config_set_category(NULL, TEST_CATEGORY));
+}
+
+static void
+flog_config_set_category_with_null_category_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    expect_assert_failure(flog_config_set_category(config, NULL));
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_get_category_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_string_equal(flog_config_get_category(config), "");
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_and_get_category_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    flog_config_set_category(config, TEST_CATEGORY);
+    assert_string_equal(flog_config_get_category(config), TEST_CATEGORY);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_category_with_long_category_truncates(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    char *category = malloc(CATEGORY_LEN + 1);
+    memset(category, TEST_CHAR, CATEGORY_LEN);
+    category[CATEGORY_LEN] = '\0';
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    flog_config_set_category(config, category);
+    assert_int_equal(strlen(flog_config_get_category(config)), strlen(category) - 1);
+
+    flog_config_free(config);
+    free(category);
+}
+
+static void
+flog_config_get_output_file_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_config_get_output_file(NULL));
+}
+
+static void
+flog_config_set_output_file_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_config_set_output_file(NULL, TEST_OUTPUT_FILE));
+}
+
+static void
+flog_config_set_output_file_with_long_path_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    char *path = malloc(PATH_MAX + 1);
+    memset(path, TEST_CHAR, PATH_MAX);
+    path[PATH_MAX] = '\0';
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_int_equal(flog_config_set_output_file(config, path), FLOG_ERROR_FILE);
+
+    flog_config_free(config);
+    free(path);
+}
+
+static void
+flog_config_set_message_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_config_set_message(NULL, TEST_MESSAGE));
+}
+
+static void
+flog_config_set_message_with_null_message_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    expect_assert_failure(flog_config_set_message(config, NULL));
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_output_file_with_null_output_file_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    expect_assert_failure(flog_config_set_output_file(config, NULL));
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_add_output_file_beyond_limit_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    for (int i = 0; i < OUTPUT_FILE_MAX; i++) {
+        assert_int_equal(flog_config_add_output_file(config, TEST_OUTPUT_FILE), FLOG_ERROR_NONE);
+    }
+
+    assert_int_equal(flog_config_add_output_file(config, TEST_OUTPUT_FILE), FLOG_ERROR_FILES);
+    assert_int_equal(flog_config_get_output_file_count(config), OUTPUT_FILE_MAX);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_get_output_file_at_with_invalid_index_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    expect_assert_failure(flog_config_get_output_file_at(config, 0));
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_get_output_file_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_string_equal(flog_config_get_output_file(config), "");
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_and_get_output_file_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    flog_config_set_output_file(config, TEST_OUTPUT_FILE);
+    assert_string_equal(flog_config_get_output_file(config), TEST_OUTPUT_FILE);
+
+    flog_config_add_output_file(config, TEST_PATH);
+    assert_int_equal(flog_config_get_output_file_count(config), 2);
+
+    flog_config_set_output_file(config, TEST_PATH_TEMPLATE);
+    assert_int_equal(flog_config_get_output_file_count(config), 1);
+    assert_string_equal(flog_config_get_output_file_at(config, 0), TEST_PATH_TEMPLATE);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_get_message_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_config_get_message(NULL));
+}
+
+
+static void
+flog_config_get_message_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_string_equal(flog_config_get_message(config), TEST_MESSAGE);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_and_get_message_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    const char message[] = "0123456789ABCDEF";
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    flog_config_set_message(config, message);
+    assert_string_equal(flog_config_get_message(config), message);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_and_get_messages_larger_than_arena_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    char message[MESSAGE_LEN / 2];
+    memset(message, TEST_CHAR, sizeof(message) - 1);
+    message[sizeof(message) - 1] = '\0';
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    for (int i = 0; i < 4; i++) {
+        message[i] = (char) ('0' + i);
+        assert_int_equal(flog_config_set_message(config, message), FLOG_ERROR_NONE);
+        assert_int_equal(flog_config_set_category(config, TEST_CATEGORY), FLOG_ERROR_NONE);
+        assert_string_equal(flog_config_get_message(config), message);
+        assert_string_equal(flog_config_get_category(config), TEST_CATEGORY);
+    }
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_message_with_long_message_truncates(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    char *message = malloc(MESSAGE_LEN + 1);
+    memset(message, TEST_CHAR, MESSAGE_LEN);
+    message[MESSAGE_LEN] = '\0';
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    flog_config_set_message(config, message);
+    assert_int_equal(strlen(flog_config_get_message(config)), MESSAGE_LEN - 1);
+
+    flog_config_free(config);
+    free(message);
+}
+
+static void
+flog_config_get_message_type_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_config_get_message_type(NULL));
+}
+
+static void
+flog_config_set_message_type_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_config_set_message_type(NULL, MSG_PRIVATE));
+}
+
+static void
+flog_config_get_message_type_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_int_equal(flog_config_get_message_type(config), MSG_PUBLIC);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_and_get_message_type_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    flog_config_set_message_type(config, MSG_PRIVATE);
+    assert_int_equal(flog_config_get_message_type(config), MSG_PRIVATE);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_message_from_stream_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+
+    FILE mock_stream = {};
+    expect_assert_failure(flog_config_set_message_from_stream(NULL, &mock_stream));
+}
+
+static void
+flog_config_set_message_from_stream_with_null_stream_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    expect_assert_failure(flog_config_set_message_from_stream(config, NULL));
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_and_get_message_from_stream_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    char *message = "0123456789ABCDEF";
+
+    FILE *mock_stream = fmemopen(message, strlen(message), "r");
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    flog_config_set_message_from_stream(config, mock_stream);
+    assert_int_equal(strlen(flog_config_get_message(config)), strlen(message));
+    assert_string_equal(flog_config_get_message(config), message);
+
+    fclose(mock_stream);
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_message_from_stream_sanitizes_message(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    char message[] = "\x1b[2Jcaf\xc3\xa9\tbad \xff byte\n";
+
+    FILE *mock_stream = fmemopen(message, strlen(message), "r");
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    flog_config_set_message_from_stream(config, mock_stream);
+    assert_string_equal(flog_config_get_message(config), "\\x1b[2Jcaf\xc3\xa9\tbad \xef\xbf\xbd byte\n");
+
+    fclose(mock_stream);
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_message_from_stream_with_long_message_truncates(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    char *message = malloc(MESSAGE_LEN + 1);
+    memset(message, TEST_CHAR, MESSAGE_LEN);
+    message[MESSAGE_LEN] = '\0';
+
+    FILE *mock_stream = fmemopen(message, strlen(message), "r");
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    flog_config_set_message_from_stream(config, mock_stream);
+    assert_int_equal(strlen(flog_config_get_message(config)), MESSAGE_LEN - 1);
+
+    fclose(mock_stream);
+    flog_config_free(config);
+    free(message);
+}
+
+static void
+flog_config_sanitize_message_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+
+    expect_assert_failure(flog_config_sanitize_message(NULL));
+}
+
+static void
+flog_config_sanitize_message_leaves_valid_message(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "caf\xc3\xa9\tcr\r\n"
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    const char *message = flog_config_get_message(config);
+
+    assert_int_equal(flog_config_sanitize_message(config), FLOG_ERROR_NONE);
+    assert_ptr_equal(flog_config_get_message(config), message);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_sanitize_message_replaces_invalid_sequences(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_int_equal(flog_config_set_message(config, "\x1b[2Jbad \xff byte"), FLOG_ERROR_NONE);
+
+    assert_int_equal(flog_config_sanitize_message(config), FLOG_ERROR_NONE);
+    assert_string_equal(flog_config_get_message(config), "\\x1b[2Jbad \xef\xbf\xbd byte");
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_message_from_args_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+
+    const char *mock_args[] = {
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    };
+
+    expect_assert_failure(flog_config_set_message_from_args(NULL, mock_args));
+}
+
+static void
+flog_config_set_message_from_args_with_null_args_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    expect_assert_failure(flog_config_set_message_from_args(config, NULL));
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_and_get_message_from_args_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    const char *mock_args[] = {
+        "abc",
+        "def",
+        "123",
+        "456",
+        NULL
+    };
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    flog_config_set_message_from_args(config, mock_args);
+    assert_string_equal(flog_config_get_message(config), "abc def 123 456");
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_message_from_args_with_long_message_truncates(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    char *message = malloc(MESSAGE_LEN + 1);
+    memset(message, TEST_CHAR, MESSAGE_LEN);
+    message[MESSAGE_LEN] = '\0';
+
+    const char *mock_args[] = {
+        message,
+        NULL
+    };
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    flog_config_set_message_from_args(config, mock_args);
+    assert_int_equal(strlen(flog_config_get_message(config)), MESSAGE_LEN - 1);
+
+    flog_config_free(config);
+    free(message);
+}
+
+static void
+flog_config_set_message_from_args_truncates_when_appending_space(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    char *message = malloc(MESSAGE_LEN);
+    memset(message, TEST_CHAR, MESSAGE_LEN);
+    message[MESSAGE_LEN - 1] = '\0';
+
+    const char *mock_args[] = {
+        message,
+        "abcdef123456",
+        NULL
+    };
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    flog_config_set_message_from_args(config, mock_args);
+    assert_int_equal(strlen(flog_config_get_message(config)), MESSAGE_LEN - 1);
+
+    flog_config_free(config);
+    free(message);
+}
+
+static void
+flog_config_get_format_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_config_get_format(NULL));
+}
+
+static void
+flog_config_set_format_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_config_set_format(NULL, FMT_BINARY));
+}
+
+static void
+flog_config_get_format_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_int_equal(flog_config_get_format(config), FMT_TEXT);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_set_and_get_format_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    flog_config_set_format(config, FMT_BINARY);
+    assert_int_equal(flog_config_get_format(config), FMT_BINARY);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_batch_opt_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_BATCH_LONG,
+        TEST_OUTPUT_FILE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_string_equal(flog_config_get_batch_file(config), TEST_OUTPUT_FILE);
+    assert_string_equal(flog_config_get_message(config), "");
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_batch_opt_and_stdin_value_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_BATCH_LONG,
+        TEST_OPTION_BATCH_VALUE_STDIN
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_string_equal(flog_config_get_batch_file(config), TEST_OPTION_BATCH_VALUE_STDIN);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_batch_opt_and_message_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_BATCH_LONG,
+        TEST_OUTPUT_FILE,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_OPTS);
+}
+
+static void
+flog_config_new_with_serve_opt_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_SERVE_LONG
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_true(flog_config_get_serve_flag(config));
+    assert_string_equal(flog_config_get_message(config), "");
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_serve_opt_and_batch_opt_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_SERVE_LONG,
+        TEST_OPTION_BATCH_LONG,
+        TEST_OUTPUT_FILE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_OPTS);
+}
+
+static void
+flog_config_new_with_exec_opt_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_LEVEL_SHORT,
+        TEST_OPTION_LEVEL_VALUE_INFO,
+        TEST_OPTION_EXEC_LONG,
+        TEST_OPTION_END,
+        TEST_COMMAND,
+        TEST_OPTION_LEVEL_SHORT,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_true(flog_config_get_exec_flag(config));
+    assert_int_equal(flog_config_get_level(config), LVL_INFO);
+    assert_string_equal(flog_config_get_message(config), "");
+
+    // Options following the command are passed to it
+    char *const *command = flog_config_get_command(config);
+    assert_non_null(command);
+    assert_string_equal(command[0], TEST_COMMAND);
+    assert_string_equal(command[1], TEST_OPTION_LEVEL_SHORT);
+    assert_string_equal(command[2], TEST_MESSAGE);
+    assert_null(command[3]);
+    assert_true((uintptr_t) command % _Alignof(char *) == 0);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_exec_opt_and_no_command_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_EXEC_LONG
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_OPTS);
+}
+
+static void
+flog_config_new_with_exec_opt_and_serve_opt_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_SERVE_LONG,
+        TEST_OPTION_EXEC_LONG,
+        TEST_OPTION_END,
+        TEST_COMMAND
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_OPTS);
+}
+
+static void
+flog_config_new_with_tee_opt_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_TEE_LONG,
+        TEST_OPTION_APPEND_SHORT,
+        TEST_OUTPUT_FILE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_true(flog_config_get_tee_flag(config));
+    assert_false(flog_config_get_splice_flag(config));
+    assert_string_equal(flog_config_get_output_file(config), TEST_OUTPUT_FILE);
+    assert_string_equal(flog_config_get_message(config), "");
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_splice_opt_sets_tee_flag(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_SPLICE_LONG,
+        TEST_OPTION_APPEND_SHORT,
+        TEST_OUTPUT_FILE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_true(flog_config_get_tee_flag(config));
+    assert_true(flog_config_get_splice_flag(config));
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_tee_opt_and_no_append_opt_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_TEE_LONG
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_OPTS);
+}
+
+static void
+flog_config_new_with_tee_opt_and_prefix_opt_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_TEE_LONG,
+        TEST_OPTION_APPEND_SHORT,
+        TEST_OUTPUT_FILE,
+        TEST_OPTION_PREFIX_SHORT,
+        TEST_OPTION_PREFIX_VALUE_TIME_LEVEL
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_OPTS);
+}
+
+static void
+flog_config_new_with_tee_opt_and_checksum_opt_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_TEE_LONG,
+        TEST_OPTION_APPEND_SHORT,
+        TEST_OUTPUT_FILE,
+        TEST_OPTION_CHECKSUM_SHORT
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_OPTS);
+}
+
+static void
+flog_config_new_with_tee_opt_and_message_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_TEE_LONG,
+        TEST_OPTION_APPEND_SHORT,
+        TEST_OUTPUT_FILE,
         TEST_MESSAGE
     )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
-    assert_string_equal(flog_config_get_category(config), "");
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_OPTS);
+}
+
+static void
+flog_config_new_with_tee_opt_and_exec_opt_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_TEE_LONG,
+        TEST_OPTION_APPEND_SHORT,
+        TEST_OUTPUT_FILE,
+        TEST_OPTION_EXEC_LONG,
+        TEST_OPTION_END,
+        TEST_COMMAND
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_OPTS);
+}
+
+static void
+flog_config_new_with_multiline_opt_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_MULTILINE_LONG
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_true(flog_config_get_multiline_flag(config));
+    assert_string_equal(flog_config_get_record_start(config), "");
+    assert_int_equal(flog_config_get_record_max(config), RECORD_MAX_DEFAULT);
+    assert_int_equal(flog_config_get_record_wait(config), RECORD_WAIT_DEFAULT);
+    assert_string_equal(flog_config_get_message(config), "");
 
     flog_config_free(config);
 }
 
 static void
-flog_config_set_and_get_category_succeeds(void **state) {
+flog_config_new_with_record_opts_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
-        TEST_MESSAGE
+        TEST_OPTION_RECORD_START_LONG,
+        TEST_RECORD_START,
+        TEST_OPTION_RECORD_MAX_LONG,
+        TEST_RECORD_MAX,
+        TEST_OPTION_RECORD_WAIT_LONG,
+        TEST_RECORD_WAIT
     )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
-    flog_config_set_category(config, TEST_CATEGORY);
-    assert_string_equal(flog_config_get_category(config), TEST_CATEGORY);
+    // The record options imply the multiline option
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_true(flog_config_get_multiline_flag(config));
+    assert_string_equal(flog_config_get_record_start(config), TEST_RECORD_START);
+    assert_int_equal(flog_config_get_record_max(config), 100);
+    assert_int_equal(flog_config_get_record_wait(config), 250);
 
     flog_config_free(config);
 }
 
 static void
-flog_config_set_category_with_long_category_truncates(void **state) {
+flog_config_new_with_multiline_opt_and_exec_opt_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_MULTILINE_LONG,
+        TEST_OPTION_EXEC_LONG,
+        TEST_OPTION_END,
+        TEST_COMMAND
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_true(flog_config_get_multiline_flag(config));
+    assert_true(flog_config_get_exec_flag(config));
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_record_max_too_long_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_RECORD_MAX_LONG,
+        TEST_RECORD_MAX_TOO_LONG
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_RECORD);
+}
+
+static void
+flog_config_new_with_invalid_record_wait_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_RECORD_WAIT_LONG,
+        TEST_RECORD_WAIT_INVALID
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_RECORD);
+}
+
+static void
+flog_config_new_with_multiline_opt_and_batch_opt_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_MULTILINE_LONG,
+        TEST_OPTION_BATCH_LONG,
+        TEST_OPTION_BATCH_VALUE_STDIN
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_OPTS);
+}
+
+static void
+flog_config_new_with_multiline_opt_and_message_fails(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
+        TEST_OPTION_MULTILINE_LONG,
         TEST_MESSAGE
     )
 
-    char *category = malloc(CATEGORY_LEN + 1);
-    memset(category, TEST_CHAR, CATEGORY_LEN);
-    category[CATEGORY_LEN] = '\0';
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_OPTS);
+}
+
+static void
+flog_config_new_with_filter_opts_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_INCLUDE_LONG,
+        TEST_FILTER_LITERAL,
+        TEST_OPTION_EXCLUDE_LONG,
+        TEST_FILTER_LITERAL,
+        TEST_OPTION_INCLUDE_LONG,
+        TEST_FILTER_REGEX,
+        TEST_MESSAGE
+    )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
-    flog_config_set_category(config, category);
-    assert_int_equal(strlen(flog_config_get_category(config)), strlen(category) - 1);
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_filter_count(config, FLT_INCLUDE), 2);
+    assert_string_equal(flog_config_get_filter_at(config, FLT_INCLUDE, 0), TEST_FILTER_LITERAL);
+    assert_string_equal(flog_config_get_filter_at(config, FLT_INCLUDE, 1), TEST_FILTER_REGEX);
+    assert_int_equal(flog_config_get_filter_count(config, FLT_EXCLUDE), 1);
+    assert_string_equal(flog_config_get_filter_at(config, FLT_EXCLUDE, 0), TEST_FILTER_LITERAL);
+    assert_string_equal(flog_config_get_message(config), TEST_MESSAGE);
 
     flog_config_free(config);
-    free(category);
 }
 
 static void
-flog_config_get_output_file_with_null_config_arg_fails(void **state) {
+flog_config_new_with_invalid_filter_opt_fails(void **state) {
     UNUSED(state);
-    expect_assert_failure(flog_config_get_output_file(NULL));
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_EXCLUDE_LONG,
+        TEST_FILTER_INVALID,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_FILTER);
 }
 
 static void
-flog_config_set_output_file_with_null_config_arg_fails(void **state) {
+flog_config_new_with_empty_filter_opt_fails(void **state) {
     UNUSED(state);
-    expect_assert_failure(flog_config_set_output_file(NULL, TEST_OUTPUT_FILE));
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_INCLUDE_LONG,
+        "",
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_FILTER);
 }
 
 static void
-flog_config_set_output_file_with_long_path_fails(void **state) {
+flog_config_add_filter_beyond_limit_fails(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
@@ -1086,26 +2741,131 @@ flog_config_set_output_file_with_long_path_fails(void **state) {
         TEST_MESSAGE
     )
 
-    char *path = malloc(PATH_MAX + 1);
-    memset(path, TEST_CHAR, PATH_MAX);
-    path[PATH_MAX] = '\0';
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    for (int i = 0; i < FILTER_PATTERN_MAX; i++) {
+        assert_int_equal(flog_config_add_filter(config, FLT_EXCLUDE, TEST_FILTER_LITERAL), FLOG_ERROR_NONE);
+    }
+
+    assert_int_equal(flog_config_add_filter(config, FLT_EXCLUDE, TEST_FILTER_LITERAL), FLOG_ERROR_FILTER);
+    assert_int_equal(flog_config_get_filter_count(config, FLT_EXCLUDE), FILTER_PATTERN_MAX);
+
+    // Each kind of pattern has its own limit
+    assert_int_equal(flog_config_add_filter(config, FLT_INCLUDE, TEST_FILTER_LITERAL), FLOG_ERROR_NONE);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_dedup_opt_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_DEDUP_LONG,
+        TEST_MESSAGE
+    )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
-    assert_int_equal(flog_config_set_output_file(config, path), FLOG_ERROR_FILE);
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_true(flog_config_get_dedup_flag(config));
+    assert_int_equal(flog_config_get_dedup_wait(config), DEDUP_WAIT_DEFAULT);
+    assert_string_equal(flog_config_get_message(config), TEST_MESSAGE);
 
     flog_config_free(config);
-    free(path);
 }
 
-static void
-flog_config_set_message_with_null_config_arg_fails(void **state) {
-    UNUSED(state);
-    expect_assert_failure(flog_config_set_message(NULL, TEST_MESSAGE));
+static void
+flog_config_new_with_dedup_wait_opt_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_DEDUP_WAIT_LONG,
+        TEST_DEDUP_WAIT,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_true(flog_config_get_dedup_flag(config));
+    assert_int_equal(flog_config_get_dedup_wait(config), 5000);
+
+    flog_config_free(config);
+}
+
+static void
+flog_config_new_with_invalid_dedup_wait_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_DEDUP_WAIT_LONG,
+        TEST_DEDUP_WAIT_INVALID,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_DEDUP);
+}
+
+static void
+flog_config_new_with_rate_limit_opts_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_RATE_LIMIT_LONG,
+        TEST_RATE_LIMIT_SELECTOR,
+        TEST_OPTION_RATE_LIMIT_LONG,
+        "@fault=unlimited",
+        TEST_OPTION_RATE_LIMIT_LONG,
+        TEST_RATE_LIMIT,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_rate_limit_count(config), 3);
+
+    const FlogConfigRateLimit *limit = flog_config_get_rate_limit_at(config, 0);
+    assert_string_equal(limit->subsystem, "uk.co.fidgetbox.api");
+    assert_string_equal(limit->category, "db");
+    assert_int_equal(limit->level, LVL_DEBUG);
+    assert_int_equal(limit->count, 10);
+    assert_int_equal(limit->period, 60000);
+
+    limit = flog_config_get_rate_limit_at(config, 1);
+    assert_string_equal(limit->subsystem, "");
+    assert_int_equal(limit->level, LVL_FAULT);
+    assert_int_equal(limit->count, 0);
+
+    limit = flog_config_get_rate_limit_at(config, 2);
+    assert_string_equal(limit->subsystem, "");
+    assert_string_equal(limit->category, "");
+    assert_int_equal(limit->level, LVL_UNKNOWN);
+    assert_int_equal(limit->count, 100);
+    assert_int_equal(limit->period, 1000);
+
+    assert_string_equal(flog_config_get_message(config), TEST_MESSAGE);
+
+    flog_config_free(config);
 }
 
 static void
-flog_config_set_message_with_null_message_arg_fails(void **state) {
+flog_config_add_rate_limit_with_invalid_rules_fails(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
@@ -1115,14 +2875,27 @@ flog_config_set_message_with_null_message_arg_fails(void **state) {
     )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
 
-    expect_assert_failure(flog_config_set_message(config, NULL));
+    const char *rules[] = { "", "0/s", "=unlimited/s", "10/d", "10/", "ten/s", "-1/s", "1000001/s", "@verbose=10/s",
+                            "uk.co.fidgetbox.api:=10/s", "uk.co.fidgetbox.api:db" };
+    for (size_t i = 0; i < sizeof(rules) / sizeof(rules[0]); i++) {
+        assert_int_equal(flog_config_add_rate_limit(config, rules[i]), FLOG_ERROR_RATE);
+    }
+
+    assert_int_equal(flog_config_get_rate_limit_count(config), 0);
+
+    for (int i = 0; i < RATE_LIMIT_MAX; i++) {
+        assert_int_equal(flog_config_add_rate_limit(config, TEST_RATE_LIMIT), FLOG_ERROR_NONE);
+    }
+
+    assert_int_equal(flog_config_add_rate_limit(config, TEST_RATE_LIMIT), FLOG_ERROR_RATE);
 
     flog_config_free(config);
 }
 
 static void
-flog_config_set_output_file_with_null_output_file_arg_fails(void **state) {
+flog_config_add_filters_and_rate_limits_keeps_each_entry(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
@@ -1132,56 +2905,80 @@ flog_config_set_output_file_with_null_output_file_arg_fails(void **state) {
     )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
 
-    expect_assert_failure(flog_config_set_output_file(config, NULL));
+    // The arrays grow in the arena, so every entry must survive each move
+    char entry[32];
+    for (int i = 0; i < FILTER_PATTERN_MAX; i++) {
+        snprintf(entry, sizeof(entry), "pattern%d", i);
+        assert_int_equal(flog_config_add_filter(config, FLT_INCLUDE, entry), FLOG_ERROR_NONE);
+
+        snprintf(entry, sizeof(entry), "sub%d=%d/s", i, i + 1);
+        assert_int_equal(flog_config_add_rate_limit(config, entry), FLOG_ERROR_NONE);
+    }
+
+    assert_int_equal(flog_config_get_filter_count(config, FLT_EXCLUDE), 0);
+
+    for (int i = 0; i < FILTER_PATTERN_MAX; i++) {
+        snprintf(entry, sizeof(entry), "pattern%d", i);
+        assert_string_equal(flog_config_get_filter_at(config, FLT_INCLUDE, i), entry);
+
+        const FlogConfigRateLimit *limit = flog_config_get_rate_limit_at(config, i);
+        snprintf(entry, sizeof(entry), "sub%d", i);
+        assert_string_equal(limit->subsystem, entry);
+        assert_int_equal(limit->count, i + 1);
+    }
 
     flog_config_free(config);
 }
 
 static void
-flog_config_get_output_file_succeeds(void **state) {
+flog_config_new_with_invalid_rate_limit_opt_fails(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
+        TEST_OPTION_RATE_LIMIT_LONG,
+        "@verbose=10/s",
         TEST_MESSAGE
     )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
-    assert_string_equal(flog_config_get_output_file(config), "");
-
-    flog_config_free(config);
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_RATE);
 }
 
 static void
-flog_config_set_and_get_output_file_succeeds(void **state) {
+flog_config_new_with_sample_opts_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
+        TEST_OPTION_SAMPLE_LONG,
+        TEST_SAMPLE_RATES,
+        TEST_OPTION_SAMPLE_LONG,
+        "info=0.5",
         TEST_MESSAGE
     )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
-    flog_config_set_output_file(config, TEST_OUTPUT_FILE);
-    assert_string_equal(flog_config_get_output_file(config), TEST_OUTPUT_FILE);
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_true(flog_config_get_sample_rate(config, LVL_DEBUG) == 0.01);
+    assert_true(flog_config_get_sample_rate(config, LVL_INFO) == 0.5);
+    assert_true(flog_config_get_sample_rate(config, LVL_DEFAULT) == 1.0);
+    assert_true(flog_config_get_sample_rate(config, LVL_FAULT) == 1.0);
+    assert_string_equal(flog_config_get_message(config), TEST_MESSAGE);
 
     flog_config_free(config);
 }
 
 static void
-flog_config_get_message_with_null_config_arg_fails(void **state) {
-    UNUSED(state);
-    expect_assert_failure(flog_config_get_message(NULL));
-}
-
-
-static void
-flog_config_get_message_succeeds(void **state) {
+flog_config_set_sample_rates_with_invalid_rates_fails(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
@@ -1191,112 +2988,156 @@ flog_config_get_message_succeeds(void **state) {
     )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
 
-    assert_string_equal(flog_config_get_message(config), TEST_MESSAGE);
+    const char *rates[] = { "", "debug", "debug=", "debug=0", "debug=1.5", "debug=-0.1", "debug=nan", "debug=0.1x",
+                            "verbose=0.1", "debug=0.1,", "debug=0.1,info" };
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        assert_int_equal(flog_config_set_sample_rates(config, rates[i]), FLOG_ERROR_SAMPLE);
+    }
+
+    // No rates are set by a list that is invalid
+    assert_true(flog_config_get_sample_rate(config, LVL_DEBUG) == 1.0);
 
     flog_config_free(config);
 }
 
 static void
-flog_config_set_and_get_message_succeeds(void **state) {
+flog_config_new_with_invalid_sample_opt_fails(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
+        TEST_OPTION_SAMPLE_LONG,
+        "debug=2",
         TEST_MESSAGE
     )
 
-    const char message[] = "0123456789ABCDEF";
-
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
-    flog_config_set_message(config, message);
-    assert_string_equal(flog_config_get_message(config), message);
-
-    flog_config_free(config);
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_SAMPLE);
 }
 
 static void
-flog_config_set_message_with_long_message_truncates(void **state) {
+flog_config_new_with_redact_opts_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
+        TEST_OPTION_REDACT_LONG,
+        "bearer,email",
+        TEST_OPTION_REDACT_LONG,
+        "card",
         TEST_MESSAGE
     )
 
-    char *message = malloc(MESSAGE_LEN + 1);
-    memset(message, TEST_CHAR, MESSAGE_LEN);
-    message[MESSAGE_LEN] = '\0';
-
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
-    flog_config_set_message(config, message);
-    assert_int_equal(strlen(flog_config_get_message(config)), MESSAGE_LEN - 1);
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_redact(config), RDT_BEARER | RDT_EMAIL | RDT_CARD);
+    assert_string_equal(flog_config_get_message(config), TEST_MESSAGE);
 
     flog_config_free(config);
-    free(message);
 }
 
 static void
-flog_config_get_message_type_with_null_config_arg_fails(void **state) {
+flog_config_new_with_invalid_redact_opt_fails(void **state) {
     UNUSED(state);
-    expect_assert_failure(flog_config_get_message_type(NULL));
+
+    FlogError error = TEST_ERROR;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_OPTION_REDACT_LONG,
+        "email,phone",
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_REDACT);
 }
 
 static void
-flog_config_set_message_type_with_null_config_arg_fails(void **state) {
+flog_config_parse_redact_succeeds(void **state) {
     UNUSED(state);
-    expect_assert_failure(flog_config_set_message_type(NULL, MSG_PRIVATE));
+
+    assert_int_equal(flog_config_parse_redact("aws-key"), RDT_AWS_KEY);
+    assert_int_equal(flog_config_parse_redact("card,bearer"), RDT_CARD | RDT_BEARER);
+    assert_int_equal(flog_config_parse_redact("all"), RDT_ALL);
+    assert_int_equal(flog_config_parse_redact(""), RDT_UNKNOWN);
+    assert_int_equal(flog_config_parse_redact("email,"), RDT_UNKNOWN);
+    assert_int_equal(flog_config_parse_redact("EMAIL"), RDT_UNKNOWN);
 }
 
 static void
-flog_config_get_message_type_succeeds(void **state) {
+flog_config_new_with_fields_opt_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
-        TEST_MESSAGE
+        TEST_OPTION_FIELDS_LONG,
+        "json",
+        TEST_OPTION_BATCH_LONG,
+        TEST_OPTION_BATCH_VALUE_STDIN
     )
 
-    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    FlogConfig *defaults = flog_config_new(mock_argc, mock_argv, &error);
 
-    assert_int_equal(flog_config_get_message_type(config), MSG_PUBLIC);
+    assert_non_null(defaults);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_fields(defaults), FLD_JSON);
+
+    // Batch lines inherit the field format and may give their own
+    FlogConfig *config = flog_config_new_with_defaults(defaults, &error);
+    assert_non_null(config);
+
+    char first_line[] = TEST_MESSAGE;
+    assert_int_equal(flog_config_parse_line(config, first_line), FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_fields(config), FLD_JSON);
+
+    char second_line[] = TEST_OPTION_FIELDS_LONG " logfmt " TEST_MESSAGE;
+    assert_int_equal(flog_config_parse_line(config, second_line), FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_fields(config), FLD_LOGFMT);
 
     flog_config_free(config);
+    flog_config_free(defaults);
 }
 
 static void
-flog_config_set_and_get_message_type_succeeds(void **state) {
+flog_config_new_with_invalid_fields_opt_fails(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
+        TEST_OPTION_FIELDS_LONG,
+        "yaml",
         TEST_MESSAGE
     )
 
     FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
 
-    flog_config_set_message_type(config, MSG_PRIVATE);
-    assert_int_equal(flog_config_get_message_type(config), MSG_PRIVATE);
-
-    flog_config_free(config);
+    assert_null(config);
+    assert_int_equal(error, FLOG_ERROR_FIELDS);
 }
 
 static void
-flog_config_set_message_from_stream_with_null_config_arg_fails(void **state) {
+flog_config_new_with_defaults_with_null_defaults_arg_fails(void **state) {
     UNUSED(state);
 
-    FILE mock_stream = {};
-    expect_assert_failure(flog_config_set_message_from_stream(NULL, &mock_stream));
+    FlogError error = TEST_ERROR;
+
+    expect_assert_failure(flog_config_new_with_defaults(NULL, &error));
 }
 
 static void
-flog_config_set_message_from_stream_with_null_stream_arg_fails(void **state) {
+flog_config_parse_line_with_null_line_arg_fails(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
@@ -1305,171 +3146,222 @@ flog_config_set_message_from_stream_with_null_stream_arg_fails(void **state) {
         TEST_MESSAGE
     )
 
-    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    FlogConfig *defaults = flog_config_new(mock_argc, mock_argv, &error);
+    FlogConfig *config = flog_config_new_with_defaults(defaults, &error);
 
-    expect_assert_failure(flog_config_set_message_from_stream(config, NULL));
+    expect_assert_failure(flog_config_parse_line(config, NULL));
 
     flog_config_free(config);
+    flog_config_free(defaults);
 }
 
 static void
-flog_config_set_and_get_message_from_stream_succeeds(void **state) {
+flog_config_parse_line_succeeds(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
-        TEST_MESSAGE
+        TEST_OPTION_SUBSYSTEM_SHORT,
+        TEST_SUBSYSTEM,
+        TEST_OPTION_APPEND_SHORT,
+        TEST_OUTPUT_FILE,
+        TEST_OPTION_BATCH_LONG,
+        TEST_OPTION_BATCH_VALUE_STDIN
     )
 
-    char *message = "0123456789ABCDEF";
+    FlogConfig *defaults = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(defaults);
 
-    FILE *mock_stream = fmemopen(message, strlen(message), "r");
-    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    FlogConfig *config = flog_config_new_with_defaults(defaults, &error);
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
 
-    flog_config_set_message_from_stream(config, mock_stream);
-    assert_int_equal(strlen(flog_config_get_message(config)), strlen(message));
-    assert_string_equal(flog_config_get_message(config), message);
+    char first_line[] = "-l error -c category 'quoted  \"message\"' \"it's\" escaped\\ word\n";
+    error = flog_config_parse_line(config, first_line);
+
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_level(config), LVL_ERROR);
+    assert_string_equal(flog_config_get_subsystem(config), TEST_SUBSYSTEM);
+    assert_string_equal(flog_config_get_category(config), TEST_CATEGORY);
+    assert_string_equal(flog_config_get_output_file(config), TEST_OUTPUT_FILE);
+    assert_string_equal(flog_config_get_batch_file(config), "");
+    assert_string_equal(flog_config_get_message(config), "quoted  \"message\" it's escaped word");
+
+    // Options from a previous line do not carry over to the next
+    char second_line[] = "  " TEST_MESSAGE;
+    error = flog_config_parse_line(config, second_line);
+
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_level(config), LVL_DEFAULT);
+    assert_string_equal(flog_config_get_category(config), "");
+    assert_string_equal(flog_config_get_message(config), TEST_MESSAGE);
 
-    fclose(mock_stream);
     flog_config_free(config);
+    flog_config_free(defaults);
 }
 
 static void
-flog_config_set_message_from_stream_with_long_message_truncates(void **state) {
+flog_config_parse_line_with_invalid_lines_fails(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
     MOCK_ARGS(
         TEST_PROGRAM_NAME,
-        TEST_MESSAGE
+        TEST_OPTION_BATCH_LONG,
+        TEST_OPTION_BATCH_VALUE_STDIN
     )
 
-    char *message = malloc(MESSAGE_LEN + 1);
-    memset(message, TEST_CHAR, MESSAGE_LEN);
-    message[MESSAGE_LEN] = '\0';
+    FlogConfig *defaults = flog_config_new(mock_argc, mock_argv, &error);
+    FlogConfig *config = flog_config_new_with_defaults(defaults, &error);
 
-    FILE *mock_stream = fmemopen(message, strlen(message), "r");
-    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    char unterminated_line[] = "'" TEST_MESSAGE;
+    assert_int_equal(flog_config_parse_line(config, unterminated_line), FLOG_ERROR_LINE);
 
-    flog_config_set_message_from_stream(config, mock_stream);
-    assert_int_equal(strlen(flog_config_get_message(config)), MESSAGE_LEN - 1);
+    char stats_line[] = TEST_OPTION_STATS_LONG " " TEST_MESSAGE;
+    assert_int_equal(flog_config_parse_line(config, stats_line), FLOG_ERROR_LINE);
 
-    fclose(mock_stream);
-    flog_config_free(config);
-    free(message);
-}
+    char help_line[] = TEST_OPTION_HELP_SHORT;
+    assert_int_equal(flog_config_parse_line(config, help_line), FLOG_ERROR_LINE);
 
-static void
-flog_config_set_message_from_args_with_null_config_arg_fails(void **state) {
-    UNUSED(state);
+    char serve_line[] = TEST_OPTION_SERVE_LONG " " TEST_MESSAGE;
+    assert_int_equal(flog_config_parse_line(config, serve_line), FLOG_ERROR_LINE);
 
-    const char *mock_args[] = {
-        TEST_PROGRAM_NAME,
-        TEST_MESSAGE
-    };
+    char exec_line[] = TEST_OPTION_EXEC_LONG " " TEST_COMMAND;
+    assert_int_equal(flog_config_parse_line(config, exec_line), FLOG_ERROR_LINE);
 
-    expect_assert_failure(flog_config_set_message_from_args(NULL, mock_args));
-}
+    char tee_line[] = TEST_OPTION_TEE_LONG " " TEST_MESSAGE;
+    assert_int_equal(flog_config_parse_line(config, tee_line), FLOG_ERROR_LINE);
 
-static void
-flog_config_set_message_from_args_with_null_args_fails(void **state) {
-    UNUSED(state);
+    char splice_line[] = TEST_OPTION_SPLICE_LONG " " TEST_MESSAGE;
+    assert_int_equal(flog_config_parse_line(config, splice_line), FLOG_ERROR_LINE);
 
-    FlogError error = TEST_ERROR;
-    MOCK_ARGS(
-        TEST_PROGRAM_NAME,
-        TEST_MESSAGE
-    )
+    char record_line[] = TEST_OPTION_RECORD_WAIT_LONG " " TEST_RECORD_WAIT " " TEST_MESSAGE;
+    assert_int_equal(flog_config_parse_line(config, record_line), FLOG_ERROR_LINE);
 
-    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    char filter_line[] = TEST_OPTION_EXCLUDE_LONG " " TEST_FILTER_LITERAL " " TEST_MESSAGE;
+    assert_int_equal(flog_config_parse_line(config, filter_line), FLOG_ERROR_LINE);
 
-    expect_assert_failure(flog_config_set_message_from_args(config, NULL));
+    char dedup_line[] = TEST_OPTION_DEDUP_LONG " " TEST_MESSAGE;
+    assert_int_equal(flog_config_parse_line(config, dedup_line), FLOG_ERROR_LINE);
+
+    char rate_limit_line[] = TEST_OPTION_RATE_LIMIT_LONG " " TEST_RATE_LIMIT " " TEST_MESSAGE;
+    assert_int_equal(flog_config_parse_line(config, rate_limit_line), FLOG_ERROR_LINE);
+
+    char sample_line[] = TEST_OPTION_SAMPLE_LONG " " TEST_SAMPLE_RATES " " TEST_MESSAGE;
+    assert_int_equal(flog_config_parse_line(config, sample_line), FLOG_ERROR_LINE);
+
+    char redact_line[] = TEST_OPTION_REDACT_LONG " all " TEST_MESSAGE;
+    assert_int_equal(flog_config_parse_line(config, redact_line), FLOG_ERROR_LINE);
+
+    char category_line[] = TEST_OPTION_CATEGORY_SHORT " " TEST_CATEGORY " " TEST_MESSAGE;
+    assert_int_equal(flog_config_parse_line(config, category_line), FLOG_ERROR_SUBSYS);
+
+    char level_line[] = TEST_OPTION_LEVEL_SHORT " " TEST_OPTION_LEVEL_VALUE_UNKNOWN " " TEST_MESSAGE;
+    assert_int_equal(flog_config_parse_line(config, level_line), FLOG_ERROR_LVL);
+
+    char empty_line[] = TEST_OPTION_LEVEL_SHORT " " TEST_OPTION_LEVEL_VALUE_INFO;
+    assert_int_equal(flog_config_parse_line(config, empty_line), FLOG_ERROR_MSG);
 
     flog_config_free(config);
+    flog_config_free(defaults);
 }
 
 static void
-flog_config_set_and_get_message_from_args_succeeds(void **state) {
+flog_config_new_from_options_with_null_options_arg_fails(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
-    MOCK_ARGS(
-        TEST_PROGRAM_NAME,
-        TEST_MESSAGE
-    )
+    expect_assert_failure(flog_config_new_from_options(NULL, &error));
+}
 
-    const char *mock_args[] = {
-        "abc",
-        "def",
-        "123",
-        "456",
-        NULL
-    };
+static void
+flog_config_new_from_options_succeeds(void **state) {
+    UNUSED(state);
 
-    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    FlogError error = TEST_ERROR;
+    FlogConfig *config = flog_config_new_from_options("-p -s " TEST_SUBSYSTEM " -a '" TEST_OUTPUT_FILE "'", &error);
 
-    flog_config_set_message_from_args(config, mock_args);
-    assert_string_equal(flog_config_get_message(config), "abc def 123 456");
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_message_type(config), MSG_PRIVATE);
+    assert_string_equal(flog_config_get_subsystem(config), TEST_SUBSYSTEM);
+    assert_string_equal(flog_config_get_output_file(config), TEST_OUTPUT_FILE);
+    assert_string_equal(flog_config_get_message(config), "");
+
+    flog_config_free(config);
+
+    config = flog_config_new_from_options("", &error);
+
+    assert_non_null(config);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_config_get_level(config), LVL_DEFAULT);
 
     flog_config_free(config);
 }
 
 static void
-flog_config_set_message_from_args_with_long_message_truncates(void **state) {
+flog_config_new_from_options_with_invalid_options_fails(void **state) {
     UNUSED(state);
 
     FlogError error = TEST_ERROR;
-    MOCK_ARGS(
-        TEST_PROGRAM_NAME,
-        TEST_MESSAGE
-    )
-
-    char *message = malloc(MESSAGE_LEN + 1);
-    memset(message, TEST_CHAR, MESSAGE_LEN);
-    message[MESSAGE_LEN] = '\0';
 
-    const char *mock_args[] = {
-        message,
-        NULL
-    };
+    assert_null(flog_config_new_from_options("'" TEST_SUBSYSTEM, &error));
+    assert_int_equal(error, FLOG_ERROR_OPTS);
 
-    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_null(flog_config_new_from_options("-c " TEST_CATEGORY, &error));
+    assert_int_equal(error, FLOG_ERROR_SUBSYS);
 
-    flog_config_set_message_from_args(config, mock_args);
-    assert_int_equal(strlen(flog_config_get_message(config)), MESSAGE_LEN - 1);
+    assert_null(flog_config_new_from_options("-l " TEST_OPTION_LEVEL_VALUE_UNKNOWN, &error));
+    assert_int_equal(error, FLOG_ERROR_LVL);
+}
 
-    flog_config_free(config);
-    free(message);
+static void
+flog_config_parse_level_with_null_str_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_config_parse_level(NULL));
 }
 
 static void
-flog_config_set_message_from_args_truncates_when_appending_space(void **state) {
+flog_config_parse_level_succeeds(void **state) {
     UNUSED(state);
 
-    FlogError error = TEST_ERROR;
-    MOCK_ARGS(
-        TEST_PROGRAM_NAME,
-        TEST_MESSAGE
-    )
+    assert_int_equal(flog_config_parse_level(TEST_OPTION_LEVEL_VALUE_DEFAULT), LVL_DEFAULT);
+    assert_int_equal(flog_config_parse_level(TEST_OPTION_LEVEL_VALUE_INFO), LVL_INFO);
+    assert_int_equal(flog_config_parse_level(TEST_OPTION_LEVEL_VALUE_DEBUG), LVL_DEBUG);
+    assert_int_equal(flog_config_parse_level(TEST_OPTION_LEVEL_VALUE_ERROR), LVL_ERROR);
+    assert_int_equal(flog_config_parse_level(TEST_OPTION_LEVEL_VALUE_FAULT), LVL_FAULT);
+    assert_int_equal(flog_config_parse_level(TEST_OPTION_LEVEL_VALUE_UNKNOWN), LVL_UNKNOWN);
+}
 
-    char *message = malloc(MESSAGE_LEN);
-    memset(message, TEST_CHAR, MESSAGE_LEN);
-    message[MESSAGE_LEN - 1] = '\0';
+static void
+flog_config_level_string_succeeds(void **state) {
+    UNUSED(state);
 
-    const char *mock_args[] = {
-        message,
-        "abcdef123456",
-        NULL
-    };
+    assert_string_equal(flog_config_level_string(LVL_DEFAULT), TEST_OPTION_LEVEL_VALUE_DEFAULT);
+    assert_string_equal(flog_config_level_string(LVL_INFO), TEST_OPTION_LEVEL_VALUE_INFO);
+    assert_string_equal(flog_config_level_string(LVL_DEBUG), TEST_OPTION_LEVEL_VALUE_DEBUG);
+    assert_string_equal(flog_config_level_string(LVL_ERROR), TEST_OPTION_LEVEL_VALUE_ERROR);
+    assert_string_equal(flog_config_level_string(LVL_FAULT), TEST_OPTION_LEVEL_VALUE_FAULT);
+    assert_string_equal(flog_config_level_string(LVL_UNKNOWN), TEST_OPTION_LEVEL_VALUE_UNKNOWN);
+}
 
-    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+static void
+flog_config_parse_prefix_with_null_str_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_config_parse_prefix(NULL));
+}
 
-    flog_config_set_message_from_args(config, mock_args);
-    assert_int_equal(strlen(flog_config_get_message(config)), MESSAGE_LEN - 1);
+static void
+flog_config_parse_prefix_succeeds(void **state) {
+    UNUSED(state);
 
-    flog_config_free(config);
-    free(message);
+    assert_int_equal(flog_config_parse_prefix("pid"), PFX_PID);
+    assert_int_equal(flog_config_parse_prefix("category,subsystem"), PFX_SUBSYSTEM | PFX_CATEGORY);
+    assert_int_equal(flog_config_parse_prefix("time,time"), PFX_TIME);
+    assert_int_equal(flog_config_parse_prefix(""), PFX_UNKNOWN);
+    assert_int_equal(flog_config_parse_prefix("time,"), PFX_UNKNOWN);
+    assert_int_equal(flog_config_parse_prefix("timestamp"), PFX_UNKNOWN);
 }
 
 int main(void) {
@@ -1493,6 +3385,10 @@ int main(void) {
         cmocka_unit_test(flog_config_new_with_long_level_opt_and_unknown_value_fails),
         cmocka_unit_test(flog_config_new_with_short_append_opt_and_long_path_fails),
         cmocka_unit_test(flog_config_new_with_long_append_opt_and_long_path_fails),
+        cmocka_unit_test(flog_config_new_with_short_format_opt_and_unknown_value_fails),
+        cmocka_unit_test(flog_config_new_with_long_format_opt_and_unknown_value_fails),
+        cmocka_unit_test(flog_config_new_with_short_writer_opt_and_unknown_value_fails),
+        cmocka_unit_test(flog_config_new_with_short_prefix_opt_and_unknown_value_fails),
         cmocka_unit_test(flog_config_new_with_message_from_unsupported_stream_fails),
 
         // flog_config_new() success tests
@@ -1513,12 +3409,84 @@ int main(void) {
         cmocka_unit_test(flog_config_new_with_long_level_opt_and_fault_value_succeeds),
         cmocka_unit_test(flog_config_new_with_long_private_opt_and_message_succeeds),
         cmocka_unit_test(flog_config_new_with_long_append_opt_and_path_succeeds),
+        cmocka_unit_test(flog_config_new_with_short_format_opt_and_text_value_succeeds),
+        cmocka_unit_test(flog_config_new_with_short_format_opt_and_binary_value_succeeds),
+        cmocka_unit_test(flog_config_new_with_long_format_opt_and_binary_value_succeeds),
+        cmocka_unit_test(flog_config_new_with_long_format_opt_and_json_value_succeeds),
+        cmocka_unit_test(flog_config_new_with_short_writer_opt_and_async_value_succeeds),
+        cmocka_unit_test(flog_config_new_with_long_writer_opt_and_sync_value_succeeds),
+        cmocka_unit_test(flog_config_new_with_long_fdatasync_opt_succeeds),
+        cmocka_unit_test(flog_config_new_with_short_checksum_opt_succeeds),
+        cmocka_unit_test(flog_config_new_with_long_checksum_opt_succeeds),
+        cmocka_unit_test(flog_config_new_with_short_prefix_opt_succeeds),
+        cmocka_unit_test(flog_config_new_with_long_prefix_opt_succeeds),
+        cmocka_unit_test(flog_config_new_with_multiple_append_opts_succeeds),
+        cmocka_unit_test(flog_config_new_with_stats_opt_succeeds),
         cmocka_unit_test(flog_config_new_with_message_from_pipe_stream_succeeds),
         cmocka_unit_test(flog_config_new_with_message_from_regular_file_stream_succeeds),
+        cmocka_unit_test(flog_config_new_with_long_level_opt_and_attached_value_succeeds),
+        cmocka_unit_test(flog_config_new_with_opts_after_message_succeeds),
+        cmocka_unit_test(flog_config_new_with_clustered_short_opts_succeeds),
+        cmocka_unit_test(flog_config_new_with_end_of_opts_marker_succeeds),
+        cmocka_unit_test(flog_config_new_with_missing_opt_value_fails),
         cmocka_unit_test(flog_config_new_with_short_version_opt_succeeds),
         cmocka_unit_test(flog_config_new_with_long_version_opt_succeeds),
         cmocka_unit_test(flog_config_new_with_short_help_opt_succeeds),
         cmocka_unit_test(flog_config_new_with_long_help_opt_succeeds),
+        cmocka_unit_test(flog_config_new_with_batch_opt_succeeds),
+        cmocka_unit_test(flog_config_new_with_batch_opt_and_stdin_value_succeeds),
+        cmocka_unit_test(flog_config_new_with_batch_opt_and_message_fails),
+        cmocka_unit_test(flog_config_new_with_serve_opt_succeeds),
+        cmocka_unit_test(flog_config_new_with_serve_opt_and_batch_opt_fails),
+        cmocka_unit_test(flog_config_new_with_exec_opt_succeeds),
+        cmocka_unit_test(flog_config_new_with_exec_opt_and_no_command_fails),
+        cmocka_unit_test(flog_config_new_with_exec_opt_and_serve_opt_fails),
+        cmocka_unit_test(flog_config_new_with_tee_opt_succeeds),
+        cmocka_unit_test(flog_config_new_with_splice_opt_sets_tee_flag),
+        cmocka_unit_test(flog_config_new_with_tee_opt_and_no_append_opt_fails),
+        cmocka_unit_test(flog_config_new_with_tee_opt_and_prefix_opt_fails),
+        cmocka_unit_test(flog_config_new_with_tee_opt_and_checksum_opt_fails),
+        cmocka_unit_test(flog_config_new_with_tee_opt_and_message_fails),
+        cmocka_unit_test(flog_config_new_with_tee_opt_and_exec_opt_fails),
+        cmocka_unit_test(flog_config_new_with_multiline_opt_succeeds),
+        cmocka_unit_test(flog_config_new_with_record_opts_succeeds),
+        cmocka_unit_test(flog_config_new_with_multiline_opt_and_exec_opt_succeeds),
+        cmocka_unit_test(flog_config_new_with_record_max_too_long_fails),
+        cmocka_unit_test(flog_config_new_with_invalid_record_wait_fails),
+        cmocka_unit_test(flog_config_new_with_multiline_opt_and_batch_opt_fails),
+        cmocka_unit_test(flog_config_new_with_multiline_opt_and_message_fails),
+        cmocka_unit_test(flog_config_new_with_filter_opts_succeeds),
+        cmocka_unit_test(flog_config_new_with_invalid_filter_opt_fails),
+        cmocka_unit_test(flog_config_new_with_empty_filter_opt_fails),
+        cmocka_unit_test(flog_config_add_filter_beyond_limit_fails),
+        cmocka_unit_test(flog_config_new_with_dedup_opt_succeeds),
+        cmocka_unit_test(flog_config_new_with_dedup_wait_opt_succeeds),
+        cmocka_unit_test(flog_config_new_with_invalid_dedup_wait_fails),
+        cmocka_unit_test(flog_config_new_with_rate_limit_opts_succeeds),
+        cmocka_unit_test(flog_config_add_rate_limit_with_invalid_rules_fails),
+        cmocka_unit_test(flog_config_add_filters_and_rate_limits_keeps_each_entry),
+        cmocka_unit_test(flog_config_new_with_invalid_rate_limit_opt_fails),
+        cmocka_unit_test(flog_config_new_with_sample_opts_succeeds),
+        cmocka_unit_test(flog_config_set_sample_rates_with_invalid_rates_fails),
+        cmocka_unit_test(flog_config_new_with_invalid_sample_opt_fails),
+        cmocka_unit_test(flog_config_new_with_redact_opts_succeeds),
+        cmocka_unit_test(flog_config_new_with_invalid_redact_opt_fails),
+        cmocka_unit_test(flog_config_parse_redact_succeeds),
+        cmocka_unit_test(flog_config_new_with_fields_opt_succeeds),
+        cmocka_unit_test(flog_config_new_with_invalid_fields_opt_fails),
+
+        // flog_config_new_with_defaults() and flog_config_parse_line() precondition tests
+        cmocka_unit_test(flog_config_new_with_defaults_with_null_defaults_arg_fails),
+        cmocka_unit_test(flog_config_parse_line_with_null_line_arg_fails),
+
+        // flog_config_parse_line() tests
+        cmocka_unit_test(flog_config_parse_line_succeeds),
+        cmocka_unit_test(flog_config_parse_line_with_invalid_lines_fails),
+
+        // flog_config_new_from_options() tests
+        cmocka_unit_test(flog_config_new_from_options_with_null_options_arg_fails),
+        cmocka_unit_test(flog_config_new_from_options_succeeds),
+        cmocka_unit_test(flog_config_new_from_options_with_invalid_options_fails),
 
         // flog_config_set_subsystem() and flog_config_get_subsystem() precondition tests
         cmocka_unit_test(flog_config_get_subsystem_with_null_config_arg_fails),
@@ -1528,6 +3496,7 @@ int main(void) {
         // flog_config_set_subsystem() and flog_config_get_subsystem() success tests
         cmocka_unit_test(flog_config_get_subsystem_succeeds),
         cmocka_unit_test(flog_config_set_and_get_subsystem_succeeds),
+        cmocka_unit_test(flog_config_set_subsystem_again_keeps_previous_value_succeeds),
 
         // flog_config_set_subsystem() truncation tests
         cmocka_unit_test(flog_config_set_subsystem_with_long_subsystem_truncates),
@@ -1555,6 +3524,8 @@ int main(void) {
 
         // flog_config_set_output_file() failure tests
         cmocka_unit_test(flog_config_set_output_file_with_long_path_fails),
+        cmocka_unit_test(flog_config_add_output_file_beyond_limit_fails),
+        cmocka_unit_test(flog_config_get_output_file_at_with_invalid_index_fails),
 
         // flog_config_set_message() and flog_config_get_message() precondition tests
         cmocka_unit_test(flog_config_set_message_with_null_config_arg_fails),
@@ -1564,6 +3535,7 @@ int main(void) {
         // flog_config_set_message() and flog_config_get_message() success tests
         cmocka_unit_test(flog_config_get_message_succeeds),
         cmocka_unit_test(flog_config_set_and_get_message_succeeds),
+        cmocka_unit_test(flog_config_set_and_get_messages_larger_than_arena_succeeds),
 
         // flog_config_set_message() truncation tests
         cmocka_unit_test(flog_config_set_message_with_long_message_truncates),
@@ -1585,6 +3557,14 @@ int main(void) {
 
         // flog_config_set_message_from_stream() truncation tests
         cmocka_unit_test(flog_config_set_message_from_stream_with_long_message_truncates),
+        cmocka_unit_test(flog_config_set_message_from_stream_sanitizes_message),
+
+        // flog_config_sanitize_message() precondition tests
+        cmocka_unit_test(flog_config_sanitize_message_with_null_config_arg_fails),
+
+        // flog_config_sanitize_message() success tests
+        cmocka_unit_test(flog_config_sanitize_message_leaves_valid_message),
+        cmocka_unit_test(flog_config_sanitize_message_replaces_invalid_sequences),
 
         // flog_config_set_message_from_args() precondition tests
         cmocka_unit_test(flog_config_set_message_from_args_with_null_config_arg_fails),
@@ -1595,8 +3575,30 @@ int main(void) {
 
         // flog_config_set_message_from_args() truncation tests
         cmocka_unit_test(flog_config_set_message_from_args_with_long_message_truncates),
-        cmocka_unit_test(flog_config_set_message_from_args_truncates_when_appending_space)
+        cmocka_unit_test(flog_config_set_message_from_args_truncates_when_appending_space),
+
+        // flog_config_set_format() and flog_config_get_format() precondition tests
+        cmocka_unit_test(flog_config_get_format_with_null_config_arg_fails),
+        cmocka_unit_test(flog_config_set_format_with_null_config_arg_fails),
+
+        // flog_config_set_format() and flog_config_get_format() success tests
+        cmocka_unit_test(flog_config_get_format_succeeds),
+        cmocka_unit_test(flog_config_set_and_get_format_succeeds),
+
+        // flog_config_parse_level() and flog_config_level_string() tests
+        cmocka_unit_test(flog_config_parse_level_with_null_str_arg_fails),
+        cmocka_unit_test(flog_config_parse_level_succeeds),
+        cmocka_unit_test(flog_config_level_string_succeeds),
+
+        // flog_config_parse_prefix() tests
+        cmocka_unit_test(flog_config_parse_prefix_with_null_str_arg_fails),
+        cmocka_unit_test(flog_config_parse_prefix_succeeds)
     };
 
-    return cmocka_run_group_tests_name("FlogConfig tests", tests, NULL, NULL);
+    // Argument parsing tests are run against both the fast parser and popt, which
+    // must produce identical results
+    int failed = cmocka_run_group_tests_name("FlogConfig tests (fast parser)", tests, use_fast_parser, NULL);
+    failed += cmocka_run_group_tests_name("FlogConfig tests (popt parser)", tests, use_popt_parser, NULL);
+
+    return failed;
 }
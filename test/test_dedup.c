@@ -0,0 +1,264 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "dedup.h"
+#include "config.h"
+#include "common.h"
+
+#define TEST_WAIT 1000
+#define TEST_SUBSYSTEM "uk.co.fidgetbox.test"
+#define TEST_CATEGORY "category"
+#define TEST_MESSAGE "connection refused"
+
+#define UNUSED(x) (void)(x)
+
+extern bool fail_calloc;
+
+static int
+enable_calloc_failure(void **state) {
+    UNUSED(state);
+    fail_calloc = true;
+    return 0;
+}
+
+static int
+disable_calloc_failure(void **state) {
+    UNUSED(state);
+    fail_calloc = false;
+    return 0;
+}
+
+static void
+flog_dedup_new_with_negative_wait_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    expect_assert_failure(flog_dedup_new(-1, &error));
+}
+
+static void
+flog_dedup_new_with_null_error_arg_fails(void **state) {
+    UNUSED(state);
+
+    expect_assert_failure(flog_dedup_new(TEST_WAIT, NULL));
+}
+
+static void
+flog_dedup_new_with_calloc_failure_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogDedup *dedup = flog_dedup_new(TEST_WAIT, &error);
+
+    assert_null(dedup);
+    assert_int_equal(error, FLOG_ERROR_ALLOC);
+}
+
+static void
+flog_dedup_free_with_null_dedup_arg_fails(void **state) {
+    UNUSED(state);
+
+    expect_assert_failure(flog_dedup_free(NULL));
+}
+
+static void
+flog_dedup_is_repeat_with_null_message_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogDedup *dedup = flog_dedup_new(TEST_WAIT, &error);
+    assert_non_null(dedup);
+
+    expect_assert_failure(flog_dedup_is_repeat(dedup, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEFAULT, NULL, 0));
+
+    flog_dedup_free(dedup);
+}
+
+static void
+flog_dedup_is_repeat_counts_repeats(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogDedup *dedup = flog_dedup_new(TEST_WAIT, &error);
+    assert_non_null(dedup);
+
+    FlogDedupSummary summary;
+
+    assert_false(flog_dedup_is_repeat(dedup, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_ERROR, TEST_MESSAGE, 0));
+    assert_int_equal(flog_dedup_get_timeout(dedup, 0), -1);
+
+    assert_true(flog_dedup_is_repeat(dedup, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_ERROR, TEST_MESSAGE, 10));
+    assert_true(flog_dedup_is_repeat(dedup, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_ERROR, TEST_MESSAGE, 20));
+    assert_false(flog_dedup_next_summary(dedup, 20, &summary));
+    assert_int_equal(flog_dedup_get_timeout(dedup, 20), TEST_WAIT - 10);
+
+    // A different message makes the count due before it is logged
+    assert_false(flog_dedup_is_repeat(dedup, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_ERROR, "connection reset", 30));
+    assert_int_equal(flog_dedup_get_timeout(dedup, 30), 0);
+    assert_true(flog_dedup_next_summary(dedup, 30, &summary));
+    assert_string_equal(summary.subsystem, TEST_SUBSYSTEM);
+    assert_string_equal(summary.category, TEST_CATEGORY);
+    assert_int_equal(summary.level, LVL_ERROR);
+    assert_int_equal(summary.count, 2);
+
+    assert_false(flog_dedup_next_summary(dedup, INT64_MAX, &summary));
+    assert_int_equal(flog_dedup_get_timeout(dedup, 30), -1);
+
+    flog_dedup_free(dedup);
+}
+
+static void
+flog_dedup_is_repeat_compares_whole_message(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogDedup *dedup = flog_dedup_new(TEST_WAIT, &error);
+    assert_non_null(dedup);
+
+    // Messages differing only in a trailing byte, or in length, are not repeats
+    const char *messages[] = { "0123456789abcdef", "0123456789abcdeg", "0123456789abcdeg0", "0123456789abcdeg00",
+                               "0123456789abcdeg0", "" };
+    for (size_t i = 0; i < sizeof(messages) / sizeof(messages[0]); i++) {
+        assert_false(flog_dedup_is_repeat(dedup, TEST_SUBSYSTEM, "", LVL_DEFAULT, messages[i], 0));
+    }
+
+    assert_true(flog_dedup_is_repeat(dedup, TEST_SUBSYSTEM, "", LVL_DEFAULT, "", 0));
+
+    flog_dedup_free(dedup);
+}
+
+static void
+flog_dedup_is_repeat_tracks_groups_separately(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogDedup *dedup = flog_dedup_new(TEST_WAIT, &error);
+    assert_non_null(dedup);
+
+    // Interleaved output and error lines repeat within their own level
+    for (int i = 0; i < 3; i++) {
+        assert_int_equal(flog_dedup_is_repeat(dedup, "", "", LVL_DEFAULT, "tick", 0), i > 0);
+        assert_int_equal(flog_dedup_is_repeat(dedup, "", "", LVL_ERROR, "tick", 0), i > 0);
+        assert_int_equal(flog_dedup_is_repeat(dedup, TEST_SUBSYSTEM, "", LVL_ERROR, "tick", 0), i > 0);
+    }
+
+    FlogDedupSummary summary;
+    size_t summary_count = 0;
+    while (flog_dedup_next_summary(dedup, INT64_MAX, &summary)) {
+        assert_int_equal(summary.count, 2);
+        summary_count++;
+    }
+
+    assert_int_equal(summary_count, 3);
+
+    flog_dedup_free(dedup);
+}
+
+static void
+flog_dedup_next_summary_after_wait_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogDedup *dedup = flog_dedup_new(TEST_WAIT, &error);
+    assert_non_null(dedup);
+
+    FlogDedupSummary summary;
+
+    assert_false(flog_dedup_is_repeat(dedup, "", "", LVL_DEFAULT, TEST_MESSAGE, 0));
+    assert_true(flog_dedup_is_repeat(dedup, "", "", LVL_DEFAULT, TEST_MESSAGE, 100));
+    assert_false(flog_dedup_next_summary(dedup, 100 + TEST_WAIT - 1, &summary));
+    assert_true(flog_dedup_next_summary(dedup, 100 + TEST_WAIT, &summary));
+    assert_int_equal(summary.count, 1);
+
+    // Repeats continue to be suppressed, and are counted again from the next
+    assert_true(flog_dedup_is_repeat(dedup, "", "", LVL_DEFAULT, TEST_MESSAGE, 2000));
+    assert_int_equal(flog_dedup_get_timeout(dedup, 2000), TEST_WAIT);
+    assert_true(flog_dedup_next_summary(dedup, INT64_MAX, &summary));
+    assert_int_equal(summary.count, 1);
+
+    flog_dedup_free(dedup);
+}
+
+static void
+flog_dedup_is_repeat_replaces_least_recent_group(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogDedup *dedup = flog_dedup_new(TEST_WAIT, &error);
+    assert_non_null(dedup);
+
+    FlogDedupSummary summary;
+    char category[CATEGORY_LEN];
+
+    for (int i = 0; i < DEDUP_GROUP_MAX; i++) {
+        snprintf(category, sizeof(category), "category%d", i);
+        assert_false(flog_dedup_is_repeat(dedup, TEST_SUBSYSTEM, category, LVL_DEFAULT, TEST_MESSAGE, 0));
+    }
+
+    // The first group is repeated, then every other group is used more recently
+    assert_true(flog_dedup_is_repeat(dedup, TEST_SUBSYSTEM, "category0", LVL_DEFAULT, TEST_MESSAGE, 0));
+    for (int i = 1; i < DEDUP_GROUP_MAX; i++) {
+        snprintf(category, sizeof(category), "category%d", i);
+        assert_true(flog_dedup_is_repeat(dedup, TEST_SUBSYSTEM, category, LVL_DEFAULT, TEST_MESSAGE, 0));
+    }
+
+    assert_false(flog_dedup_is_repeat(dedup, TEST_SUBSYSTEM, "new", LVL_DEFAULT, TEST_MESSAGE, 0));
+    assert_true(flog_dedup_next_summary(dedup, 0, &summary));
+    assert_string_equal(summary.category, "category0");
+    assert_int_equal(summary.count, 1);
+
+    // The replaced group is tracked afresh
+    assert_false(flog_dedup_is_repeat(dedup, TEST_SUBSYSTEM, "category0", LVL_DEFAULT, TEST_MESSAGE, 0));
+
+    flog_dedup_free(dedup);
+}
+
+int main(void) {
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+
+    const struct CMUnitTest tests[] = {
+        // flog_dedup_new() and flog_dedup_free() failure tests
+        cmocka_unit_test(flog_dedup_new_with_negative_wait_arg_fails),
+        cmocka_unit_test(flog_dedup_new_with_null_error_arg_fails),
+        cmocka_unit_test_setup_teardown(flog_dedup_new_with_calloc_failure_fails, enable_calloc_failure, disable_calloc_failure),
+        cmocka_unit_test(flog_dedup_free_with_null_dedup_arg_fails),
+
+        // flog_dedup_is_repeat() and flog_dedup_next_summary() tests
+        cmocka_unit_test(flog_dedup_is_repeat_with_null_message_arg_fails),
+        cmocka_unit_test(flog_dedup_is_repeat_counts_repeats),
+        cmocka_unit_test(flog_dedup_is_repeat_compares_whole_message),
+        cmocka_unit_test(flog_dedup_is_repeat_tracks_groups_separately),
+        cmocka_unit_test(flog_dedup_next_summary_after_wait_succeeds),
+        cmocka_unit_test(flog_dedup_is_repeat_replaces_least_recent_group),
+    };
+
+    return cmocka_run_group_tests_name("FlogDedup tests", tests, NULL, NULL);
+}
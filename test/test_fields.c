@@ -0,0 +1,330 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdbool.h>
+#include "fields.h"
+
+#define TEST_VALUE_LEN 64
+
+#define UNUSED(x) (void)(x)
+
+static void
+assert_field(const FlogFields *fields, size_t index, const char *key, const char *value) {
+    assert_true(index < fields->count);
+
+    const FlogField *field = &fields->fields[index];
+    assert_int_equal(field->key_len, strlen(key));
+    assert_memory_equal(field->key, key, field->key_len);
+
+    char buf[TEST_VALUE_LEN];
+    flog_fields_copy_value(field, buf, sizeof(buf));
+    assert_string_equal(buf, value);
+}
+
+static void
+flog_fields_parse_with_null_message_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogFields fields;
+    expect_assert_failure(flog_fields_parse(&fields, FLD_LOGFMT, NULL));
+}
+
+static void
+flog_fields_parse_logfmt_succeeds(void **state) {
+    UNUSED(state);
+
+    const char *message = "level=warn msg=\"disk \\\"full\\\"\" path=/var/log retry  free= ok=a=b";
+    FlogFields fields;
+
+    assert_true(flog_fields_parse(&fields, FLD_LOGFMT, message));
+    assert_int_equal(fields.count, 6);
+    assert_field(&fields, 0, "level", "warn");
+    assert_field(&fields, 1, "msg", "disk \"full\"");
+    assert_field(&fields, 2, "path", "/var/log");
+    assert_field(&fields, 3, "retry", "");
+    assert_null(fields.fields[3].value);
+    assert_field(&fields, 4, "free", "");
+    assert_non_null(fields.fields[4].value);
+    assert_field(&fields, 5, "ok", "a=b");
+
+    // Fields refer to the message rather than to copies
+    assert_ptr_equal(fields.fields[2].value, strstr(message, "/var/log"));
+}
+
+static void
+flog_fields_parse_logfmt_with_invalid_message_fails(void **state) {
+    UNUSED(state);
+
+    const char *messages[] = { "", "   ", "plain text message", "=value", "msg=\"unterminated", "msg=\"a\"b",
+                               "key\"=1" };
+    FlogFields fields;
+
+    for (size_t i = 0; i < sizeof(messages) / sizeof(messages[0]); i++) {
+        assert_false(flog_fields_parse(&fields, FLD_LOGFMT, messages[i]));
+    }
+}
+
+static void
+flog_fields_parse_json_succeeds(void **state) {
+    UNUSED(state);
+
+    const char *message = " {\"level\": \"error\", \"msg\":\"caf\\u00e9 \\ud83d\\ude00\\n\",\"count\":-1.5e3,"
+                          "\"ok\":true, \"tags\":[\"a\", {\"b\": \"]\"}], \"none\":null} ";
+    FlogFields fields;
+
+    assert_true(flog_fields_parse(&fields, FLD_JSON, message));
+    assert_int_equal(fields.count, 6);
+    assert_field(&fields, 0, "level", "error");
+    assert_field(&fields, 1, "msg", "caf\xc3\xa9 \xf0\x9f\x98\x80\n");
+    assert_field(&fields, 2, "count", "-1.5e3");
+    assert_field(&fields, 3, "ok", "true");
+    assert_field(&fields, 4, "tags", "[\"a\", {\"b\": \"]\"}]");
+    assert_field(&fields, 5, "none", "null");
+    assert_true(fields.fields[1].quoted);
+    assert_false(fields.fields[2].quoted);
+
+    assert_true(flog_fields_parse(&fields, FLD_JSON, "{}"));
+    assert_int_equal(fields.count, 0);
+}
+
+static void
+flog_fields_parse_json_with_invalid_message_fails(void **state) {
+    UNUSED(state);
+
+    const char *messages[] = { "", "[1, 2]", "{", "{\"a\":1", "{\"a\" 1}", "{\"a\":}", "{\"a\":1,}", "{\"a\":1} x",
+                               "{a:1}", "{\"a\":\"b}", "{\"a\":[1, 2}" };
+    FlogFields fields;
+
+    for (size_t i = 0; i < sizeof(messages) / sizeof(messages[0]); i++) {
+        assert_false(flog_fields_parse(&fields, FLD_JSON, messages[i]));
+    }
+
+    // Messages with more fields than the table holds are not parsed
+    char message[FIELDS_MAX * 8] = "";
+    for (int i = 0; i <= FIELDS_MAX; i++) {
+        snprintf(message + strlen(message), sizeof(message) - strlen(message), "k%d=v ", i);
+    }
+    assert_false(flog_fields_parse(&fields, FLD_LOGFMT, message));
+}
+
+static void
+flog_fields_find_skips_taken_fields(void **state) {
+    UNUSED(state);
+
+    const char *keys[] = { "msg", "message", NULL };
+    FlogFields fields;
+    assert_true(flog_fields_parse(&fields, FLD_LOGFMT, "message=first msg=second msg=third"));
+
+    FlogField *field = flog_fields_find(&fields, keys);
+    assert_ptr_equal(field, &fields.fields[1]);
+    field->taken = true;
+
+    assert_ptr_equal(flog_fields_find(&fields, keys), &fields.fields[2]);
+    fields.fields[2].taken = true;
+
+    assert_ptr_equal(flog_fields_find(&fields, keys), &fields.fields[0]);
+    fields.fields[0].taken = true;
+
+    assert_null(flog_fields_find(&fields, keys));
+}
+
+static void
+flog_fields_copy_value_truncates_at_character_boundary(void **state) {
+    UNUSED(state);
+
+    FlogFields fields;
+    assert_true(flog_fields_parse(&fields, FLD_JSON, "{\"a\": \"\xc3\xa9\xc3\xa9\\u00e9\"}"));
+
+    char buf[5];
+    assert_int_equal(flog_fields_copy_value(&fields.fields[0], buf, sizeof(buf)), 4);
+    assert_string_equal(buf, "\xc3\xa9\xc3\xa9");
+
+    assert_int_equal(flog_fields_copy_value(&fields.fields[0], buf, 4), 2);
+    assert_string_equal(buf, "\xc3\xa9");
+}
+
+static void
+flog_fields_copy_text_escapes_control_characters(void **state) {
+    UNUSED(state);
+
+    FlogFields fields;
+    assert_true(flog_fields_parse(&fields, FLD_JSON, "{\"msg\": \"\\u001b[2Jhi\\nthere\\t\xc3\xa9\"}"));
+
+    char buf[32];
+    assert_int_equal(flog_fields_copy_text(&fields.fields[0], buf, sizeof(buf)), 21);
+    assert_string_equal(buf, "\\x1b[2Jhi\\x0athere\t\xc3\xa9");
+
+    // An escape or character that does not fit is left out whole
+    assert_int_equal(flog_fields_copy_text(&fields.fields[0], buf, 3), 0);
+    assert_string_equal(buf, "");
+
+    assert_int_equal(flog_fields_copy_text(&fields.fields[0], buf, 21), 19);
+    assert_string_equal(buf, "\\x1b[2Jhi\\x0athere\t");
+}
+
+static void
+flog_fields_render_appends_fields_left(void **state) {
+    UNUSED(state);
+
+    FlogFields fields;
+    const char *message = "{\"msg\": \"disk full\", \"path\": \"/var/a b\", \"free\": 0, \"note\": \"\", "
+                          "\"raw\": \"a\\tb\\\"\\u0001\", \"obj\": {\"k\": 1}}";
+    assert_true(flog_fields_parse(&fields, FLD_JSON, message));
+    fields.fields[0].taken = true;
+
+    char buf[TEST_VALUE_LEN * 2] = "disk full";
+    size_t len = flog_fields_render(&fields, buf, sizeof(buf), strlen(buf));
+
+    const char *expected = "disk full path=\"/var/a b\" free=0 note=\"\" raw=\"a\\tb\\\"\\u0001\" "
+                           "obj=\"{\\\"k\\\": 1}\"";
+    assert_string_equal(buf, expected);
+    assert_int_equal(len, strlen(expected));
+
+    // Fields that do not fit are left out whole
+    char small[24] = "disk full";
+    flog_fields_render(&fields, small, sizeof(small), strlen(small));
+    assert_string_equal(small, "disk full free=0");
+}
+
+static void
+flog_fields_parse_level_succeeds(void **state) {
+    UNUSED(state);
+
+    assert_int_equal(flog_fields_parse_level("info"), LVL_INFO);
+    assert_int_equal(flog_fields_parse_level("WARNING"), LVL_ERROR);
+    assert_int_equal(flog_fields_parse_level("Trace"), LVL_DEBUG);
+    assert_int_equal(flog_fields_parse_level("notice"), LVL_DEFAULT);
+    assert_int_equal(flog_fields_parse_level("critical"), LVL_FAULT);
+    assert_int_equal(flog_fields_parse_level("verbose"), LVL_UNKNOWN);
+    assert_int_equal(flog_fields_parse_level(""), LVL_UNKNOWN);
+}
+
+static void
+flog_fields_scan_plain_finds_first_special_byte(void **state) {
+    UNUSED(state);
+
+    // Every position of each kind of special byte, including those past the first word
+    const char specials[] = { '"', '\\', '\n', '\x01', '\x1f' };
+    char str[40];
+
+    for (size_t s = 0; s < sizeof(specials); s++) {
+        for (size_t i = 0; i < sizeof(str); i++) {
+            memset(str, 'a', sizeof(str));
+            str[i] = specials[s];
+            if (i + 1 < sizeof(str)) {
+                str[i + 1] = '"';
+            }
+            assert_int_equal(flog_fields_scan_plain(str, sizeof(str)), i);
+        }
+    }
+
+    // Bytes that are not special, including UTF-8 and the neighbours of special bytes
+    const char *plain = " !#[]\x7f\xc3\xa9\xe2\x82\xac{}~ plain text that runs for several words";
+    assert_int_equal(flog_fields_scan_plain(plain, strlen(plain)), strlen(plain));
+    assert_int_equal(flog_fields_scan_plain(plain, 3), 3);
+}
+
+static void
+flog_fields_append_quoted_escapes_strings(void **state) {
+    UNUSED(state);
+
+    const char *value = "tab\there \"quoted\" back\\slash \x01\x1f\b caf\xc3\xa9 and a plain tail";
+    const char *quoted = "\"tab\\there \\\"quoted\\\" back\\\\slash \\u0001\\u001f\\b caf\xc3\xa9 and a plain tail\"";
+
+    // Buffers with room for any value are written without checking each run, and
+    // others a run at a time, with the same result
+    char buf[TEST_VALUE_LEN * 8];
+    size_t len = 3;
+    assert_true(flog_fields_append_quoted(buf, sizeof(buf), &len, value, strlen(value)));
+    assert_int_equal(len, 3 + strlen(quoted));
+    assert_memory_equal(buf + 3, quoted, strlen(quoted));
+
+    len = 0;
+    assert_true(flog_fields_append_quoted(buf, strlen(quoted) + 1, &len, value, strlen(value)));
+    assert_int_equal(len, strlen(quoted));
+    assert_memory_equal(buf, quoted, strlen(quoted));
+
+    len = 0;
+    assert_false(flog_fields_append_quoted(buf, strlen(quoted), &len, value, strlen(value)));
+}
+
+static void
+flog_fields_append_quoted_replaces_invalid_utf8(void **state) {
+    UNUSED(state);
+
+    const char *value = "bad \xff byte, \"cut\" \xe2\x82\r short caf\xc3\xa9\x1b[0m";
+    const char *quoted = "\"bad \xef\xbf\xbd byte, \\\"cut\\\" \xef\xbf\xbd\\r short caf\xc3\xa9\\u001b[0m\"";
+
+    // Each invalid sequence is replaced once, however much room the buffer has
+    char buf[TEST_VALUE_LEN * 8];
+    size_t len = 0;
+    assert_true(flog_fields_append_quoted(buf, sizeof(buf), &len, value, strlen(value)));
+    assert_int_equal(len, strlen(quoted));
+    assert_memory_equal(buf, quoted, strlen(quoted));
+
+    len = 0;
+    assert_true(flog_fields_append_quoted(buf, strlen(quoted) + 1, &len, value, strlen(value)));
+    assert_int_equal(len, strlen(quoted));
+    assert_memory_equal(buf, quoted, strlen(quoted));
+}
+
+int main(void) {
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+
+    const struct CMUnitTest tests[] = {
+        // flog_fields_parse() tests
+        cmocka_unit_test(flog_fields_parse_with_null_message_arg_fails),
+        cmocka_unit_test(flog_fields_parse_logfmt_succeeds),
+        cmocka_unit_test(flog_fields_parse_logfmt_with_invalid_message_fails),
+        cmocka_unit_test(flog_fields_parse_json_succeeds),
+        cmocka_unit_test(flog_fields_parse_json_with_invalid_message_fails),
+
+        // flog_fields_find() tests
+        cmocka_unit_test(flog_fields_find_skips_taken_fields),
+
+        // flog_fields_copy_value() tests
+        cmocka_unit_test(flog_fields_copy_value_truncates_at_character_boundary),
+        cmocka_unit_test(flog_fields_copy_text_escapes_control_characters),
+
+        // flog_fields_render() tests
+        cmocka_unit_test(flog_fields_render_appends_fields_left),
+
+        // flog_fields_parse_level() tests
+        cmocka_unit_test(flog_fields_parse_level_succeeds),
+
+        // flog_fields_scan_plain() tests
+        cmocka_unit_test(flog_fields_scan_plain_finds_first_special_byte),
+
+        // flog_fields_append_quoted() tests
+        cmocka_unit_test(flog_fields_append_quoted_escapes_strings),
+        cmocka_unit_test(flog_fields_append_quoted_replaces_invalid_utf8),
+    };
+
+    return cmocka_run_group_tests_name("Fields function tests", tests, NULL, NULL);
+}
@@ -0,0 +1,236 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdbool.h>
+#include "filter.h"
+#include "config.h"
+#include "common.h"
+
+#define UNUSED(x) (void)(x)
+
+extern bool fail_calloc;
+
+static int
+enable_calloc_failure(void **state) {
+    UNUSED(state);
+    fail_calloc = true;
+    return 0;
+}
+
+static int
+disable_calloc_failure(void **state) {
+    UNUSED(state);
+    fail_calloc = false;
+    return 0;
+}
+
+static FlogFilter *
+new_filter(const char *options) {
+    FlogError error = FLOG_ERROR_NONE;
+    FlogConfig *config = flog_config_new_from_options(options, &error);
+    assert_non_null(config);
+
+    FlogFilter *filter = flog_filter_new(config, &error);
+    assert_non_null(filter);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+
+    // The filter keeps no references to the patterns held by the configuration
+    flog_config_free(config);
+
+    return filter;
+}
+
+static void
+flog_filter_new_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    expect_assert_failure(flog_filter_new(NULL, &error));
+}
+
+static void
+flog_filter_new_with_null_error_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogConfig *config = flog_config_new_from_options("--include error", &error);
+    assert_non_null(config);
+
+    expect_assert_failure(flog_filter_new(config, NULL));
+
+    flog_config_free(config);
+}
+
+static void
+flog_filter_new_with_calloc_failure_fails(void **state) {
+    UNUSED(state);
+
+    // The configuration is created before allocations are made to fail
+    disable_calloc_failure(NULL);
+    FlogError error = FLOG_ERROR_NONE;
+    FlogConfig *config = flog_config_new_from_options("--include error", &error);
+    assert_non_null(config);
+    enable_calloc_failure(NULL);
+
+    FlogFilter *filter = flog_filter_new(config, &error);
+    assert_null(filter);
+    assert_int_equal(error, FLOG_ERROR_ALLOC);
+
+    disable_calloc_failure(NULL);
+    flog_config_free(config);
+}
+
+static void
+flog_filter_free_with_null_filter_arg_fails(void **state) {
+    UNUSED(state);
+
+    expect_assert_failure(flog_filter_free(NULL));
+}
+
+static void
+flog_filter_accepts_with_null_message_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogFilter *filter = new_filter("--include error");
+    expect_assert_failure(flog_filter_accepts(filter, NULL));
+    flog_filter_free(filter);
+}
+
+static void
+flog_filter_accepts_without_patterns_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogFilter *filter = new_filter("");
+
+    assert_true(flog_filter_accepts(filter, "anything"));
+    assert_true(flog_filter_accepts(filter, ""));
+
+    flog_filter_free(filter);
+}
+
+static void
+flog_filter_accepts_with_include_literals_succeeds(void **state) {
+    UNUSED(state);
+
+    // Literals that overlap and share prefixes are all found, wherever they start
+    FlogFilter *filter = new_filter("--include he --include she --include his --include hers");
+
+    assert_true(flog_filter_accepts(filter, "ushers"));
+    assert_true(flog_filter_accepts(filter, "this"));
+    assert_true(flog_filter_accepts(filter, "ahishers"));
+    assert_true(flog_filter_accepts(filter, "she"));
+    assert_false(flog_filter_accepts(filter, "hi"));
+    assert_false(flog_filter_accepts(filter, "sh"));
+    assert_false(flog_filter_accepts(filter, ""));
+
+    flog_filter_free(filter);
+}
+
+static void
+flog_filter_accepts_with_exclude_literals_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogFilter *filter = new_filter("--exclude healthcheck --exclude 'GET /favicon\\.ico'");
+
+    assert_true(flog_filter_accepts(filter, "GET /index.html 200"));
+    assert_true(flog_filter_accepts(filter, "GET /faviconXico 404"));
+    assert_false(flog_filter_accepts(filter, "GET /healthcheck 200"));
+    assert_false(flog_filter_accepts(filter, "GET /favicon.ico 404"));
+
+    flog_filter_free(filter);
+}
+
+static void
+flog_filter_accepts_with_include_regexes_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogFilter *filter = new_filter("--include '^ERROR ' --include 'took [0-9]{4,} ms'");
+
+    assert_true(flog_filter_accepts(filter, "ERROR disk full"));
+    assert_true(flog_filter_accepts(filter, "INFO request took 1500 ms"));
+    assert_false(flog_filter_accepts(filter, "INFO request took 150 ms"));
+    assert_false(flog_filter_accepts(filter, "WARN ERROR in message"));
+
+    flog_filter_free(filter);
+}
+
+static void
+flog_filter_accepts_with_alternation_succeeds(void **state) {
+    UNUSED(state);
+
+    // An alternation within a pattern does not extend into the patterns joined with it
+    FlogFilter *filter = new_filter("--include '^a|b' --include 'c$'");
+
+    assert_true(flog_filter_accepts(filter, "a..."));
+    assert_true(flog_filter_accepts(filter, "..b..."));
+    assert_true(flog_filter_accepts(filter, "...c"));
+    assert_false(flog_filter_accepts(filter, "..a..."));
+    assert_false(flog_filter_accepts(filter, "...c."));
+
+    flog_filter_free(filter);
+}
+
+static void
+flog_filter_accepts_with_include_and_exclude_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogFilter *filter = new_filter("--include error --include '^WARN' --exclude 'retrying' --exclude 'attempt [12]/'");
+
+    assert_true(flog_filter_accepts(filter, "connection error"));
+    assert_true(flog_filter_accepts(filter, "WARN disk nearly full"));
+    assert_true(flog_filter_accepts(filter, "connection error, attempt 3/3"));
+    assert_false(flog_filter_accepts(filter, "connection error, retrying"));
+    assert_false(flog_filter_accepts(filter, "WARN timeout, attempt 1/3"));
+    assert_false(flog_filter_accepts(filter, "INFO started"));
+
+    flog_filter_free(filter);
+}
+
+int main(void) {
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+
+    const struct CMUnitTest tests[] = {
+        // flog_filter_new() and flog_filter_free() failure tests
+        cmocka_unit_test(flog_filter_new_with_null_config_arg_fails),
+        cmocka_unit_test(flog_filter_new_with_null_error_arg_fails),
+        cmocka_unit_test_teardown(flog_filter_new_with_calloc_failure_fails, disable_calloc_failure),
+        cmocka_unit_test(flog_filter_free_with_null_filter_arg_fails),
+
+        // flog_filter_accepts() tests
+        cmocka_unit_test(flog_filter_accepts_with_null_message_arg_fails),
+        cmocka_unit_test(flog_filter_accepts_without_patterns_succeeds),
+        cmocka_unit_test(flog_filter_accepts_with_include_literals_succeeds),
+        cmocka_unit_test(flog_filter_accepts_with_exclude_literals_succeeds),
+        cmocka_unit_test(flog_filter_accepts_with_include_regexes_succeeds),
+        cmocka_unit_test(flog_filter_accepts_with_alternation_succeeds),
+        cmocka_unit_test(flog_filter_accepts_with_include_and_exclude_succeeds),
+    };
+
+    return cmocka_run_group_tests_name("FlogFilter tests", tests, NULL, NULL);
+}
@@ -0,0 +1,1501 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include "flog.h"
+#include "binlog.h"
+#include "config.h"
+#include "common.h"
+#include "oslog.h"
+#include "sample.h"
+
+#define TEST_PROGRAM_NAME "flog"
+#define TEST_MESSAGE "test message"
+#define TEST_SUBSYSTEM "uk.co.fidgetbox.test"
+#define TEST_CATEGORY "category"
+#define TEST_PATH_TEMPLATE "/tmp/flog.XXXXXXXX"
+#define TEST_PATH_LEN 32
+#define TEST_LINE_LEN 64
+#define TEST_BUFFER_LEN 256
+
+#define MOCK_ARGS(...) \
+    char *mock_argv[] = {__VA_ARGS__, NULL}; \
+    int mock_argc = (sizeof(mock_argv) / sizeof(mock_argv[0]) - 1);
+
+#define UNUSED(x) (void)(x)
+
+extern bool fail_calloc;
+
+static int
+enable_calloc_failure(void **state) {
+    UNUSED(state);
+    fail_calloc = true;
+    return 0;
+}
+
+static int
+disable_calloc_failure(void **state) {
+    UNUSED(state);
+    fail_calloc = false;
+    return 0;
+}
+
+static int
+reset_events(void **state) {
+    UNUSED(state);
+    flog_oslog_reset();
+    return 0;
+}
+
+static void
+commit_and_verify_event(int argc, char *argv[], os_log_type_t type, bool redacted) {
+    FlogError error = FLOG_ERROR_NONE;
+    FlogConfig *config = flog_config_new(argc, argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+
+    flog_commit_message(flog);
+
+    assert_int_equal(flog_oslog_get_event_count(), 1);
+
+    const FlogOsLogEvent *event = flog_oslog_get_event(0);
+    assert_non_null(event);
+    assert_int_equal(event->type, type);
+    assert_int_equal(event->redacted, redacted);
+    assert_string_equal(event->subsystem, TEST_SUBSYSTEM);
+    assert_string_equal(event->category, TEST_CATEGORY);
+    assert_string_equal(event->message, TEST_MESSAGE);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+}
+
+static void
+flog_cli_new_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+
+    expect_assert_failure(flog_cli_new(NULL, &error));
+}
+
+static void
+flog_cli_new_with_calloc_failure_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    // Only allocations made by flog.c, the unit under test, fail
+    FlogCli *flog = flog_cli_new(config, &error);
+
+    assert_null(flog);
+    assert_int_equal(error, FLOG_ERROR_ALLOC);
+
+    flog_config_free(config);
+}
+
+static void
+flog_commit_message_with_default_level_succeeds(void **state) {
+    UNUSED(state);
+
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "-s", TEST_SUBSYSTEM,
+        "-c", TEST_CATEGORY,
+        TEST_MESSAGE
+    )
+
+    commit_and_verify_event(mock_argc, mock_argv, OS_LOG_TYPE_DEFAULT, false);
+}
+
+static void
+flog_commit_message_with_info_level_succeeds(void **state) {
+    UNUSED(state);
+
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "-l", "info",
+        "-s", TEST_SUBSYSTEM,
+        "-c", TEST_CATEGORY,
+        TEST_MESSAGE
+    )
+
+    commit_and_verify_event(mock_argc, mock_argv, OS_LOG_TYPE_INFO, false);
+}
+
+static void
+flog_commit_message_with_debug_level_succeeds(void **state) {
+    UNUSED(state);
+
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "-l", "debug",
+        "-s", TEST_SUBSYSTEM,
+        "-c", TEST_CATEGORY,
+        TEST_MESSAGE
+    )
+
+    commit_and_verify_event(mock_argc, mock_argv, OS_LOG_TYPE_DEBUG, false);
+}
+
+static void
+flog_commit_message_with_error_level_succeeds(void **state) {
+    UNUSED(state);
+
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "-l", "error",
+        "-s", TEST_SUBSYSTEM,
+        "-c", TEST_CATEGORY,
+        TEST_MESSAGE
+    )
+
+    commit_and_verify_event(mock_argc, mock_argv, OS_LOG_TYPE_ERROR, false);
+}
+
+static void
+flog_commit_message_with_fault_level_succeeds(void **state) {
+    UNUSED(state);
+
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "-l", "fault",
+        "-s", TEST_SUBSYSTEM,
+        "-c", TEST_CATEGORY,
+        TEST_MESSAGE
+    )
+
+    commit_and_verify_event(mock_argc, mock_argv, OS_LOG_TYPE_FAULT, false);
+}
+
+static void
+flog_commit_message_with_private_message_succeeds(void **state) {
+    UNUSED(state);
+
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "-p",
+        "-s", TEST_SUBSYSTEM,
+        "-c", TEST_CATEGORY,
+        TEST_MESSAGE
+    )
+
+    commit_and_verify_event(mock_argc, mock_argv, OS_LOG_TYPE_DEFAULT, true);
+}
+
+static void
+flog_commit_message_without_subsystem_uses_default_log(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    flog_commit_message(flog);
+
+    const FlogOsLogEvent *event = flog_oslog_get_event(0);
+    assert_non_null(event);
+    assert_string_equal(event->subsystem, "");
+    assert_string_equal(event->category, "");
+    assert_string_equal(event->message, TEST_MESSAGE);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+}
+
+static void
+flog_append_and_commit_message_succeeds(void **state) {
+    UNUSED(state);
+
+    char path[TEST_PATH_LEN] = TEST_PATH_TEMPLATE;
+    int fd = mkstemp(path);
+    assert_int_not_equal(fd, -1);
+    close(fd);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "-l", "error",
+        "-s", TEST_SUBSYSTEM,
+        "-c", TEST_CATEGORY,
+        "-a", path,
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    assert_int_equal(flog_append_message_output(flog), FLOG_ERROR_NONE);
+    flog_commit_message(flog);
+    assert_int_equal(flog_cli_flush(flog), FLOG_ERROR_NONE);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    FILE *file = fopen(path, "r");
+    assert_non_null(file);
+
+    char buffer[TEST_BUFFER_LEN];
+    assert_non_null(fgets(buffer, TEST_BUFFER_LEN, file));
+    assert_string_equal(buffer, TEST_MESSAGE "\n");
+
+    fclose(file);
+    unlink(path);
+
+    const FlogOsLogEvent *event = flog_oslog_get_event(0);
+    assert_non_null(event);
+    assert_int_equal(event->type, OS_LOG_TYPE_ERROR);
+    assert_string_equal(event->message, TEST_MESSAGE);
+}
+
+static void
+flog_cli_run_logs_message(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "-l", "fault",
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    // The logger may be run more than once, as it is by the bash builtin
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    assert_int_equal(flog_oslog_get_event_count(), 2);
+
+    const FlogOsLogEvent *event = flog_oslog_get_event(0);
+    assert_int_equal(event->type, OS_LOG_TYPE_FAULT);
+    assert_string_equal(event->message, TEST_MESSAGE);
+}
+
+static void
+flog_cli_run_with_redact_masks_secrets(void **state) {
+    UNUSED(state);
+
+    char path[TEST_PATH_LEN] = TEST_PATH_TEMPLATE;
+    int fd = mkstemp(path);
+    assert_int_not_equal(fd, -1);
+    close(fd);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "--redact", "bearer,email",
+        "-a", path,
+        "login by bob@example.com with Bearer abcdefghijklmnop from 4111111111111111"
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    // The message is masked in both the log and the append file, and kinds not
+    // selected are left
+    const char *redacted = "login by *************** with Bearer **************** from 4111111111111111";
+
+    FILE *file = fopen(path, "r");
+    assert_non_null(file);
+
+    char buffer[TEST_BUFFER_LEN];
+    assert_non_null(fgets(buffer, TEST_BUFFER_LEN, file));
+    buffer[strcspn(buffer, "\n")] = '\0';
+    assert_string_equal(buffer, redacted);
+
+    fclose(file);
+    unlink(path);
+
+    assert_int_equal(flog_oslog_get_event_count(), 1);
+    assert_string_equal(flog_oslog_get_event(0)->message, redacted);
+}
+
+static void
+flog_cli_run_again_takes_redact_from_each_config(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    char *plain_argv[] = {TEST_PROGRAM_NAME, "token Bearer abcdefghijklmnop", NULL};
+    char *redacted_argv[] = {TEST_PROGRAM_NAME, "--redact", "all", "token Bearer abcdefghijklmnop", NULL};
+
+    FlogConfig *plain = flog_config_new(2, plain_argv, &error);
+    assert_non_null(plain);
+
+    FlogConfig *redacted = flog_config_new(4, redacted_argv, &error);
+    assert_non_null(redacted);
+
+    // A FlogCli object kept across runs, as by the builtin, takes redaction from each run
+    FlogCli *flog = flog_cli_new(plain, &error);
+    assert_non_null(flog);
+
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+
+    flog_cli_set_config(flog, redacted);
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+
+    flog_cli_set_config(flog, plain);
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+
+    flog_cli_free(flog);
+    flog_config_free(redacted);
+    flog_config_free(plain);
+
+    assert_int_equal(flog_oslog_get_event_count(), 3);
+    assert_string_equal(flog_oslog_get_event(2)->message, "token Bearer abcdefghijklmnop");
+    assert_string_equal(flog_oslog_get_event(1)->message, "token Bearer ****************");
+    assert_string_equal(flog_oslog_get_event(0)->message, "token Bearer abcdefghijklmnop");
+}
+
+static void
+flog_cli_run_with_json_format_appends_json_record(void **state) {
+    UNUSED(state);
+
+    char path[TEST_PATH_LEN] = TEST_PATH_TEMPLATE;
+    int fd = mkstemp(path);
+    assert_int_not_equal(fd, -1);
+    close(fd);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "-f", "json",
+        "-k",
+        "-t", "level",
+        "-p",
+        "-l", "error",
+        "-s", "com.example.app",
+        "-a", path,
+        "disk \"full\"\tretrying"
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    FILE *file = fopen(path, "r");
+    assert_non_null(file);
+
+    // The prefix and checksum options are ignored, as the record holds every field
+    char buffer[TEST_BUFFER_LEN];
+    assert_non_null(fgets(buffer, TEST_BUFFER_LEN, file));
+    assert_int_equal(strncmp(buffer, "{\"ts\":\"", 7), 0);
+
+    const char *rest = strstr(buffer, "\",\"level\":");
+    assert_non_null(rest);
+    assert_string_equal(rest, "\",\"level\":\"error\",\"subsystem\":\"com.example.app\",\"category\":\"\","
+                              "\"private\":true,\"msg\":\"disk \\\"full\\\"\\tretrying\"}\n");
+    assert_null(fgets(buffer, TEST_BUFFER_LEN, file));
+
+    fclose(file);
+    unlink(path);
+}
+
+static void
+flog_cli_run_with_filters_skips_message(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "--include", "error",
+        TEST_MESSAGE
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    // A skipped message is not an error
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+    assert_int_equal(flog_cli_get_exit_status(flog), 0);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    assert_int_equal(flog_oslog_get_event_count(), 0);
+}
+
+static void
+flog_cli_run_batch_with_filters_skips_lines(void **state) {
+    UNUSED(state);
+
+    char path[TEST_PATH_LEN] = TEST_PATH_TEMPLATE;
+    int fd = mkstemp(path);
+    assert_int_not_equal(fd, -1);
+
+    char batch[] =
+        "-l error 'connection error'\n"
+        "'connection error, retrying'\n"
+        "'INFO started'\n"
+        "'WARN disk nearly full'\n";
+    assert_int_equal(write(fd, batch, strlen(batch)), (ssize_t) strlen(batch));
+    close(fd);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "--include", "error",
+        "--include", "^WARN",
+        "--exclude", "retrying",
+        "--batch", path
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+    assert_int_equal(flog_cli_get_exit_status(flog), 0);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+    unlink(path);
+
+    assert_int_equal(flog_oslog_get_event_count(), 2);
+
+    const FlogOsLogEvent *event = flog_oslog_get_event(1);
+    assert_int_equal(event->type, OS_LOG_TYPE_ERROR);
+    assert_string_equal(event->message, "connection error");
+    assert_string_equal(flog_oslog_get_event(0)->message, "WARN disk nearly full");
+}
+
+static void
+flog_cli_run_batch_with_dedup_summarises_repeats(void **state) {
+    UNUSED(state);
+
+    char path[TEST_PATH_LEN] = TEST_PATH_TEMPLATE;
+    int fd = mkstemp(path);
+    assert_int_not_equal(fd, -1);
+
+    char batch[] =
+        "-l error 'connection refused'\n"
+        "-l error 'connection refused'\n"
+        "-l error 'connection refused'\n"
+        "'connection refused'\n"
+        "-l error 'connection reset'\n";
+    assert_int_equal(write(fd, batch, strlen(batch)), (ssize_t) strlen(batch));
+    close(fd);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "--dedup",
+        "--batch", path
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+    assert_int_equal(flog_cli_get_exit_status(flog), 0);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+    unlink(path);
+
+    assert_int_equal(flog_oslog_get_event_count(), 4);
+
+    const FlogOsLogEvent *event = flog_oslog_get_event(1);
+    assert_int_equal(event->type, OS_LOG_TYPE_ERROR);
+    assert_string_equal(event->message, "last message repeated 2 times");
+    assert_string_equal(flog_oslog_get_event(3)->message, "connection refused");
+    assert_string_equal(flog_oslog_get_event(2)->message, "connection refused");
+    assert_string_equal(flog_oslog_get_event(0)->message, "connection reset");
+}
+
+static void
+flog_cli_run_batch_with_rate_limit_reports_suppressed(void **state) {
+    UNUSED(state);
+
+    char path[TEST_PATH_LEN] = TEST_PATH_TEMPLATE;
+    int fd = mkstemp(path);
+    assert_int_not_equal(fd, -1);
+
+    char batch[] =
+        "-l debug 'cache miss 1'\n"
+        "-l debug 'cache miss 2'\n"
+        "-l fault 'disk failed'\n"
+        "-l debug 'cache miss 3'\n"
+        "-l error 'connection refused'\n";
+    assert_int_equal(write(fd, batch, strlen(batch)), (ssize_t) strlen(batch));
+    close(fd);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "--rate-limit", "@fault=unlimited",
+        "--rate-limit", "1/h",
+        "--batch", path
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+    assert_int_equal(flog_cli_get_exit_status(flog), 0);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+    unlink(path);
+
+    assert_int_equal(flog_oslog_get_event_count(), 3);
+
+    const FlogOsLogEvent *event = flog_oslog_get_event(0);
+    assert_int_equal(event->type, OS_LOG_TYPE_ERROR);
+    assert_string_equal(event->message, "3 messages suppressed by rate limit");
+    assert_string_equal(flog_oslog_get_event(1)->message, "disk failed");
+    assert_string_equal(flog_oslog_get_event(2)->message, "cache miss 1");
+}
+
+static void
+flog_cli_run_batch_with_fields_takes_options_from_fields(void **state) {
+    UNUSED(state);
+
+    char path[TEST_PATH_LEN] = TEST_PATH_TEMPLATE;
+    int fd = mkstemp(path);
+    assert_int_not_equal(fd, -1);
+
+    char batch[] =
+        "'level=warn subsystem=" TEST_SUBSYSTEM " category=db msg=\"connection reset\" peer=10.0.0.1'\n"
+        "'plain message'\n"
+        "--fields json '{\"lvl\": \"debug\", \"message\": \"cache miss\", \"key\": \"a b\"}'\n";
+    assert_int_equal(write(fd, batch, strlen(batch)), (ssize_t) strlen(batch));
+    close(fd);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "--fields", "logfmt",
+        "--batch", path
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+    assert_int_equal(flog_cli_get_exit_status(flog), 0);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+    unlink(path);
+
+    assert_int_equal(flog_oslog_get_event_count(), 3);
+
+    const FlogOsLogEvent *event = flog_oslog_get_event(2);
+    assert_int_equal(event->type, OS_LOG_TYPE_ERROR);
+    assert_string_equal(event->subsystem, TEST_SUBSYSTEM);
+    assert_string_equal(event->category, "db");
+    assert_string_equal(event->message, "connection reset peer=10.0.0.1");
+
+    // Messages that are not in the format are logged as they are
+    event = flog_oslog_get_event(1);
+    assert_int_equal(event->type, OS_LOG_TYPE_DEFAULT);
+    assert_string_equal(event->message, "plain message");
+
+    event = flog_oslog_get_event(0);
+    assert_int_equal(event->type, OS_LOG_TYPE_DEBUG);
+    assert_string_equal(event->message, "cache miss key=\"a b\"");
+}
+
+static void
+flog_cli_run_with_fields_escapes_decoded_control_characters(void **state) {
+    UNUSED(state);
+
+    char path[TEST_PATH_LEN] = TEST_PATH_TEMPLATE;
+    int fd = mkstemp(path);
+    assert_int_not_equal(fd, -1);
+    close(fd);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "--fields", "json",
+        "-a", path,
+        "{\"msg\": \"\\u001b[2Jhi\\nthere\", \"user\": \"x\\ny\"}"
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    // The message is one line of the append file, and fields left keep their escapes
+    const char *expected = "\\x1b[2Jhi\\x0athere user=\"x\\ny\"";
+
+    FILE *file = fopen(path, "r");
+    assert_non_null(file);
+
+    char buffer[TEST_BUFFER_LEN];
+    assert_non_null(fgets(buffer, TEST_BUFFER_LEN, file));
+    assert_string_equal(buffer, "\\x1b[2Jhi\\x0athere user=\"x\\ny\"\n");
+    assert_null(fgets(buffer, TEST_BUFFER_LEN, file));
+
+    fclose(file);
+    unlink(path);
+
+    assert_int_equal(flog_oslog_get_event_count(), 1);
+    assert_string_equal(flog_oslog_get_event(0)->message, expected);
+}
+
+static void
+flog_cli_run_batch_with_fields_takes_message_field_alone(void **state) {
+    UNUSED(state);
+
+    char path[TEST_PATH_LEN] = TEST_PATH_TEMPLATE;
+    int fd = mkstemp(path);
+    assert_int_not_equal(fd, -1);
+
+    char batch[] =
+        "'msg=hello user=x'\n"
+        "--fields json '{\"message\": \"hello\", \"user\": \"x\"}'\n";
+    assert_int_equal(write(fd, batch, strlen(batch)), (ssize_t) strlen(batch));
+    close(fd);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "-s", TEST_SUBSYSTEM,
+        "--fields", "logfmt",
+        "--batch", path
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+    assert_int_equal(flog_cli_get_exit_status(flog), 0);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+    unlink(path);
+
+    // A message field is taken even when no other option is given by a field
+    assert_int_equal(flog_oslog_get_event_count(), 2);
+
+    for (size_t i = 0; i < 2; i++) {
+        const FlogOsLogEvent *event = flog_oslog_get_event(i);
+        assert_int_equal(event->type, OS_LOG_TYPE_DEFAULT);
+        assert_string_equal(event->subsystem, TEST_SUBSYSTEM);
+        assert_string_equal(event->message, "hello user=x");
+    }
+}
+
+static void
+flog_cli_run_batch_with_sample_annotates_kept_lines(void **state) {
+    UNUSED(state);
+
+    char path[TEST_PATH_LEN] = TEST_PATH_TEMPLATE;
+    int fd = mkstemp(path);
+    assert_int_not_equal(fd, -1);
+
+    // Whether a line is kept depends only on its message, so the same lines are kept by every run
+    char line[TEST_LINE_LEN];
+    size_t kept = 0;
+    for (int i = 0; i < 10; i++) {
+        int len = snprintf(line, sizeof(line), "-l debug 'cache miss %d'\n", i);
+        assert_int_equal(write(fd, line, (size_t) len), len);
+
+        snprintf(line, sizeof(line), "cache miss %d", i);
+        kept += flog_sample_keeps(line, 0.5);
+    }
+
+    char last[] = "'cache hit'\n";
+    assert_int_equal(write(fd, last, strlen(last)), (ssize_t) strlen(last));
+    close(fd);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "--sample", "debug=0.5",
+        "--batch", path
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+    assert_int_equal(flog_cli_get_exit_status(flog), 0);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+    unlink(path);
+
+    assert_int_equal(flog_oslog_get_event_count(), kept + 1);
+    assert_string_equal(flog_oslog_get_event(0)->message, "cache hit");
+
+    for (size_t age = 1; age <= kept; age++) {
+        const FlogOsLogEvent *event = flog_oslog_get_event(age);
+        assert_int_equal(event->type, OS_LOG_TYPE_DEBUG);
+        assert_non_null(strstr(event->message, " [sample_rate=0.5]"));
+    }
+}
+
+static void
+flog_cli_run_again_takes_sample_rates_from_each_config(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    char *plain_argv[] = {TEST_PROGRAM_NAME, "-l", "debug", TEST_MESSAGE, NULL};
+    char *sampled_argv[] = {TEST_PROGRAM_NAME, "--sample", "debug=0.999", "-l", "debug", TEST_MESSAGE, NULL};
+
+    FlogConfig *plain = flog_config_new(4, plain_argv, &error);
+    assert_non_null(plain);
+
+    FlogConfig *sampled = flog_config_new(6, sampled_argv, &error);
+    assert_non_null(sampled);
+
+    // A FlogCli object kept across runs, as by the builtin, takes sample rates from each run
+    FlogCli *flog = flog_cli_new(plain, &error);
+    assert_non_null(flog);
+
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+
+    flog_cli_set_config(flog, sampled);
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+
+    flog_cli_set_config(flog, plain);
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+
+    flog_cli_free(flog);
+    flog_config_free(sampled);
+    flog_config_free(plain);
+
+    size_t kept = flog_sample_keeps(TEST_MESSAGE, 0.999) ? 1 : 0;
+    assert_int_equal(flog_oslog_get_event_count(), 2 + kept);
+    assert_string_equal(flog_oslog_get_event(0)->message, TEST_MESSAGE);
+    assert_string_equal(flog_oslog_get_event(1 + kept)->message, TEST_MESSAGE);
+    if (kept) {
+        assert_string_equal(flog_oslog_get_event(1)->message, TEST_MESSAGE " [sample_rate=0.999]");
+    }
+}
+
+static void
+flog_cli_run_batch_logs_each_line(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "-p",
+        "--batch", "-"
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    char batch[] =
+        "-l error -s " TEST_SUBSYSTEM " -c " TEST_CATEGORY " '" TEST_MESSAGE "'\n"
+        "# comment\n"
+        "\n"
+        "--stats " TEST_MESSAGE "\n"
+        "-s " TEST_SUBSYSTEM " " TEST_MESSAGE "\n"
+        TEST_MESSAGE;
+    FILE *stream = fmemopen(batch, strlen(batch), "r");
+    assert_non_null(stream);
+
+    assert_int_equal(flog_cli_run_batch(flog, stream), FLOG_ERROR_LINE);
+    assert_ptr_equal(flog_cli_get_config(flog), config);
+
+    fclose(stream);
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    assert_int_equal(flog_oslog_get_event_count(), 3);
+
+    const FlogOsLogEvent *event = flog_oslog_get_event(2);
+    assert_int_equal(event->type, OS_LOG_TYPE_ERROR);
+    assert_true(event->redacted);
+    assert_string_equal(event->subsystem, TEST_SUBSYSTEM);
+    assert_string_equal(event->category, TEST_CATEGORY);
+    assert_string_equal(event->message, TEST_MESSAGE);
+
+    event = flog_oslog_get_event(1);
+    assert_int_equal(event->type, OS_LOG_TYPE_DEFAULT);
+    assert_string_equal(event->subsystem, TEST_SUBSYSTEM);
+    assert_string_equal(event->category, "");
+
+    event = flog_oslog_get_event(0);
+    assert_string_equal(event->subsystem, "");
+    assert_string_equal(event->message, TEST_MESSAGE);
+}
+
+static bool
+count_binlog_record(const FlogBinlogRecord *record, void *context) {
+    size_t *counts = context;
+
+    counts[strcmp(record->subsystem, TEST_SUBSYSTEM) == 0 ? 0 : 1]++;
+
+    return true;
+}
+
+static void
+flog_cli_run_batch_appends_binary_records(void **state) {
+    UNUSED(state);
+
+    char path[TEST_PATH_LEN] = TEST_PATH_TEMPLATE;
+    int fd = mkstemp(path);
+    assert_int_not_equal(fd, -1);
+    close(fd);
+    unlink(path);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "-f", "binary",
+        "-a", path,
+        "--batch", "-"
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    // The file is held open across lines, its strings interned once
+    char batch[] =
+        "-s " TEST_SUBSYSTEM " " TEST_MESSAGE "\n"
+        "-s other " TEST_MESSAGE "\n"
+        "-s " TEST_SUBSYSTEM " " TEST_MESSAGE "\n";
+    FILE *stream = fmemopen(batch, strlen(batch), "r");
+    assert_non_null(stream);
+
+    assert_int_equal(flog_cli_run_batch(flog, stream), FLOG_ERROR_NONE);
+
+    fclose(stream);
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    FlogBinlogReader *reader = flog_binlog_reader_new(path, &error);
+    assert_non_null(reader);
+
+    size_t counts[2] = {0};
+    FlogBinlogQuery query = { .since = 0, .until = UINT64_MAX, .level_mask = 0 };
+    assert_int_equal(flog_binlog_reader_query(reader, &query, count_binlog_record, counts), FLOG_ERROR_NONE);
+    assert_int_equal(counts[0], 2);
+    assert_int_equal(counts[1], 1);
+
+    flog_binlog_reader_free(reader);
+    unlink(path);
+}
+
+static void
+flog_cli_run_batch_sanitizes_messages(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "--batch", "-"
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    char batch[] =
+        "-s " TEST_SUBSYSTEM " 'bad \xff byte'\n"
+        "\x1b[31mred\n";
+    FILE *stream = fmemopen(batch, strlen(batch), "r");
+    assert_non_null(stream);
+
+    assert_int_equal(flog_cli_run_batch(flog, stream), FLOG_ERROR_NONE);
+
+    fclose(stream);
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    assert_int_equal(flog_oslog_get_event_count(), 2);
+    assert_string_equal(flog_oslog_get_event(1)->message, "bad \xef\xbf\xbd byte");
+    assert_string_equal(flog_oslog_get_event(0)->message, "\\x1b[31mred");
+}
+
+static void
+flog_cli_exec_logs_each_stream(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "-l", "info",
+        "-s", TEST_SUBSYSTEM,
+        "--exec", "--",
+        "sh", "-c", "echo " TEST_MESSAGE "; echo; echo failed >&2; printf partial; exit 3"
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+    assert_int_equal(flog_cli_get_exit_status(flog), 3);
+    assert_ptr_equal(flog_cli_get_config(flog), config);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    // The empty line is skipped, and only the lines of each stream are ordered
+    assert_int_equal(flog_oslog_get_event_count(), 3);
+
+    const FlogOsLogEvent *event = flog_oslog_get_event(2);
+    assert_int_equal(event->type, OS_LOG_TYPE_INFO);
+    assert_string_equal(event->subsystem, TEST_SUBSYSTEM);
+    assert_string_equal(event->message, TEST_MESSAGE);
+
+    for (size_t age = 0; age < 2; age++) {
+        event = flog_oslog_get_event(age);
+        if (event->type == OS_LOG_TYPE_ERROR) {
+            assert_string_equal(event->message, "failed");
+        } else {
+            assert_int_equal(event->type, OS_LOG_TYPE_INFO);
+            assert_string_equal(event->message, "partial");
+        }
+    }
+
+    assert_int_not_equal(flog_oslog_get_event(0)->type, flog_oslog_get_event(1)->type);
+}
+
+static void
+flog_cli_exec_sanitizes_lines(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "--exec", "--",
+        "printf", "bad \\377 byte\\n\\033[31mred\\n"
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    assert_int_equal(flog_cli_run(flog), FLOG_ERROR_NONE);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    assert_int_equal(flog_oslog_get_event_count(), 2);
+    assert_string_equal(flog_oslog_get_event(1)->message, "bad \xef\xbf\xbd byte");
+    assert_string_equal(flog_oslog_get_event(0)->message, "\\x1b[31mred");
+}
+
+static void
+flog_cli_exec_with_missing_command_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "--exec", "--",
+        "/nonexistent/command"
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    assert_int_equal(flog_cli_exec(flog), FLOG_ERROR_EXEC);
+    assert_int_equal(flog_cli_get_exit_status(flog), 0);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    assert_int_equal(flog_oslog_get_event_count(), 0);
+}
+
+static void
+flog_cli_tee_passes_input_through(void **state) {
+    UNUSED(state);
+
+    char input[] = TEST_MESSAGE "\n\nsecond\nlast";
+
+    // The copying path is used wherever tee(2) and splice(2) are unavailable
+    for (int zero_copy = 0; zero_copy < 2; zero_copy++) {
+        flog_oslog_reset();
+
+        char path[TEST_PATH_LEN] = TEST_PATH_TEMPLATE;
+        int fd = mkstemp(path);
+        assert_int_not_equal(fd, -1);
+        assert_int_equal(write(fd, "existing\n", 9), 9);
+        close(fd);
+
+        FlogError error = FLOG_ERROR_NONE;
+        MOCK_ARGS(
+            TEST_PROGRAM_NAME,
+            "-s", TEST_SUBSYSTEM,
+            "--tee",
+            "-a", path
+        )
+
+        FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+        assert_non_null(config);
+
+        FlogCli *flog = flog_cli_new(config, &error);
+        assert_non_null(flog);
+
+        int pipe_fds[2];
+        assert_int_equal(pipe(pipe_fds), 0);
+        assert_int_equal(write(pipe_fds[1], input, strlen(input)), (ssize_t) strlen(input));
+        close(pipe_fds[1]);
+
+        assert_int_equal(flog_cli_tee(flog, pipe_fds[0], zero_copy), FLOG_ERROR_NONE);
+        assert_ptr_equal(flog_cli_get_config(flog), config);
+
+        close(pipe_fds[0]);
+        flog_cli_free(flog);
+        flog_config_free(config);
+
+        FILE *file = fopen(path, "r");
+        assert_non_null(file);
+
+        char buffer[TEST_BUFFER_LEN] = {0};
+        size_t len = fread(buffer, 1, TEST_BUFFER_LEN - 1, file);
+        assert_int_equal(len, strlen("existing\n") + strlen(input));
+        assert_string_equal(buffer, "existing\n" TEST_MESSAGE "\n\nsecond\nlast");
+
+        fclose(file);
+        unlink(path);
+
+        // Each line is logged as it passes through, and the empty line is skipped
+        assert_int_equal(flog_oslog_get_event_count(), 3);
+
+        const FlogOsLogEvent *event = flog_oslog_get_event(2);
+        assert_int_equal(event->type, OS_LOG_TYPE_DEFAULT);
+        assert_string_equal(event->subsystem, TEST_SUBSYSTEM);
+        assert_string_equal(event->message, TEST_MESSAGE);
+        assert_string_equal(flog_oslog_get_event(1)->message, "second");
+        assert_string_equal(flog_oslog_get_event(0)->message, "last");
+    }
+}
+
+static void
+flog_cli_tee_passes_input_through_with_small_fd_limit(void **state) {
+    UNUSED(state);
+
+    // A limit of 64 descriptors leaves room in the router cache for a single writer
+    struct rlimit original;
+    assert_int_equal(getrlimit(RLIMIT_NOFILE, &original), 0);
+    struct rlimit limit = { .rlim_cur = 64, .rlim_max = original.rlim_max };
+    assert_int_equal(setrlimit(RLIMIT_NOFILE, &limit), 0);
+
+    char first_path[TEST_PATH_LEN] = TEST_PATH_TEMPLATE;
+    char second_path[TEST_PATH_LEN] = TEST_PATH_TEMPLATE;
+    int first_fd = mkstemp(first_path);
+    int second_fd = mkstemp(second_path);
+    assert_int_not_equal(first_fd, -1);
+    assert_int_not_equal(second_fd, -1);
+    close(first_fd);
+    close(second_fd);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "--tee",
+        "-a", first_path,
+        "-a", second_path
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    int pipe_fds[2];
+    assert_int_equal(pipe(pipe_fds), 0);
+    assert_int_equal(write(pipe_fds[1], TEST_MESSAGE "\n", strlen(TEST_MESSAGE "\n")),
+                     (ssize_t) strlen(TEST_MESSAGE "\n"));
+    close(pipe_fds[1]);
+
+    assert_int_equal(flog_cli_tee(flog, pipe_fds[0], false), FLOG_ERROR_NONE);
+
+    close(pipe_fds[0]);
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    assert_int_equal(setrlimit(RLIMIT_NOFILE, &original), 0);
+
+    const char *paths[] = { first_path, second_path };
+    for (size_t i = 0; i < 2; i++) {
+        FILE *file = fopen(paths[i], "r");
+        assert_non_null(file);
+
+        char buffer[TEST_BUFFER_LEN] = {0};
+        fread(buffer, 1, TEST_BUFFER_LEN - 1, file);
+        assert_string_equal(buffer, TEST_MESSAGE "\n");
+
+        fclose(file);
+        unlink(paths[i]);
+    }
+}
+
+static void
+flog_cli_read_records_joins_lines(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "-l", "error",
+        "-s", TEST_SUBSYSTEM,
+        "--multiline"
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    char input[] =
+        "Traceback (most recent call last):\n"
+        "  File \"app.py\", line 1, in <module>\n"
+        "\n"
+        "ValueError: " TEST_MESSAGE "\n"
+        TEST_MESSAGE "\n"
+        "\tcontinued";
+
+    int pipe_fds[2];
+    assert_int_equal(pipe(pipe_fds), 0);
+    assert_int_equal(write(pipe_fds[1], input, strlen(input)), (ssize_t) strlen(input));
+    close(pipe_fds[1]);
+
+    assert_int_equal(flog_cli_read_records(flog, pipe_fds[0]), FLOG_ERROR_NONE);
+    assert_ptr_equal(flog_cli_get_config(flog), config);
+
+    // The input is left open for the caller
+    assert_int_equal(close(pipe_fds[0]), 0);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    // The empty line is skipped without ending the record, and the last record is
+    // logged when the input is closed
+    assert_int_equal(flog_oslog_get_event_count(), 3);
+
+    const FlogOsLogEvent *event = flog_oslog_get_event(2);
+    assert_int_equal(event->type, OS_LOG_TYPE_ERROR);
+    assert_string_equal(event->subsystem, TEST_SUBSYSTEM);
+    assert_string_equal(event->message, "Traceback (most recent call last):\n  File \"app.py\", line 1, in <module>");
+    assert_string_equal(flog_oslog_get_event(1)->message, "ValueError: " TEST_MESSAGE);
+    assert_string_equal(flog_oslog_get_event(0)->message, TEST_MESSAGE "\n\tcontinued");
+}
+
+static void
+flog_cli_read_records_logs_record_after_wait(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "--record-start", "^[A-Z]",
+        "--record-max", "16",
+        "--record-wait", "20"
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    int pipe_fds[2];
+    assert_int_equal(pipe(pipe_fds), 0);
+
+    // The writer pauses for longer than the record wait before continuing the record
+    pid_t pid = fork();
+    assert_int_not_equal(pid, -1);
+    if (pid == 0) {
+        close(pipe_fds[0]);
+        (void) write(pipe_fds[1], "First\nmore\n", 11);
+        usleep(200000);
+        (void) write(pipe_fds[1], "late\nSecond record too long\n", 28);
+        _exit(0);
+    }
+
+    close(pipe_fds[1]);
+
+    assert_int_equal(flog_cli_read_records(flog, pipe_fds[0]), FLOG_ERROR_NONE);
+
+    close(pipe_fds[0]);
+    waitpid(pid, NULL, 0);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    // A record longer than the maximum is logged in parts
+    assert_int_equal(flog_oslog_get_event_count(), 4);
+    assert_string_equal(flog_oslog_get_event(3)->message, "First\nmore");
+    assert_string_equal(flog_oslog_get_event(2)->message, "late");
+    assert_string_equal(flog_oslog_get_event(1)->message, "Second record to");
+    assert_string_equal(flog_oslog_get_event(0)->message, "o long");
+}
+
+static void
+flog_cli_read_records_with_invalid_pattern_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "--record-start", "(a)\\1"
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    assert_int_equal(flog_cli_read_records(flog, STDIN_FILENO), FLOG_ERROR_RECORD);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    assert_int_equal(flog_oslog_get_event_count(), 0);
+}
+
+static void
+flog_cli_serve_replies_to_marked_requests(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    MOCK_ARGS(
+        TEST_PROGRAM_NAME,
+        "--serve"
+    )
+
+    FlogConfig *config = flog_config_new(mock_argc, mock_argv, &error);
+    assert_non_null(config);
+
+    FlogCli *flog = flog_cli_new(config, &error);
+    assert_non_null(flog);
+
+    int requests[2];
+    int replies[2];
+    assert_int_equal(pipe(requests), 0);
+    assert_int_equal(pipe(replies), 0);
+
+    const char *input =
+        "-l info -s " TEST_SUBSYSTEM " " TEST_MESSAGE "\n"
+        "?-l error " TEST_MESSAGE "\n"
+        "?-l unknown " TEST_MESSAGE "\n"
+        "?\n"
+        TEST_MESSAGE;
+    assert_int_equal(write(requests[1], input, strlen(input)), (ssize_t) strlen(input));
+    close(requests[1]);
+
+    assert_int_equal(flog_cli_serve(flog, requests[0], replies[1]), FLOG_ERROR_LVL);
+    assert_ptr_equal(flog_cli_get_config(flog), config);
+    close(requests[0]);
+    close(replies[1]);
+
+    char status[TEST_BUFFER_LEN] = {0};
+    assert_int_equal(read(replies[0], status, TEST_BUFFER_LEN), 3);
+    assert_string_equal(status, "010");
+    close(replies[0]);
+
+    flog_cli_free(flog);
+    flog_config_free(config);
+
+    assert_int_equal(flog_oslog_get_event_count(), 3);
+
+    const FlogOsLogEvent *event = flog_oslog_get_event(2);
+    assert_int_equal(event->type, OS_LOG_TYPE_INFO);
+    assert_string_equal(event->subsystem, TEST_SUBSYSTEM);
+
+    event = flog_oslog_get_event(1);
+    assert_int_equal(event->type, OS_LOG_TYPE_ERROR);
+    assert_string_equal(event->subsystem, "");
+
+    event = flog_oslog_get_event(0);
+    assert_int_equal(event->type, OS_LOG_TYPE_DEFAULT);
+    assert_string_equal(event->message, TEST_MESSAGE);
+}
+
+static void
+flog_oslog_ring_keeps_most_recent_events(void **state) {
+    UNUSED(state);
+
+    char message[TEST_BUFFER_LEN];
+    for (int i = 0; i < OSLOG_RING_SIZE + 3; i++) {
+        os_log(OS_LOG_DEFAULT, "%{public}s %d", TEST_MESSAGE, i);
+    }
+
+    assert_int_equal(flog_oslog_get_event_count(), OSLOG_RING_SIZE + 3);
+    assert_null(flog_oslog_get_event(OSLOG_RING_SIZE));
+
+    snprintf(message, TEST_BUFFER_LEN, "%s %d", TEST_MESSAGE, OSLOG_RING_SIZE + 2);
+    assert_string_equal(flog_oslog_get_event(0)->message, message);
+
+    snprintf(message, TEST_BUFFER_LEN, "%s %d", TEST_MESSAGE, 3);
+    assert_string_equal(flog_oslog_get_event(OSLOG_RING_SIZE - 1)->message, message);
+}
+
+int main(void) {
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+
+    const struct CMUnitTest tests[] = {
+        // flog_cli_new() tests
+        cmocka_unit_test(flog_cli_new_with_null_config_arg_fails),
+        cmocka_unit_test_setup_teardown(flog_cli_new_with_calloc_failure_fails, enable_calloc_failure, disable_calloc_failure),
+
+        // flog_commit_message() tests
+        cmocka_unit_test_setup(flog_commit_message_with_default_level_succeeds, reset_events),
+        cmocka_unit_test_setup(flog_commit_message_with_info_level_succeeds, reset_events),
+        cmocka_unit_test_setup(flog_commit_message_with_debug_level_succeeds, reset_events),
+        cmocka_unit_test_setup(flog_commit_message_with_error_level_succeeds, reset_events),
+        cmocka_unit_test_setup(flog_commit_message_with_fault_level_succeeds, reset_events),
+        cmocka_unit_test_setup(flog_commit_message_with_private_message_succeeds, reset_events),
+        cmocka_unit_test_setup(flog_commit_message_without_subsystem_uses_default_log, reset_events),
+
+        // flog_append_message_output() and flog_commit_message() tests
+        cmocka_unit_test_setup(flog_append_and_commit_message_succeeds, reset_events),
+
+        // flog_cli_run() tests
+        cmocka_unit_test_setup(flog_cli_run_logs_message, reset_events),
+        cmocka_unit_test_setup(flog_cli_run_with_redact_masks_secrets, reset_events),
+        cmocka_unit_test_setup(flog_cli_run_again_takes_redact_from_each_config, reset_events),
+        cmocka_unit_test_setup(flog_cli_run_with_json_format_appends_json_record, reset_events),
+        cmocka_unit_test_setup(flog_cli_run_with_filters_skips_message, reset_events),
+
+        // flog_cli_run_batch() tests
+        cmocka_unit_test_setup(flog_cli_run_batch_logs_each_line, reset_events),
+        cmocka_unit_test_setup(flog_cli_run_batch_appends_binary_records, reset_events),
+        cmocka_unit_test_setup(flog_cli_run_batch_sanitizes_messages, reset_events),
+        cmocka_unit_test_setup(flog_cli_run_batch_with_filters_skips_lines, reset_events),
+        cmocka_unit_test_setup(flog_cli_run_batch_with_dedup_summarises_repeats, reset_events),
+        cmocka_unit_test_setup(flog_cli_run_batch_with_rate_limit_reports_suppressed, reset_events),
+        cmocka_unit_test_setup(flog_cli_run_batch_with_fields_takes_options_from_fields, reset_events),
+        cmocka_unit_test_setup(flog_cli_run_batch_with_fields_takes_message_field_alone, reset_events),
+        cmocka_unit_test_setup(flog_cli_run_with_fields_escapes_decoded_control_characters, reset_events),
+        cmocka_unit_test_setup(flog_cli_run_batch_with_sample_annotates_kept_lines, reset_events),
+        cmocka_unit_test_setup(flog_cli_run_again_takes_sample_rates_from_each_config, reset_events),
+
+        // flog_cli_serve() tests
+        cmocka_unit_test_setup(flog_cli_serve_replies_to_marked_requests, reset_events),
+        cmocka_unit_test_setup(flog_cli_exec_logs_each_stream, reset_events),
+        cmocka_unit_test_setup(flog_cli_exec_sanitizes_lines, reset_events),
+        cmocka_unit_test_setup(flog_cli_exec_with_missing_command_fails, reset_events),
+        cmocka_unit_test_setup(flog_cli_tee_passes_input_through, reset_events),
+        cmocka_unit_test_setup(flog_cli_tee_passes_input_through_with_small_fd_limit, reset_events),
+        cmocka_unit_test_setup(flog_cli_read_records_joins_lines, reset_events),
+        cmocka_unit_test_setup(flog_cli_read_records_logs_record_after_wait, reset_events),
+        cmocka_unit_test_setup(flog_cli_read_records_with_invalid_pattern_fails, reset_events),
+
+        // Stand-in unified logging system tests
+        cmocka_unit_test_setup(flog_oslog_ring_keeps_most_recent_events, reset_events)
+    };
+
+    return cmocka_run_group_tests_name("FlogCli tests", tests, NULL, NULL);
+}
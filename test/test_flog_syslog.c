@@ -0,0 +1,238 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <syslog.h>
+#include "flog_syslog.h"
+#include "config.h"
+#include "oslog.h"
+
+#define TEST_MESSAGE "test message"
+#define TEST_IDENT "uk.co.fidgetbox.test"
+
+#define UNUSED(x) (void)(x)
+
+static int
+reset_events(void **state) {
+    UNUSED(state);
+    flog_oslog_reset();
+    return 0;
+}
+
+static int
+close_log(void **state) {
+    UNUSED(state);
+    closelog();
+    setlogmask(LOG_UPTO(LOG_DEBUG));
+    return 0;
+}
+
+static void *
+log_from_thread(void *arg) {
+    UNUSED(arg);
+    syslog(LOG_ERR, "%s from a thread", TEST_MESSAGE);
+    return NULL;
+}
+
+static void
+flog_syslog_level_maps_priorities(void **state) {
+    UNUSED(state);
+
+    assert_int_equal(flog_syslog_level(LOG_EMERG), LVL_FAULT);
+    assert_int_equal(flog_syslog_level(LOG_ALERT), LVL_FAULT);
+    assert_int_equal(flog_syslog_level(LOG_CRIT), LVL_FAULT);
+    assert_int_equal(flog_syslog_level(LOG_ERR), LVL_ERROR);
+    assert_int_equal(flog_syslog_level(LOG_WARNING), LVL_DEFAULT);
+    assert_int_equal(flog_syslog_level(LOG_NOTICE), LVL_DEFAULT);
+    assert_int_equal(flog_syslog_level(LOG_INFO), LVL_INFO);
+    assert_int_equal(flog_syslog_level(LOG_DEBUG), LVL_DEBUG);
+    assert_int_equal(flog_syslog_level(LOG_DAEMON | LOG_DEBUG), LVL_DEBUG);
+}
+
+static void
+flog_syslog_facility_name_maps_facilities(void **state) {
+    UNUSED(state);
+
+    assert_string_equal(flog_syslog_facility_name(LOG_KERN), "kern");
+    assert_string_equal(flog_syslog_facility_name(LOG_USER), "user");
+    assert_string_equal(flog_syslog_facility_name(LOG_DAEMON), "daemon");
+    assert_string_equal(flog_syslog_facility_name(LOG_AUTHPRIV), "authpriv");
+    assert_string_equal(flog_syslog_facility_name(LOG_LOCAL0), "local0");
+    assert_string_equal(flog_syslog_facility_name(LOG_LOCAL7), "local7");
+    assert_string_equal(flog_syslog_facility_name(LOG_LOCAL7 + LOG_LOCAL0), "");
+    assert_string_equal(flog_syslog_facility_name(LOG_DAEMON | LOG_ERR), "");
+}
+
+static void
+flog_syslog_intern_ident_copies_each_ident_once(void **state) {
+    UNUSED(state);
+
+    char first[] = TEST_IDENT;
+    char second[] = TEST_IDENT;
+
+    const char *copy = flog_syslog_intern_ident(first);
+    assert_non_null(copy);
+    assert_ptr_not_equal(copy, first);
+    assert_string_equal(copy, TEST_IDENT);
+
+    assert_ptr_equal(flog_syslog_intern_ident(second), copy);
+    assert_ptr_not_equal(flog_syslog_intern_ident("other"), copy);
+    assert_ptr_equal(flog_syslog_intern_ident(first), copy);
+}
+
+static void
+flog_syslog_logs_message_on_flush(void **state) {
+    UNUSED(state);
+
+    openlog(TEST_IDENT, LOG_PID, LOG_DAEMON);
+    syslog(LOG_ERR, "%s %d", TEST_MESSAGE, 1);
+    syslog(LOG_LOCAL3 | LOG_INFO, "%s %d", TEST_MESSAGE, 2);
+    flog_syslog_flush();
+
+    assert_int_equal(flog_oslog_get_event_count(), 2);
+
+    // Options from the environment are applied to each message
+    const FlogOsLogEvent *event = flog_oslog_get_event(1);
+    assert_int_equal(event->type, OS_LOG_TYPE_ERROR);
+    assert_true(event->redacted);
+    assert_string_equal(event->subsystem, TEST_IDENT);
+    assert_string_equal(event->category, "daemon");
+    assert_string_equal(event->message, TEST_MESSAGE " 1");
+
+    event = flog_oslog_get_event(0);
+    assert_int_equal(event->type, OS_LOG_TYPE_INFO);
+    assert_string_equal(event->category, "local3");
+    assert_string_equal(event->message, TEST_MESSAGE " 2");
+}
+
+static void
+flog_syslog_closelog_writes_buffered_messages(void **state) {
+    UNUSED(state);
+
+    openlog(TEST_IDENT, 0, LOG_USER);
+    syslog(LOG_NOTICE, TEST_MESSAGE);
+    closelog();
+
+    assert_int_equal(flog_oslog_get_event_count(), 1);
+
+    const FlogOsLogEvent *event = flog_oslog_get_event(0);
+    assert_int_equal(event->type, OS_LOG_TYPE_DEFAULT);
+    assert_string_equal(event->category, "user");
+    assert_string_equal(event->message, TEST_MESSAGE);
+}
+
+static void
+flog_syslog_expands_error_string(void **state) {
+    UNUSED(state);
+
+    openlog(TEST_IDENT, 0, LOG_USER);
+    errno = ENOENT;
+    syslog(LOG_ERR, TEST_MESSAGE ": %m (100%%)");
+    assert_int_equal(errno, ENOENT);
+    flog_syslog_flush();
+
+    char expected[256];
+    snprintf(expected, sizeof(expected), "%s: %s (100%%)", TEST_MESSAGE, strerror(ENOENT));
+
+    assert_int_equal(flog_oslog_get_event_count(), 1);
+    assert_string_equal(flog_oslog_get_event(0)->message, expected);
+}
+
+static void
+flog_syslog_setlogmask_filters_messages(void **state) {
+    UNUSED(state);
+
+    openlog(TEST_IDENT, 0, LOG_USER);
+    setlogmask(LOG_UPTO(LOG_WARNING));
+    assert_int_equal(setlogmask(0), LOG_UPTO(LOG_WARNING));
+
+    syslog(LOG_DEBUG, TEST_MESSAGE);
+    syslog(LOG_INFO, TEST_MESSAGE);
+    syslog(LOG_CRIT, TEST_MESSAGE);
+    flog_syslog_flush();
+
+    assert_int_equal(flog_oslog_get_event_count(), 1);
+    assert_int_equal(flog_oslog_get_event(0)->type, OS_LOG_TYPE_FAULT);
+}
+
+static void
+flog_syslog_logs_message_from_thread(void **state) {
+    UNUSED(state);
+
+    openlog(TEST_IDENT, 0, LOG_AUTH);
+
+    pthread_t thread;
+    assert_int_equal(pthread_create(&thread, NULL, log_from_thread, NULL), 0);
+    assert_int_equal(pthread_join(thread, NULL), 0);
+
+    // The exited thread's buffer is written, and then released, by the next flush
+    flog_syslog_flush();
+
+    assert_int_equal(flog_oslog_get_event_count(), 1);
+
+    const FlogOsLogEvent *event = flog_oslog_get_event(0);
+    assert_string_equal(event->category, "auth");
+    assert_string_equal(event->message, TEST_MESSAGE " from a thread");
+}
+
+static void
+flog_syslog_screens_messages_as_flog_does(void **state) {
+    UNUSED(state);
+
+    openlog(TEST_IDENT, 0, LOG_USER);
+    syslog(LOG_INFO, "login by alice@example.com");
+    syslog(LOG_INFO, "login by bob@example.com");
+    syslog(LOG_INFO, "login by bob@example.com");
+    flog_syslog_flush();
+
+    // Repeats are found in the message before it is redacted, so that messages that
+    // differ only in a secret are not taken for repeats of each other
+    assert_int_equal(flog_oslog_get_event_count(), 2);
+    assert_string_equal(flog_oslog_get_event(1)->message, "login by *****************");
+    assert_string_equal(flog_oslog_get_event(0)->message, "login by ***************");
+}
+
+int main(void) {
+    setenv(SYSLOG_OPTIONS_ENV, "-p --redact email --dedup", 1);
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(flog_syslog_level_maps_priorities),
+        cmocka_unit_test(flog_syslog_facility_name_maps_facilities),
+        cmocka_unit_test(flog_syslog_intern_ident_copies_each_ident_once),
+        cmocka_unit_test_setup_teardown(flog_syslog_logs_message_on_flush, reset_events, close_log),
+        cmocka_unit_test_setup_teardown(flog_syslog_closelog_writes_buffered_messages, reset_events, close_log),
+        cmocka_unit_test_setup_teardown(flog_syslog_expands_error_string, reset_events, close_log),
+        cmocka_unit_test_setup_teardown(flog_syslog_setlogmask_filters_messages, reset_events, close_log),
+        cmocka_unit_test_setup_teardown(flog_syslog_logs_message_from_thread, reset_events, close_log),
+        cmocka_unit_test_setup_teardown(flog_syslog_screens_messages_as_flog_does, reset_events, close_log),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,146 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdbool.h>
+#include "jsonl.h"
+#include "fields.h"
+
+#define TEST_TIME "2026-10-19T09:00:00.123456+01:00"
+#define TEST_BUF_LEN 256
+
+#define UNUSED(x) (void)(x)
+
+static FlogJsonlRecord
+test_record(const char *message) {
+    FlogJsonlRecord record = {
+        .time = TEST_TIME,
+        .time_len = strlen(TEST_TIME),
+        .level = LVL_ERROR,
+        .message_type = MSG_PUBLIC,
+        .subsystem = "com.example.app",
+        .category = "network",
+        .message = message,
+        .message_len = strlen(message)
+    };
+
+    return record;
+}
+
+static void
+flog_jsonl_render_with_null_record_arg_fails(void **state) {
+    UNUSED(state);
+
+    char buf[TEST_BUF_LEN];
+    expect_assert_failure(flog_jsonl_render(NULL, buf, sizeof(buf)));
+}
+
+static void
+flog_jsonl_render_with_null_buf_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogJsonlRecord record = test_record("request failed");
+    expect_assert_failure(flog_jsonl_render(&record, NULL, TEST_BUF_LEN));
+}
+
+static void
+flog_jsonl_render_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogJsonlRecord record = test_record("request failed");
+    record.message_type = MSG_PRIVATE;
+    char buf[TEST_BUF_LEN];
+
+    size_t len = flog_jsonl_render(&record, buf, sizeof(buf));
+    assert_string_equal(buf, "{\"ts\":\"" TEST_TIME "\",\"level\":\"error\",\"subsystem\":\"com.example.app\","
+                             "\"category\":\"network\",\"private\":true,\"msg\":\"request failed\"}");
+    assert_int_equal(len, strlen(buf));
+}
+
+static void
+flog_jsonl_render_escapes_strings(void **state) {
+    UNUSED(state);
+
+    FlogJsonlRecord record = test_record("say \"hi\"\\\tnow\n\x01 caf\xc3\xa9 and some plain text after");
+    record.subsystem = "";
+    record.category = "a\"b";
+    char buf[TEST_BUF_LEN];
+
+    flog_jsonl_render(&record, buf, sizeof(buf));
+    assert_string_equal(buf, "{\"ts\":\"" TEST_TIME "\",\"level\":\"error\",\"subsystem\":\"\","
+                             "\"category\":\"a\\\"b\",\"private\":false,"
+                             "\"msg\":\"say \\\"hi\\\"\\\\\\tnow\\n\\u0001 caf\xc3\xa9 and some plain text after\"}");
+}
+
+static void
+flog_jsonl_render_replaces_invalid_utf8(void **state) {
+    UNUSED(state);
+
+    FlogJsonlRecord record = test_record("bad \xff byte, cut \xe2\x82 short");
+    record.category = "\xc0\xaf";
+    char buf[TEST_BUF_LEN];
+
+    flog_jsonl_render(&record, buf, sizeof(buf));
+    assert_string_equal(buf, "{\"ts\":\"" TEST_TIME "\",\"level\":\"error\",\"subsystem\":\"com.example.app\","
+                             "\"category\":\"\xef\xbf\xbd\xef\xbf\xbd\",\"private\":false,"
+                             "\"msg\":\"bad \xef\xbf\xbd byte, cut \xef\xbf\xbd short\"}");
+}
+
+static void
+flog_jsonl_render_with_message_too_long_fails(void **state) {
+    UNUSED(state);
+
+    char message[TEST_BUF_LEN];
+    memset(message, 'x', sizeof(message) - 1);
+    message[sizeof(message) - 1] = '\0';
+
+    FlogJsonlRecord record = test_record(message);
+    char buf[TEST_BUF_LEN];
+
+    // A record is never truncated, as the result would not be valid JSON
+    assert_int_equal(flog_jsonl_render(&record, buf, sizeof(buf)), 0);
+    assert_string_equal(buf, "");
+}
+
+int main(void) {
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+
+    const struct CMUnitTest tests[] = {
+        // flog_jsonl_render() precondition tests
+        cmocka_unit_test(flog_jsonl_render_with_null_record_arg_fails),
+        cmocka_unit_test(flog_jsonl_render_with_null_buf_arg_fails),
+
+        // flog_jsonl_render() tests
+        cmocka_unit_test(flog_jsonl_render_succeeds),
+        cmocka_unit_test(flog_jsonl_render_escapes_strings),
+        cmocka_unit_test(flog_jsonl_render_replaces_invalid_utf8),
+        cmocka_unit_test(flog_jsonl_render_with_message_too_long_fails),
+    };
+
+    return cmocka_run_group_tests_name("JSON Lines function tests", tests, NULL, NULL);
+}
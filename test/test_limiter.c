@@ -0,0 +1,308 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "limiter.h"
+#include "config.h"
+#include "common.h"
+
+#define TEST_PATH_TEMPLATE "/tmp/flog_limiter_XXXXXX"
+#define TEST_PATH_LEN 32
+#define TEST_SUBSYSTEM "uk.co.fidgetbox.test"
+#define TEST_CATEGORY "category"
+#define TEST_SECOND INT64_C(1000000000)
+
+#define UNUSED(x) (void)(x)
+
+extern bool fail_calloc;
+
+static int
+enable_calloc_failure(void **state) {
+    UNUSED(state);
+    fail_calloc = true;
+    return 0;
+}
+
+static int
+disable_calloc_failure(void **state) {
+    UNUSED(state);
+    fail_calloc = false;
+    return 0;
+}
+
+static FlogLimiter *
+new_limiter(const char *options, const char *path) {
+    FlogError error = FLOG_ERROR_NONE;
+    FlogConfig *config = flog_config_new_from_options(options, &error);
+    assert_non_null(config);
+
+    FlogLimiter *limiter = flog_limiter_new(config, path, &error);
+    assert_non_null(limiter);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+
+    // The limiter keeps no references to the rules held by the configuration
+    flog_config_free(config);
+
+    return limiter;
+}
+
+static bool
+acquire(FlogLimiter *limiter, const char *subsystem, const char *category, FlogConfigLevel level, int64_t now) {
+    unsigned long suppressed = 0;
+    return flog_limiter_acquire(limiter, subsystem, category, level, now, &suppressed);
+}
+
+static void
+flog_limiter_new_with_null_config_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    expect_assert_failure(flog_limiter_new(NULL, NULL, &error));
+}
+
+static void
+flog_limiter_new_with_null_error_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogConfig *config = flog_config_new_from_options("--rate-limit 10/s", &error);
+    assert_non_null(config);
+
+    expect_assert_failure(flog_limiter_new(config, NULL, NULL));
+
+    flog_config_free(config);
+}
+
+static void
+flog_limiter_new_with_calloc_failure_fails(void **state) {
+    UNUSED(state);
+
+    // The configuration is created before allocations are made to fail
+    disable_calloc_failure(NULL);
+    FlogError error = FLOG_ERROR_NONE;
+    FlogConfig *config = flog_config_new_from_options("--rate-limit 10/s", &error);
+    assert_non_null(config);
+    enable_calloc_failure(NULL);
+
+    FlogLimiter *limiter = flog_limiter_new(config, NULL, &error);
+    assert_null(limiter);
+    assert_int_equal(error, FLOG_ERROR_ALLOC);
+
+    disable_calloc_failure(NULL);
+    flog_config_free(config);
+}
+
+static void
+flog_limiter_free_with_null_limiter_arg_fails(void **state) {
+    UNUSED(state);
+
+    expect_assert_failure(flog_limiter_free(NULL));
+}
+
+static void
+flog_limiter_acquire_with_null_suppressed_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogLimiter *limiter = new_limiter("--rate-limit 10/s", NULL);
+
+    expect_assert_failure(flog_limiter_acquire(limiter, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEFAULT, 0, NULL));
+
+    flog_limiter_free(limiter);
+}
+
+static void
+flog_limiter_acquire_limits_to_rate(void **state) {
+    UNUSED(state);
+
+    FlogLimiter *limiter = new_limiter("--rate-limit 4/s", NULL);
+    assert_false(flog_limiter_is_shared(limiter));
+
+    int64_t now = TEST_SECOND;
+    unsigned long suppressed = 0;
+
+    // A full bucket allows a burst of the whole count
+    for (int i = 0; i < 4; i++) {
+        assert_true(flog_limiter_acquire(limiter, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEFAULT, now, &suppressed));
+        assert_int_equal(suppressed, 0);
+    }
+
+    assert_false(flog_limiter_acquire(limiter, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEFAULT, now, &suppressed));
+    assert_false(acquire(limiter, "", "", LVL_ERROR, now + TEST_SECOND / 4 - 1));
+
+    // A token is refilled every quarter of a second
+    assert_true(flog_limiter_acquire(limiter, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEFAULT, now + TEST_SECOND / 4,
+                                     &suppressed));
+    assert_int_equal(suppressed, 2);
+    assert_false(acquire(limiter, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEFAULT, now + TEST_SECOND / 4));
+
+    // Tokens are never accumulated beyond the count
+    now += 10 * TEST_SECOND;
+    for (int i = 0; i < 4; i++) {
+        assert_true(acquire(limiter, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEFAULT, now));
+    }
+
+    assert_false(acquire(limiter, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEFAULT, now));
+
+    flog_limiter_free(limiter);
+}
+
+static void
+flog_limiter_acquire_applies_first_matching_rule(void **state) {
+    UNUSED(state);
+
+    FlogLimiter *limiter = new_limiter("--rate-limit @fault=unlimited --rate-limit " TEST_SUBSYSTEM ":db=1/m "
+                                       "--rate-limit @debug=1/h", NULL);
+
+    int64_t now = TEST_SECOND;
+
+    for (int i = 0; i < 100; i++) {
+        assert_true(acquire(limiter, TEST_SUBSYSTEM, "db", LVL_FAULT, now));
+        assert_true(acquire(limiter, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEFAULT, now));
+    }
+
+    // Debug messages in the category take from its bucket alone
+    assert_true(acquire(limiter, TEST_SUBSYSTEM, "db", LVL_DEBUG, now));
+    assert_false(acquire(limiter, TEST_SUBSYSTEM, "db", LVL_INFO, now));
+    assert_true(acquire(limiter, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEBUG, now));
+    assert_false(acquire(limiter, "", "", LVL_DEBUG, now));
+    assert_true(acquire(limiter, TEST_SUBSYSTEM, "db", LVL_INFO, now + 60 * TEST_SECOND));
+
+    flog_limiter_free(limiter);
+}
+
+static void
+flog_limiter_next_summary_takes_suppressed_counts(void **state) {
+    UNUSED(state);
+
+    FlogLimiter *limiter = new_limiter("--rate-limit @error=1/s --rate-limit 1/s", NULL);
+    FlogLimiterSummary summary;
+
+    assert_false(flog_limiter_next_summary(limiter, &summary));
+
+    assert_true(acquire(limiter, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_ERROR, 0));
+    assert_false(acquire(limiter, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_ERROR, 0));
+    assert_false(acquire(limiter, TEST_SUBSYSTEM, "last", LVL_ERROR, 0));
+    assert_true(acquire(limiter, "", "", LVL_INFO, 0));
+
+    assert_true(flog_limiter_next_summary(limiter, &summary));
+    assert_string_equal(summary.subsystem, TEST_SUBSYSTEM);
+    assert_string_equal(summary.category, "last");
+    assert_int_equal(summary.level, LVL_ERROR);
+    assert_int_equal(summary.count, 2);
+
+    assert_false(flog_limiter_next_summary(limiter, &summary));
+
+    flog_limiter_free(limiter);
+}
+
+static void
+flog_limiter_with_state_file_shares_buckets(void **state) {
+    UNUSED(state);
+
+    char path[TEST_PATH_LEN] = TEST_PATH_TEMPLATE;
+    int fd = mkstemp(path);
+    assert_int_not_equal(fd, -1);
+    close(fd);
+
+    // Limiters with the same rule share its bucket, whatever the order of their rules
+    FlogLimiter *first = new_limiter("--rate-limit @debug=2/s", path);
+    FlogLimiter *second = new_limiter("--rate-limit @fault=unlimited --rate-limit @debug=2/s", path);
+    FlogLimiter *other = new_limiter("--rate-limit @debug=3/s", path);
+    assert_true(flog_limiter_is_shared(first));
+    assert_true(flog_limiter_is_shared(second));
+
+    int64_t now = TEST_SECOND;
+    unsigned long suppressed = 0;
+
+    assert_true(acquire(first, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEBUG, now));
+    assert_true(acquire(second, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEBUG, now));
+    assert_false(acquire(first, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEBUG, now));
+    assert_false(acquire(second, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEBUG, now));
+    assert_true(acquire(other, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEBUG, now));
+
+    // Counts in the state file are left for the next message allowed by any limiter
+    FlogLimiterSummary summary;
+    assert_false(flog_limiter_next_summary(first, &summary));
+
+    assert_true(flog_limiter_acquire(second, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEBUG, now + TEST_SECOND,
+                                     &suppressed));
+    assert_int_equal(suppressed, 2);
+
+    flog_limiter_free(first);
+    flog_limiter_free(second);
+    flog_limiter_free(other);
+
+    // A bucket left far ahead of the clock, as after a restart, is reset
+    FlogLimiter *restarted = new_limiter("--rate-limit @debug=2/s", path);
+    assert_true(acquire(restarted, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEBUG, 0));
+    flog_limiter_free(restarted);
+
+    unlink(path);
+}
+
+static void
+flog_limiter_with_unusable_state_file_keeps_buckets_in_memory(void **state) {
+    UNUSED(state);
+
+    FlogLimiter *limiter = new_limiter("--rate-limit 1/s", "/nonexistent/flog-ratelimit");
+    assert_false(flog_limiter_is_shared(limiter));
+
+    assert_true(acquire(limiter, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEFAULT, 0));
+    assert_false(acquire(limiter, TEST_SUBSYSTEM, TEST_CATEGORY, LVL_DEFAULT, 0));
+
+    FlogLimiterSummary summary;
+    assert_true(flog_limiter_next_summary(limiter, &summary));
+    assert_int_equal(summary.count, 1);
+
+    flog_limiter_free(limiter);
+}
+
+int main(void) {
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+
+    const struct CMUnitTest tests[] = {
+        // flog_limiter_new() and flog_limiter_free() failure tests
+        cmocka_unit_test(flog_limiter_new_with_null_config_arg_fails),
+        cmocka_unit_test(flog_limiter_new_with_null_error_arg_fails),
+        cmocka_unit_test(flog_limiter_new_with_calloc_failure_fails),
+        cmocka_unit_test(flog_limiter_free_with_null_limiter_arg_fails),
+
+        // flog_limiter_acquire() and flog_limiter_next_summary() tests
+        cmocka_unit_test(flog_limiter_acquire_with_null_suppressed_arg_fails),
+        cmocka_unit_test(flog_limiter_acquire_limits_to_rate),
+        cmocka_unit_test(flog_limiter_acquire_applies_first_matching_rule),
+        cmocka_unit_test(flog_limiter_next_summary_takes_suppressed_counts),
+        cmocka_unit_test(flog_limiter_with_state_file_shares_buckets),
+        cmocka_unit_test(flog_limiter_with_unusable_state_file_keeps_buckets_in_memory),
+    };
+
+    return cmocka_run_group_tests_name("FlogLimiter tests", tests, NULL, NULL);
+}
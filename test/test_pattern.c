@@ -0,0 +1,150 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdbool.h>
+#include "pattern.h"
+
+#define TEST_LITERAL_LEN 64
+
+#define UNUSED(x) (void)(x)
+
+static void
+flog_pattern_compile_with_null_regex_arg_fails(void **state) {
+    UNUSED(state);
+
+    expect_assert_failure(flog_pattern_compile(NULL, "error"));
+}
+
+static void
+flog_pattern_compile_with_null_pattern_arg_fails(void **state) {
+    UNUSED(state);
+
+    regex_t regex;
+    expect_assert_failure(flog_pattern_compile(&regex, NULL));
+}
+
+static void
+flog_pattern_compile_succeeds(void **state) {
+    UNUSED(state);
+
+    regex_t regex;
+    assert_true(flog_pattern_compile(&regex, "^(GET|POST) /api/"));
+
+    assert_int_equal(regexec(&regex, "POST /api/users", 0, NULL, 0), 0);
+    assert_int_not_equal(regexec(&regex, "PUT /api/users", 0, NULL, 0), 0);
+
+    regfree(&regex);
+}
+
+static void
+flog_pattern_is_valid_succeeds(void **state) {
+    UNUSED(state);
+
+    assert_true(flog_pattern_is_valid("timeout"));
+    assert_true(flog_pattern_is_valid("^[0-9]+ ms$"));
+
+    assert_false(flog_pattern_is_valid("[unterminated"));
+    assert_false(flog_pattern_is_valid("a)|(b"));
+    assert_false(flog_pattern_is_valid("(a)\\1"));
+}
+
+static void
+flog_pattern_has_backreference_succeeds(void **state) {
+    UNUSED(state);
+
+    assert_true(flog_pattern_has_backreference("(a)\\1"));
+    assert_true(flog_pattern_has_backreference("[a](b)\\2"));
+
+    // An escaped backslash, or a backslash in a bracket expression, is a literal
+    assert_false(flog_pattern_has_backreference("^\\\\1"));
+    assert_false(flog_pattern_has_backreference("^[\\1]"));
+    assert_false(flog_pattern_has_backreference("^[]\\1]"));
+    assert_false(flog_pattern_has_backreference("^[[:digit:]\\1]"));
+}
+
+static void
+flog_pattern_get_literal_with_null_literal_arg_fails(void **state) {
+    UNUSED(state);
+
+    size_t len = 0;
+    expect_assert_failure(flog_pattern_get_literal("error", NULL, &len));
+}
+
+static void
+flog_pattern_get_literal_succeeds(void **state) {
+    UNUSED(state);
+
+    char literal[TEST_LITERAL_LEN];
+    size_t len = 0;
+
+    assert_true(flog_pattern_get_literal("connection refused", literal, &len));
+    assert_string_equal(literal, "connection refused");
+    assert_int_equal(len, 18);
+
+    // Escaped operators and backslashes match themselves
+    assert_true(flog_pattern_get_literal("GET /index\\.html \\(cached\\) C:\\\\", literal, &len));
+    assert_string_equal(literal, "GET /index.html (cached) C:\\");
+    assert_int_equal(len, 28);
+}
+
+static void
+flog_pattern_get_literal_with_operator_fails(void **state) {
+    UNUSED(state);
+
+    char literal[TEST_LITERAL_LEN];
+    size_t len = 0;
+
+    assert_false(flog_pattern_get_literal("^error", literal, &len));
+    assert_false(flog_pattern_get_literal("a|b", literal, &len));
+    assert_false(flog_pattern_get_literal("index.html", literal, &len));
+    assert_false(flog_pattern_get_literal("\\w+", literal, &len));
+    assert_false(flog_pattern_get_literal("trailing\\", literal, &len));
+}
+
+int main(void) {
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+
+    const struct CMUnitTest tests[] = {
+        // flog_pattern_compile() and flog_pattern_is_valid() tests
+        cmocka_unit_test(flog_pattern_compile_with_null_regex_arg_fails),
+        cmocka_unit_test(flog_pattern_compile_with_null_pattern_arg_fails),
+        cmocka_unit_test(flog_pattern_compile_succeeds),
+        cmocka_unit_test(flog_pattern_is_valid_succeeds),
+
+        // flog_pattern_has_backreference() tests
+        cmocka_unit_test(flog_pattern_has_backreference_succeeds),
+
+        // flog_pattern_get_literal() tests
+        cmocka_unit_test(flog_pattern_get_literal_with_null_literal_arg_fails),
+        cmocka_unit_test(flog_pattern_get_literal_succeeds),
+        cmocka_unit_test(flog_pattern_get_literal_with_operator_fails),
+    };
+
+    return cmocka_run_group_tests_name("FlogPattern tests", tests, NULL, NULL);
+}
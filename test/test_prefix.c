@@ -0,0 +1,301 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+#include "prefix.h"
+#include "config.h"
+#include "common.h"
+
+#define TEST_SECOND 1792400400
+#define TEST_NANOSECONDS 123456789
+#define TEST_TIME_UTC "2026-10-19T09:00:00.123456+00:00 "
+#define TEST_TIME_OFFSET "2026-10-19T14:30:00.123456+05:30 "
+#define TEST_TIME_NEGATIVE "2026-10-19T05:00:00.000001-04:00 "
+#define TEST_TZ_UTC "UTC0"
+#define TEST_TZ_OFFSET "XYZ-05:30"
+#define TEST_TZ_NEGATIVE "XYZ+04:00"
+#define TEST_SUBSYSTEM "com.example.app"
+#define TEST_CATEGORY "network"
+#define TEST_BUFF_SIZE 128
+
+#define UNUSED(x) (void)(x)
+
+extern bool fail_calloc;
+
+static int
+enable_calloc_failure(void **state) {
+    UNUSED(state);
+    fail_calloc = true;
+    return 0;
+}
+
+static int
+disable_calloc_failure(void **state) {
+    UNUSED(state);
+    fail_calloc = false;
+    return 0;
+}
+
+static int
+set_utc_timezone(void **state) {
+    UNUSED(state);
+    setenv("TZ", TEST_TZ_UTC, 1);
+    tzset();
+    return 0;
+}
+
+static void
+flog_prefix_new_with_null_error_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_prefix_new(PFX_TIME, NULL));
+}
+
+static void
+flog_prefix_new_with_calloc_failure_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogPrefix *prefix = flog_prefix_new(PFX_TIME, &error);
+
+    assert_null(prefix);
+    assert_int_equal(error, FLOG_ERROR_ALLOC);
+}
+
+static void
+flog_prefix_free_with_null_prefix_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_prefix_free(NULL));
+}
+
+static void
+flog_prefix_render_with_null_buf_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogPrefix *prefix = flog_prefix_new(PFX_TIME, &error);
+    assert_non_null(prefix);
+
+    struct timespec time = { .tv_sec = TEST_SECOND, .tv_nsec = 0 };
+    expect_assert_failure(flog_prefix_render(prefix, &time, LVL_DEFAULT, "", "", NULL, TEST_BUFF_SIZE));
+
+    flog_prefix_free(prefix);
+}
+
+static void
+flog_prefix_new_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_ALLOC;
+    FlogPrefix *prefix = flog_prefix_new(PFX_TIME | PFX_LEVEL, &error);
+
+    assert_non_null(prefix);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+    assert_int_equal(flog_prefix_get_fields(prefix), PFX_TIME | PFX_LEVEL);
+
+    flog_prefix_free(prefix);
+}
+
+static void
+flog_prefix_render_with_no_fields_is_empty(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogPrefix *prefix = flog_prefix_new(PFX_NONE, &error);
+    assert_non_null(prefix);
+
+    char buf[TEST_BUFF_SIZE];
+    struct timespec time = { .tv_sec = TEST_SECOND, .tv_nsec = TEST_NANOSECONDS };
+
+    assert_int_equal(flog_prefix_render(prefix, &time, LVL_ERROR, TEST_SUBSYSTEM, TEST_CATEGORY, buf, sizeof(buf)), 0);
+    assert_string_equal(buf, "");
+
+    flog_prefix_free(prefix);
+}
+
+static void
+flog_prefix_render_time_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogPrefix *prefix = flog_prefix_new(PFX_TIME, &error);
+    assert_non_null(prefix);
+
+    char buf[TEST_BUFF_SIZE];
+    struct timespec time = { .tv_sec = TEST_SECOND, .tv_nsec = TEST_NANOSECONDS };
+
+    size_t len = flog_prefix_render(prefix, &time, LVL_DEFAULT, "", "", buf, sizeof(buf));
+
+    assert_string_equal(buf, TEST_TIME_UTC);
+    assert_int_equal(len, strlen(TEST_TIME_UTC));
+
+    flog_prefix_free(prefix);
+}
+
+static void
+flog_prefix_render_time_within_cached_second_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogPrefix *prefix = flog_prefix_new(PFX_TIME, &error);
+    assert_non_null(prefix);
+
+    char buf[TEST_BUFF_SIZE];
+    struct timespec time = { .tv_sec = TEST_SECOND, .tv_nsec = 0 };
+
+    flog_prefix_render(prefix, &time, LVL_DEFAULT, "", "", buf, sizeof(buf));
+    assert_string_equal(buf, "2026-10-19T09:00:00.000000+00:00 ");
+
+    time.tv_nsec = 999999999;
+    flog_prefix_render(prefix, &time, LVL_DEFAULT, "", "", buf, sizeof(buf));
+    assert_string_equal(buf, "2026-10-19T09:00:00.999999+00:00 ");
+
+    time.tv_sec += 61;
+    time.tv_nsec = 500000;
+    flog_prefix_render(prefix, &time, LVL_DEFAULT, "", "", buf, sizeof(buf));
+    assert_string_equal(buf, "2026-10-19T09:01:01.000500+00:00 ");
+
+    flog_prefix_free(prefix);
+}
+
+static void
+flog_prefix_render_time_with_offset_succeeds(void **state) {
+    UNUSED(state);
+
+    setenv("TZ", TEST_TZ_OFFSET, 1);
+    tzset();
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogPrefix *prefix = flog_prefix_new(PFX_TIME, &error);
+    assert_non_null(prefix);
+
+    char buf[TEST_BUFF_SIZE];
+    struct timespec time = { .tv_sec = TEST_SECOND, .tv_nsec = TEST_NANOSECONDS };
+
+    flog_prefix_render(prefix, &time, LVL_DEFAULT, "", "", buf, sizeof(buf));
+    assert_string_equal(buf, TEST_TIME_OFFSET);
+
+    flog_prefix_free(prefix);
+
+    setenv("TZ", TEST_TZ_NEGATIVE, 1);
+    tzset();
+
+    prefix = flog_prefix_new(PFX_TIME, &error);
+    assert_non_null(prefix);
+
+    time.tv_nsec = 1000;
+    flog_prefix_render(prefix, &time, LVL_DEFAULT, "", "", buf, sizeof(buf));
+    assert_string_equal(buf, TEST_TIME_NEGATIVE);
+
+    flog_prefix_free(prefix);
+}
+
+static void
+flog_prefix_render_all_fields_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogPrefix *prefix = flog_prefix_new(PFX_TIME | PFX_LEVEL | PFX_PID | PFX_SUBSYSTEM | PFX_CATEGORY, &error);
+    assert_non_null(prefix);
+
+    char buf[TEST_BUFF_SIZE];
+    char expected[TEST_BUFF_SIZE];
+    struct timespec time = { .tv_sec = TEST_SECOND, .tv_nsec = TEST_NANOSECONDS };
+
+    snprintf(expected, sizeof(expected), "%serror [%ld] %s %s ",
+             TEST_TIME_UTC, (long) getpid(), TEST_SUBSYSTEM, TEST_CATEGORY);
+
+    size_t len = flog_prefix_render(prefix, &time, LVL_ERROR, TEST_SUBSYSTEM, TEST_CATEGORY, buf, sizeof(buf));
+
+    assert_string_equal(buf, expected);
+    assert_int_equal(len, strlen(expected));
+
+    flog_prefix_free(prefix);
+}
+
+static void
+flog_prefix_render_empty_names_succeeds(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogPrefix *prefix = flog_prefix_new(PFX_LEVEL | PFX_SUBSYSTEM | PFX_CATEGORY, &error);
+    assert_non_null(prefix);
+
+    char buf[TEST_BUFF_SIZE];
+    struct timespec time = { .tv_sec = TEST_SECOND, .tv_nsec = 0 };
+
+    flog_prefix_render(prefix, &time, LVL_INFO, "", "", buf, sizeof(buf));
+    assert_string_equal(buf, "info - - ");
+
+    flog_prefix_free(prefix);
+}
+
+static void
+flog_prefix_render_truncates_to_buffer(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogPrefix *prefix = flog_prefix_new(PFX_TIME | PFX_SUBSYSTEM, &error);
+    assert_non_null(prefix);
+
+    char buf[12];
+    struct timespec time = { .tv_sec = TEST_SECOND, .tv_nsec = 0 };
+
+    size_t len = flog_prefix_render(prefix, &time, LVL_DEFAULT, TEST_SUBSYSTEM, "", buf, sizeof(buf));
+
+    assert_int_equal(len, sizeof(buf) - 1);
+    assert_string_equal(buf, "2026-10-19T");
+
+    flog_prefix_free(prefix);
+}
+
+int main(void) {
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+
+    const struct CMUnitTest tests[] = {
+        // flog_prefix_new() and flog_prefix_render() failure tests
+        cmocka_unit_test(flog_prefix_new_with_null_error_arg_fails),
+        cmocka_unit_test_setup_teardown(flog_prefix_new_with_calloc_failure_fails, enable_calloc_failure, disable_calloc_failure),
+        cmocka_unit_test(flog_prefix_free_with_null_prefix_arg_fails),
+        cmocka_unit_test(flog_prefix_render_with_null_buf_arg_fails),
+
+        // flog_prefix_new() and flog_prefix_render() success tests
+        cmocka_unit_test(flog_prefix_new_succeeds),
+        cmocka_unit_test_setup(flog_prefix_render_with_no_fields_is_empty, set_utc_timezone),
+        cmocka_unit_test_setup(flog_prefix_render_time_succeeds, set_utc_timezone),
+        cmocka_unit_test_setup(flog_prefix_render_time_within_cached_second_succeeds, set_utc_timezone),
+        cmocka_unit_test_setup(flog_prefix_render_time_with_offset_succeeds, set_utc_timezone),
+        cmocka_unit_test_setup(flog_prefix_render_all_fields_succeeds, set_utc_timezone),
+        cmocka_unit_test_setup(flog_prefix_render_empty_names_succeeds, set_utc_timezone),
+        cmocka_unit_test_setup(flog_prefix_render_truncates_to_buffer, set_utc_timezone),
+    };
+
+    return cmocka_run_group_tests_name("FlogPrefix tests", tests, NULL, NULL);
+}
@@ -0,0 +1,370 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "record.h"
+#include "writer.h"
+#include "common.h"
+
+#define TEST_MESSAGE "test message"
+#define TEST_MESSAGE_NEWLINE "test message\n"
+#define TEST_PREFIX "prefix "
+#define TEST_PATH_TEMPLATE "/tmp/flog.XXXXXXXX"
+#define TEST_PATH_LEN 32
+#define TEST_BUFF_SIZE 256
+
+#define STRESS_WRITERS 16
+#define STRESS_RECORDS 250
+#define STRESS_MESSAGE_MAX 12000
+
+#define UNUSED(x) (void)(x)
+
+static int
+create_record_path(void **state) {
+    char *path = malloc(TEST_PATH_LEN);
+    if (path == NULL) {
+        return 1;
+    }
+
+    strcpy(path, TEST_PATH_TEMPLATE);
+
+    int fd = mkstemp(path);
+    if (fd == -1) {
+        free(path);
+        return 1;
+    }
+
+    close(fd);
+    *state = path;
+
+    return 0;
+}
+
+static int
+remove_record_path(void **state) {
+    unlink(*state);
+    free(*state);
+
+    return 0;
+}
+
+static size_t
+flatten_record(const FlogRecord *record, char *buf, size_t len) {
+    int count;
+    const struct iovec *segments = flog_record_get_segments(record, &count);
+    size_t offset = 0;
+
+    for (int i = 0; i < count; i++) {
+        assert_true(offset + segments[i].iov_len <= len);
+        memcpy(buf + offset, segments[i].iov_base, segments[i].iov_len);
+        offset += segments[i].iov_len;
+    }
+
+    return offset;
+}
+
+static void
+flog_record_init_with_null_record_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_record_init(NULL));
+}
+
+static void
+flog_record_append_with_null_buf_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogRecord record;
+    flog_record_init(&record);
+
+    expect_assert_failure(flog_record_append(&record, NULL, 0));
+}
+
+static void
+flog_record_append_with_too_many_segments_fails(void **state) {
+    UNUSED(state);
+
+    FlogRecord record;
+    flog_record_init(&record);
+
+    for (int i = 0; i < RECORD_SEGMENT_MAX - 2; i++) {
+        flog_record_append(&record, TEST_MESSAGE, strlen(TEST_MESSAGE));
+    }
+
+    expect_assert_failure(flog_record_append(&record, TEST_MESSAGE, strlen(TEST_MESSAGE)));
+}
+
+static void
+flog_record_finish_adds_newline(void **state) {
+    UNUSED(state);
+
+    FlogRecord record;
+    flog_record_init(&record);
+    flog_record_append(&record, TEST_PREFIX, strlen(TEST_PREFIX));
+    flog_record_append(&record, TEST_MESSAGE, strlen(TEST_MESSAGE));
+    flog_record_finish(&record, false);
+
+    char buf[TEST_BUFF_SIZE] = {0};
+    size_t len = flatten_record(&record, buf, sizeof(buf));
+
+    assert_int_equal(len, flog_record_get_length(&record));
+    assert_string_equal(buf, TEST_PREFIX TEST_MESSAGE "\n");
+}
+
+static void
+flog_record_finish_keeps_existing_newline(void **state) {
+    UNUSED(state);
+
+    FlogRecord record;
+    flog_record_init(&record);
+    flog_record_append(&record, TEST_MESSAGE_NEWLINE, strlen(TEST_MESSAGE_NEWLINE));
+    flog_record_finish(&record, false);
+
+    char buf[TEST_BUFF_SIZE] = {0};
+    flatten_record(&record, buf, sizeof(buf));
+
+    assert_string_equal(buf, TEST_MESSAGE_NEWLINE);
+}
+
+static void
+flog_record_finish_with_empty_message_writes_newline(void **state) {
+    UNUSED(state);
+
+    FlogRecord record;
+    flog_record_init(&record);
+    flog_record_append(&record, "", 0);
+    flog_record_finish(&record, false);
+
+    char buf[TEST_BUFF_SIZE] = {0};
+    flatten_record(&record, buf, sizeof(buf));
+
+    assert_string_equal(buf, "\n");
+}
+
+static void
+flog_record_framed_record_parses(void **state) {
+    UNUSED(state);
+
+    FlogRecord record;
+    flog_record_init(&record);
+    flog_record_append(&record, TEST_PREFIX, strlen(TEST_PREFIX));
+    flog_record_append(&record, TEST_MESSAGE_NEWLINE, strlen(TEST_MESSAGE_NEWLINE));
+    flog_record_finish(&record, true);
+
+    char buf[TEST_BUFF_SIZE] = {0};
+    size_t len = flatten_record(&record, buf, sizeof(buf));
+
+    assert_int_equal(len, RECORD_FRAME_LEN + strlen(TEST_PREFIX TEST_MESSAGE_NEWLINE));
+
+    const char *payload = NULL;
+    size_t payload_len = 0;
+    size_t consumed = 0;
+
+    assert_int_equal(flog_record_parse(buf, len, &payload, &payload_len, &consumed), RECORD_VALID);
+    assert_int_equal(consumed, len);
+    assert_int_equal(payload_len, strlen(TEST_PREFIX TEST_MESSAGE));
+    assert_memory_equal(payload, TEST_PREFIX TEST_MESSAGE, payload_len);
+}
+
+static void
+flog_record_corrupt_record_is_torn(void **state) {
+    UNUSED(state);
+
+    FlogRecord record;
+    flog_record_init(&record);
+    flog_record_append(&record, TEST_MESSAGE, strlen(TEST_MESSAGE));
+    flog_record_finish(&record, true);
+
+    char buf[TEST_BUFF_SIZE] = {0};
+    size_t len = flatten_record(&record, buf, sizeof(buf));
+
+    // Follow the corrupt record with a valid one, which should be found again
+    size_t second = flatten_record(&record, buf + len, sizeof(buf) - len);
+    buf[RECORD_FRAME_LEN + 2] ^= 0x20;
+
+    const char *payload = NULL;
+    size_t payload_len = 0;
+    size_t consumed = 0;
+
+    assert_int_equal(flog_record_parse(buf, len + second, &payload, &payload_len, &consumed), RECORD_TORN);
+    assert_int_equal(consumed, len);
+    assert_int_equal(flog_record_parse(buf + consumed, second, &payload, &payload_len, &consumed), RECORD_VALID);
+}
+
+static void
+flog_record_truncated_record_is_incomplete(void **state) {
+    UNUSED(state);
+
+    FlogRecord record;
+    flog_record_init(&record);
+    flog_record_append(&record, TEST_MESSAGE, strlen(TEST_MESSAGE));
+    flog_record_finish(&record, true);
+
+    char buf[TEST_BUFF_SIZE] = {0};
+    size_t len = flatten_record(&record, buf, sizeof(buf));
+
+    const char *payload = NULL;
+    size_t payload_len = 0;
+    size_t consumed = 0;
+
+    assert_int_equal(flog_record_parse(buf, len - 1, &payload, &payload_len, &consumed), RECORD_INCOMPLETE);
+    assert_int_equal(flog_record_parse(buf, RECORD_FRAME_LEN - 1, &payload, &payload_len, &consumed), RECORD_INCOMPLETE);
+}
+
+static void
+stress_writer(const char *path, int id, FlogConfigWriter backend) {
+    FlogError error = FLOG_ERROR_NONE;
+    FlogWriter *writer = flog_writer_new(path, backend, false, &error);
+    if (writer == NULL) {
+        _exit(1);
+    }
+
+    char *filler = malloc(STRESS_MESSAGE_MAX);
+    if (filler == NULL) {
+        _exit(1);
+    }
+    memset(filler, 'a' + id, STRESS_MESSAGE_MAX);
+
+    char header[TEST_BUFF_SIZE];
+    unsigned int seed = (unsigned int) id + 1;
+
+    for (int i = 0; i < STRESS_RECORDS; i++) {
+        int header_len = snprintf(header, sizeof(header), "writer %02d record %04d ", id, i);
+        size_t filler_len = (size_t) rand_r(&seed) % STRESS_MESSAGE_MAX;
+
+        FlogRecord record;
+        flog_record_init(&record);
+        flog_record_append(&record, header, (size_t) header_len);
+        flog_record_append(&record, filler, filler_len);
+        flog_record_finish(&record, true);
+
+        int count;
+        const struct iovec *segments = flog_record_get_segments(&record, &count);
+        if (flog_writer_writev(writer, segments, count) != FLOG_ERROR_NONE) {
+            _exit(1);
+        }
+    }
+
+    free(filler);
+    flog_writer_free(writer);
+
+    _exit(0);
+}
+
+static void
+flog_record_concurrent_writers_do_not_interleave(void **state) {
+    pid_t pids[STRESS_WRITERS];
+
+    for (int id = 0; id < STRESS_WRITERS; id++) {
+        pids[id] = fork();
+        assert_true(pids[id] != -1);
+
+        if (pids[id] == 0) {
+            stress_writer(*state, id, id % 2 == 0 ? WRT_SYNC : WRT_ASYNC);
+        }
+    }
+
+    for (int id = 0; id < STRESS_WRITERS; id++) {
+        int status;
+        assert_int_equal(waitpid(pids[id], &status, 0), pids[id]);
+        assert_true(WIFEXITED(status));
+        assert_int_equal(WEXITSTATUS(status), 0);
+    }
+
+    FILE *file = fopen(*state, "r");
+    assert_non_null(file);
+
+    struct stat statbuf;
+    assert_int_equal(fstat(fileno(file), &statbuf), 0);
+
+    size_t size = (size_t) statbuf.st_size;
+    char *buf = malloc(size);
+    assert_non_null(buf);
+    assert_int_equal(fread(buf, 1, size, file), size);
+    fclose(file);
+
+    int next_record[STRESS_WRITERS] = {0};
+    size_t offset = 0;
+    size_t records = 0;
+
+    while (offset < size) {
+        const char *payload;
+        size_t payload_len;
+        size_t consumed;
+
+        assert_int_equal(flog_record_parse(buf + offset, size - offset, &payload, &payload_len, &consumed), RECORD_VALID);
+
+        int id;
+        int sequence;
+        assert_int_equal(sscanf(payload, "writer %d record %d ", &id, &sequence), 2);
+        assert_in_range(id, 0, STRESS_WRITERS - 1);
+        assert_int_equal(sequence, next_record[id]);
+        next_record[id]++;
+
+        // Every filler byte must belong to the writer named in the record header
+        for (size_t i = strlen("writer 00 record 0000 "); i < payload_len; i++) {
+            assert_int_equal(payload[i], 'a' + id);
+        }
+
+        offset += consumed;
+        records++;
+    }
+
+    free(buf);
+
+    assert_int_equal(records, STRESS_WRITERS * STRESS_RECORDS);
+}
+
+int main(void) {
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+
+    const struct CMUnitTest tests[] = {
+        // flog_record_init() and flog_record_append() precondition tests
+        cmocka_unit_test(flog_record_init_with_null_record_arg_fails),
+        cmocka_unit_test(flog_record_append_with_null_buf_arg_fails),
+        cmocka_unit_test(flog_record_append_with_too_many_segments_fails),
+
+        // flog_record_finish() success tests
+        cmocka_unit_test(flog_record_finish_adds_newline),
+        cmocka_unit_test(flog_record_finish_keeps_existing_newline),
+        cmocka_unit_test(flog_record_finish_with_empty_message_writes_newline),
+
+        // flog_record_parse() tests
+        cmocka_unit_test(flog_record_framed_record_parses),
+        cmocka_unit_test(flog_record_corrupt_record_is_torn),
+        cmocka_unit_test(flog_record_truncated_record_is_incomplete),
+
+        // concurrent append stress tests
+        cmocka_unit_test_setup_teardown(flog_record_concurrent_writers_do_not_interleave, create_record_path, remove_record_path),
+    };
+
+    return cmocka_run_group_tests_name("FlogRecord tests", tests, NULL, NULL);
+}
@@ -0,0 +1,371 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdbool.h>
+#include <ftw.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "router.h"
+#include "writer.h"
+#include "config.h"
+#include "common.h"
+
+#define TEST_DIR_TEMPLATE "/tmp/flog.XXXXXXXX"
+#define TEST_DIR_LEN 32
+#define TEST_PATH_LEN 256
+#define TEST_SUBSYSTEM "com.example.app"
+#define TEST_CATEGORY "network"
+#define TEST_MESSAGE "test message\n"
+
+#define UNUSED(x) (void)(x)
+
+extern bool fail_calloc;
+
+static int
+enable_calloc_failure(void **state) {
+    UNUSED(state);
+    fail_calloc = true;
+    return 0;
+}
+
+static int
+disable_calloc_failure(void **state) {
+    UNUSED(state);
+    fail_calloc = false;
+    return 0;
+}
+
+static int
+create_router_dir(void **state) {
+    char *dir = malloc(TEST_DIR_LEN);
+    if (dir == NULL) {
+        return 1;
+    }
+
+    strcpy(dir, TEST_DIR_TEMPLATE);
+
+    if (mkdtemp(dir) == NULL) {
+        free(dir);
+        return 1;
+    }
+
+    *state = dir;
+
+    return 0;
+}
+
+static int
+remove_entry(const char *path, const struct stat *statbuf, int type, struct FTW *ftw) {
+    UNUSED(statbuf);
+    UNUSED(type);
+    UNUSED(ftw);
+
+    return remove(path);
+}
+
+static int
+remove_router_dir(void **state) {
+    nftw(*state, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+    free(*state);
+
+    return 0;
+}
+
+static void
+router_path(char *buf, const char *dir, const char *name) {
+    snprintf(buf, TEST_PATH_LEN, "%s/%s", dir, name);
+}
+
+static size_t
+read_file(const char *path, char *buf, size_t size) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return 0;
+    }
+
+    size_t len = fread(buf, 1, size - 1, file);
+    buf[len] = '\0';
+    fclose(file);
+
+    return len;
+}
+
+static void
+flog_router_new_with_null_error_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_router_new(ROUTER_CACHE_SIZE, WRT_SYNC, false, NULL));
+}
+
+static void
+flog_router_new_with_calloc_failure_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogRouter *router = flog_router_new(ROUTER_CACHE_SIZE, WRT_SYNC, false, &error);
+
+    assert_null(router);
+    assert_int_equal(error, FLOG_ERROR_ALLOC);
+}
+
+static void
+flog_router_free_with_null_router_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_router_free(NULL));
+}
+
+static void
+flog_router_expand_succeeds(void **state) {
+    UNUSED(state);
+
+    char path[TEST_PATH_LEN];
+
+    assert_int_equal(flog_router_expand("/var/log/flog/%{subsystem}/%{category}.%{level}.log",
+                                        TEST_SUBSYSTEM, TEST_CATEGORY, LVL_ERROR, path, sizeof(path)),
+                     FLOG_ERROR_NONE);
+    assert_string_equal(path, "/var/log/flog/com.example.app/network.error.log");
+
+    assert_int_equal(flog_router_expand("/var/log/100%%-%{level}%.log", "", "", LVL_INFO, path, sizeof(path)),
+                     FLOG_ERROR_NONE);
+    assert_string_equal(path, "/var/log/100%-info%.log");
+
+    assert_int_equal(flog_router_expand("/var/log/plain.log", TEST_SUBSYSTEM, TEST_CATEGORY, LVL_INFO,
+                                        path, sizeof(path)),
+                     FLOG_ERROR_NONE);
+    assert_string_equal(path, "/var/log/plain.log");
+}
+
+static void
+flog_router_expand_sanitises_values(void **state) {
+    UNUSED(state);
+
+    char path[TEST_PATH_LEN];
+
+    assert_int_equal(flog_router_expand("/log/%{subsystem}/%{category}", "../etc", "", LVL_DEFAULT,
+                                        path, sizeof(path)),
+                     FLOG_ERROR_NONE);
+    assert_string_equal(path, "/log/.._etc/default");
+
+    assert_int_equal(flog_router_expand("/log/%{subsystem}/%{category}", "..", ".", LVL_DEFAULT,
+                                        path, sizeof(path)),
+                     FLOG_ERROR_NONE);
+    assert_string_equal(path, "/log/__/_");
+}
+
+static void
+flog_router_expand_with_invalid_template_fails(void **state) {
+    UNUSED(state);
+
+    char path[TEST_PATH_LEN];
+
+    assert_int_equal(flog_router_expand("/log/%{level}/%{unknown}.log", "", "", LVL_DEFAULT, path, sizeof(path)),
+                     FLOG_ERROR_TEMPLATE);
+    assert_int_equal(flog_router_expand("/log/%{level}/%{subsystem.log", "", "", LVL_DEFAULT, path, sizeof(path)),
+                     FLOG_ERROR_TEMPLATE);
+}
+
+static void
+flog_router_expand_keeps_literal_paths(void **state) {
+    UNUSED(state);
+
+    char path[TEST_PATH_LEN];
+
+    // Paths without a known variable name the file they did before templates existed
+    const char *paths[] = { "/log/100%%.log", "/log/%{unknown}.log", "/log/%{subsystem.log", "/log/%%{level}" };
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+        assert_int_equal(flog_router_expand(paths[i], TEST_SUBSYSTEM, "", LVL_DEFAULT, path, sizeof(path)),
+                         FLOG_ERROR_NONE);
+        assert_string_equal(path, paths[i]);
+    }
+}
+
+static void
+flog_router_expand_with_long_path_fails(void **state) {
+    UNUSED(state);
+
+    char path[16];
+
+    assert_int_equal(flog_router_expand("/log/%{subsystem}", TEST_SUBSYSTEM, "", LVL_DEFAULT, path, sizeof(path)),
+                     FLOG_ERROR_FILE);
+    assert_int_equal(flog_router_expand("/var/log/plain.log", "", "", LVL_DEFAULT, path, sizeof(path)),
+                     FLOG_ERROR_FILE);
+}
+
+static void
+flog_router_is_template_succeeds(void **state) {
+    UNUSED(state);
+
+    assert_true(flog_router_is_template("/log/%{subsystem}.log"));
+    assert_true(flog_router_is_template("/log/100%%/%{level}.log"));
+    assert_false(flog_router_is_template("/log/100%%.log"));
+    assert_false(flog_router_is_template("/log/100%.log"));
+    assert_false(flog_router_is_template("/log/%{unknown}.log"));
+    assert_false(flog_router_is_template("/log/%%{subsystem}.log"));
+    assert_false(flog_router_is_template("/log/plain.log"));
+}
+
+static void
+flog_router_get_writer_caches_writers(void **state) {
+    char path[TEST_PATH_LEN];
+    router_path(path, *state, "a.log");
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogRouter *router = flog_router_new(ROUTER_CACHE_SIZE, WRT_SYNC, false, &error);
+    assert_non_null(router);
+
+    FlogWriter *first = flog_router_get_writer(router, path, false, &error);
+    assert_non_null(first);
+    FlogWriter *second = flog_router_get_writer(router, path, false, &error);
+    assert_ptr_equal(first, second);
+
+    FlogRouterStats stats;
+    flog_router_get_stats(router, &stats);
+    assert_int_equal(stats.hits, 1);
+    assert_int_equal(stats.misses, 1);
+    assert_int_equal(stats.evictions, 0);
+    assert_int_equal(stats.open, 1);
+
+    flog_router_free(router);
+}
+
+static void
+flog_router_get_writer_evicts_least_recently_used(void **state) {
+    char a[TEST_PATH_LEN];
+    char b[TEST_PATH_LEN];
+    char c[TEST_PATH_LEN];
+    router_path(a, *state, "a.log");
+    router_path(b, *state, "b.log");
+    router_path(c, *state, "c.log");
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogRouter *router = flog_router_new(2, WRT_SYNC, false, &error);
+    assert_non_null(router);
+    assert_int_equal(flog_router_get_capacity(router), 2);
+
+    assert_non_null(flog_router_get_writer(router, a, false, &error));
+    assert_non_null(flog_router_get_writer(router, b, false, &error));
+    assert_non_null(flog_router_get_writer(router, a, false, &error));
+    assert_non_null(flog_router_get_writer(router, c, false, &error));
+
+    FlogRouterStats stats;
+    flog_router_get_stats(router, &stats);
+    assert_int_equal(stats.hits, 1);
+    assert_int_equal(stats.misses, 3);
+    assert_int_equal(stats.evictions, 1);
+    assert_int_equal(stats.open, 2);
+
+    // b was evicted rather than a, which was used more recently
+    assert_non_null(flog_router_get_writer(router, a, false, &error));
+    assert_non_null(flog_router_get_writer(router, b, false, &error));
+
+    flog_router_get_stats(router, &stats);
+    assert_int_equal(stats.hits, 2);
+    assert_int_equal(stats.misses, 4);
+    assert_int_equal(stats.evictions, 2);
+    assert_int_equal(stats.open, 2);
+
+    flog_router_free(router);
+}
+
+static void
+flog_router_evicted_writer_is_flushed(void **state) {
+    char a[TEST_PATH_LEN];
+    char b[TEST_PATH_LEN];
+    router_path(a, *state, "a.log");
+    router_path(b, *state, "b.log");
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogRouter *router = flog_router_new(1, WRT_ASYNC, false, &error);
+    assert_non_null(router);
+
+    FlogWriter *writer = flog_router_get_writer(router, a, false, &error);
+    assert_non_null(writer);
+    assert_int_equal(flog_writer_write(writer, TEST_MESSAGE, strlen(TEST_MESSAGE)), FLOG_ERROR_NONE);
+
+    assert_non_null(flog_router_get_writer(router, b, false, &error));
+
+    char buf[TEST_PATH_LEN];
+    read_file(a, buf, sizeof(buf));
+    assert_string_equal(buf, TEST_MESSAGE);
+
+    assert_int_equal(flog_router_flush(router), FLOG_ERROR_NONE);
+
+    flog_router_free(router);
+}
+
+static void
+flog_router_get_writer_creates_parents(void **state) {
+    char path[TEST_PATH_LEN];
+    router_path(path, *state, "com.example.app/network/error.log");
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogRouter *router = flog_router_new(ROUTER_CACHE_SIZE, WRT_SYNC, false, &error);
+    assert_non_null(router);
+
+    assert_null(flog_router_get_writer(router, path, false, &error));
+    assert_int_equal(error, FLOG_ERROR_APPEND);
+
+    FlogWriter *writer = flog_router_get_writer(router, path, true, &error);
+    assert_non_null(writer);
+    assert_int_equal(flog_writer_write(writer, TEST_MESSAGE, strlen(TEST_MESSAGE)), FLOG_ERROR_NONE);
+
+    flog_router_free(router);
+
+    char buf[TEST_PATH_LEN];
+    read_file(path, buf, sizeof(buf));
+    assert_string_equal(buf, TEST_MESSAGE);
+}
+
+int main(void) {
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+
+    const struct CMUnitTest tests[] = {
+        // flog_router_new() and flog_router_free() failure tests
+        cmocka_unit_test(flog_router_new_with_null_error_arg_fails),
+        cmocka_unit_test_setup_teardown(flog_router_new_with_calloc_failure_fails, enable_calloc_failure, disable_calloc_failure),
+        cmocka_unit_test(flog_router_free_with_null_router_arg_fails),
+
+        // flog_router_expand() and flog_router_is_template() tests
+        cmocka_unit_test(flog_router_expand_succeeds),
+        cmocka_unit_test(flog_router_expand_sanitises_values),
+        cmocka_unit_test(flog_router_expand_with_invalid_template_fails),
+        cmocka_unit_test(flog_router_expand_keeps_literal_paths),
+        cmocka_unit_test(flog_router_expand_with_long_path_fails),
+        cmocka_unit_test(flog_router_is_template_succeeds),
+
+        // flog_router_get_writer() cache tests
+        cmocka_unit_test_setup_teardown(flog_router_get_writer_caches_writers, create_router_dir, remove_router_dir),
+        cmocka_unit_test_setup_teardown(flog_router_get_writer_evicts_least_recently_used, create_router_dir, remove_router_dir),
+        cmocka_unit_test_setup_teardown(flog_router_evicted_writer_is_flushed, create_router_dir, remove_router_dir),
+        cmocka_unit_test_setup_teardown(flog_router_get_writer_creates_parents, create_router_dir, remove_router_dir),
+    };
+
+    return cmocka_run_group_tests_name("FlogRouter tests", tests, NULL, NULL);
+}
@@ -0,0 +1,134 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdbool.h>
+#include "sample.h"
+
+#define TEST_MESSAGE_COUNT 10000
+
+#define UNUSED(x) (void)(x)
+
+static void
+flog_sample_keeps_with_null_message_arg_fails(void **state) {
+    UNUSED(state);
+
+    expect_assert_failure(flog_sample_keeps(NULL, 0.5));
+}
+
+static void
+flog_sample_keeps_every_message_at_full_rate(void **state) {
+    UNUSED(state);
+
+    char message[32];
+    for (int i = 0; i < 100; i++) {
+        snprintf(message, sizeof(message), "request %d", i);
+        assert_true(flog_sample_keeps(message, 1.0));
+    }
+
+    assert_true(flog_sample_keeps("", 1.0));
+}
+
+static void
+flog_sample_keeps_fraction_of_messages(void **state) {
+    UNUSED(state);
+
+    char message[32];
+    int kept = 0;
+    int kept_rarely = 0;
+
+    for (int i = 0; i < TEST_MESSAGE_COUNT; i++) {
+        snprintf(message, sizeof(message), "request %d", i);
+        bool keeps = flog_sample_keeps(message, 0.1);
+        kept += keeps;
+
+        // A message kept at a rate is kept at every higher rate, and every time
+        if (flog_sample_keeps(message, 0.01)) {
+            assert_true(keeps);
+            kept_rarely++;
+        }
+
+        assert_int_equal(flog_sample_keeps(message, 0.1), keeps);
+    }
+
+    assert_in_range(kept, TEST_MESSAGE_COUNT / 10 - 200, TEST_MESSAGE_COUNT / 10 + 200);
+    assert_in_range(kept_rarely, TEST_MESSAGE_COUNT / 100 - 50, TEST_MESSAGE_COUNT / 100 + 50);
+}
+
+static void
+flog_sample_annotate_with_small_size_arg_fails(void **state) {
+    UNUSED(state);
+
+    char message[SAMPLE_ANNOTATION_LEN - 1] = "";
+    expect_assert_failure(flog_sample_annotate(message, sizeof(message), 0.5));
+}
+
+static void
+flog_sample_annotate_appends_rate(void **state) {
+    UNUSED(state);
+
+    char message[64] = "cache miss";
+    flog_sample_annotate(message, sizeof(message), 0.01);
+
+    assert_string_equal(message, "cache miss [sample_rate=0.01]");
+}
+
+static void
+flog_sample_annotate_truncates_at_character_boundary(void **state) {
+    UNUSED(state);
+
+    // The annotation takes 18 bytes, leaving 21 for the message, which would cut its
+    // eleventh two-byte character in half
+    char message[40] = "";
+    for (int i = 0; i < 12; i++) {
+        strcat(message, "\xc3\xa9");
+    }
+
+    flog_sample_annotate(message, sizeof(message), 0.5);
+
+    assert_string_equal(message, "\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9"
+                                 " [sample_rate=0.5]");
+}
+
+int main(void) {
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+
+    const struct CMUnitTest tests[] = {
+        // flog_sample_keeps() tests
+        cmocka_unit_test(flog_sample_keeps_with_null_message_arg_fails),
+        cmocka_unit_test(flog_sample_keeps_every_message_at_full_rate),
+        cmocka_unit_test(flog_sample_keeps_fraction_of_messages),
+
+        // flog_sample_annotate() tests
+        cmocka_unit_test(flog_sample_annotate_with_small_size_arg_fails),
+        cmocka_unit_test(flog_sample_annotate_appends_rate),
+        cmocka_unit_test(flog_sample_annotate_truncates_at_character_boundary),
+    };
+
+    return cmocka_run_group_tests_name("Sample function tests", tests, NULL, NULL);
+}
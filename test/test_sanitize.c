@@ -0,0 +1,178 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdbool.h>
+#include "sanitize.h"
+
+#define TEST_BUF_LEN 256
+
+#define UNUSED(x) (void)(x)
+
+#define assert_sanitized(str, expected) do { \
+    char buf[TEST_BUF_LEN]; \
+    bool truncated = true; \
+    size_t len = flog_sanitize_copy(str, sizeof(str) - 1, buf, sizeof(buf), &truncated); \
+    assert_false(truncated); \
+    assert_int_equal(len, strlen(expected)); \
+    assert_string_equal(buf, expected); \
+} while (0)
+
+static void
+flog_sanitize_scan_with_null_str_arg_fails(void **state) {
+    UNUSED(state);
+
+    expect_assert_failure(flog_sanitize_scan(NULL, 0));
+}
+
+static void
+flog_sanitize_scan_accepts_valid_text(void **state) {
+    UNUSED(state);
+
+    // Printable ASCII across several vectors, tabs, line endings, DEL and sequences of
+    // each length, including the lowest and highest of each
+    const char text[] = "plain text that spans more than one vector of sixteen bytes\tand\r\nlines\n\x7f"
+                        "\xc2\x80 caf\xc3\xa9 \xe0\xa0\x80 \xe2\x82\xac \xed\x9f\xbf \xef\xbf\xbf "
+                        "\xf0\x90\x80\x80 \xf0\x9f\x98\x80 \xf4\x8f\xbf\xbf";
+    assert_int_equal(flog_sanitize_scan(text, sizeof(text) - 1), sizeof(text) - 1);
+}
+
+static void
+flog_sanitize_scan_finds_first_byte_to_sanitize(void **state) {
+    UNUSED(state);
+
+    // Every position of each kind of byte, including those past the first vector
+    const char *sanitized[] = { "\x1b", "\x01", "\r", "\x80", "\xc0\xaf", "\xe0\x80\x80", "\xed\xa0\x80",
+                                "\xf4\x90\x80\x80", "\xf8", "\xff", "\xc3" };
+    char str[40];
+
+    for (size_t s = 0; s < sizeof(sanitized) / sizeof(sanitized[0]); s++) {
+        size_t len = strlen(sanitized[s]);
+        for (size_t i = 0; i + len <= sizeof(str); i++) {
+            memset(str, 'a', sizeof(str));
+            memcpy(str + i, sanitized[s], len);
+            assert_int_equal(flog_sanitize_scan(str, sizeof(str)), i);
+        }
+    }
+}
+
+static void
+flog_sanitize_scan_quoted_finds_first_byte_to_escape(void **state) {
+    UNUSED(state);
+
+    const char text[] = "plain text that spans more than one vector of sixteen bytes, DEL \x7f, "
+                        "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80";
+    assert_int_equal(flog_sanitize_scan_quoted(text, sizeof(text) - 1), sizeof(text) - 1);
+
+    // The bytes that end a run of a JSON string, as well as those flog_sanitize_scan() stops at
+    const char *escaped[] = { "\"", "\\", "\t", "\n", "\r\n", "\x1b", "\x80", "\xc0\xaf", "\xed\xa0\x80", "\xc3" };
+    char str[40];
+
+    for (size_t s = 0; s < sizeof(escaped) / sizeof(escaped[0]); s++) {
+        size_t len = strlen(escaped[s]);
+        for (size_t i = 0; i + len <= sizeof(str); i++) {
+            memset(str, 'a', sizeof(str));
+            memcpy(str + i, escaped[s], len);
+            assert_int_equal(flog_sanitize_scan_quoted(str, sizeof(str)), i);
+        }
+    }
+}
+
+static void
+flog_sanitize_copy_with_null_args_fails(void **state) {
+    UNUSED(state);
+
+    char buf[TEST_BUF_LEN];
+    bool truncated;
+    expect_assert_failure(flog_sanitize_copy(NULL, 0, buf, sizeof(buf), &truncated));
+    expect_assert_failure(flog_sanitize_copy("", 0, NULL, sizeof(buf), &truncated));
+    expect_assert_failure(flog_sanitize_copy("", 0, buf, sizeof(buf), NULL));
+}
+
+static void
+flog_sanitize_copy_escapes_control_characters(void **state) {
+    UNUSED(state);
+
+    assert_sanitized("\x1b[31mred\x1b[0m\ttab\r\nline\rover\x07", "\\x1b[31mred\\x1b[0m\ttab\r\nline\\x0dover\\x07");
+}
+
+static void
+flog_sanitize_copy_replaces_invalid_sequences(void **state) {
+    UNUSED(state);
+
+    // Each invalid sequence is replaced once, as far as it could have been valid
+    assert_sanitized("a\x80" "b\xc0\xaf" "c\xe2\x82" "d\xed\xa0\x80" "e\xf0\x9f\x98" "f\xff" "caf\xc3\xa9\xc3",
+                     "a" SANITIZE_REPLACEMENT "b" SANITIZE_REPLACEMENT SANITIZE_REPLACEMENT
+                     "c" SANITIZE_REPLACEMENT "d" SANITIZE_REPLACEMENT SANITIZE_REPLACEMENT SANITIZE_REPLACEMENT
+                     "e" SANITIZE_REPLACEMENT "f" SANITIZE_REPLACEMENT "caf\xc3\xa9" SANITIZE_REPLACEMENT);
+}
+
+static void
+flog_sanitize_copy_truncates_between_characters(void **state) {
+    UNUSED(state);
+
+    char buf[8];
+    bool truncated = false;
+
+    // Neither a character nor an escape is cut short
+    assert_int_equal(flog_sanitize_copy("abcde\xc3\xa9\x1b", 8, buf, sizeof(buf), &truncated), 7);
+    assert_true(truncated);
+    assert_string_equal(buf, "abcde\xc3\xa9");
+
+    assert_int_equal(flog_sanitize_copy("abcdef\xc3\xa9", 8, buf, sizeof(buf), &truncated), 6);
+    assert_true(truncated);
+    assert_string_equal(buf, "abcdef");
+
+    assert_int_equal(flog_sanitize_copy("abcd\x1b", 5, buf, sizeof(buf), &truncated), 4);
+    assert_true(truncated);
+    assert_string_equal(buf, "abcd");
+
+    assert_int_equal(flog_sanitize_copy("abc\x1b", 4, buf, sizeof(buf), &truncated), 7);
+    assert_false(truncated);
+    assert_string_equal(buf, "abc\\x1b");
+}
+
+int main(void) {
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+
+    const struct CMUnitTest tests[] = {
+        // flog_sanitize_scan() tests
+        cmocka_unit_test(flog_sanitize_scan_with_null_str_arg_fails),
+        cmocka_unit_test(flog_sanitize_scan_accepts_valid_text),
+        cmocka_unit_test(flog_sanitize_scan_finds_first_byte_to_sanitize),
+        cmocka_unit_test(flog_sanitize_scan_quoted_finds_first_byte_to_escape),
+
+        // flog_sanitize_copy() tests
+        cmocka_unit_test(flog_sanitize_copy_with_null_args_fails),
+        cmocka_unit_test(flog_sanitize_copy_escapes_control_characters),
+        cmocka_unit_test(flog_sanitize_copy_replaces_invalid_sequences),
+        cmocka_unit_test(flog_sanitize_copy_truncates_between_characters),
+    };
+
+    return cmocka_run_group_tests_name("Sanitize function tests", tests, NULL, NULL);
+}
@@ -0,0 +1,232 @@
+// MIT License
+//
+// Copyright (c) 2026 Marc Ransome
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "writer.h"
+#include "common.h"
+
+#define TEST_MESSAGE "test message\n"
+#define TEST_PATH_TEMPLATE "/tmp/flog.XXXXXXXX"
+#define TEST_PATH_LEN 32
+#define TEST_RECORD_LEN 64
+#define TEST_RECORD_COUNT 20000
+
+#define UNUSED(x) (void)(x)
+
+static int
+create_writer_path(void **state) {
+    char *path = malloc(TEST_PATH_LEN);
+    if (path == NULL) {
+        return 1;
+    }
+
+    strcpy(path, TEST_PATH_TEMPLATE);
+
+    int fd = mkstemp(path);
+    if (fd == -1) {
+        free(path);
+        return 1;
+    }
+
+    close(fd);
+    *state = path;
+
+    return 0;
+}
+
+static int
+remove_writer_path(void **state) {
+    unlink(*state);
+    free(*state);
+
+    return 0;
+}
+
+static void
+write_and_verify_records(const char *path, FlogConfigWriter backend, bool datasync, size_t count) {
+    FlogError error = FLOG_ERROR_NONE;
+    FlogWriter *writer = flog_writer_new(path, backend, datasync, &error);
+
+    assert_non_null(writer);
+    assert_int_equal(error, FLOG_ERROR_NONE);
+
+    char record[TEST_RECORD_LEN];
+    for (size_t i = 0; i < count; i++) {
+        int len = snprintf(record, sizeof(record), "record %08zu\n", i);
+        assert_int_equal(flog_writer_write(writer, record, (size_t) len), FLOG_ERROR_NONE);
+    }
+
+    assert_int_equal(flog_writer_flush(writer), FLOG_ERROR_NONE);
+    flog_writer_free(writer);
+
+    FILE *file = fopen(path, "r");
+    assert_non_null(file);
+
+    char line[TEST_RECORD_LEN];
+    char expected[TEST_RECORD_LEN];
+    size_t lines = 0;
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        snprintf(expected, sizeof(expected), "record %08zu\n", lines);
+        assert_string_equal(line, expected);
+        lines++;
+    }
+
+    fclose(file);
+
+    assert_int_equal(lines, count);
+}
+
+static void
+flog_writer_new_with_null_path_arg_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error;
+
+    expect_assert_failure(flog_writer_new(NULL, WRT_SYNC, false, &error));
+}
+
+static void
+flog_writer_new_with_null_error_arg_fails(void **state) {
+    expect_assert_failure(flog_writer_new(*state, WRT_SYNC, false, NULL));
+}
+
+static void
+flog_writer_write_with_null_writer_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_writer_write(NULL, TEST_MESSAGE, strlen(TEST_MESSAGE)));
+}
+
+static void
+flog_writer_flush_with_null_writer_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_writer_flush(NULL));
+}
+
+static void
+flog_writer_free_with_null_writer_arg_fails(void **state) {
+    UNUSED(state);
+    expect_assert_failure(flog_writer_free(NULL));
+}
+
+static void
+flog_writer_new_with_unwritable_path_fails(void **state) {
+    UNUSED(state);
+
+    FlogError error = FLOG_ERROR_NONE;
+    FlogWriter *writer = flog_writer_new("/nonexistent/flog/output", WRT_SYNC, false, &error);
+
+    assert_null(writer);
+    assert_int_equal(error, FLOG_ERROR_APPEND);
+}
+
+static void
+flog_writer_sync_backend_succeeds(void **state) {
+    FlogError error = FLOG_ERROR_NONE;
+    FlogWriter *writer = flog_writer_new(*state, WRT_SYNC, false, &error);
+
+    assert_non_null(writer);
+    assert_int_equal(flog_writer_get_backend(writer), WRT_SYNC);
+
+    flog_writer_free(writer);
+
+    write_and_verify_records(*state, WRT_SYNC, false, TEST_RECORD_COUNT);
+}
+
+static void
+flog_writer_async_backend_preserves_order(void **state) {
+    write_and_verify_records(*state, WRT_ASYNC, false, TEST_RECORD_COUNT);
+}
+
+static void
+flog_writer_async_backend_with_datasync_preserves_order(void **state) {
+    write_and_verify_records(*state, WRT_ASYNC, true, TEST_RECORD_COUNT / 10);
+}
+
+static void
+flog_writer_async_backend_with_large_write_preserves_order(void **state) {
+    FlogError error = FLOG_ERROR_NONE;
+    FlogWriter *writer = flog_writer_new(*state, WRT_ASYNC, false, &error);
+    assert_non_null(writer);
+
+    size_t large_len = WRITER_BATCH_SIZE * 2;
+    char *large = malloc(large_len);
+    assert_non_null(large);
+    memset(large, 'x', large_len);
+
+    assert_int_equal(flog_writer_write(writer, "first\n", 6), FLOG_ERROR_NONE);
+    assert_int_equal(flog_writer_write(writer, large, large_len), FLOG_ERROR_NONE);
+    assert_int_equal(flog_writer_write(writer, "last\n", 5), FLOG_ERROR_NONE);
+
+    flog_writer_free(writer);
+    free(large);
+
+    struct stat statbuf;
+    assert_int_equal(stat(*state, &statbuf), 0);
+    assert_int_equal(statbuf.st_size, 6 + large_len + 5);
+
+    FILE *file = fopen(*state, "r");
+    assert_non_null(file);
+
+    char head[7] = {0};
+    char tail[6] = {0};
+    assert_int_equal(fread(head, 1, 6, file), 6);
+    fseek(file, -5, SEEK_END);
+    assert_int_equal(fread(tail, 1, 5, file), 5);
+    fclose(file);
+
+    assert_string_equal(head, "first\n");
+    assert_string_equal(tail, "last\n");
+}
+
+int main(void) {
+    cmocka_set_message_output(CM_OUTPUT_TAP);
+
+    const struct CMUnitTest tests[] = {
+        // flog_writer_new() and associated function precondition tests
+        cmocka_unit_test(flog_writer_new_with_null_path_arg_fails),
+        cmocka_unit_test_setup_teardown(flog_writer_new_with_null_error_arg_fails, create_writer_path, remove_writer_path),
+        cmocka_unit_test(flog_writer_write_with_null_writer_arg_fails),
+        cmocka_unit_test(flog_writer_flush_with_null_writer_arg_fails),
+        cmocka_unit_test(flog_writer_free_with_null_writer_arg_fails),
+
+        // flog_writer_new() failure tests
+        cmocka_unit_test(flog_writer_new_with_unwritable_path_fails),
+
+        // flog_writer_write() success tests
+        cmocka_unit_test_setup_teardown(flog_writer_sync_backend_succeeds, create_writer_path, remove_writer_path),
+        cmocka_unit_test_setup_teardown(flog_writer_async_backend_preserves_order, create_writer_path, remove_writer_path),
+        cmocka_unit_test_setup_teardown(flog_writer_async_backend_with_datasync_preserves_order, create_writer_path, remove_writer_path),
+        cmocka_unit_test_setup_teardown(flog_writer_async_backend_with_large_write_preserves_order, create_writer_path, remove_writer_path),
+    };
+
+    return cmocka_run_group_tests_name("FlogWriter tests", tests, NULL, NULL);
+}
@@ -24,6 +24,11 @@ extern void _test_free(void * const ptr, const char *file, const int line);
 
 bool fail_calloc = false;
 
+// Selects the argument parser used by flog_config_new() regardless of whether popt
+// configuration files exist, so that the same tests can be run against both parsers
+bool force_fast_parser = false;
+bool force_popt_parser = false;
+
 void *
 flog_test_calloc(size_t count, size_t size, char *file, int line) {
     if (fail_calloc) {